@@ -27,4 +27,25 @@ void arch_restore_flags(uint64_t flags);
 void arch_smap_begin();
 void arch_smap_end();
 
+/// Serialized TSC read (LFENCE; RDTSC) so the timestamp is not taken early.
+uint64_t arch_read_tsc();
+
+/// Sets CR4.PGE (global pages) and, if requested, CR4.PCIDE. CR3[11:0] must be 0.
+void arch_enable_tlb_features(bool enable_pcid);
+
+/// Loads the kernel's PAT layout: the power-on entries 0-3 (WB, WT, UC-, UC),
+/// so PWT/PCD keep their meaning, and write-combining in entry 4. Call before
+/// any mapping uses the PAT bit, then reload CR3.
+void arch_program_pat();
+
+/// Raw CR3 load: PCID in bits 0-11 and the no-flush hint in bit 63 are kept.
+void arch_load_cr3(uint64_t value);
+
+/// Drops every TLB entry of every PCID, global ones included (CR4.PGE toggle).
+void arch_flush_tlb_all();
+
+/// Index of the executing CPU from CpuControlBlock::cpu_id via GS; 0 (the boot
+/// CPU) until init_syscalls() has loaded the kernel GS base.
+uint32_t arch_current_cpu_id();
+
 } // extern "C"
@@ -64,5 +64,8 @@ void ata_secondary_handler([[maybe_unused]] uint8_t vector,
 void mouse_handler([[maybe_unused]] uint8_t vector,
                    InterruptFrame *frame = nullptr);
 
+void serial_handler([[maybe_unused]] uint8_t vector,
+                    InterruptFrame *frame = nullptr);
+
 void apic_timer_handler([[maybe_unused]] uint8_t vector,
                         InterruptFrame *frame = nullptr);
@@ -56,6 +56,7 @@ public:
                                                                     uint16_t entry) override;
   void enable_msi(uint8_t vector) override;
   void disable_msi(uint8_t vector) override;
+  fk::core::Result<void, fk::core::Error> send_ipi(uint32_t apic_id, uint8_t vector) override;
 
   /**
    * @brief Calibrate APIC timer
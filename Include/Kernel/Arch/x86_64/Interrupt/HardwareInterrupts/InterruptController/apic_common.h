@@ -18,9 +18,15 @@ constexpr uint32_t APIC_LVT_MASK               = 1u << 16;
 constexpr uint32_t APIC_LVT_TIMER_MODE_PERIODIC = 1u << 17;
 constexpr uint32_t APIC_TIMER_DIVISOR           = 0x3; // divide by 16
 
+// ICR: fixed delivery, physical destination, level assert
+constexpr uint32_t APIC_ICR_LEVEL_ASSERT     = 1u << 14;
+constexpr uint32_t APIC_ICR_DELIVERY_PENDING = 1u << 12;
+
 // xAPIC MMIO register offsets
 constexpr uint32_t APIC_REG_EOI           = 0x0B0;
 constexpr uint32_t APIC_REG_SPURIOUS      = 0x0F0;
+constexpr uint32_t APIC_REG_ICR_LOW       = 0x300;
+constexpr uint32_t APIC_REG_ICR_HIGH      = 0x310;
 constexpr uint32_t APIC_REG_LVT_TIMER    = 0x320;
 constexpr uint32_t APIC_REG_INITIAL_COUNT = 0x380;
 constexpr uint32_t APIC_REG_CURRENT_COUNT = 0x390;
@@ -29,6 +35,7 @@ constexpr uint32_t APIC_REG_DIVIDE_CONFIG = 0x3E0;
 // x2APIC MSR addresses
 constexpr uint32_t X2APIC_EOI_MSR           = 0x80B;
 constexpr uint32_t X2APIC_SPURIOUS_MSR      = 0x80F;
+constexpr uint32_t X2APIC_ICR_MSR           = 0x830;
 constexpr uint32_t X2APIC_LVT_TIMER_MSR     = 0x832;
 constexpr uint32_t X2APIC_INITIAL_COUNT_MSR = 0x838;
 constexpr uint32_t X2APIC_CURRENT_COUNT_MSR = 0x839;
@@ -47,6 +47,7 @@ public:
   fk::core::Result<uint8_t, fk::core::Error> allocate_msi_vector(const PciDevice& device) override;
   void enable_msi(uint8_t vector) override;
   void disable_msi(uint8_t vector) override;
+  fk::core::Result<void, fk::core::Error> send_ipi(uint32_t apic_id, uint8_t vector) override;
 
   /**
    * @brief Calibrate APIC timer
@@ -24,5 +24,10 @@ public:
   }
   virtual void enable_msi(uint8_t vector) { (void)vector; }
   virtual void disable_msi(uint8_t vector) { (void)vector; }
+
+  /** @brief Sends a fixed interrupt to the local APIC with the given ID. */
+  virtual fk::core::Result<void, fk::core::Error> send_ipi(uint32_t apic_id, uint8_t vector) {
+      (void)apic_id; (void)vector; return fk::core::Error::NotImplemented;
+  }
 };
 
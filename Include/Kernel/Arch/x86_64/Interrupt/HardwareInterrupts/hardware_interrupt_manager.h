@@ -44,6 +44,7 @@ public:
                                                                     uint16_t entry);
   void enable_msi(uint8_t vector);
   void disable_msi(uint8_t vector);
+  fk::core::Result<void, fk::core::Error> send_ipi(uint32_t apic_id, uint8_t vector);
 
   void set_controller(HardwareInterrupt* controller);
   void set_memory_manager(bool is_memory_manager);
@@ -44,6 +44,18 @@ static constexpr size_t PAGE_SIZE = 4 * fk::types::KiB;
 
 static constexpr size_t PAGE_SIZE_2M = 2 * fk::types::MiB;
 
+/**
+ * @brief Buddy allocator order (log2 of the block size in bytes) of a 2 MiB page;
+ */
+
+static constexpr size_t PAGE_SIZE_2M_ORDER = 21;
+
+/**
+ * @brief Define a huge page size as 1 GiB (requires CPUID PDPE1GB);
+ */
+
+static constexpr size_t PAGE_SIZE_1G = 1 * fk::types::GiB;
+
 /**
  * @brief Define a Page Mask
  */
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <LibFK/Core/result.h>
+#include <LibFK/Types/types.h>
+
+/**
+ * @brief PIT channel 2 data port (speaker channel, gated through port 0x61).
+ */
+constexpr uint16_t PIT_CHANNEL2 = 0x42;
+
+/**
+ * @brief Keyboard controller port B: bit 0 gates PIT channel 2, bit 5 is its OUT.
+ */
+constexpr uint16_t PIT_GATE_PORT = 0x61;
+
+/**
+ * @brief Monotonic clocksource backed by the invariant TSC.
+ *
+ * The TSC rate is calibrated once at boot against the HPET main counter (or
+ * PIT channel 2 when no HPET is available) and converted to nanoseconds with
+ * a 32.32 fixed-point multiplier, the same representation the vDSO uses so
+ * kernel and user space agree on every reading.
+ */
+class TscClockSource {
+public:
+  static constexpr uint32_t SHIFT = 32;
+
+private:
+  uint64_t m_frequency_hz = 0;
+  uint64_t m_mult = 0; ///< Nanoseconds per cycle, scaled by 2^SHIFT.
+  bool m_usable = false;
+
+  TscClockSource() = default;
+
+  uint64_t calibrate_with_hpet();
+  uint64_t calibrate_with_pit();
+
+public:
+  static TscClockSource& the() {
+    static TscClockSource inst;
+    return inst;
+  }
+
+  /**
+   * @brief Calibrates the TSC and enables it as the system clocksource.
+   *
+   * Fails with NotImplemented when the CPU does not advertise an invariant
+   * TSC; the caller then falls back to tick-based timekeeping.
+   */
+  fk::core::Result<void> initialize();
+
+  bool is_usable() const { return m_usable; }
+  uint64_t frequency_hz() const { return m_frequency_hz; }
+  uint64_t mult() const { return m_mult; }
+
+  uint64_t read_cycles() const;
+  uint64_t cycles_to_ns(uint64_t cycles) const;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+/**
+ * @brief POSIX clock identifiers accepted by clock_gettime/clock_getres.
+ *
+ * Values match the Linux x86_64 ABI so musl can pass them through untouched.
+ */
+enum class ClockId : uint32_t {
+  Realtime = 0,
+  Monotonic = 1,
+  ProcessCputime = 2,
+  ThreadCputime = 3,
+  MonotonicRaw = 4,
+  RealtimeCoarse = 5,
+  MonotonicCoarse = 6,
+  Boottime = 7,
+};
+
+constexpr uint32_t CLOCK_ID_COUNT = 8;
@@ -13,5 +13,7 @@ struct DateTime {
   uint16_t year;
 
   fk::text::String to_string() const;
+  /** @brief Seconds since 1970-01-01T00:00:00Z (0 for dates before the epoch). */
+  int64_t to_unix_epoch() const;
   void print();
 };
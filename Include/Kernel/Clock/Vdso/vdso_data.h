@@ -0,0 +1,35 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+/// Set in VdsoData::flags when the TSC parameters may be used from user space.
+constexpr uint32_t VDSO_FLAG_TSC_USABLE = 1u << 0;
+
+/**
+ * @brief Layout of the read-only page shared between the kernel and the vDSO.
+ *
+ * The kernel publishes updates with a sequence counter (odd while writing);
+ * readers retry until they observe the same even value before and after
+ * sampling. Offsets are hard-coded in vdso.asm, hence the static_asserts.
+ *
+ *   monotonic_ns = monotonic_base_ns + ((rdtsc - tsc_base) * tsc_mult) >> 32
+ *   realtime_ns  = monotonic_ns + realtime_offset_ns
+ *   boottime_ns  = monotonic_ns + boottime_offset_ns
+ */
+struct VdsoData {
+  volatile uint32_t seq;
+  uint32_t flags;
+  uint64_t tsc_base;
+  uint64_t tsc_mult;
+  uint64_t monotonic_base_ns;
+  int64_t realtime_offset_ns;
+  int64_t boottime_offset_ns;
+};
+
+static_assert(__builtin_offsetof(VdsoData, seq) == 0);
+static_assert(__builtin_offsetof(VdsoData, flags) == 4);
+static_assert(__builtin_offsetof(VdsoData, tsc_base) == 8);
+static_assert(__builtin_offsetof(VdsoData, tsc_mult) == 16);
+static_assert(__builtin_offsetof(VdsoData, monotonic_base_ns) == 24);
+static_assert(__builtin_offsetof(VdsoData, realtime_offset_ns) == 32);
+static_assert(__builtin_offsetof(VdsoData, boottime_offset_ns) == 40);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Kernel/Clock/Types/clock_id.h>
+#include <Kernel/Clock/Vdso/vdso_data.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Types/types.h>
+
+/**
+ * @brief Kernel timekeeping: CLOCK_MONOTONIC, CLOCK_REALTIME and CLOCK_BOOTTIME.
+ *
+ * Monotonic time comes from the TSC clocksource when it is usable and from
+ * the tick counter otherwise. Realtime and boottime are kept as signed
+ * offsets from monotonic time, seeded from the RTC once at boot, so reading
+ * any clock never touches CMOS. Every change is mirrored into the vDSO data
+ * page so user space can read the same clocks without a syscall.
+ */
+class TimeKeeper {
+private:
+  VdsoData* m_vdso_data = nullptr;
+  uintptr_t m_vdso_data_phys = 0;
+  uint64_t m_tsc_base = 0;
+  int64_t m_realtime_offset_ns = 0;
+  int64_t m_boottime_offset_ns = 0;
+  bool m_initialized = false;
+
+  TimeKeeper() = default;
+
+  void publish_vdso_data();
+
+public:
+  static TimeKeeper& the() {
+    static TimeKeeper inst;
+    return inst;
+  }
+
+  /**
+   * @brief Calibrates the clocksource, seeds CLOCK_REALTIME from the RTC and
+   * allocates the vDSO data page. Requires the memory manager and ClockManager.
+   */
+  void initialize();
+  bool is_initialized() const { return m_initialized; }
+
+  uint64_t monotonic_ns() const;
+  uint64_t realtime_ns() const;
+  uint64_t boottime_ns() const;
+
+  /** @brief Reads @p clock_id in nanoseconds; InvalidParameter for unknown ids. */
+  fk::core::Result<uint64_t> now_ns(uint32_t clock_id) const;
+
+  /** @brief Resolution of @p clock_id in nanoseconds. */
+  fk::core::Result<uint64_t> resolution_ns(uint32_t clock_id) const;
+
+  /** @return Physical frame of the vDSO data page (0 before initialize()). */
+  uintptr_t vdso_data_phys() const { return m_vdso_data_phys; }
+};
@@ -1,28 +1,53 @@
 #pragma once
 
-#include <Kernel/Ipc/notification.h>
-#include <LibFK/Container/vector.h>
+#include <Kernel/Driver/Terminal/line_discipline.h>
+#include <Kernel/Scheduler/wait_queue.h>
+#include <LibFK/Core/result.h>
 #include <LibFK/Memory/ref_counted.h>
+#include <LibFK/Synchronization/spinlock.h>
 
 namespace fkernel {
 
-class PtyBuffer : public fk::memory::RefCounted<PtyBuffer> {
+// Bounded byte ring carrying slave output (and echoed input) to the master.
+// Readers sleep while it is empty and writers while it is full, so a slave
+// that outruns its master is throttled instead of losing output.
+class PtyBuffer : public fk::memory::RefCounted<PtyBuffer>,
+                  public terminal::LineDisciplineDelegate {
 public:
   static constexpr size_t CAPACITY = 4096;
 
   PtyBuffer() = default;
 
-  size_t read(uint8_t* dst, size_t len);
-  size_t write(const uint8_t* src, size_t len);
+  // Sleeps until data is available, then copies out what there is
+  fk::core::Result<size_t, fk::core::Error> read(uint8_t* dst, size_t len);
+  // Sleeps while full until all of src is queued; a signal cuts it short
+  fk::core::Result<size_t, fk::core::Error> write(const uint8_t* src, size_t len);
+  // Queues what fits without sleeping
+  size_t try_write(const uint8_t* src, size_t len);
 
   bool is_empty() const;
+  bool is_full() const;
   size_t available() const;
 
-  ipc::Notification& data_ready() { return m_notification; }
+  // Echo from the slave's line discipline; dropped when the ring is full
+  void echo(const char* data, size_t len) override;
 
 private:
-  fk::containers::Vector<uint8_t> m_data;
-  ipc::Notification m_notification;
+  size_t copy_in_locked(const uint8_t* src, size_t len);
+
+  mutable fk::synchronization::Spinlock m_lock{"pty"};
+  uint8_t m_data[CAPACITY];
+  size_t m_head{0}; // Free-running; both taken modulo CAPACITY
+  size_t m_tail{0};
+  WaitQueue m_readers{"pty-read"};
+  WaitQueue m_writers{"pty-write"};
+};
+
+// The slave's line discipline, shared with the master that feeds it input
+class PtyLineDiscipline final : public fk::memory::RefCounted<PtyLineDiscipline>,
+                                public terminal::LineDiscipline {
+public:
+  explicit PtyLineDiscipline(terminal::LineDisciplineDelegate* echo) : LineDiscipline(echo) {}
 };
 
 } // namespace fkernel
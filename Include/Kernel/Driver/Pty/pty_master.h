@@ -7,11 +7,12 @@
 namespace fkernel {
 
 // Master side of a pseudo-terminal pair.
-// Writing to master delivers data to slave's read; reading from master
-// returns data written by the slave.
+// Writing to master feeds the slave's line discipline, sleeping while its
+// input ring is full; reading from master returns data written by the slave
+// and whatever the line discipline echoed.
 class PtyMaster final : public CharacterDevice {
 public:
-  PtyMaster(fk::RefPtr<PtyBuffer> to_slave, fk::RefPtr<PtyBuffer> from_slave,
+  PtyMaster(fk::RefPtr<PtyLineDiscipline> ldisc, fk::RefPtr<PtyBuffer> from_slave,
             uint32_t index = 0);
   virtual ~PtyMaster() override = default;
 
@@ -33,7 +34,7 @@ public:
   }
 
 private:
-  fk::RefPtr<PtyBuffer> m_to_slave;
+  fk::RefPtr<PtyLineDiscipline> m_ldisc;
   fk::RefPtr<PtyBuffer> m_from_slave;
 };
 
@@ -7,11 +7,12 @@
 namespace fkernel {
 
 // Slave side of a pseudo-terminal pair.
-// Reading from slave delivers data written by the master; writing to slave
-// delivers data to the master's read.
+// Reading from slave returns input the master wrote, after the line
+// discipline; writing to slave delivers data to the master's read, with
+// newlines mapped to CR LF under OPOST | ONLCR.
 class PtySlave final : public CharacterDevice {
 public:
-  PtySlave(fk::RefPtr<PtyBuffer> from_master, fk::RefPtr<PtyBuffer> to_master,
+  PtySlave(fk::RefPtr<PtyLineDiscipline> ldisc, fk::RefPtr<PtyBuffer> to_master,
            uint32_t index);
   virtual ~PtySlave() override = default;
 
@@ -21,17 +22,20 @@ public:
   fk::core::Result<size_t, fk::core::Error>
   write(uint64_t offset, size_t size, const uint8_t* buf) override;
 
+  fk::core::Result<int, fk::core::Error> ioctl(uint64_t request, uint64_t arg) override;
+
   size_t size() const override { return 0; }
   bool is_directory() const override { return false; }
   bool is_character_device() const override { return true; }
   short poll() const override {
-    short r = POLLOUT;
-    if (m_from_master && !m_from_master->is_empty()) r |= POLLIN;
+    short r = 0;
+    if (m_ldisc && m_ldisc->can_read()) r |= POLLIN;
+    if (m_to_master && !m_to_master->is_full()) r |= POLLOUT;
     return r;
   }
 
 private:
-  fk::RefPtr<PtyBuffer> m_from_master;
+  fk::RefPtr<PtyLineDiscipline> m_ldisc;
   fk::RefPtr<PtyBuffer> m_to_master;
 };
 
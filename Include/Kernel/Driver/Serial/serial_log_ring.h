@@ -0,0 +1,38 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/**
+ * @brief Byte ring holding one CPU's serial output until the UART takes it.
+ *
+ * Only the owning CPU writes, with interrupts off, and only the holder of the
+ * serial drain flag reads, so each side just publishes its own position and
+ * no lock is taken. A full ring takes what fits; the caller decides whether
+ * to wait for room.
+ */
+class SerialLogRing {
+public:
+  static constexpr size_t CAPACITY = 4096;
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+  /** @brief Queues up to @p len bytes. Owning CPU only. @return Bytes queued. */
+  size_t push(const char *data, size_t len);
+
+  /**
+   * @brief Takes up to @p max bytes, stopping after a newline so lines from
+   * different CPUs do not interleave. Drain-flag holder only.
+   * @param line_end Set when the last byte taken is a newline.
+   */
+  size_t pop(char *out, size_t max, bool &line_end);
+
+  bool is_empty() const;
+
+private:
+  char m_data[CAPACITY];
+  uint64_t m_head{0}; ///< Next byte to write; stored by the producer
+  uint64_t m_tail{0}; ///< Next byte to send; stored by the consumer
+};
+
+} // namespace fkernel
@@ -19,11 +19,7 @@ public:
 
     virtual fk::core::Result<size_t, fk::core::Error> write(uint64_t, size_t size, const uint8_t* buffer) override {
         if (!buffer) return fk::core::Error::InvalidParameter;
-        
-        for (size_t i = 0; i < size; ++i) {
-            serial::write_char(static_cast<char>(buffer[i]));
-        }
-        
+        serial::write_buffer(reinterpret_cast<const char*>(buffer), size);
         return size;
     }
 
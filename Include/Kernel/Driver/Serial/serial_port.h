@@ -12,6 +12,13 @@
  * Provides low-level access to the serial port for debugging and
  * kernel output. Supports character output, string output,
  * and numeric formatting (decimal and hexadecimal).
+ *
+ * Output is written synchronously until enable_async() is called. After that
+ * each CPU queues it into its own SerialLogRing, and whoever holds the drain
+ * flag feeds the UART one 16-byte FIFO load at a time: the writer when the
+ * FIFO is idle, otherwise the THRE interrupt when it empties. Once
+ * fk::algorithms::in_panic_mode() is set, output is synchronous again and
+ * anything still queued is sent first.
  */
 class serial {
 private:
@@ -24,6 +31,12 @@ private:
   static inline bool is_transmit_empty() { return inb(COM1 + 5) & 0x20; }
   static inline bool is_data_ready()     { return inb(COM1 + 5) & 0x01; }
 
+  static void write_sync(const char *data, size_t len);
+  static void queue(const char *data, size_t len);
+  static void kick();
+  static void drain_fifo();
+  static void flush_sync();
+
 public:
   /**
    * @brief Initialize the serial port
@@ -32,6 +45,17 @@ public:
    */
   static void init();
 
+  /**
+   * @brief Switches output to the per-CPU rings, drained by IRQ 4.
+   *
+   * Needs per-CPU GS data and should be called as interrupts are enabled:
+   * until then nothing drains the rings but the writers themselves.
+   */
+  static void enable_async();
+
+  /** @brief THRE interrupt: refills the transmit FIFO. */
+  static void handle_interrupt();
+
   /**
    * @brief Write a single character to the serial port
    * @param c Character to write
@@ -47,8 +71,8 @@ public:
   /**
    * @brief Write a counted byte buffer to the serial port.
    *
-   * Polls TX-FIFO-empty once per 16-byte FIFO chunk instead of per
-   * character, cutting UART polling overhead by up to 16×.
+   * Queues it on this CPU's ring once async output is on. Otherwise polls
+   * TX-FIFO-empty once per 16-byte FIFO chunk instead of per character.
    */
   static void write_buffer(const char *data, size_t len);
 
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <Kernel/Scheduler/wait_queue.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace terminal {
+
+/// Linux struct termios (x86_64 ABI: 4x uint32 + c_line + cc_t[19])
+struct Termios {
+    uint32_t c_iflag{0};
+    uint32_t c_oflag{0};
+    uint32_t c_cflag{0};
+    uint32_t c_lflag{0};
+    uint8_t c_line{0};
+    uint8_t c_cc[19]{};
+};
+
+struct WindowSize {
+    uint16_t rows{25};
+    uint16_t cols{80};
+    uint16_t xpixel{0};
+    uint16_t ypixel{0};
+};
+
+namespace tty {
+// c_iflag
+constexpr uint32_t ISTRIP = 0x20;
+constexpr uint32_t INLCR  = 0x40;
+constexpr uint32_t IGNCR  = 0x80;
+constexpr uint32_t ICRNL  = 0x100;
+constexpr uint32_t IXON   = 0x400;
+// c_oflag
+constexpr uint32_t OPOST  = 0x1;
+constexpr uint32_t ONLCR  = 0x4;
+// c_lflag
+constexpr uint32_t ISIG    = 0x1;
+constexpr uint32_t ICANON  = 0x2;
+constexpr uint32_t ECHO    = 0x8;
+constexpr uint32_t ECHOE   = 0x10;
+constexpr uint32_t ECHOK   = 0x20;
+constexpr uint32_t ECHONL  = 0x40;
+constexpr uint32_t NOFLSH  = 0x80;
+constexpr uint32_t ECHOCTL = 0x200;
+constexpr uint32_t ECHOKE  = 0x800;
+constexpr uint32_t IEXTEN  = 0x8000;
+// c_cc indices
+constexpr size_t VINTR   = 0;
+constexpr size_t VQUIT   = 1;
+constexpr size_t VERASE  = 2;
+constexpr size_t VKILL   = 3;
+constexpr size_t VEOF    = 4;
+constexpr size_t VTIME   = 5;
+constexpr size_t VMIN    = 6;
+constexpr size_t VSTART  = 8;
+constexpr size_t VSTOP   = 9;
+constexpr size_t VSUSP   = 10;
+constexpr size_t VEOL    = 11;
+constexpr size_t VWERASE = 14;
+} // namespace tty
+
+/// @brief Receives what the line discipline echoes back to the terminal
+class LineDisciplineDelegate {
+public:
+    virtual ~LineDisciplineDelegate() = default;
+
+    /// @brief Called with the line discipline locked, possibly from an IRQ: must not block
+    virtual void echo(const char* data, size_t len) = 0;
+};
+
+/**
+ * @brief N_TTY-style line discipline shared by VGA terminals and PTY slaves.
+ *
+ * Input is received into a fixed ring. In canonical mode (ICANON) the bytes
+ * past the last completed line form the line being edited: VERASE, VWERASE
+ * and VKILL trim it and a newline, VEOL or VEOF commits it. A bitmap marks
+ * where each committed line ends, so a read stops there without scanning;
+ * VEOF is stored as a NUL carrying the mark and is never copied out. With
+ * ISIG the VINTR, VQUIT and VSUSP characters signal the foreground process
+ * group instead of being queued.
+ *
+ * Readers sleep until a line (or, raw, a byte) is ready. A writer that may
+ * sleep (the PTY master) waits while the ring is full of unread input; the
+ * keyboard cannot wait, so its excess input is dropped. A line that alone
+ * fills the ring only accepts its terminator, as in Linux.
+ */
+class LineDiscipline {
+public:
+    static constexpr size_t BUFFER_SIZE = 4096;
+
+    explicit LineDiscipline(LineDisciplineDelegate* delegate = nullptr);
+    LineDiscipline(const LineDiscipline&) = delete;
+    LineDiscipline& operator=(const LineDiscipline&) = delete;
+
+    void set_delegate(LineDisciplineDelegate* delegate) { m_delegate = delegate; }
+
+    /**
+     * @brief Feeds terminal input through the discipline.
+     * @param can_block Wait for room instead of dropping input when the ring is full.
+     * @return Bytes consumed, or Interrupted if a signal arrived before any were.
+     */
+    fk::core::Result<size_t, fk::core::Error> receive(const uint8_t* data, size_t len,
+                                                      bool can_block);
+    void receive_char(char c) { receive(reinterpret_cast<const uint8_t*>(&c), 1, false); }
+
+    /** @brief Reads a line (canonical) or what is available (raw), sleeping until then. */
+    fk::core::Result<size_t, fk::core::Error> read(uint8_t* dst, size_t len);
+
+    /** @brief True once read() would not sleep. */
+    bool can_read() const;
+
+    /** @brief Whether output newlines are written as CR LF (OPOST | ONLCR). */
+    bool maps_nl_to_crnl() const;
+
+    /** @brief Discards pending input and wakes writers waiting for room. */
+    void flush_input();
+
+    Termios termios() const;
+    void set_termios(const Termios& termios);
+
+    int foreground_pgid() const { return m_foreground_pgid; }
+    void set_foreground_pgid(int pgid) { m_foreground_pgid = pgid; }
+
+    WindowSize window_size() const { return m_winsize; }
+    void set_window_size(const WindowSize& winsize) { m_winsize = winsize; }
+
+    /**
+     * @brief The termios, process group and window size ioctls every tty shares.
+     * @return NotImplemented for requests the device must handle itself.
+     */
+    fk::core::Result<int, fk::core::Error> ioctl(uint64_t request, uint64_t arg);
+
+private:
+    enum class InputResult { Accepted, Full };
+
+    InputResult receive_char_locked(uint8_t c, int& signal);
+    bool is_canonical() const { return m_termios.c_lflag & tty::ICANON; }
+    bool can_read_locked() const;
+    size_t used_locked() const { return m_head - m_read_tail; }
+    uint8_t& at(size_t pos) { return m_buffer[pos % BUFFER_SIZE]; }
+    bool is_line_end(size_t pos) const;
+    void set_line_end(size_t pos, bool value);
+    bool erase_one_locked();
+    void echo_char_locked(uint8_t c);
+    void echo_locked(const char* data, size_t len);
+    void flush_input_locked();
+
+    mutable fk::synchronization::Spinlock m_lock{"ldisc"};
+    LineDisciplineDelegate* m_delegate{nullptr};
+    Termios m_termios;
+    WindowSize m_winsize;
+    int m_foreground_pgid{0};
+
+    uint8_t m_buffer[BUFFER_SIZE];
+    uint64_t m_line_ends[BUFFER_SIZE / 64]{};
+    // Free-running positions, taken modulo BUFFER_SIZE:
+    size_t m_read_tail{0};  ///< Next byte read() returns
+    size_t m_canon_head{0}; ///< End of input readers may consume
+    size_t m_head{0};       ///< End of input, including the line being edited
+
+    WaitQueue m_readers{"ldisc-read"};
+    WaitQueue m_writers{"ldisc-write"};
+};
+
+} // namespace terminal
+} // namespace fkernel
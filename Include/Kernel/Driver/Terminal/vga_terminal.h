@@ -1,9 +1,9 @@
 #pragma once
 
+#include <Kernel/Driver/Terminal/line_discipline.h>
 #include <Kernel/Driver/Terminal/terminal.h>
 #include <Kernel/Driver/Terminal/terminal_renderer.h>
 #include <LibFK/Core/result.h>
-#include <LibFK/Container/circular_buffer.h>
 #include <LibFK/Terminal/ansi_parser.h>
 #include <LibFK/Synchronization/spinlock.h>
 
@@ -11,17 +11,15 @@ namespace fkernel {
 namespace terminal {
 
 struct TerminalState {
-    bool raw_mode{false};
-    bool echo_enabled{true};
     bool line_drawing_mode{false};
-    size_t line_chars{0};
     uint16_t rows{25};
     uint16_t cols{80};
-    int foreground_pgid{0};
 };
 
 /// @brief VGA Terminal implementation using VGA adapter and PS/2 keyboard
-class VGATerminal final : public Terminal, public fk::terminal::AnsiDelegate {
+class VGATerminal final : public Terminal,
+                          public fk::terminal::AnsiDelegate,
+                          public LineDisciplineDelegate {
 public:
   explicit VGATerminal(int index);
   virtual ~VGATerminal() override = default;
@@ -82,13 +80,15 @@ public:
   virtual void scroll_down(uint16_t count) override;
   virtual void set_line_drawing_mode(bool enabled) override;
 
+  // LineDisciplineDelegate interface
+  virtual void echo(const char* data, size_t len) override;
+
   int index() const { return m_index; }
   void clear();
 
 private:
   int m_index;
-  static constexpr size_t INPUT_QUEUE_SIZE = 1024;
-  fk::containers::CircularBuffer<char, INPUT_QUEUE_SIZE> m_input_queue;
+  LineDiscipline m_ldisc;
   fk::terminal::AnsiParser m_ansi_parser;
   fk::synchronization::Spinlock m_lock;
   
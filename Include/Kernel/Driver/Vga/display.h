@@ -51,6 +51,15 @@ public:
   /// Copy a rectangle of pixels from one location to another (for scrolling)
   virtual void copy_rect(uint32_t src_x, uint32_t src_y, uint32_t dst_x, uint32_t dst_y, uint32_t width, uint32_t height) = 0;
 
+  /// Blank count character cells of a row, from col on
+  virtual void clear_cells(uint32_t row, uint32_t col, uint32_t count);
+
+  /// Move count character cells within a row (insert/delete characters)
+  virtual void move_cells(uint32_t row, uint32_t src_col, uint32_t dst_col, uint32_t count);
+
+  /// Scroll character rows [top, bottom) up or down by count, blanking the rows uncovered
+  virtual void scroll_rows(uint32_t top, uint32_t bottom, uint32_t count, bool up);
+
   /// Set foreground and background colors (4-bit palette)
   virtual void set_color(Color fg, Color bg) = 0;
 
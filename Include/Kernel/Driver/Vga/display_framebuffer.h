@@ -10,6 +10,8 @@
 #include <Kernel/Driver/Vga/Types/framebuffer_info.h>
 #include <Kernel/Driver/Vga/Types/render_command.h>
 #include <Kernel/Driver/Vga/display.h>
+#include <Kernel/Driver/Vga/glyph_atlas.h>
+#include <Kernel/Driver/Vga/text_grid.h>
 #include <LibFK/Container/circular_buffer.h>
 
 class DisplayFramebuffer : public Display {
@@ -48,11 +50,28 @@ class DisplayFramebuffer : public Display {
   uint8_t* m_dirty_tiles = nullptr; // Bitset for dirty tiles
   bool m_full_redraw_requested = false;
 
+  // Text model: output updates cells, flush() renders the changed ones.
+  // Without it (allocation failed) characters are drawn as they arrive.
+  fkernel::TextGrid m_grid;
+  fkernel::GlyphAtlas m_atlas;
+  bool m_cursor_visible = true;
+  bool m_cursor_drawn = false;  // Cursor pixels are on screen at m_drawn_cursor_*
+  uint32_t m_drawn_cursor_x = 0;
+  uint32_t m_drawn_cursor_y = 0;
+
   DisplayFramebuffer();
   void initialize_framebuffer();
   void select_best_font();
   void render_char(uint32_t x, uint32_t y, char c, uint32_t fg_color,
                    uint32_t bg_color);
+  void initialize_text_grid();
+  fkernel::TextCell blank_cell() const;
+  uint32_t fg_pixel() const;
+  uint32_t bg_pixel() const;
+  void place_char(uint32_t col, uint32_t row, char c, uint32_t fg, uint32_t bg);
+  void render_cells(uint32_t row, uint32_t first_col, uint32_t end_col);
+  void render_grid();
+  void paint_cursor(uint32_t col, uint32_t row, uint32_t color);
   uint32_t color_to_pixel(Color c) const;
   void scroll();
   void draw_cursor();
@@ -100,6 +119,9 @@ public:
   void clear() override;
   void clear_rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
   void copy_rect(uint32_t src_x, uint32_t src_y, uint32_t dst_x, uint32_t dst_y, uint32_t width, uint32_t height) override;
+  void clear_cells(uint32_t row, uint32_t col, uint32_t count) override;
+  void move_cells(uint32_t row, uint32_t src_col, uint32_t dst_col, uint32_t count) override;
+  void scroll_rows(uint32_t top, uint32_t bottom, uint32_t count, bool up) override;
   void set_color(Color fg, Color bg) override;
   void set_colors_rgb(uint32_t fg, uint32_t bg) override;
   
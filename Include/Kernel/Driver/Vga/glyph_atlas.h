@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Kernel/Driver/Vga/font.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/**
+ * @brief The console font rasterized once, at its scale, into per-pixel masks.
+ *
+ * Each glyph is a row-major block of words, ~0 where the glyph is set and 0
+ * elsewhere, so a cell renders as (fg & mask) | (bg & ~mask) per pixel
+ * instead of testing font bits and repeating them for the scale.
+ */
+class GlyphAtlas {
+public:
+    GlyphAtlas() = default;
+    ~GlyphAtlas();
+
+    bool build(const Vga::Font& font);
+    void reset();
+
+    bool is_ready() const { return m_masks != nullptr; }
+    uint32_t glyph_width() const { return m_glyph_width; }
+    uint32_t glyph_height() const { return m_glyph_height; }
+
+    /** @brief Masks for @p codepoint; characters outside the font use '?'. */
+    const uint32_t* glyph(uint32_t codepoint) const;
+
+private:
+    uint32_t* m_masks{nullptr};
+    uint32_t m_glyph_width{0};
+    uint32_t m_glyph_height{0};
+    uint8_t m_first_char{0};
+    uint8_t m_last_char{0};
+};
+
+} // namespace fkernel
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/// One character cell; colors are already in framebuffer pixel format
+struct TextCell {
+    uint32_t codepoint{' '};
+    uint32_t fg{0};
+    uint32_t bg{0};
+
+    bool operator==(const TextCell& other) const {
+        return codepoint == other.codepoint && fg == other.fg && bg == other.bg;
+    }
+};
+
+/**
+ * @brief Text model of a framebuffer console: what each cell shows and which changed.
+ *
+ * Rows live in a ring, so scrolling the whole screen moves its top index and
+ * blanks the rows that come in rather than copying every cell. The lines
+ * scrolled since the last flush are counted, letting the renderer shift the
+ * pixels once for all of them. Each row tracks the column span changed since
+ * it was last rendered; the renderer redraws only those cells.
+ */
+class TextGrid {
+public:
+    TextGrid() = default;
+    ~TextGrid();
+
+    bool initialize(uint32_t cols, uint32_t rows, const TextCell& blank);
+    void reset();
+
+    bool is_ready() const { return m_cells != nullptr; }
+    uint32_t cols() const { return m_cols; }
+    uint32_t rows() const { return m_rows; }
+
+    const TextCell& cell(uint32_t row, uint32_t col) const { return row_cells(row)[col]; }
+    void put(uint32_t row, uint32_t col, const TextCell& cell);
+    void fill(uint32_t row, uint32_t col, uint32_t count, const TextCell& blank);
+    /** @brief Moves @p count cells of @p row from @p src_col to @p dst_col. */
+    void move(uint32_t row, uint32_t src_col, uint32_t dst_col, uint32_t count);
+    /** @brief Scrolls rows [top, bottom) by @p count, blanking the rows that come in. */
+    void scroll(uint32_t top, uint32_t bottom, uint32_t count, bool up, const TextCell& blank);
+    /** @brief Blanks everything and marks it clean, for a screen cleared behind our back. */
+    void clear(const TextCell& blank);
+
+    void mark_dirty(uint32_t row, uint32_t first_col, uint32_t end_col);
+    void mark_all_dirty();
+    /** @brief Takes the changed span of @p row, if any, leaving the row clean. */
+    bool take_dirty(uint32_t row, uint32_t& first_col, uint32_t& end_col);
+    /** @brief Lines scrolled up since the last call; rows() means redraw everything. */
+    uint32_t take_pending_scroll();
+
+    bool save();
+    void restore();
+
+private:
+    struct DirtySpan {
+        uint16_t first;
+        uint16_t end; ///< first >= end: clean
+    };
+
+    TextCell* row_cells(uint32_t row) const { return m_cells + ((m_top + row) % m_rows) * m_cols; }
+
+    TextCell* m_cells{nullptr};
+    TextCell* m_saved{nullptr};
+    DirtySpan* m_dirty{nullptr};
+    uint32_t m_cols{0};
+    uint32_t m_rows{0};
+    uint32_t m_top{0};            ///< Ring index of the top row
+    uint32_t m_pending_scroll{0}; ///< Lines scrolled up since the last flush
+};
+
+} // namespace fkernel
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Kernel/Fs/Vfs/node.h>
+
+namespace fkernel {
+
+/**
+ * @brief /debug/tracing_on: reads "0" or "1", write "1" to start tracing and
+ * "0" to stop it.
+ */
+class TraceControlNode final : public Node {
+public:
+  TraceControlNode();
+  virtual ~TraceControlNode() override = default;
+
+  virtual fk::core::Result<size_t, fk::core::Error>
+  read(uint64_t offset, size_t size, uint8_t *buffer) override;
+  virtual fk::core::Result<size_t, fk::core::Error>
+  write(uint64_t, size_t, const uint8_t *buffer) override;
+  virtual size_t size() const override { return 2; }
+
+  static fk::RefPtr<TraceControlNode> the();
+};
+
+} // namespace fkernel
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <Kernel/Fs/Vfs/node.h>
+
+namespace fkernel {
+
+/**
+ * @brief /debug/trace: drains the per-CPU trace rings as binary TraceEvents.
+ *
+ * Reads are consuming and return whole 64-byte records; writing anything
+ * discards the events that are still queued.
+ */
+class TraceNode final : public Node {
+public:
+  TraceNode();
+  virtual ~TraceNode() override = default;
+
+  virtual fk::core::Result<size_t, fk::core::Error>
+  read(uint64_t offset, size_t size, uint8_t *buffer) override;
+  virtual fk::core::Result<size_t, fk::core::Error>
+  write(uint64_t, size_t, const uint8_t *buffer) override;
+  virtual size_t size() const override;
+
+  static fk::RefPtr<TraceNode> the();
+};
+
+} // namespace fkernel
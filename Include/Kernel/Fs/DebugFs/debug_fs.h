@@ -5,8 +5,8 @@
 #include <LibFK/Text/string.h>
 
 #include <Kernel/Fs/DebugFs/Node/debug_log_node.h>
-#include <Kernel/Fs/DebugFs/Node/syscall_log_node.h>
-#include <Kernel/Ipc/ipc_log_node.h>
+#include <Kernel/Fs/DebugFs/Node/trace_control_node.h>
+#include <Kernel/Fs/DebugFs/Node/trace_node.h>
 
 namespace fkernel {
 
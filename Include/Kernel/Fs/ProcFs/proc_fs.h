@@ -17,3 +17,4 @@
 #include <Kernel/Fs/ProcFs/proc_sys_string_node.h>
 #include <Kernel/Fs/ProcFs/proc_loadavg_node.h>
 #include <Kernel/Fs/ProcFs/proc_cpuinfo_node.h>
+#include <Kernel/Fs/ProcFs/proc_syscall_stats_node.h>
@@ -0,0 +1,21 @@
+#pragma once
+#include <Kernel/Fs/Vfs/node.h>
+
+#ifdef FKERNEL_LOCK_STAT
+/**
+ * @brief /proc/lock_stat: per-class spinlock acquisitions, contention and
+ * TSC spin/hold times. Only built with FKERNEL_LOCK_STAT. Writing anything
+ * resets the counters.
+ */
+class ProcLockStatNode : public Node {
+public:
+  ProcLockStatNode() = default;
+  virtual fk::core::Result<size_t, fk::core::Error> read(uint64_t offset, size_t size, uint8_t* buffer) override;
+  virtual fk::core::Result<size_t, fk::core::Error> write(uint64_t, size_t size, const uint8_t*) override;
+  virtual size_t size() const override { return m_cached.size(); }
+  virtual bool is_directory() const override { return false; }
+private:
+  fk::containers::Vector<uint8_t> m_cached;
+  void ensure_cached();
+};
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+#include <Kernel/Fs/Vfs/node.h>
+
+/**
+ * @brief /proc/syscall_stats: per-syscall counts, errors and TSC latency
+ * histograms summed over all CPUs. Writing anything resets the counters.
+ */
+class ProcSyscallStatsNode : public Node {
+public:
+  ProcSyscallStatsNode() = default;
+  virtual fk::core::Result<size_t, fk::core::Error> read(uint64_t offset, size_t size, uint8_t* buffer) override;
+  virtual fk::core::Result<size_t, fk::core::Error> write(uint64_t, size_t size, const uint8_t*) override;
+  virtual size_t size() const override { return m_cached.size(); }
+  virtual bool is_directory() const override { return false; }
+private:
+  fk::containers::Vector<uint8_t> m_cached;
+  void ensure_cached();
+};
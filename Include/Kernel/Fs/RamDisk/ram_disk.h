@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Kernel/Fs/Vfs/node.h>
+#include <LibFK/Container/hash_map.h>
 #include <LibFK/Container/vector.h>
 #include <LibFK/Text/string.h>
 #include <LibFK/Utilities/Archive/tar.h>
@@ -16,6 +17,8 @@ public:
         return fk::core::Error::PermissionDenied; // Read-only
     }
     virtual size_t size() const override { return m_size; }
+    virtual bool is_immutable() const override { return true; }
+    virtual uintptr_t backing_frame(uint64_t offset) const override;
 
 private:
     const uint8_t* m_data;
@@ -43,6 +46,13 @@ private:
     fk::text::String m_target;
 };
 
+/**
+ * @brief A directory of the initrd.
+ *
+ * The TAR image is parsed once at boot into a tree of these: every
+ * directory indexes its children by name, and file nodes read straight
+ * from the image. Lookup costs one hash probe per path component.
+ */
 class RamDiskNode final : public Node {
 public:
     static fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error> create(uintptr_t start, uintptr_t end);
@@ -60,19 +70,23 @@ public:
     virtual fk::core::Result<fk::RefPtr<Node>, fk::core::Error> lookup(const char* name) override;
     virtual fk::core::Result<void, fk::core::Error> list_dir(fk::containers::Vector<DirectoryEntry>& entries) override;
     virtual bool is_directory() const override { return true; }
-    virtual fk::text::String get_path() const override { 
-        if (m_prefix.is_empty()) return "/";
-        fk::text::String p = "/";
-        const char* pref = m_prefix.c_str();
-        size_t len = strlen(pref);
-        if (len > 0 && pref[len-1] == '/') len--;
-        for(size_t i=0; i<len; ++i) p.push_back(pref[i]);
-        return p;
-    }
 
 private:
     void parse_tar();
 
+    /** @brief The child directory called name, created if missing. */
+    fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error> ensure_directory(const char* name);
+
+    /**
+     * @brief Creates the directories of a slash-separated path relative to this one.
+     * @param create_last Also create the final component; otherwise it is left to the caller.
+     * @return The directory that holds the final component.
+     */
+    fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error> ensure_path(const char* path, bool create_last);
+
+    fk::RefPtr<Node> find_child(const char* name) const;
+    fk::core::Result<void, fk::core::Error> add_child(const char* name, fk::RefPtr<Node> node);
+
     struct Entry {
         fk::text::String name;
         fk::RefPtr<Node> node;
@@ -80,9 +94,8 @@ private:
 
     uintptr_t m_start;
     uintptr_t m_end;
-    fk::text::String m_prefix{""};
-    fk::containers::Vector<Entry> m_files;
-    fk::containers::Vector<fk::text::String> m_directories;
+    fk::containers::Vector<Entry> m_children; ///< In archive order, for list_dir
+    fk::containers::HashMap<fk::text::String, size_t> m_child_index; ///< Name to m_children slot
 };
 
 } // namespace fkernel
\ No newline at end of file
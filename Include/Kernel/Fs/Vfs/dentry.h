@@ -41,7 +41,7 @@ public:
     Dentry(fk::text::String name, fk::RefPtr<Dentry> parent);
 
 private:
-    mutable fk::synchronization::Spinlock m_lock;
+    mutable fk::synchronization::Spinlock m_lock{"dentry"};
     fk::text::String m_name;
     fk::RefPtr<Dentry> m_parent;
     DentryNodeStack m_node_stack;
@@ -14,7 +14,6 @@ class FileDescription : public fk::memory::RefCounted<FileDescription> {
   mutable fk::synchronization::Spinlock m_offset_lock;
   uint64_t m_current_offset{0};
   int m_flags{0};
-  bool m_cloexec{false};
 
 public:
   virtual ~FileDescription() override;
@@ -33,8 +32,6 @@ public:
 
   int  open_flags()        const { return m_flags; }
   void set_open_flags(int f)    { m_flags = f; }
-  bool is_cloexec()        const { return m_cloexec; }
-  void set_cloexec(bool v)      { m_cloexec = v; }
 
   fk::RefPtr<fkernel::Dentry> dentry() const;
   fk::RefPtr<Node> node() const;
@@ -96,6 +96,14 @@ public:
   virtual bool is_signalfd() const { return false; }
   virtual short poll() const { return POLLIN | POLLOUT; }
 
+  /// Contents never change while the node exists, so pages read from it may
+  /// be cached and shared between processes
+  virtual bool is_immutable() const { return false; }
+
+  /// Physical frame that already holds the page of this node at offset, so
+  /// it can be mapped in place; 0 if the page has to be read into a new one
+  virtual uintptr_t backing_frame(uint64_t) const { return 0; }
+
   virtual fk::core::Result<fk::text::String, fk::core::Error> read_link() {
     return fk::core::Error::NotASymlink;
   }
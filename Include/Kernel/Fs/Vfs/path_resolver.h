@@ -4,17 +4,17 @@
 #include <Kernel/Fs/Vfs/definitions.h>
 #include <LibFK/Core/result.h>
 #include <LibFK/Memory/retain_ptr.h>
-#include <LibFK/Synchronization/spinlock.h>
 #include <LibFK/Text/string.h>
 #include <LibFK/Utilities/pair.h>
 
 namespace fkernel {
 
+class RwSemaphore;
 class VirtualFileSystem;
 
 class PathResolver {
 public:
-  explicit PathResolver(VirtualFileSystem& vfs, fk::synchronization::Spinlock& lock);
+  explicit PathResolver(VirtualFileSystem& vfs, RwSemaphore& lock);
 
   fk::core::Result<fk::RefPtr<Dentry>, fk::core::Error>
   resolve(const char* path, fk::RefPtr<Dentry> base = nullptr, int depth = 0);
@@ -30,7 +30,7 @@ public:
 
 private:
   VirtualFileSystem& m_vfs;
-  fk::synchronization::Spinlock& m_lock;
+  RwSemaphore& m_lock;
 };
 
 } // namespace fkernel
@@ -3,6 +3,7 @@
 #include <Kernel/Fs/Vfs/file_description.h>
 #include <Kernel/Fs/Vfs/node.h>
 #include <Kernel/Fs/Vfs/path_resolver.h>
+#include <Kernel/Scheduler/rw_semaphore.h>
 #include <LibFK/Core/result.h>
 #include <LibFK/Memory/retain_ptr.h>
 
@@ -12,15 +13,13 @@
 
 #include <Kernel/Posix/sys/stat.h>
 
-#include <LibFK/Synchronization/spinlock.h>
-
 namespace fkernel {
 
 class Dentry;
 
 class VirtualFileSystem {
 private:
-  fk::synchronization::Spinlock m_lock;
+  RwSemaphore m_lock{"vfs"}; ///< Shared for path walks and lookups, exclusive for changes; held across disk I/O
   PathResolver m_resolver;
   fk::RefPtr<Dentry> m_root;
   VirtualFileSystem();
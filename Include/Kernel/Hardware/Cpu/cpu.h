@@ -24,6 +24,7 @@ private:
   bool m_has_nx = false;
   bool m_has_smep = false;
   bool m_has_smap = false;
+  bool m_has_invariant_tsc = false;
 
   void cpuid(uint32_t eax, uint32_t ecx, uint32_t *a, uint32_t *b, uint32_t *c,
              uint32_t *d);
@@ -44,6 +45,7 @@ public:
   bool has_hpet() const { return m_has_hpet; }
   bool has_nx() const { return m_has_nx; }
   bool has_smap() const { return m_has_smap; }
+  bool has_invariant_tsc() const { return m_has_invariant_tsc; }
 
   void initialize_features();
 
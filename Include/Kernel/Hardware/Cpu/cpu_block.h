@@ -2,6 +2,9 @@
 
 #include <LibFK/Types/types.h>
 
+// Upper bound for statically sized per-CPU arrays (indexed by cpu_id).
+constexpr size_t MAX_CPUS = 8;
+
 // This structure is used to store per-CPU data, accessed via GS segment.
 // It MUST match the offsets used in syscall_stub.asm.
 struct CpuControlBlock {
@@ -11,7 +11,7 @@ struct Processor {
     Task* current_task { nullptr };
     Task* idle_task { nullptr };
     bool need_resched { false };
-    fk::synchronization::Spinlock run_queue_lock;
+    fk::synchronization::Spinlock run_queue_lock{"runqueue"};
     fk::containers::IntrusiveList<Task, &Task::run_node> run_queue;
 
     Processor() : id(0) {}
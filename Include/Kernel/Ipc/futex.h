@@ -0,0 +1,117 @@
+#pragma once
+
+#include <Kernel/Scheduler/Task/task.h>
+#include <LibFK/Container/intrusive_list.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace ipc {
+
+/// Wait/wake bitset that matches every waiter (plain FUTEX_WAIT/FUTEX_WAKE)
+constexpr uint32_t FUTEX_BITSET_MATCH_ANY = 0xFFFFFFFF;
+
+/**
+ * @brief Identity of a futex word.
+ *
+ * Private futexes and ordinary process memory are keyed by address space and
+ * virtual address. Only frames mapped into several address spaces
+ * (PageFlags::Shared) are keyed by physical address, so waiters in different
+ * processes meet on the same word.
+ */
+struct FutexKey {
+    uintptr_t space{0};   ///< CR3 of the address space, 0 for a physical key
+    uintptr_t address{0}; ///< Virtual address, or physical for a shared key
+
+    bool operator==(const FutexKey& other) const {
+        return space == other.space && address == other.address;
+    }
+};
+
+struct FutexBucket;
+
+/**
+ * @brief A task sleeping on a futex word. Lives on the waiter's stack.
+ *
+ * key and bucket change when the waiter is requeued; both are only touched
+ * with the bucket lock held.
+ */
+struct FutexWaiter {
+    FutexKey key;
+    uint32_t bitset{FUTEX_BITSET_MATCH_ANY};
+    Task* task{nullptr};
+    FutexBucket* bucket{nullptr};
+    bool woken{false};
+    fk::containers::IntrusiveListNode<FutexWaiter> node;
+};
+
+struct FutexBucket {
+    fk::synchronization::Spinlock lock{"futex"};
+    fk::containers::IntrusiveList<FutexWaiter, &FutexWaiter::node> waiters;
+};
+
+/**
+ * @brief Hashed futex wait queues.
+ *
+ * Each bucket has its own lock and an unbounded list of waiters, so unrelated
+ * futexes do not contend and a contended word never runs out of slots.
+ */
+class FutexTable {
+public:
+    static constexpr size_t BUCKET_COUNT = 256;
+
+    static FutexTable& the() {
+        static FutexTable inst;
+        return inst;
+    }
+
+    /**
+     * @brief Builds the key for @p uaddr in the current address space.
+     *
+     * Private keys are derived without touching the page tables. Returns
+     * InvalidParameter for a misaligned word and BadAddress if it is unmapped.
+     */
+    fk::core::Result<FutexKey, fk::core::Error> key_for(uintptr_t uaddr, bool is_private);
+
+    /**
+     * @brief Sleeps while the word at @p uaddr still holds @p expected.
+     * @param deadline_ns CLOCK_MONOTONIC deadline, 0 to wait without a timeout.
+     * @return WouldBlock if the value changed, Timeout, or Interrupted by a signal.
+     */
+    fk::core::Result<void, fk::core::Error> wait(const FutexKey& key, uintptr_t uaddr,
+                                                 uint32_t expected, uint32_t bitset,
+                                                 uint64_t deadline_ns);
+
+    /** @brief Wakes up to @p count waiters whose bitset intersects @p bitset. */
+    uint32_t wake(const FutexKey& key, uint32_t count, uint32_t bitset = FUTEX_BITSET_MATCH_ANY);
+
+    /**
+     * @brief Wakes up to @p wake_count waiters on @p from and moves up to
+     * @p requeue_count of the rest onto @p to without waking them.
+     *
+     * With @p compare set, fails with WouldBlock unless the word at @p uaddr
+     * still holds @p expected.
+     * @return Number of waiters woken plus requeued.
+     */
+    fk::core::Result<uint32_t, fk::core::Error> requeue(const FutexKey& from, const FutexKey& to,
+                                                        uint32_t wake_count, uint32_t requeue_count,
+                                                        bool compare, uintptr_t uaddr,
+                                                        uint32_t expected);
+
+private:
+    FutexTable() = default;
+
+    FutexBucket& bucket_for(const FutexKey& key);
+    uint32_t wake_locked(FutexBucket& bucket, const FutexKey& key, uint32_t count,
+                         uint32_t bitset);
+    fk::core::Result<uint32_t, fk::core::Error>
+    requeue_locked(FutexBucket& source, FutexBucket& target, const FutexKey& from,
+                   const FutexKey& to, uint32_t wake_count, uint32_t requeue_count, bool compare,
+                   uintptr_t uaddr, uint32_t expected);
+
+    FutexBucket m_buckets[BUCKET_COUNT];
+};
+
+} // namespace ipc
+} // namespace fkernel
@@ -5,6 +5,8 @@
 
 namespace fkernel::elf_domains {
 
+class MemoryDomain;
+
 class LoadDomain : public ElfDomain {
 public:
     explicit LoadDomain(fk::RefPtr<Node> node);
@@ -19,9 +21,11 @@ public:
     
     MemoryRegion calculate_memory_region(const Elf64_Phdr& phdr, uintptr_t load_base);
     
+    /** @brief Copies the segment's file bytes that fall in [start_vaddr, end_vaddr). */
     fk::core::Result<void, fk::core::Error>
     copy_segment_data(const MemoryRegion& region);
     
+    /** @brief Zeroes the segment's bss that falls in [start_vaddr, end_vaddr). */
     void zero_fill_bss(const MemoryRegion& region);
     
     fk::core::Result<bool, fk::core::Error>
@@ -29,7 +33,22 @@ public:
     
 private:
     fk::core::Result<void, fk::core::Error>
-    process_single_load_segment(const Elf64_Phdr& phdr, uintptr_t load_base);
+    process_single_load_segment(const Elf64_Phdr& phdr, uintptr_t load_base,
+                                const fk::containers::Vector<Elf64_Phdr>& headers);
+
+    /** @brief Whether the segment can be faulted in from FilePageCache. */
+    bool can_demand_page(const MemoryRegion& region) const;
+
+    bool needs_eager_page(MemoryDomain& memory, const Elf64_Phdr& phdr, uintptr_t load_base,
+                          const fk::containers::Vector<Elf64_Phdr>& headers, uintptr_t page);
+
+    /** @brief Allocates, fills and protects the segment's pages in [start, end). */
+    fk::core::Result<void, fk::core::Error>
+    load_pages(MemoryDomain& memory, const MemoryRegion& region, uintptr_t start, uintptr_t end);
+
+    /** @brief Adds the loaded segment to the current task's VMA tree. */
+    fk::core::Result<void, fk::core::Error> record_mapping(const MemoryRegion& region,
+                                                           bool file_backed);
 };
 
 } // namespace fkernel::elf_domains
\ No newline at end of file
@@ -28,6 +28,7 @@ struct ElfLoadResult {
     bool      stack_executable{false};
     TlsInfo   tls;
     uintptr_t highest_load_end{0};
+    uintptr_t vdso_base{0};
 };
 
 using ElfLoadOperationResult = fk::core::Result<ElfLoadResult, fk::core::Error>;
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Kernel/Fs/Vfs/node.h>
+#include <Kernel/Loader/elf_types.h>
+#include <LibFK/Container/hash_map.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Memory/ref_counted.h>
+#include <LibFK/Memory/ref_ptr.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Text/string.h>
+
+namespace fkernel {
+
+/// Parsed images kept before the oldest one is dropped
+constexpr size_t ELF_IMAGE_CACHE_CAPACITY = 32;
+
+/**
+ * @brief The parts of an ELF file that execve() needs and that do not depend
+ * on the load base. Addresses are the file's own, unrelocated values.
+ */
+struct ElfImage : public fk::memory::RefCounted<ElfImage> {
+    Elf64_Ehdr header;
+    fk::containers::Vector<Elf64_Phdr> program_headers;
+    fk::text::String interpreter_path; ///< Empty for static executables
+    size_t file_size{0};
+    uintptr_t phdr_vaddr{0};           ///< PT_PHDR address, 0 if absent
+    uintptr_t load_end{0};             ///< Page-aligned end of the highest PT_LOAD
+    bool stack_executable{false};
+    bool has_dynamic{false};
+    uintptr_t relro_start{0};          ///< Page-aligned PT_GNU_RELRO range, empty if none
+    uintptr_t relro_end{0};
+    TlsInfo tls;
+
+    bool has_interpreter() const { return !interpreter_path.is_empty(); }
+};
+
+/**
+ * @brief Parse-once cache of ElfImage keyed by inode.
+ *
+ * Repeated execve() of the same binary (shell loops, the interpreter of
+ * every dynamic executable) reuses the header, program headers and
+ * PT_INTERP path instead of reading and validating them again. Writes and
+ * truncation through the VFS drop the node's entry; a size mismatch on
+ * lookup does too, for changes that bypass it. At most
+ * ELF_IMAGE_CACHE_CAPACITY images are kept, evicted oldest first.
+ */
+class ElfImageCache {
+private:
+    fk::containers::HashMap<uint64_t, fk::RefPtr<ElfImage>> m_images;
+    fk::containers::Vector<uint64_t> m_order; ///< Cached inodes, oldest first
+    mutable fk::synchronization::Spinlock m_lock;
+    uint64_t m_generation{0}; ///< Bumped by invalidate(); guarded by m_lock
+
+    ElfImageCache() = default;
+
+    static fk::core::Result<fk::RefPtr<ElfImage>, fk::core::Error>
+    parse(const fk::RefPtr<Node>& node);
+
+    void remove_locked(uint64_t inode);
+
+public:
+    static ElfImageCache& the() {
+        static ElfImageCache inst;
+        return inst;
+    }
+
+    /** @brief The parsed image of node; parses and caches it on a miss. */
+    fk::core::Result<fk::RefPtr<ElfImage>, fk::core::Error> get(const fk::RefPtr<Node>& node);
+
+    /**
+     * @brief Drops node's image once its contents have changed. An image parsed
+     * across the call is returned to its execve but not cached.
+     */
+    void invalidate(const Node& node);
+};
+
+} // namespace fkernel
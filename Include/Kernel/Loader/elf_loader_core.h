@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Kernel/Loader/elf_image_cache.h>
 #include <Kernel/Loader/elf_types.h>
 #include <Kernel/Loader/Domains/Base/elf_domain.h>
 #include <Kernel/Loader/Domains/Types/load_context.h>
@@ -14,6 +15,7 @@ namespace fkernel {
 class ElfLoaderCore {
 private:
     fk::RefPtr<Node> m_node;
+    fk::RefPtr<ElfImage> m_image;
     elf_domains::LoadContext m_context;
     
     elf_domains::ParserDomain m_parser;
@@ -34,7 +36,7 @@ private:
     fk::core::Result<void, fk::core::Error> handle_interpreter();
     fk::core::Result<void, fk::core::Error> load_segments();
     fk::core::Result<void, fk::core::Error> process_dynamic();
-    void apply_relro(const fk::containers::Vector<Elf64_Phdr>& headers);
+    void apply_relro();
     ElfLoadOperationResult calculate_entry_point();
     
     fk::containers::Vector<elf_domains::MemoryRegion> 
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <LibFK/Core/result.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/// User address of the read-only TimeKeeper data page (vvar)
+constexpr uintptr_t VDSO_DATA_VADDR = 0x7FFFFF000000ULL;
+/// User address of the vDSO ELF image, directly after the data page
+constexpr uintptr_t VDSO_TEXT_VADDR = VDSO_DATA_VADDR + 0x1000;
+
+/**
+ * @brief Maps the vDSO into user address spaces.
+ *
+ * The image (Src/Kernel/Arch/x86_64/Vdso/vdso.asm) is copied into a physical
+ * frame once; every process then maps it and the TimeKeeper data page
+ * with the Shared flag, so fork() and exit never copy or free them.
+ */
+class VdsoMapper {
+private:
+  uintptr_t m_text_phys = 0;
+
+  VdsoMapper() = default;
+
+  fk::core::Result<void, fk::core::Error> prepare_image();
+
+public:
+  static VdsoMapper& the() {
+    static VdsoMapper inst;
+    return inst;
+  }
+
+  /**
+   * @brief Maps the data page and the vDSO text into the current address space.
+   * @return User address of the vDSO ELF header (AT_SYSINFO_EHDR).
+   */
+  fk::core::Result<uintptr_t, fk::core::Error> map_into_current();
+};
+
+} // namespace fkernel
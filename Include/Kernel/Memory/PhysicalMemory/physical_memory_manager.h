@@ -16,7 +16,7 @@
  */
 class PhysicalMemoryManager {
 private:
-  fk::synchronization::Spinlock m_lock;
+  fk::synchronization::Spinlock m_lock{"pmm"};
   PhysicalZone m_zones[MAX_PHYSICAL_ZONES]; ///< Array of available memory zones.
   size_t m_zone_count{0};
 
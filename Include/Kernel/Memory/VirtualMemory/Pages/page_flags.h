@@ -33,9 +33,23 @@ enum PageFlags : uint64_t {
   /// Huge page (2 MiB or 1 GiB)
   HugePage = 1ULL << 7,
 
+  /// Write-combining memory type, for framebuffers and other MMIO written in
+  /// bursts (never read back). This is the PAT bit of a 4 KiB entry: with
+  /// WriteThrough and CacheDisabled clear it selects PAT entry 4, which
+  /// arch_program_pat() sets to WC. map_large_page() moves it to bit 12.
+  WriteCombining = 1ULL << 7,
+
   /// Global page (does not get invalidated in TLB on CR3 reload)
   Global = 1ULL << 8,
 
+  /// Software bit: frame is shared between address spaces (vDSO, shared
+  /// text) and is never freed or deep-copied with the mapping process
+  Shared = 1ULL << 9,
+
+  /// Software bit: 4 KiB piece of a split 2 MiB user page. The frame came
+  /// from the buddy allocator and goes back through free_contiguous()
+  HugeFragment = 1ULL << 10,
+
   /// No-execute (NX) bit, if supported
   ExecuteDisable = 1ULL << 63
 };
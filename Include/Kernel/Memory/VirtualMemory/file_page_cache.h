@@ -0,0 +1,61 @@
+#pragma once
+
+#include <Kernel/Fs/Vfs/node.h>
+#include <LibFK/Container/hash_map.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Memory/ref_ptr.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/**
+ * @brief Page-sized frames of immutable files, keyed by inode.
+ *
+ * File-backed mappings fault their pages in from here, so the text and
+ * read-only data of a binary are read once and every process executing the
+ * same inode maps the same frames with PageFlags::Shared. Only nodes whose
+ * is_immutable() holds are cached; a frame stays until the kernel shuts down.
+ * Pages the node already keeps in a frame of their own (see
+ * Node::backing_frame()) are handed out as is and never copied.
+ * The cache keeps a reference to each node it holds pages of.
+ */
+class FilePageCache {
+private:
+  struct CachedFile {
+    fk::RefPtr<Node> node;
+    fk::containers::Vector<uintptr_t> frames; ///< Indexed by page; 0 if not read yet
+  };
+
+  fk::containers::HashMap<uint64_t, CachedFile*> m_files;
+  mutable fk::synchronization::Spinlock m_lock;
+  size_t m_pages{0};
+
+  FilePageCache() = default;
+
+  CachedFile* file_for(const fk::RefPtr<Node>& node);
+
+public:
+  static FilePageCache& the() {
+    static FilePageCache inst;
+    return inst;
+  }
+
+  static bool can_cache(const Node& node) { return node.is_immutable(); }
+
+  /**
+   * @brief Physical frame holding the page of node at offset: the node's own
+   * backing frame if it has one, otherwise a copy read in on first use.
+   *
+   * offset must be page aligned. Bytes past the end of the file read as zero.
+   * @return InvalidParameter if the node is not cacheable or offset is past EOF.
+   */
+  fk::core::Result<uintptr_t, fk::core::Error> get_page(const fk::RefPtr<Node>& node,
+                                                        uint64_t offset);
+
+  /** @brief Number of frames the cache allocated; backing frames are not counted. */
+  size_t cached_pages() const;
+};
+
+} // namespace fkernel
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <Kernel/Memory/VirtualMemory/tlb_shootdown.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/**
+ * @brief Batches TLB invalidations and frame frees for one address space.
+ *
+ * Callers clear entries under the page-table lock and record them here;
+ * finish(), run after the lock is dropped, issues one local invalidation
+ * run and one shootdown, and only then hands the frames back, so no CPU
+ * can reach a freed frame through a stale translation.
+ *
+ * Example:
+ *   MmuGather gather(root_phys);
+ *   { ScopedLockIRQ lock(...); ...; gather.add_page(virt); gather.defer_free(frame, 0); }
+ *   gather.finish();
+ */
+class MmuGather {
+public:
+  /// Frames held back per batch; a full batch makes the caller stop and finish
+  static constexpr size_t MAX_DEFERRED_FRAMES = 64;
+
+  explicit MmuGather(uintptr_t root) : m_root(root) {}
+  ~MmuGather() { finish(); }
+
+  MmuGather(const MmuGather&) = delete;
+  MmuGather& operator=(const MmuGather&) = delete;
+
+  /** @brief Records that virt lost its translation or some of its rights. */
+  void add_page(uintptr_t virt);
+
+  /** @brief Forces a full flush, e.g. after freeing a page table. */
+  void flush_all() { m_flush_all = true; }
+
+  /**
+   * @brief Frees phys after the flush.
+   * @param order Buddy order, or PAGE_FRAME for a single bitmap page.
+   */
+  void defer_free(uintptr_t phys, uint8_t order = PAGE_FRAME);
+
+  /** @brief No room for another deferred frame. */
+  bool is_full() const { return m_frame_count == MAX_DEFERRED_FRAMES; }
+  size_t deferred_frames() const { return m_frame_count; }
+
+  /** @brief Flushes and frees; the gather can be reused afterwards. */
+  void finish();
+
+  static constexpr uint8_t PAGE_FRAME = 0xFF;
+
+private:
+  struct DeferredFrame {
+    uintptr_t phys;
+    uint8_t order;
+  };
+
+  uintptr_t m_root;
+  uintptr_t m_pages[TLB_FLUSH_ALL_THRESHOLD];
+  size_t m_page_count = 0;
+  bool m_flush_all = false;
+  DeferredFrame m_frames[MAX_DEFERRED_FRAMES];
+  size_t m_frame_count = 0;
+};
+
+} // namespace fkernel
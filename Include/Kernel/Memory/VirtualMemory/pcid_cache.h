@@ -0,0 +1,57 @@
+#pragma once
+
+#include <Kernel/Hardware/Cpu/cpu_block.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/// PCIDs handed out per CPU; PCID 0 stays with the boot page tables
+constexpr size_t PCID_SLOTS_PER_CPU = 6;
+
+/// CR3 bit 63: keep the TLB entries already tagged with the loaded PCID
+constexpr uint64_t CR3_NOFLUSH = 1ULL << 63;
+
+/**
+ * @brief Per-CPU mapping from address-space roots to recently used PCIDs.
+ *
+ * Each CPU keeps its last few address spaces in PCID_SLOTS_PER_CPU slots
+ * (PCIDs 1..N). Switching back to a cached root reloads CR3 with the no-flush
+ * bit so its TLB entries survive; a miss evicts the least recently used slot
+ * and loads its PCID without the bit, which drops that PCID's stale entries.
+ */
+class PcidCache {
+private:
+  struct Slot {
+    uintptr_t root;
+    uint64_t last_used;
+  };
+
+  struct CpuSlots {
+    Slot slots[PCID_SLOTS_PER_CPU];
+    uint64_t clock;
+  };
+
+  CpuSlots m_cpus[MAX_CPUS]{};
+
+  PcidCache() = default;
+
+public:
+  static PcidCache& the() {
+    static PcidCache inst;
+    return inst;
+  }
+
+  /** @brief CR3 value (root | PCID [| NOFLUSH]) that activates root on cpu. */
+  uint64_t cr3_for(uint32_t cpu, uintptr_t root);
+
+  /** @brief Forgets root on every CPU; called before its PML4 is freed and can be reused. */
+  void forget(uintptr_t root);
+
+  /** @brief Forgets root on cpu, so its next load starts from an empty PCID. */
+  void drop(uint32_t cpu, uintptr_t root);
+
+  /** @brief Forgets root on every CPU outside keep_mask (bit n = CPU n). */
+  void drop_inactive(uintptr_t root, uint32_t keep_mask);
+};
+
+} // namespace fkernel
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <Kernel/Hardware/Cpu/cpu_block.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+struct InterruptFrame;
+
+namespace fkernel {
+
+/// IDT vector of the shootdown IPI: above device IRQs, below the spurious vector
+constexpr uint8_t TLB_SHOOTDOWN_VECTOR = 0xF0;
+
+/// Past this many pages one CR3 reload is cheaper than a run of INVLPGs
+constexpr size_t TLB_FLUSH_ALL_THRESHOLD = 32;
+
+/**
+ * @brief Invalidates user translations on every CPU that may cache them.
+ *
+ * Each CPU records the root it has loaded, which gives the set of CPUs an
+ * address space is active on. flush() invalidates locally, sends one IPI to
+ * the other CPUs in that set and waits for all of them to acknowledge. CPUs
+ * that only hold the root in an idle PCID slot lose the slot instead, so
+ * their next switch starts from an empty PCID.
+ */
+class TlbShootdown {
+private:
+  struct Request {
+    uintptr_t root;
+    const uintptr_t* pages; ///< nullptr: flush the whole address space
+    size_t count;
+    volatile uint32_t pending; ///< CPUs that have not acknowledged yet
+  };
+
+  uintptr_t m_active_roots[MAX_CPUS]{};
+  uint32_t m_apic_ids[MAX_CPUS]{};
+  uint32_t m_online_mask = 0;
+  fk::synchronization::Spinlock m_lock; ///< One request in flight
+  Request m_request{};
+
+  TlbShootdown() = default;
+
+  static void flush_local(const uintptr_t* pages, size_t count);
+  static void ipi_handler(uint8_t vector, InterruptFrame* frame);
+  void service_pending(uint32_t cpu);
+
+public:
+  static TlbShootdown& the() {
+    static TlbShootdown inst;
+    return inst;
+  }
+
+  /** @brief Installs the IPI handler and registers the boot CPU. */
+  void initialize();
+
+  /** @brief Makes cpu, reachable at apic_id, a shootdown target. */
+  void register_cpu(uint32_t cpu, uint32_t apic_id);
+
+  /** @brief Records that cpu is about to load root; called before the CR3 write. */
+  void note_active(uint32_t cpu, uintptr_t root);
+
+  /** @brief CPUs with root loaded (bit n = CPU n). */
+  uint32_t cpus_using(uintptr_t root) const;
+
+  /**
+   * @brief Drops root's translations for pages on every CPU.
+   *
+   * pages == nullptr or count > TLB_FLUSH_ALL_THRESHOLD flushes the whole
+   * address space. Must be called without page-table locks held: targets
+   * spinning on one with interrupts off could not acknowledge.
+   */
+  void flush(uintptr_t root, const uintptr_t* pages, size_t count);
+};
+
+} // namespace fkernel
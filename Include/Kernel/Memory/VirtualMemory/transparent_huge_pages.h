@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Kernel/Memory/VirtualMemory/Pages/page_flags.h>
+#include <LibFK/Core/error.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Types/types.h>
+
+struct Task;
+
+namespace fkernel {
+
+/// madvise() advice values handled by TransparentHugePages::advise
+constexpr uint64_t MADV_HUGEPAGE = 14;
+constexpr uint64_t MADV_NOHUGEPAGE = 15;
+
+struct ThpCounters {
+  uint64_t anon_pages;     ///< 2 MiB user pages currently mapped
+  uint64_t fault_alloc;    ///< 2 MiB pages installed by mmap or a fault
+  uint64_t fault_fallback; ///< Eligible blocks that fell back to 4 KiB pages
+  uint64_t split;          ///< 2 MiB user pages broken into 4 KiB PTEs
+};
+
+/**
+ * @brief Backs 2 MiB-aligned stretches of anonymous user memory with PS-bit pages.
+ *
+ * Anonymous mmap and heap/mmap demand paging ask here first. A block is
+ * eligible when it lies wholly inside the caller's region, nothing is mapped
+ * in it yet and the task has not marked it MADV_NOHUGEPAGE. The frame comes
+ * from the buddy allocator; when none is free the caller maps 4 KiB pages.
+ * Counters are exported through /proc/meminfo.
+ */
+class TransparentHugePages {
+private:
+  ThpCounters m_counters{};
+
+  TransparentHugePages() = default;
+
+public:
+  static TransparentHugePages& the() {
+    static TransparentHugePages inst;
+    return inst;
+  }
+
+  /**
+   * @brief Maps the 2 MiB block at vaddr with one zeroed large page.
+   * @return false if the block is ineligible or no 2 MiB frame is free.
+   */
+  bool try_map(Task* task, uintptr_t vaddr, uintptr_t region_start, uintptr_t region_end,
+               PageFlags flags);
+
+  /** @brief Whether the task allows a huge page for the block at vaddr. */
+  bool is_allowed(const Task* task, uintptr_t vaddr) const;
+
+  /**
+   * @brief Applies MADV_HUGEPAGE (enable) or MADV_NOHUGEPAGE to the mappings
+   * in [start, end); the advice lives on the VMAs, so munmap, mprotect and
+   * fork carry it along.
+   */
+  fk::core::Result<void, fk::core::Error> advise(Task* task, uintptr_t start, uintptr_t end,
+                                                 bool enable);
+
+  /** @brief Bookkeeping from the VMM when a user 2 MiB page goes away or is copied. */
+  void note_released();
+  void note_split();
+  void note_copied();
+
+  ThpCounters counters() const;
+};
+
+} // namespace fkernel
@@ -7,20 +7,39 @@
 #include <LibFK/Core/result.h>
 #include <LibFK/Synchronization/spinlock.h>
 
+namespace fkernel {
+class MmuGather;
+}
+
 extern "C" void write_on_cr3(void *pml4_virt_addr);
 extern "C" uintptr_t read_on_cr3();
 extern "C" int invalid_tlb(uintptr_t addr);
 
+/// Root-lock stripes; address spaces whose PML4s hash alike share one
+constexpr size_t PAGE_TABLE_LOCK_STRIPES = 64;
+
 /**
  * @class VirtualMemoryManager
  * @brief Manages virtual address spaces and page table mappings for x86_64.
+ *
+ * Operations act on the address space loaded in the calling CPU's CR3. Each
+ * address space is guarded by a lock chosen from its PML4 address, so faults
+ * and forks in different processes proceed in parallel. Kernel-only entries
+ * live in tables shared by every address space and are additionally guarded
+ * by m_kernel_lock, always taken after the root lock.
  */
 class VirtualMemoryManager {
 private:
-  fk::synchronization::Spinlock m_lock;
-  PageTable *m_pml4 = nullptr; ///< Pointer to the active PML4 table.
-  uintptr_t m_pml4_phys = 0;   ///< Physical address of the PML4.
+  struct RootLock {
+    fk::synchronization::Spinlock lock{"vmm.root"};
+  };
+  RootLock m_root_locks[PAGE_TABLE_LOCK_STRIPES];
+  fk::synchronization::Spinlock m_kernel_lock{"vmm.kernel"};
+  PageTable *m_pml4 = nullptr; ///< Boot PML4; the active root once paging is set up is CR3.
   uintptr_t m_kernel_pml4_phys = 0; ///< Physical address of the kernel's PML4 (never freed).
+  bool m_has_1g_pages = false; ///< CPUID 0x80000001 EDX.PDPE1GB.
+  bool m_pcid_enabled = false; ///< CR4.PCIDE set; CR3 loads go through PcidCache.
+  bool m_has_pat = false;      ///< CPUID 1 EDX.PAT; the PAT MSR holds the WC layout.
 
 protected:
   /** @brief Allocates and zeroes a new page table. */
@@ -32,9 +51,21 @@ protected:
   /** @brief Invalidates a single TLB entry. */
   void invlpg(uintptr_t addr);
 
-  /** @brief Flushes the entire TLB by reloading CR3. */
+  /** @brief Swaps WriteCombining for CacheDisabled when the CPU has no PAT. */
+  PageFlags with_cache_type(PageFlags flags) const;
+
+  /** @brief Flushes the entire TLB, global entries and every PCID included. */
   void flush_tlb();
 
+  /** @brief Invalidates virt after its entry (previously old_entry) changed. */
+  void invalidate_page(uintptr_t virt, uint64_t old_entry);
+
+  /** @brief PML4 of the address space loaded on this CPU. */
+  PageTable *active_root() const;
+
+  /** @brief Lock guarding the address space rooted at root_phys. */
+  fk::synchronization::Spinlock &root_lock(uintptr_t root_phys);
+
   /** @brief (Internal) Calculates the virtual address of a page table. */
   uintptr_t get_table_virtual_address(uint16_t pml4_idx, uint16_t pdpt_idx = 0,
                                       uint16_t pd_idx = 0,
@@ -63,15 +94,40 @@ public:
    */
   void map_page(uintptr_t virt, uintptr_t phys, PageFlags flags);
 
-  /** @brief Maps a range of pages. */
+  /**
+   * @brief Maps a single 2 MiB or 1 GiB page with a PS-bit entry.
+   *
+   * Fails without side effects if the addresses are misaligned, 1 GiB pages
+   * are unsupported, or the slot already holds a lower-level table.
+   */
+  bool map_large_page(uintptr_t virt, uintptr_t phys, size_t page_size, PageFlags flags);
+
+  /** @brief Whether map_large_page() could install a leaf at virt (no table there yet). */
+  bool can_map_large_page(uintptr_t virt, size_t page_size);
+
+  /** @brief Identity-maps a range of pages. */
   void map_range(uintptr_t start, uintptr_t size, PageFlags flags);
 
+  /** @brief Maps a range using the largest page size alignment allows at each step. */
+  void map_range(uintptr_t virt, uintptr_t phys, size_t size, PageFlags flags);
+
+  /** @brief Whether the CPU supports 1 GiB pages. */
+  bool has_1g_pages() const { return m_has_1g_pages; }
+  bool has_pat() const { return m_has_pat; }
+
   /** @brief Removes a mapping for a virtual address. */
   void unmap_page(uintptr_t virt);
 
   /** @brief Changes the protection flags of a mapped page (RELRO, mprotect). */
   void protect_page(uintptr_t virt, PageFlags flags);
 
+  /**
+   * @brief Sets flags on every present user page in [start, end).
+   *
+   * Pages that lose rights are shot down on all CPUs in one batch.
+   */
+  void protect_range(uintptr_t start, uintptr_t end, PageFlags flags);
+
   /** @brief Translates a virtual address to its corresponding physical address.
    */
   uintptr_t translate(uintptr_t virt);
@@ -94,12 +150,36 @@ public:
   /** @brief Unmaps a region of virtual memory. */
   fk::core::Result<int, fk::core::Error> munmap(uintptr_t addr, size_t length);
 
-  /** @brief Gets the PTE for a virtual address. */
+  /**
+   * @brief Gets the 4 KiB PTE for a virtual address.
+   *
+   * A 2 MiB or 1 GiB mapping covering virt is split first, so the returned
+   * entry can be modified on its own.
+   */
   uint64_t* get_pte(uintptr_t virt, bool create = false);
 
 private:
-  void unmap_page_range(uintptr_t start, uintptr_t end);
+  /**
+   * @brief Clears [start, end), queueing invalidations and frees on gather.
+   * @return Where it stopped: end, or earlier when gather ran out of room.
+   */
+  uintptr_t unmap_page_range(PageTable* root, uintptr_t start, uintptr_t end,
+                             fkernel::MmuGather& gather);
+
+  /**
+   * @brief Ensures a page table level exists, creating it if necessary.
+   *
+   * entry_size is the span of one parent entry; a large leaf there is split.
+   */
+  PageTable* ensure_table(PageTable* parent, size_t index, size_t entry_size, PageFlags flags,
+                          bool& changed);
+
+  /** @brief Replaces a large leaf with a table of 512 next-smaller entries. */
+  PageTable* split_large_entry(PageTable* parent, size_t index, size_t page_size);
+
+  /** @brief Finds the leaf entry (PTE, 2 MiB PDE or 1 GiB PDPTE) mapping virt. */
+  uint64_t* find_leaf(PageTable* root, uintptr_t virt, size_t& page_size);
 
-  /** @brief Ensures a page table level exists, creating it if necessary. */
-  PageTable* ensure_table(PageTable* parent, size_t index, PageFlags flags, bool& changed);
+  /** @brief get_pte() on an explicit root; the caller holds its lock. */
+  uint64_t* get_pte_in(PageTable* root, uintptr_t virt, bool create);
 };
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <Kernel/Fs/Vfs/node.h>
+#include <Kernel/Memory/VirtualMemory/Pages/page_flags.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Memory/ref_counted.h>
+#include <LibFK/Memory/ref_ptr.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Text/fixed_string.h>
+#include <LibFK/Tree/intrusive_rb_tree.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/// Window searched by mmap() when the caller gives no usable hint; it ends
+/// below the TLS block and the stack.
+constexpr uintptr_t USER_MMAP_BASE = 0x40000000;
+constexpr uintptr_t USER_MMAP_END = 0x7FFFFE000000;
+/// Size of the [stack] mapping; only the top pages are populated at exec
+constexpr size_t USER_STACK_RESERVE = 0x100000;
+
+enum class VmaKind : uint8_t {
+  Anonymous, ///< mmap(MAP_ANONYMOUS) and copied-in file data
+  Image,     ///< PT_LOAD segment of the executable or interpreter
+  Heap,      ///< [heap_start, heap_break), grown by brk()
+  Stack,     ///< Main thread stack
+  Special,   ///< TLS block, vDSO and other kernel-provided pages
+};
+
+/**
+ * @brief One contiguous user mapping with uniform protection.
+ *
+ * A file-backed mapping takes [start, file_end) from file at file_offset
+ * and zero-fills the rest; its pages are faulted in from FilePageCache.
+ *
+ * The subtree_* fields are maintained by the tree: the lowest start and
+ * highest end under this node and the largest hole between two consecutive
+ * mappings below it.
+ */
+struct Vma {
+  uintptr_t start{0};
+  uintptr_t end{0};
+  PageFlags flags{PageFlags::Present};
+  VmaKind kind{VmaKind::Anonymous};
+  bool no_huge_pages{false}; ///< MADV_NOHUGEPAGE
+  fk::text::fixed_string<64> name;
+
+  fk::RefPtr<Node> file;
+  uint64_t file_offset{0}; ///< Page-aligned file offset of start
+  uintptr_t file_end{0};
+
+  uintptr_t subtree_start{0};
+  uintptr_t subtree_end{0};
+  uintptr_t subtree_gap{0};
+  fk::containers::IntrusiveRBNode<Vma> rb_node;
+
+  size_t size() const { return end - start; }
+  bool contains(uintptr_t addr) const { return addr >= start && addr < end; }
+  bool is_writable() const { return flags & PageFlags::Writable; }
+  bool is_file_backed() const { return static_cast<bool>(file); }
+};
+
+/**
+ * @brief The set of user mappings of one address space.
+ *
+ * Mappings are kept in a red-black tree ordered by start address and
+ * augmented with the largest free gap per subtree, so fault lookup and
+ * first-fit placement are O(log n). Threads created with CLONE_VM share one
+ * tree; fork() gets a copy and execve() a fresh one.
+ */
+class VmaTree : public fk::memory::RefCounted<VmaTree> {
+public:
+  struct Less {
+    bool operator()(const Vma& a, const Vma& b) const { return a.start < b.start; }
+  };
+  struct GapAugment {
+    static void update(Vma& vma);
+  };
+  using Tree = fk::containers::IntrusiveRBTree<Vma, &Vma::rb_node, Less, GapAugment>;
+
+  VmaTree() = default;
+  ~VmaTree() override;
+  VmaTree(const VmaTree&) = delete;
+  VmaTree& operator=(const VmaTree&) = delete;
+
+  static fk::core::Result<fk::RefPtr<VmaTree>, fk::core::Error> create();
+
+  /** @brief Deep copy for fork(). */
+  fk::core::Result<fk::RefPtr<VmaTree>, fk::core::Error> clone() const;
+
+  /**
+   * @brief Adds [start, end); merges with compatible anonymous neighbours.
+   * @return AlreadyExists if the range overlaps an existing mapping.
+   */
+  fk::core::Result<void, fk::core::Error> insert(uintptr_t start, uintptr_t end, PageFlags flags,
+                                                 VmaKind kind, const char* name = "");
+
+  /**
+   * @brief Adds an Image mapping of file whose page at start is file_offset.
+   * @return AlreadyExists if the range overlaps an existing mapping.
+   */
+  fk::core::Result<void, fk::core::Error> insert_file(uintptr_t start, uintptr_t end,
+                                                      PageFlags flags, const char* name,
+                                                      fk::RefPtr<Node> file, uint64_t file_offset,
+                                                      uintptr_t file_end);
+
+  /** @brief Copies the mapping containing addr into out. */
+  bool lookup(uintptr_t addr, Vma& out) const;
+
+  bool is_range_free(uintptr_t start, uintptr_t end) const;
+
+  /**
+   * @brief First-fit search for length bytes aligned to alignment in [low, high).
+   * @return OutOfMemory if no hole is large enough.
+   */
+  fk::core::Result<uintptr_t, fk::core::Error> find_free_range(size_t length, size_t alignment,
+                                                               uintptr_t low,
+                                                               uintptr_t high) const;
+
+  /** @brief Drops [start, end), trimming or splitting mappings that straddle it. */
+  fk::core::Result<void, fk::core::Error> remove_range(uintptr_t start, uintptr_t end);
+
+  /** @brief Sets flags on [start, end), splitting at the edges and re-merging. */
+  fk::core::Result<void, fk::core::Error> protect_range(uintptr_t start, uintptr_t end,
+                                                        PageFlags flags);
+
+  /** @brief Sets or clears MADV_NOHUGEPAGE on the mappings in [start, end), splitting at the edges. */
+  fk::core::Result<void, fk::core::Error> set_no_huge_pages(uintptr_t start, uintptr_t end,
+                                                            bool no_huge);
+
+  /** @brief False if any mapping overlapping [start, end) is marked MADV_NOHUGEPAGE. */
+  bool allows_huge_pages(uintptr_t start, uintptr_t end) const;
+
+  /**
+   * @brief Moves the end of the mapping that starts at start.
+   * @return NotFound if there is none, OutOfMemory if growing would overlap.
+   */
+  fk::core::Result<void, fk::core::Error> resize(uintptr_t start, uintptr_t new_end);
+
+  /** @brief Visits every mapping in address order with the tree locked. */
+  template <typename Callback> void for_each(Callback callback) const {
+    fk::synchronization::ScopedLockIRQ lock(m_lock);
+    for (Vma* vma = m_tree.first(); vma; vma = Tree::next(*vma))
+      callback(static_cast<const Vma&>(*vma));
+  }
+
+  size_t count() const { return m_tree.size(); }
+
+private:
+  mutable fk::synchronization::Spinlock m_lock{"vma"};
+  Tree m_tree;
+
+  Vma* find_locked(uintptr_t addr) const;
+  Vma* first_ending_after(uintptr_t addr) const;
+  fk::core::Result<void, fk::core::Error> link_locked(Vma* vma);
+  Vma* split_locked(Vma* vma, uintptr_t at);
+  template <typename Apply>
+  fk::core::Result<void, fk::core::Error> update_range_locked(uintptr_t start, uintptr_t end,
+                                                              Apply apply);
+  void merge_with_next_locked(Vma* vma);
+  void destroy_all_locked();
+  uintptr_t search_gap(const Vma* node, uintptr_t before, uintptr_t after, size_t length,
+                       size_t alignment, uintptr_t low, uintptr_t high) const;
+};
+
+} // namespace fkernel
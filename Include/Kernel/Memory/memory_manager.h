@@ -35,7 +35,7 @@ private:
 
   BlockHeader *m_heap_head = nullptr;
   bool m_heap_initialized = false;
-  fk::synchronization::Spinlock m_heap_lock;
+  fk::synchronization::Spinlock m_heap_lock{"heap"};
 
 public:
   /** @return The singleton instance. */
@@ -69,6 +69,11 @@ public:
    */
   void map_page(uintptr_t virt, uintptr_t phys, PageFlags flags);
 
+  /**
+   * @brief Maps a physically contiguous range, using 2 MiB / 1 GiB pages where aligned.
+   */
+  void map_range(uintptr_t virt, uintptr_t phys, size_t size, PageFlags flags);
+
   /**
    * @brief Translates a virtual address to its corresponding physical address.
    */
@@ -3,6 +3,8 @@
 #include <Kernel/Driver/Network/network_device.h>
 #include <Kernel/Net/Eth/ethernet_frame.h>
 #include <Kernel/Net/Ip/ip_address.h>
+#include <Kernel/Net/Tcp/tcp_tuple.h>
+#include <LibFK/Container/hash_map.h>
 #include <LibFK/Types/types.h>
 #include <LibFK/Core/result.h>
 #include <LibFK/Synchronization/spinlock.h>
@@ -14,20 +16,23 @@ class UdpSocket;
 class TcpSocket;
 
 static constexpr size_t MAX_UDP_BINDINGS = 64;
-static constexpr size_t MAX_TCP_BINDINGS = 64;
 
 struct UdpBinding { uint16_t port{0}; UdpSocket* socket{nullptr}; };
-struct TcpBinding { uint16_t port{0}; TcpSocket* socket{nullptr}; };
 
 class NetworkStack {
   NetworkDevice* m_device;
   IPv4Address    m_ip;
 
   UdpBinding m_udp_sockets[MAX_UDP_BINDINGS]{};
-  fk::synchronization::Spinlock m_udp_lock;
+  fk::synchronization::Spinlock m_udp_lock{"net.udp_table"};
 
-  TcpBinding m_tcp_sockets[MAX_TCP_BINDINGS]{};
-  fk::synchronization::Spinlock m_tcp_lock;
+  // Synchronized connections keyed by 4-tuple; bound/listening sockets keyed
+  // by (local ip, port). Both hold raw pointers: sockets unregister themselves
+  // before they are destroyed.
+  fk::containers::HashMap<TcpFourTuple, TcpSocket*> m_tcp_connections;
+  fk::containers::HashMap<TcpListenKey, TcpSocket*> m_tcp_listeners;
+  uint16_t m_tcp_next_ephemeral{49152};
+  fk::synchronization::Spinlock m_tcp_lock{"net.tcp_table"};
 
 public:
   static NetworkStack& the();
@@ -53,12 +58,24 @@ public:
   bool register_udp_socket(uint16_t port, UdpSocket* socket);
   void unregister_udp_socket(uint16_t port);
 
-  bool register_tcp_socket(uint16_t port, TcpSocket* socket);
-  void unregister_tcp_socket(uint16_t port);
+  bool register_tcp_listener(TcpListenKey key, TcpSocket* socket);
+  void unregister_tcp_listener(TcpListenKey key);
+  bool register_tcp_connection(TcpFourTuple tuple, TcpSocket* socket);
+  void unregister_tcp_connection(TcpFourTuple tuple);
+  /** @brief Returns a free ephemeral port (RFC 6335 range), or 0 if exhausted. */
+  uint16_t allocate_tcp_port();
+  /**
+   * @brief Picks an ephemeral local port for tuple, one free of listeners and of
+   * connections to the same peer, and registers the connection under it.
+   * @return The port, or 0 if none is free.
+   */
+  uint16_t register_tcp_connection_ephemeral(TcpFourTuple tuple, TcpSocket* socket);
 
 private:
   NetworkStack();
 
+  uint16_t next_tcp_port_locked(TcpFourTuple* tuple);
+
   void handle_arp(const uint8_t* data, size_t len);
   void handle_ipv4(const uint8_t* data, size_t len);
   void handle_icmp(const uint8_t* ip_payload, size_t len, uint32_t src_ip);
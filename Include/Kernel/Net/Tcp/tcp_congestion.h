@@ -0,0 +1,48 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+static constexpr uint32_t TCP_DEFAULT_MSS      = 1460;
+static constexpr uint32_t TCP_DUP_ACK_THRESHOLD = 3;
+
+/**
+ * @brief NewReno congestion control (RFC 5681 with the RFC 6582 recovery).
+ *
+ * Byte-counted cwnd. on_ack() and on_dup_ack() tell the caller when the
+ * oldest outstanding segment has to be retransmitted.
+ */
+class TcpCongestionControl {
+  uint32_t m_mss;
+  uint32_t m_cwnd;
+  uint32_t m_ssthresh{0xFFFFFFFFu};
+  uint32_t m_dup_acks{0};
+  uint32_t m_recover{0};
+  bool     m_in_recovery{false};
+  bool     m_after_timeout{false};   // m_recover guards against a spurious fast retransmit
+
+public:
+  enum class Action : uint8_t { None, Retransmit };
+
+  explicit TcpCongestionControl(uint32_t mss = TCP_DEFAULT_MSS);
+
+  /** @brief An ACK advanced snd.una by bytes_acked; flight_size is measured before it. */
+  Action on_ack(uint32_t ack, uint32_t bytes_acked, uint32_t flight_size);
+  /** @brief A duplicate ACK as defined in RFC 5681 section 2. */
+  Action on_dup_ack(uint32_t flight_size, uint32_t send_unacked, uint32_t send_next);
+  /** @brief The retransmission timer expired. */
+  void on_timeout(uint32_t flight_size, uint32_t send_next);
+
+  uint32_t cwnd() const { return m_cwnd; }
+  uint32_t ssthresh() const { return m_ssthresh; }
+  uint32_t mss() const { return m_mss; }
+  bool in_recovery() const { return m_in_recovery; }
+
+private:
+  uint32_t halved_flight(uint32_t flight_size) const;
+};
+
+} // namespace net
+} // namespace fkernel
@@ -2,8 +2,14 @@
 
 #include <Kernel/Ipc/notification.h>
 #include <Kernel/Net/Ip/ip_address.h>
+#include <Kernel/Net/Tcp/tcp_congestion.h>
 #include <Kernel/Net/Tcp/tcp_header.h>
-#include <LibFK/Container/vector.h>
+#include <Kernel/Net/Tcp/tcp_options.h>
+#include <Kernel/Net/Tcp/tcp_reassembly_queue.h>
+#include <Kernel/Net/Tcp/tcp_retransmit_queue.h>
+#include <Kernel/Net/Tcp/tcp_rtt_estimator.h>
+#include <Kernel/Net/Tcp/tcp_tuple.h>
+#include <Kernel/Net/socket_ring_buffer.h>
 #include <LibFK/Types/types.h>
 
 namespace fkernel {
@@ -20,7 +26,16 @@ struct TcpEndpoint {
     uint16_t    port;
 };
 
-static constexpr size_t TCP_RECV_BUFFER_SIZE = 65536;
+// SO_RCVBUF / SO_SNDBUF defaults and bounds
+static constexpr size_t TCP_DEFAULT_RCVBUF = 256 * 1024;
+static constexpr size_t TCP_DEFAULT_SNDBUF = 256 * 1024;
+static constexpr size_t TCP_MIN_BUFFER     = 4096;
+static constexpr size_t TCP_MAX_BUFFER     = 4 * 1024 * 1024;
+// RFC 879 default when the peer sends no MSS option
+static constexpr uint16_t TCP_DEFAULT_PEER_MSS = 536;
+static constexpr uint32_t TCP_MAX_RETRANSMITS = 12;
+// 2*MSL with a 30 s MSL (RFC 9293 3.4.2)
+static constexpr uint32_t TCP_TIME_WAIT_MS = 60000;
 
 class TcpConnection {
   TcpEndpoint m_local;
@@ -30,25 +45,74 @@ public:
   TcpState             state{TcpState::Closed};
   uint32_t             send_next{0};
   uint32_t             recv_next{0};
-  uint16_t             send_window{65535};   // advertised to peer
-  uint16_t             peer_window{65535};   // peer's advertised window
+  uint32_t             peer_window{65535};   // peer's advertised window, scaled to bytes
   uint32_t             send_unacked{0};      // oldest unacknowledged seq
-  fk::containers::Vector<uint8_t> recv_buf;
+  uint32_t             last_advertised{0};   // receive window carried by our last segment
+  SocketRingBuffer     recv_buf{TCP_DEFAULT_RCVBUF};
+  size_t               send_buffer_size{TCP_DEFAULT_SNDBUF};
+
+  // Negotiated in the SYN exchange (RFC 7323)
+  uint16_t             peer_mss{TCP_DEFAULT_PEER_MSS};
+  uint8_t              snd_wscale{0};        // applied to windows the peer advertises
+  uint8_t              rcv_wscale{0};        // applied to windows we advertise
+  bool                 wscale_ok{false};
+  bool                 ts_ok{false};
+  uint32_t             ts_recent{0};
   fkernel::ipc::Notification state_changed;
+  fkernel::ipc::Notification send_space;     // ACK opened the window or the connection died
+
+  TcpRetransmitQueue   retransmit_queue;
+  TcpReassemblyQueue   reassembly_queue;
+  TcpRttEstimator      rtt;
+  TcpCongestionControl congestion;
+  uint64_t             rto_deadline{0};      // ticks; 0 = retransmission timer stopped
+  uint64_t             persist_deadline{0};  // ticks; zero-window probe while nothing is in flight
+  uint32_t             retransmits{0};       // consecutive timeouts of the oldest segment
+  uint64_t             time_wait_deadline{0}; // ticks; TimeWait ends and the connection closes
+
+  uint32_t flight_size() const { return send_next - send_unacked; }
+
+  /** @brief True once everything we sent, including our FIN, is acknowledged. */
+  bool fin_acked() const { return send_unacked == send_next; }
+
+  /** @brief Free receive space in bytes, limited to what the window field can express. */
+  uint32_t recv_window() const {
+    size_t avail = recv_buf.free_space();
+    size_t max = (size_t)65535 << rcv_wscale;
+    return static_cast<uint32_t>(avail > max ? max : avail);
+  }
 
-  uint16_t recv_window() const {
-    size_t used = recv_buf.size();
-    if (used >= TCP_RECV_BUFFER_SIZE) return 0;
-    size_t avail = TCP_RECV_BUFFER_SIZE - used;
-    return static_cast<uint16_t>(avail > 65535 ? 65535 : avail);
+  /** @brief Window field for an outgoing segment; SYNs are never scaled (RFC 7323 2.2). */
+  uint16_t window_field(bool syn) const {
+    uint32_t wnd = syn ? recv_window() : recv_window() >> rcv_wscale;
+    return static_cast<uint16_t>(wnd > 65535 ? 65535 : wnd);
+  }
+
+  /** @brief Payload bytes per segment after timestamp option overhead. */
+  uint32_t send_mss() const {
+    uint32_t mss = peer_mss < TCP_DEFAULT_MSS ? peer_mss : TCP_DEFAULT_MSS;
+    return ts_ok ? mss - TCP_TIMESTAMP_OPTION_SIZE : mss;
+  }
+
+  /** @brief Smallest shift that lets the window field cover the whole receive buffer. */
+  static uint8_t wscale_for(size_t buffer_size) {
+    uint8_t shift = 0;
+    while (shift < TCP_MAX_WSCALE && ((size_t)65535 << shift) < buffer_size) ++shift;
+    return shift;
   }
 
   TcpConnection(TcpEndpoint local, TcpEndpoint remote);
   const TcpEndpoint& local()  const { return m_local; }
   const TcpEndpoint& remote() const { return m_remote; }
+  void set_local(TcpEndpoint ep) { m_local = ep; }
   void set_local_port(uint16_t port) { m_local.port = port; }
   void set_remote(TcpEndpoint ep) { m_remote = ep; }
 
+  TcpFourTuple tuple() const {
+    return {m_local.ip.value, m_remote.ip.value, m_local.port, m_remote.port};
+  }
+  TcpListenKey listen_key() const { return {m_local.ip.value, m_local.port}; }
+
   bool matches(uint32_t src_ip, uint16_t src_port,
                uint32_t dst_ip, uint16_t dst_port) const;
 };
@@ -25,6 +25,7 @@ struct __attribute__((packed)) TcpHeader {
     uint16_t urgent_ptr;
 
     uint8_t header_length() const { return (data_offset >> 4) * 4; }
+    void set_header_length(size_t len) { data_offset = (uint8_t)((len / 4) << 4); }
 
     void fill(uint16_t src, uint16_t dst, uint32_t seq, uint32_t ack,
               uint8_t fl, uint16_t win) {
@@ -42,5 +43,11 @@ struct __attribute__((packed)) TcpHeader {
 
 static constexpr size_t TCP_HEADER_SIZE = 20;
 
+// Sequence-space comparisons modulo 2^32 (RFC 793 section 3.3)
+inline bool seq_lt(uint32_t a, uint32_t b)  { return (int32_t)(a - b) < 0; }
+inline bool seq_leq(uint32_t a, uint32_t b) { return (int32_t)(a - b) <= 0; }
+inline bool seq_gt(uint32_t a, uint32_t b)  { return (int32_t)(a - b) > 0; }
+inline bool seq_geq(uint32_t a, uint32_t b) { return (int32_t)(a - b) >= 0; }
+
 } // namespace net
 } // namespace fkernel
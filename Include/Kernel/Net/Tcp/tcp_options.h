@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Kernel/Net/Tcp/tcp_header.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+static constexpr uint8_t TCP_OPT_END       = 0;
+static constexpr uint8_t TCP_OPT_NOP       = 1;
+static constexpr uint8_t TCP_OPT_MSS       = 2;
+static constexpr uint8_t TCP_OPT_WSCALE    = 3;   // RFC 7323 section 2
+static constexpr uint8_t TCP_OPT_TIMESTAMP = 8;   // RFC 7323 section 3
+
+static constexpr uint8_t TCP_MAX_WSCALE       = 14;
+static constexpr size_t  TCP_MAX_OPTIONS_SIZE = 40;
+static constexpr size_t  TCP_TIMESTAMP_OPTION_SIZE = 12;   // NOP, NOP, kind, len, TSval, TSecr
+
+/** @brief The TCP options this stack understands, parsed or to be emitted. */
+struct TcpOptions {
+    bool     has_mss{false};
+    uint16_t mss{0};
+    bool     has_wscale{false};
+    uint8_t  wscale{0};
+    bool     has_timestamp{false};
+    uint32_t ts_val{0};
+    uint32_t ts_ecr{0};
+
+    /** @brief Parses the options area of a segment; malformed options end parsing. */
+    static TcpOptions parse(const TcpHeader* hdr);
+
+    /** @brief Serializes into out (at least TCP_MAX_OPTIONS_SIZE bytes); returns the padded length. */
+    size_t write(uint8_t* out) const;
+};
+
+} // namespace net
+} // namespace fkernel
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Kernel/Net/Tcp/tcp_header.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Memory/heap_malloc.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+/**
+ * @brief Out-of-order receive segments held until the gap before them fills.
+ *
+ * Fragments are kept sorted and non-overlapping; newly inserted data is
+ * trimmed against what is already queued.
+ */
+class TcpReassemblyQueue {
+  struct Fragment {
+    uint32_t seq{0};
+    uint32_t len{0};
+    uint8_t* data{nullptr};
+    uint32_t end() const { return seq + len; }
+  };
+
+  fk::containers::Vector<Fragment> m_fragments;
+  size_t m_bytes{0};
+
+public:
+  TcpReassemblyQueue() = default;
+  ~TcpReassemblyQueue();
+  TcpReassemblyQueue(const TcpReassemblyQueue&) = delete;
+  TcpReassemblyQueue& operator=(const TcpReassemblyQueue&) = delete;
+
+  /** @brief Queues [seq, seq + len); false if nothing new was stored. */
+  bool insert(uint32_t seq, const uint8_t* data, uint32_t len);
+
+  /**
+   * @brief Feeds data contiguous with recv_next to sink and returns the new recv_next.
+   *
+   * sink(const uint8_t*, size_t) returns how many bytes it accepted; a
+   * short count leaves the rest queued.
+   */
+  template <typename Sink>
+  uint32_t drain(uint32_t recv_next, Sink&& sink) {
+    while (!m_fragments.is_empty() && seq_leq(m_fragments[0].seq, recv_next)) {
+      Fragment& frag = m_fragments[0];
+      if (seq_gt(frag.end(), recv_next)) {
+        uint32_t skip = recv_next - frag.seq;
+        size_t want = frag.len - skip;
+        size_t taken = sink(frag.data + skip, want);
+        recv_next += (uint32_t)taken;
+        if (taken < want) {
+          release_prefix(frag, recv_next - frag.seq);
+          break;
+        }
+      }
+      m_bytes -= frag.len;
+      kfree(frag.data);
+      m_fragments.remove_at(0);
+    }
+    return recv_next;
+  }
+
+  size_t bytes() const { return m_bytes; }
+  bool is_empty() const { return m_fragments.is_empty(); }
+  void clear();
+
+private:
+  void release_prefix(Fragment& frag, uint32_t count);
+};
+
+} // namespace net
+} // namespace fkernel
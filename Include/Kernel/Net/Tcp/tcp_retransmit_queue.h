@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Kernel/Net/Tcp/tcp_header.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+/**
+ * @brief A transmitted segment that still occupies sequence space.
+ *
+ * SYN and FIN each count for one sequence number, so a bare SYN or FIN is
+ * queued with len == 0 and still has to be acknowledged.
+ */
+struct TcpSegment {
+    uint32_t seq{0};
+    uint32_t len{0};
+    uint8_t  flags{0};
+    bool     retransmitted{false};
+    uint64_t sent_ticks{0};
+    uint8_t* data{nullptr};   // kmalloc'd, owned by the queue
+
+    uint32_t seq_len() const {
+        return len + ((flags & TCP_FLAG_SYN) ? 1 : 0) + ((flags & TCP_FLAG_FIN) ? 1 : 0);
+    }
+    uint32_t end() const { return seq + seq_len(); }
+};
+
+/** @brief Unacknowledged segments in sequence order. */
+class TcpRetransmitQueue {
+  fk::containers::Vector<TcpSegment> m_segments;
+
+public:
+  struct AckResult {
+    uint32_t segments{0};
+    bool     has_rtt_sample{false};
+    uint64_t sample_sent_ticks{0};
+  };
+
+  TcpRetransmitQueue() = default;
+  ~TcpRetransmitQueue();
+  TcpRetransmitQueue(const TcpRetransmitQueue&) = delete;
+  TcpRetransmitQueue& operator=(const TcpRetransmitQueue&) = delete;
+
+  /** @brief Copies the payload and appends the segment; false on allocation failure. */
+  bool push(uint32_t seq, uint8_t flags, const uint8_t* data, uint32_t len, uint64_t now);
+
+  /**
+   * @brief Releases everything below ack and trims a partially covered head.
+   *
+   * Per Karn's algorithm the RTT sample comes from the newest fully
+   * acknowledged segment and only if it was never retransmitted.
+   */
+  AckResult acknowledge(uint32_t ack);
+
+  TcpSegment* front() { return m_segments.is_empty() ? nullptr : &m_segments[0]; }
+  bool is_empty() const { return m_segments.is_empty(); }
+  size_t size() const { return m_segments.size(); }
+  void clear();
+};
+
+} // namespace net
+} // namespace fkernel
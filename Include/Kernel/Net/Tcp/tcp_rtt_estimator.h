@@ -0,0 +1,39 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+static constexpr uint32_t TCP_INITIAL_RTO_MS = 1000;
+static constexpr uint32_t TCP_MIN_RTO_MS     = 200;
+static constexpr uint32_t TCP_MAX_RTO_MS     = 60000;
+
+/**
+ * @brief Retransmission timeout computation (RFC 6298).
+ *
+ * Callers apply Karn's algorithm: only segments that were never
+ * retransmitted may produce a sample. The exponential backoff applied by
+ * back_off() sticks until the next valid sample.
+ */
+class TcpRttEstimator {
+  uint32_t m_srtt_ms{0};
+  uint32_t m_rttvar_ms{0};
+  uint32_t m_rto_ms{TCP_INITIAL_RTO_MS};
+  uint8_t  m_backoff{0};
+  bool     m_has_sample{false};
+
+public:
+  /** @brief Feeds one round-trip measurement; granularity is the clock tick in ms. */
+  void sample(uint32_t rtt_ms, uint32_t granularity_ms);
+  /** @brief Doubles the RTO after a retransmission timeout (RFC 6298 5.5). */
+  void back_off();
+
+  uint32_t rto_ms() const;
+  uint32_t srtt_ms() const { return m_srtt_ms; }
+  uint32_t rttvar_ms() const { return m_rttvar_ms; }
+  bool has_sample() const { return m_has_sample; }
+};
+
+} // namespace net
+} // namespace fkernel
@@ -2,6 +2,7 @@
 
 #include <Kernel/Net/Ip/ip_address.h>
 #include <Kernel/Net/Tcp/tcp_connection.h>
+#include <Kernel/Net/Tcp/tcp_options.h>
 #include <Kernel/Net/socket.h>
 #include <LibFK/Container/vector.h>
 #include <LibFK/Synchronization/spinlock.h>
@@ -11,11 +12,13 @@ namespace net {
 
 class TcpSocket : public Socket {
   TcpConnection m_connection;
-  fk::synchronization::Spinlock m_lock;
+  fk::synchronization::Spinlock m_lock{"socket.tcp"};
   fk::containers::Vector<fk::RefPtr<TcpSocket>> m_accept_queue;
+  TcpSocket* m_listener{nullptr};   // set while a passive child is in SynReceived; guarded by m_lock
 
 public:
   TcpSocket(TcpEndpoint local, TcpEndpoint remote);
+  ~TcpSocket() override;
 
   SocketDomain domain() const override { return SocketDomain::Inet; }
   SocketType   type()   const override { return SocketType::Stream; }
@@ -50,7 +53,15 @@ public:
     return r;
   }
 
-  void on_segment(const TcpHeader* hdr, const uint8_t* data, size_t data_len);
+  void on_segment(const TcpHeader* hdr, IPv4Address src_ip, IPv4Address dst_ip,
+                  const uint8_t* data, size_t data_len);
+  /** @brief Retransmission, persist and TIME-WAIT timers; run by the TCP timer task. */
+  void on_timer(uint64_t now_ticks);
+  /**
+   * @brief Whether on_timer() has work. Lock-free for the timer tick: a deadline
+   * read mid-update only moves the work to the next tick.
+   */
+  bool timer_due(uint64_t now_ticks) const;
   TcpConnection& connection() { return m_connection; }
 
 private:
@@ -58,11 +69,25 @@ private:
   bool m_tcp_nodelay{false};
   bool m_so_keepalive{false};
   int m_so_error{0};
+  bool m_listener_registered{false};
+  bool m_connection_registered{false};
+  bool m_timer_registered{false};
 
-  void process_handshake(const TcpHeader* hdr, uint8_t flags, uint32_t seq);
-  void process_ack(const TcpHeader* hdr, uint8_t flags);
+  void process_handshake(const TcpHeader* hdr, uint8_t flags, uint32_t seq,
+                         IPv4Address src_ip, IPv4Address dst_ip, const TcpOptions& opts);
+  void apply_syn_options(const TcpOptions& opts);
+  void process_ack(const TcpHeader* hdr, uint8_t flags, size_t data_len, const TcpOptions& opts);
   void process_data(const TcpHeader* hdr, uint8_t flags, const uint8_t* data, size_t data_len, uint32_t seq);
-  void process_fin(const TcpHeader* hdr, uint8_t flags);
+  void process_fin(const TcpHeader* hdr, uint8_t flags, size_t data_len, uint32_t seq);
+  void process_fin_ack();
+  void enter_time_wait();
+
+  void register_connection_timers();
+  void send_segment(uint32_t seq, uint8_t flags, const uint8_t* data, size_t len);
+  fk::core::Result<void, fk::core::Error> transmit(uint8_t flags, const uint8_t* data, size_t len);
+  void retransmit_oldest(uint64_t now);
+  void arm_retransmit_timer(uint64_t now);
+  void send_ack() { send_segment(m_connection.send_next, TCP_FLAG_ACK, nullptr, 0); }
 };
 
 } // namespace net
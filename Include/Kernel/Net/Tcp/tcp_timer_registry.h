@@ -0,0 +1,23 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+class TcpSocket;
+
+namespace tcp_timer_registry {
+
+/** @brief Starts the timer task on first use. */
+void register_socket(TcpSocket* socket);
+void unregister_socket(TcpSocket* socket);
+/**
+ * @brief Called from the timer tick. Only looks for due timers and wakes the
+ * timer task, which runs them; nothing is sent from interrupt context.
+ */
+void tick_all(uint64_t now_ticks);
+
+} // namespace tcp_timer_registry
+} // namespace net
+} // namespace fkernel
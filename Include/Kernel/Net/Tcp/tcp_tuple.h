@@ -0,0 +1,72 @@
+#pragma once
+
+#include <Kernel/Net/Ip/ip_address.h>
+#include <LibFK/Container/hash_map.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+namespace net {
+
+/**
+ * @brief Key identifying a synchronized TCP connection (host byte order).
+ *
+ * "local" is this host's side, "remote" the peer's, so an inbound segment
+ * maps to {dst_ip, dst_port, src_ip, src_port}.
+ */
+struct TcpFourTuple {
+    uint32_t local_ip{0};
+    uint32_t remote_ip{0};
+    uint16_t local_port{0};
+    uint16_t remote_port{0};
+
+    bool operator==(const TcpFourTuple& o) const {
+        return local_ip == o.local_ip && remote_ip == o.remote_ip
+            && local_port == o.local_port && remote_port == o.remote_port;
+    }
+};
+
+/**
+ * @brief Key identifying a bound or listening TCP socket.
+ *
+ * An ip of IPv4Address::any() is the wildcard binding consulted when no
+ * socket is bound to the exact destination address.
+ */
+struct TcpListenKey {
+    uint32_t ip{0};
+    uint16_t port{0};
+
+    bool operator==(const TcpListenKey& o) const {
+        return ip == o.ip && port == o.port;
+    }
+};
+
+/** @brief Finalizer from MurmurHash3; spreads all input bits over the result. */
+inline uint64_t tcp_hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+} // namespace net
+} // namespace fkernel
+
+namespace fk {
+namespace containers {
+template <> struct DefaultHasher<fkernel::net::TcpFourTuple> {
+  size_t operator()(const fkernel::net::TcpFourTuple &value) const {
+    uint64_t addrs = (uint64_t)value.remote_ip << 32 | value.local_ip;
+    uint64_t ports = (uint64_t)value.remote_port << 16 | value.local_port;
+    return static_cast<size_t>(fkernel::net::tcp_hash_mix(addrs ^ fkernel::net::tcp_hash_mix(ports)));
+  }
+};
+
+template <> struct DefaultHasher<fkernel::net::TcpListenKey> {
+  size_t operator()(const fkernel::net::TcpListenKey &value) const {
+    return static_cast<size_t>(fkernel::net::tcp_hash_mix((uint64_t)value.ip << 16 | value.port));
+  }
+};
+}
+}
@@ -69,7 +69,7 @@ private:
   uint16_t m_remote_port{0};
   bool m_so_reuseaddr{false};
   fk::containers::Vector<UdpRecvEntry> m_recv_queue;
-  fk::synchronization::Spinlock m_lock;
+  fk::synchronization::Spinlock m_lock{"socket.udp"};
 };
 
 } // namespace net
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/**
+ * @brief Byte ring with a run-time capacity, used for socket receive queues.
+ *
+ * Read and write positions are free-running counters, so consuming data is
+ * O(1) and never moves the remaining bytes. Storage is allocated on the
+ * first write so idle and listening sockets cost nothing.
+ */
+class SocketRingBuffer {
+public:
+  explicit SocketRingBuffer(size_t capacity);
+  ~SocketRingBuffer();
+  SocketRingBuffer(const SocketRingBuffer&) = delete;
+  SocketRingBuffer& operator=(const SocketRingBuffer&) = delete;
+
+  size_t read(uint8_t* buf, size_t max);
+  size_t write(const uint8_t* src, size_t count);
+  size_t available() const { return m_write_ptr - m_read_ptr; }
+  size_t free_space() const { return m_capacity - available(); }
+  size_t capacity() const { return m_capacity; }
+  bool is_empty() const { return m_write_ptr == m_read_ptr; }
+
+  /** @brief Changes the capacity; refused while data is queued. */
+  bool set_capacity(size_t capacity);
+  void clear() { m_read_ptr = m_write_ptr = 0; }
+
+private:
+  uint8_t* m_data{nullptr};
+  size_t   m_capacity;
+  uint64_t m_read_ptr{0};
+  uint64_t m_write_ptr{0};
+};
+
+} // namespace fkernel
@@ -44,7 +44,7 @@ public:
 private:
     SocketType m_type;
     fk::text::fixed_string<108> m_bound_path;
-    fk::synchronization::Spinlock m_lock;
+    fk::synchronization::Spinlock m_lock{"socket.unix"};
 
     UnixSocket* m_peer{nullptr};
     fk::RefPtr<UnixSocket> m_backlog[16];
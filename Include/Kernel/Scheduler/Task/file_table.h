@@ -0,0 +1,76 @@
+#pragma once
+
+#include <Kernel/Fs/Vfs/file_description.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Memory/ref_counted.h>
+#include <LibFK/Memory/ref_ptr.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+/// Ceiling for RLIMIT_NOFILE and any descriptor number (Linux's nr_open)
+constexpr size_t FD_TABLE_MAX = 1 << 20;
+/// RLIMIT_NOFILE a task starts with; children inherit their parent's
+constexpr uint64_t DEFAULT_NOFILE_SOFT = 1024;
+constexpr uint64_t DEFAULT_NOFILE_HARD = 65536;
+
+/**
+ * @brief Descriptor table of one or more tasks (shared by clone(CLONE_FILES)).
+ *
+ * Slots grow on demand in 64-descriptor words. An open bitmap finds the
+ * lowest free descriptor a word at a time, starting from a hint below which
+ * every slot is known to be in use, and close-on-exec lives in a parallel
+ * bitmap because it belongs to the descriptor, not the open file.
+ *
+ * Callers pass the RLIMIT_NOFILE of the calling task: the limit belongs to
+ * the process, while the table may be shared.
+ */
+class FileTable : public fk::memory::RefCounted<FileTable> {
+public:
+    static fk::core::Result<fk::RefPtr<FileTable>, fk::core::Error> create();
+
+    /** @brief Copy for fork(): same open files and close-on-exec flags. */
+    fk::core::Result<fk::RefPtr<FileTable>, fk::core::Error> clone() const;
+
+    fk::RefPtr<FileDescription> get(int fd) const;
+
+    /**
+     * @brief Installs @p description at the lowest free descriptor >= @p min_fd.
+     * @return The descriptor, or TooManyOpenFiles at @p limit.
+     */
+    fk::core::Result<int, fk::core::Error> allocate(fk::RefPtr<FileDescription> description,
+                                                    int min_fd, bool cloexec, size_t limit);
+
+    /**
+     * @brief Points @p fd at @p description (dup2/dup3), replacing what it held.
+     * @return The displaced description, so the caller drops it outside the lock.
+     */
+    fk::core::Result<fk::RefPtr<FileDescription>, fk::core::Error>
+    install(int fd, fk::RefPtr<FileDescription> description, bool cloexec, size_t limit);
+
+    /** @brief Frees @p fd; returns what it held (null if it was not open). */
+    fk::RefPtr<FileDescription> remove(int fd);
+
+    fk::core::Result<bool, fk::core::Error> is_cloexec(int fd) const;
+    fk::core::Result<void, fk::core::Error> set_cloexec(int fd, bool cloexec);
+
+    /** @brief Closes every descriptor marked close-on-exec. */
+    void close_on_exec();
+
+    /** @brief One past the highest descriptor the table has room for. */
+    size_t slot_count() const;
+
+private:
+    static constexpr size_t BITS_PER_WORD = 64;
+
+    bool is_open_locked(size_t fd) const;
+    void set_bit(fk::containers::Vector<uint64_t>& bits, size_t fd, bool value);
+    bool ensure_slots_locked(size_t slots);
+    void release_locked(size_t fd);
+
+    mutable fk::synchronization::Spinlock m_lock{"fdtable"};
+    fk::containers::Vector<fk::RefPtr<FileDescription>> m_files;
+    fk::containers::Vector<uint64_t> m_open_bits;
+    fk::containers::Vector<uint64_t> m_cloexec_bits;
+    size_t m_next_fd{0}; ///< Every descriptor below this is open
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Kernel/Fs/Vfs/file_description.h>
+#include <Kernel/Scheduler/Task/file_table.h>
 #include <LibFK/Container/intrusive_list.h>
 #include <LibFK/Container/static_vector.h>
 #include <LibFK/Text/fixed_string.h>
@@ -11,6 +12,7 @@
 #include <Kernel/Scheduler/Task/task_state.h>
 #include <Kernel/Posix/signal_defs.h>
 #include <Kernel/Memory/VirtualMemory/memory_region.h>
+#include <Kernel/Memory/VirtualMemory/vma_tree.h>
 #include <LibFK/Container/vector.h>
 
 namespace fkernel::ipc {
@@ -52,20 +54,18 @@ struct TaskMemory {
     struct {
         uintptr_t heap_start{0};
         uintptr_t heap_break{0};
-        uintptr_t mmap_start{0};
-        uintptr_t mmap_end{0};
-        fk::containers::Vector<::fkernel::MemoryRegion> list;
     } regions{};
+    fk::RefPtr<::fkernel::VmaTree> vmas; ///< User mappings; shared with CLONE_VM threads
 };
 
-static constexpr size_t MAX_OPEN_FILES = 128;
-
 /**
  * @brief Task Files and filesystem state
  */
 struct TaskFiles {
     fk::text::fixed_string<256> cwd{"/"};
-    fk::containers::static_vector<fk::RefPtr<FileDescription>, MAX_OPEN_FILES> descriptors;
+    fk::RefPtr<FileTable> table; ///< Descriptors; shared with CLONE_FILES threads
+    uint64_t nofile_soft{DEFAULT_NOFILE_SOFT}; ///< RLIMIT_NOFILE
+    uint64_t nofile_hard{DEFAULT_NOFILE_HARD};
 };
 
 /**
@@ -153,7 +153,7 @@ struct Task {
     fk::containers::IntrusiveListNode<Task> sleep_node;
     fk::containers::IntrusiveListNode<Task> zombie_node;
 
-    mutable fk::synchronization::Spinlock lock;
+    mutable fk::synchronization::Spinlock lock{"task"};
 
     struct Control {
         TaskIdentity identity;
@@ -189,14 +189,21 @@ struct Task {
     bool is_a_kernel_task() const { return control.lifecycle.is_a_kernel_task; }
     bool has_pending_signals() const { return (resources.ipc.signals.pending & ~resources.ipc.signals.blocked) != 0; }
 
-    int add_file_descriptor(fk::RefPtr<FileDescription> description);
+    /// Descriptor operations return the descriptor or a negative errno.
+    /// The table is created on first use for tasks that were not given one.
+    fk::RefPtr<FileTable> file_table();
+    int add_file_descriptor(fk::RefPtr<FileDescription> description, bool cloexec = false);
     int dup_file_descriptor(int old_fd, bool cloexec = false, int min_fd = 0);
+    int install_file_descriptor(int fd, fk::RefPtr<FileDescription> description, bool cloexec);
     fk::RefPtr<FileDescription> get_file_descriptor(int fd);
-    void close_file_descriptor(int fd);
+    /** @brief Copies (or with share, shares) parent's table and takes its RLIMIT_NOFILE. */
+    fk::core::Result<void, fk::core::Error> inherit_files(Task& parent, bool share);
+    /** @brief Closes fd; returns -EBADF if it was not open. */
+    int close_file_descriptor(int fd);
 
     void set_heap_regions(uintptr_t start, uintptr_t break_addr);
-    void set_mmap_regions(uintptr_t start, uintptr_t end);
-    bool is_address_in_allowed_regions(uintptr_t address) const;
+    /** @brief Copies the user mapping that contains address into out. */
+    bool find_vma(uintptr_t address, ::fkernel::Vma& out) const;
 
     void dump_file_descriptors() const;
     void print_info() const;
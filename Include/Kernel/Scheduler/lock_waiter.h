@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Kernel/Scheduler/Task/task.h>
+#include <LibFK/Container/intrusive_list.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/// Iterations a contender spins on a running owner before it goes to sleep
+constexpr uint32_t LOCK_OWNER_SPIN_LIMIT = 4096;
+
+/**
+ * @brief A task queued on a sleeping lock. Lives on the waiter's stack.
+ *
+ * The releasing side hands the lock over by setting granted under the lock's
+ * wait-list spinlock, so a woken waiter already owns it.
+ */
+struct LockWaiter {
+    Task* task{nullptr};
+    bool writer{false};
+    volatile bool granted{false};
+    fk::containers::IntrusiveListNode<LockWaiter> node;
+};
+
+using LockWaitList = fk::containers::IntrusiveList<LockWaiter, &LockWaiter::node>;
+
+/// Owner recorded for locks taken before the scheduler runs the first task
+inline Task* const BOOT_LOCK_OWNER = reinterpret_cast<Task*>(uintptr_t{1});
+
+/** @brief The calling task, or BOOT_LOCK_OWNER if it cannot sleep yet. */
+Task* lock_caller();
+
+/** @brief True while owner is running on another CPU, so spinning on it pays off. */
+bool lock_owner_running(const Task* owner);
+
+/**
+ * @brief Sleeps until waiter is granted. waiter must already be queued; guard
+ * is the spinlock that protects the queue and is taken here, not held on entry.
+ */
+void lock_wait_for_grant(fk::synchronization::Spinlock& guard, LockWaiter& waiter);
+
+/** @brief Marks waiter as the new holder and wakes it. Called with its guard held. */
+void lock_grant(LockWaiter& waiter);
+
+/// Priority-inheritance hooks for turnstiles, called with the guard held.
+/// They do not change priorities yet; the scheduler has no notion of a
+/// boosted priority to restore.
+void lock_owner_blocks(Task* owner, Task* waiter);
+void lock_owner_releases(Task* owner);
+
+} // namespace fkernel
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Kernel/Scheduler/lock_waiter.h>
+#include <LibFK/Synchronization/spinlock.h>
+
+namespace fkernel {
+
+/**
+ * @brief Sleeping, non-recursive mutual exclusion lock.
+ *
+ * The fast path is one compare-and-swap on the owner. A contender first spins
+ * while the owner runs on another CPU, then queues and sleeps; unlock() hands
+ * the lock to the oldest waiter. Interrupts stay enabled while it is held, so
+ * long operations (path walks, filesystem I/O) no longer stall them. Must not
+ * be taken from interrupt context; before the scheduler runs it spins.
+ */
+class Mutex {
+public:
+    explicit constexpr Mutex(const char* name = "mutex") : m_wait_lock(name) {}
+    Mutex(const Mutex&) = delete;
+    Mutex& operator=(const Mutex&) = delete;
+
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    bool is_locked() const { return __atomic_load_n(&m_owner, __ATOMIC_RELAXED) != nullptr; }
+    bool is_locked_by_current() const;
+
+private:
+    bool try_acquire(Task* self);
+    void spin_on_owner();
+
+    Task* m_owner{nullptr}; ///< Holder, BOOT_LOCK_OWNER before tasks exist
+    fk::synchronization::Spinlock m_wait_lock;
+    LockWaitList m_waiters;
+};
+
+/**
+ * @brief RAII wrapper for Mutex.
+ */
+class MutexLocker {
+public:
+    explicit MutexLocker(Mutex& mutex) : m_mutex(mutex) { m_mutex.lock(); }
+    ~MutexLocker() { m_mutex.unlock(); }
+
+    MutexLocker(const MutexLocker&) = delete;
+    MutexLocker& operator=(const MutexLocker&) = delete;
+
+private:
+    Mutex& m_mutex;
+};
+
+} // namespace fkernel
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <Kernel/Scheduler/lock_waiter.h>
+#include <LibFK/Synchronization/spinlock.h>
+
+namespace fkernel {
+
+/**
+ * @brief Sleeping reader-writer lock.
+ *
+ * Any number of readers or one writer. Waiters are served in arrival order:
+ * a reader that finds a writer queued waits behind it, so writers are not
+ * starved, and a released writer admits the run of readers at the head of
+ * the queue together. Contenders spin while a writer runs on another CPU
+ * before sleeping. Same context rules as Mutex.
+ */
+class RwSemaphore {
+public:
+    explicit constexpr RwSemaphore(const char* name = "rwsem") : m_wait_lock(name) {}
+    RwSemaphore(const RwSemaphore&) = delete;
+    RwSemaphore& operator=(const RwSemaphore&) = delete;
+
+    void lock_read();
+    bool try_lock_read();
+    void unlock_read();
+
+    void lock_write();
+    bool try_lock_write();
+    void unlock_write();
+
+private:
+    void lock(bool writer);
+    bool try_acquire_locked(bool writer, Task* self);
+    void spin_on_writer();
+    void grant_waiters_locked();
+
+    uint32_t m_readers{0};
+    Task* m_writer{nullptr};
+    fk::synchronization::Spinlock m_wait_lock; ///< Guards all of the above
+    LockWaitList m_waiters;
+};
+
+/**
+ * @brief RAII shared hold of an RwSemaphore.
+ */
+class ReadLocker {
+public:
+    explicit ReadLocker(RwSemaphore& sem) : m_sem(sem) { m_sem.lock_read(); }
+    ~ReadLocker() { m_sem.unlock_read(); }
+
+    ReadLocker(const ReadLocker&) = delete;
+    ReadLocker& operator=(const ReadLocker&) = delete;
+
+private:
+    RwSemaphore& m_sem;
+};
+
+/**
+ * @brief RAII exclusive hold of an RwSemaphore.
+ */
+class WriteLocker {
+public:
+    explicit WriteLocker(RwSemaphore& sem) : m_sem(sem) { m_sem.lock_write(); }
+    ~WriteLocker() { m_sem.unlock_write(); }
+
+    WriteLocker(const WriteLocker&) = delete;
+    WriteLocker& operator=(const WriteLocker&) = delete;
+
+private:
+    RwSemaphore& m_sem;
+};
+
+} // namespace fkernel
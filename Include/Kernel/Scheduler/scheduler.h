@@ -14,7 +14,7 @@ class SchedulerManager {
 private:
     SchedulerManager();
 
-    fk::synchronization::Spinlock m_lock;
+    fk::synchronization::Spinlock m_lock{"scheduler"};
     fkernel::Processor m_processors[32];
     uint32_t m_processor_count = 1;
 
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Kernel/Scheduler/Task/task.h>
+#include <LibFK/Container/intrusive_list.h>
+#include <LibFK/Core/result.h>
+#include <LibFK/Synchronization/spinlock.h>
+
+namespace fkernel {
+
+/** @brief A task parked on a WaitQueue. Lives on the waiter's stack. */
+struct WaitQueueEntry {
+    Task* task{nullptr};
+    volatile bool queued{false};
+    fk::containers::IntrusiveListNode<WaitQueueEntry> node;
+};
+
+/**
+ * @brief Tasks sleeping until some condition, guarded by the caller's lock, changes.
+ *
+ * The waiter checks its condition under its own lock and, if it has to wait,
+ * calls prepare_to_wait() before dropping it, then finish_wait(). A waker
+ * changes the condition and then calls wake_one()/wake_all(), so a wake in
+ * between is never lost. Wakes may be spurious: callers re-check and loop.
+ * Unlike ipc::Notification a waiter woken by a signal leaves the queue.
+ */
+class WaitQueue {
+public:
+    explicit constexpr WaitQueue(const char* name = "waitqueue") : m_lock(name) {}
+    WaitQueue(const WaitQueue&) = delete;
+    WaitQueue& operator=(const WaitQueue&) = delete;
+
+    /** @brief Queues the current task and marks it blocked; it runs on until finish_wait(). */
+    void prepare_to_wait(WaitQueueEntry& entry);
+
+    /**
+     * @brief Sleeps unless already woken, then leaves the queue.
+     * @return Interrupted if a signal is pending.
+     */
+    fk::core::Result<void, fk::core::Error> finish_wait(WaitQueueEntry& entry);
+
+    void wake_one();
+    void wake_all();
+
+    bool has_waiters() const { return !m_waiters.is_empty(); }
+
+private:
+    fk::synchronization::Spinlock m_lock;
+    fk::containers::IntrusiveList<WaitQueueEntry, &WaitQueueEntry::node> m_waiters;
+};
+
+} // namespace fkernel
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <Kernel/Hardware/Cpu/cpu_block.h>
+#include <Kernel/Syscall/syscall_numbers.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel {
+
+/// Bucket k counts calls that took [2^k, 2^(k+1)) TSC cycles; the last one is open-ended.
+constexpr size_t SYSCALL_LATENCY_BUCKETS = 32;
+
+struct SyscallCounters {
+  uint64_t calls;
+  uint64_t errors;
+  uint64_t cycles;
+  uint32_t latency[SYSCALL_LATENCY_BUCKETS];
+};
+
+/**
+ * @brief Per-CPU, per-syscall call/error counts and log2 latency histograms.
+ *
+ * Each CPU normally touches only its own table, so the hot path is a handful
+ * of relaxed atomic adds that never contend; they are atomic only because a
+ * task can migrate between reading its CPU id and counting. Tables are
+ * allocated on the first syscall a CPU dispatches. Exported as
+ * /proc/syscall_stats.
+ */
+class SyscallStats {
+private:
+  SyscallCounters* m_cpu_tables[MAX_CPUS]{};
+
+  SyscallStats() = default;
+
+  SyscallCounters* table_for(uint32_t cpu);
+
+public:
+  static SyscallStats& the() {
+    static SyscallStats inst;
+    return inst;
+  }
+
+  /** @brief Accounts one completed syscall. Called from syscall_dispatcher. */
+  void record(uint64_t num, uint64_t result, uint64_t cycles);
+
+  /** @brief Sums all CPUs into @p out (SYS_MAX entries). */
+  void snapshot(SyscallCounters* out) const;
+
+  /** @brief Zeroes every CPU's counters. */
+  void reset();
+};
+
+} // namespace fkernel
@@ -31,6 +31,16 @@ inline int error_to_errno(fk::core::Error error) {
     return 10; // ECHILD
   case fk::core::Error::InappropriateIoctlForDevice:
     return 25; // ENOTTY
+  case fk::core::Error::Timeout:
+    return 110; // ETIMEDOUT
+  case fk::core::Error::WouldBlock:
+    return 11; // EAGAIN
+  case fk::core::Error::BadAddress:
+    return 14; // EFAULT
+  case fk::core::Error::InvalidHandle:
+    return 9; // EBADF
+  case fk::core::Error::TooManyOpenFiles:
+    return 24; // EMFILE
   case fk::core::Error::EndOfFile:
     return 0; // Usually not an error in POSIX read, but 0 return
   default:
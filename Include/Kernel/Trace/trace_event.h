@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Kernel/Trace/trace_event_id.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel::trace {
+
+constexpr size_t TRACE_EVENT_ARGS = 6;
+
+/**
+ * @brief One binary trace record, exactly one cache line.
+ *
+ * This is the on-the-wire format of /debug/trace; the user-space decoder
+ * (Src/Userland/tracecat) keeps an identical copy of the layout.
+ */
+struct TraceEvent {
+  uint64_t timestamp_ns; ///< CLOCK_MONOTONIC when the tracepoint fired
+  uint32_t tid;          ///< Current task id, 0 when no task is running
+  uint16_t cpu;
+  uint16_t event_id;     ///< TraceEventId
+  uint64_t args[TRACE_EVENT_ARGS];
+};
+
+static_assert(sizeof(TraceEvent) == 64, "TraceEvent is part of the /debug/trace ABI");
+
+} // namespace fkernel::trace
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <LibFK/Types/types.h>
+
+namespace fkernel::trace {
+
+/**
+ * @brief Static tracepoint identifiers stored in TraceEvent::event_id.
+ *
+ * The values are part of the /debug/trace format decoded by
+ * Src/Userland/tracecat: append new ids, never renumber existing ones.
+ */
+enum class TraceEventId : uint16_t {
+  None = 0,
+
+  /// args: number, arg1..arg5
+  SyscallEnter = 1,
+  /// args: number, result
+  SyscallExit = 2,
+
+  /// args: sender id, receiver id, message info
+  IpcDeliver = 16,
+  IpcSendBlocked = 17,
+  IpcSendImmediate = 18,
+  IpcReceiveBlocked = 19,
+  IpcReceiveImmediate = 20,
+
+  /// args: task id, bits
+  NotifySignalWake = 32,
+  NotifySignalQueue = 33,
+  NotifyWaitImmediate = 34,
+  NotifyWaitBlocked = 35,
+  NotifyWaitWoken = 36,
+  NotifyPoll = 37,
+
+  /// args: task id, signal, handler, frame address
+  SignalDeliver = 48,
+};
+
+} // namespace fkernel::trace
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Kernel/Trace/trace_event.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel::trace {
+
+/**
+ * @brief Lock-free event ring owned by one CPU.
+ *
+ * Producers reserve a slot with one atomic increment of the head, fill it and
+ * publish it through the slot's commit word, so an interrupt that traces
+ * while the CPU is already inside record() simply gets the next slot. When
+ * the ring is full the oldest events are overwritten; the consumer notices
+ * through the commit words and counts them as dropped.
+ */
+class TraceRing {
+public:
+  static constexpr size_t CAPACITY = 512;
+  static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+  /** @brief Reserves, fills and publishes one slot. Safe in IRQ context. */
+  void record(const TraceEvent& event);
+
+  /**
+   * @brief Moves up to @p max committed events into @p out, oldest first.
+   * Must be serialized by the caller (only one consumer per ring).
+   */
+  size_t consume(TraceEvent* out, size_t max);
+
+  /** @brief Discards everything recorded so far. Caller serializes consumers. */
+  void clear();
+
+  /** @brief Number of events that are recorded but not consumed yet. */
+  size_t pending() const;
+
+  uint64_t dropped() const { return m_dropped; }
+
+private:
+  TraceEvent m_events[CAPACITY];
+  uint64_t m_commit[CAPACITY]{}; ///< Sequence + 1 of the event in each slot
+  uint64_t m_head{0};            ///< Next sequence to reserve
+  uint64_t m_tail{0};            ///< Next sequence to consume
+  uint64_t m_dropped{0};
+};
+
+} // namespace fkernel::trace
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <Kernel/Hardware/Cpu/cpu_block.h>
+#include <Kernel/Trace/trace_event.h>
+#include <Kernel/Trace/trace_event_id.h>
+#include <Kernel/Trace/trace_ring.h>
+#include <LibFK/Synchronization/spinlock.h>
+#include <LibFK/Types/types.h>
+
+namespace fkernel::trace {
+
+/// Checked by every tracepoint; toggled through /debug/tracing_on.
+extern bool g_tracing_enabled;
+
+/**
+ * @brief Per-CPU binary event tracing exposed as /debug/trace.
+ *
+ * Tracing is off by default. Reading /debug/trace drains all rings as raw
+ * TraceEvent records; Src/Userland/tracecat renders them as text.
+ */
+class Tracer {
+private:
+  TraceRing m_rings[MAX_CPUS];
+  fk::synchronization::Spinlock m_consumer_lock;
+
+  Tracer() = default;
+
+public:
+  static Tracer& the() {
+    static Tracer inst;
+    return inst;
+  }
+
+  void set_enabled(bool enabled);
+  bool is_enabled() const { return g_tracing_enabled; }
+
+  /** @brief Slow path of tracepoint(): stamps and stores one event. */
+  void record(TraceEventId id, uint64_t a0 = 0, uint64_t a1 = 0, uint64_t a2 = 0,
+              uint64_t a3 = 0, uint64_t a4 = 0, uint64_t a5 = 0);
+
+  /** @brief Drains up to @p max events from all CPUs into @p out. */
+  size_t consume(TraceEvent* out, size_t max);
+
+  void clear();
+
+  size_t pending() const;
+  uint64_t dropped() const;
+};
+
+/**
+ * @brief Static tracepoint: a single predictable branch while tracing is off.
+ */
+template <typename... Args>
+[[gnu::always_inline]] inline void tracepoint(TraceEventId id, Args... args) {
+  static_assert(sizeof...(Args) <= TRACE_EVENT_ARGS, "too many tracepoint arguments");
+  if (__builtin_expect(g_tracing_enabled, false))
+    Tracer::the().record(id, static_cast<uint64_t>(args)...);
+}
+
+} // namespace fkernel::trace
@@ -138,6 +138,19 @@ char *strnchr(const char *s, int c, size_t maxlen);
  */
 char *strcat(char *dest, const char *src);
 
+/**
+ * @brief Append at most @p n characters of @p src to @p dest.
+ *
+ * Declared for hosted builds too: unlike strstr or memchr it has no C++
+ * overloads, and LibFK/Utilities/memory.h wraps it.
+ *
+ * @param dest Destination buffer (must be large enough).
+ * @param src  Source string.
+ * @param n    Maximum characters taken from @p src.
+ * @return Pointer to @p dest.
+ */
+char *strncat(char *dest, const char *src, size_t n);
+
 /**
  * @brief Copy at most @p n characters from one string to another.
  *
@@ -249,7 +262,6 @@ char *strstr(const char *haystack, const char *needle);
 int strcasecmp(const char *s1, const char *s2);
 int strncasecmp(const char *s1, const char *s2, size_t n);
 void *memchr(const void *s, int c, size_t n);
-char *strncat(char *dest, const char *src, size_t n);
 char *strpbrk(const char *s, const char *accept);
 size_t strspn(const char *s, const char *accept);
 size_t strcspn(const char *s, const char *reject);
@@ -28,6 +28,13 @@ uint32_t get_log_targets();
 void set_log_level(LogLevel level);
 LogLevel get_log_level();
 
+/**
+ * @brief Marks the system as going down: from now on log sinks that buffer
+ * (the serial rings) write synchronously, so the last words are not lost.
+ */
+void enter_panic_mode();
+bool in_panic_mode();
+
 #define KLOG_COLOR_RESET "\033[0m"
 #define KLOG_COLOR_RED "\033[31m"
 #define KLOG_COLOR_GREEN "\033[32m"
@@ -48,6 +55,7 @@ inline void kfatal(const char *prefix, const char *fmt, ...) {
   vsnprintf(buf, sizeof(buf), fmt, args);
   va_end(args);
 
+  enter_panic_mode();
   kprintf("%s[FATAL][%s]%s: %s\n", KLOG_COLOR_RED, prefix, KLOG_COLOR_RESET, buf);
 
   while (true) {
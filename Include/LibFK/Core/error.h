@@ -33,6 +33,8 @@ enum class Error {
   BrokenPipe = 32,                  // EPIPE
   WouldBlock = 11,                  // EAGAIN
   NotConnected = 107,               // ENOTCONN
+  BadAddress = 14,                  // EFAULT
+  TooManyOpenFiles = 24,            // EMFILE
 };
 
 } // namespace core
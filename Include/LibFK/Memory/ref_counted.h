@@ -19,6 +19,23 @@ public:
         }
     }
 
+    /**
+     * @brief Takes a reference unless the count already dropped to zero.
+     *
+     * For lookups through tables that hold raw pointers: an object whose
+     * destructor has started stays listed until it unregisters itself, and
+     * must not be picked up again in the meantime.
+     */
+    bool try_ref() const {
+        uint32_t count = __atomic_load_n(&m_ref_count, __ATOMIC_RELAXED);
+        while (count != 0) {
+            if (__atomic_compare_exchange_n(&m_ref_count, &count, count + 1, true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                return true;
+        }
+        return false;
+    }
+
     uint32_t ref_count() const { return m_ref_count; }
 
 protected:
@@ -2,6 +2,7 @@
 
 namespace fk::synchronization {
 
+#ifdef __fkernel__
 /**
  * @brief RAII wrapper to disable interrupts and restore state on destruction.
  * Uses direct x86 cli/sti/pushfq so LibFK does not depend on Kernel headers.
@@ -25,5 +26,16 @@ public:
 private:
     bool m_previous_state;
 };
+#else
+/**
+ * @brief Host builds have no interrupts to mask.
+ */
+class ScopedInterruptDisabler {
+public:
+    ScopedInterruptDisabler() = default;
+    ScopedInterruptDisabler(const ScopedInterruptDisabler&) = delete;
+    ScopedInterruptDisabler& operator=(const ScopedInterruptDisabler&) = delete;
+};
+#endif
 
 } // namespace fk::synchronization
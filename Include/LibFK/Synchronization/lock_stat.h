@@ -0,0 +1,118 @@
+#pragma once
+
+#include <LibFK/Synchronization/lock_rank.h>
+#include <LibFK/Types/types.h>
+
+namespace fk::synchronization {
+
+// Contention statistics per lock class. Spinlock only feeds them when built
+// with FKERNEL_LOCK_STAT (xmake f --lock_stat=y); otherwise nothing here is
+// referenced and the registry stays empty. Exported as /proc/lock_stat.
+
+/// Classes registered after the first 63 share the last, "(other)" slot
+constexpr size_t LOCK_STAT_MAX_CLASSES = 64;
+
+/**
+ * @brief Counters shared by every Spinlock of one class, in TSC cycles.
+ *
+ * Locks of the same class may be held on several CPUs at once, so every
+ * update is atomic.
+ */
+struct LockClassStats {
+    const char* name;
+    uint64_t acquisitions;
+    uint64_t contended;       ///< Acquisitions that found the lock held
+    uint64_t spin_cycles;     ///< Total time spent waiting
+    uint64_t max_spin_cycles;
+    uint64_t max_hold_cycles; ///< Longest hold with interrupts disabled
+};
+
+inline LockClassStats g_lock_classes[LOCK_STAT_MAX_CLASSES];
+inline uint32_t g_lock_class_count = 0;
+inline int g_lock_class_registry_lock = 0; ///< Plain test-and-set: a Spinlock would recurse
+
+inline uint64_t lock_stat_cycles() {
+    uint32_t lo, hi;
+    asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+inline void lock_stat_raise(uint64_t& slot, uint64_t value) {
+    uint64_t seen = __atomic_load_n(&slot, __ATOMIC_RELAXED);
+    while (value > seen &&
+           !__atomic_compare_exchange_n(&slot, &seen, value, true, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED)) {
+    }
+}
+
+/// Class name of locks constructed without one
+inline const char* lock_rank_class_name(LockRank rank) {
+    switch (rank) {
+    case LockRank::Scheduler: return "rank:scheduler";
+    case LockRank::Memory:    return "rank:memory";
+    case LockRank::VFS:       return "rank:vfs";
+    case LockRank::Process:   return "rank:process";
+    case LockRank::Ipc:       return "rank:ipc";
+    case LockRank::Driver:    return "rank:driver";
+    case LockRank::Network:   return "rank:network";
+    default:                  return "unclassified";
+    }
+}
+
+/**
+ * @brief The stats slot of the class called name, registered on first use.
+ *
+ * Runs with interrupts disabled so a lock taken from an interrupt handler
+ * cannot spin on the registry its own CPU holds.
+ */
+inline LockClassStats* lock_class(const char* name) {
+#ifdef __fkernel__
+    uint64_t rflags;
+    asm volatile("pushfq ; popq %0 ; cli" : "=r"(rflags) : : "memory");
+#endif
+    while (__sync_lock_test_and_set(&g_lock_class_registry_lock, 1)) {
+        asm volatile("pause");
+    }
+
+    LockClassStats* found = nullptr;
+    for (uint32_t i = 0; i < g_lock_class_count && !found; ++i) {
+        const char* a = g_lock_classes[i].name;
+        const char* b = name;
+        while (*a && *a == *b) {
+            ++a;
+            ++b;
+        }
+        if (*a == *b)
+            found = &g_lock_classes[i];
+    }
+    if (!found) {
+        if (g_lock_class_count < LOCK_STAT_MAX_CLASSES - 1) {
+            found = &g_lock_classes[g_lock_class_count];
+            found->name = name;
+            __atomic_store_n(&g_lock_class_count, g_lock_class_count + 1, __ATOMIC_RELEASE);
+        } else {
+            found = &g_lock_classes[LOCK_STAT_MAX_CLASSES - 1];
+            found->name = "(other)";
+        }
+    }
+
+    __sync_lock_release(&g_lock_class_registry_lock);
+#ifdef __fkernel__
+    if (rflags & (1ULL << 9))
+        asm volatile("sti" ::: "memory");
+#endif
+    return found;
+}
+
+/** @brief Zeroes the counters of every class; the classes stay registered. */
+inline void lock_stat_reset() {
+    for (auto& stats : g_lock_classes) {
+        __atomic_store_n(&stats.acquisitions, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats.contended, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats.spin_cycles, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats.max_spin_cycles, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stats.max_hold_cycles, 0, __ATOMIC_RELAXED);
+    }
+}
+
+} // namespace fk::synchronization
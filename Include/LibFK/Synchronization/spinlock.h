@@ -2,31 +2,66 @@
 
 #include <LibFK/Core/assertions.h>
 #include <LibFK/Synchronization/lock_rank.h>
+#ifdef FKERNEL_LOCK_STAT
+#include <LibFK/Synchronization/lock_stat.h>
+#endif
 #include <LibFK/Types/types.h>
 
 namespace fk::synchronization {
 
+/// Offset of CpuControlBlock::cpu_id in the block the kernel GS base points at
+constexpr uint32_t GS_CPU_ID_OFFSET = 32;
+
+/// Set once the kernel GS base points at the CPU block; until then only the
+/// boot CPU runs and it is CPU 0. Lives here so no separate .cpp is needed.
+inline bool g_gs_cpu_id_ready = false;
+
 /**
- * @brief Simple atomic spinlock using xchg.
+ * @brief 1 + the id of the calling CPU, read from the per-CPU GS block.
+ *
+ * 0 means "unknown" (host builds), which disables recursive acquisition.
+ */
+inline uint32_t current_cpu_slot() {
+#ifdef __fkernel__
+    if (!g_gs_cpu_id_ready)
+        return 1;
+    uint64_t id;
+    asm volatile("movq %%gs:%c1, %0" : "=r"(id) : "i"(GS_CPU_ID_OFFSET));
+    return static_cast<uint32_t>(id) + 1;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Fair ticket spinlock.
+ *
+ * lock() takes the next ticket and spins until it is served, so waiters get
+ * the lock in arrival order. The owning CPU may re-acquire it recursively.
+ *
+ * With FKERNEL_LOCK_STAT every acquisition is accounted to the lock's class
+ * (its name, or its rank if it has none) in /proc/lock_stat.
  */
 class Spinlock {
 public:
     constexpr Spinlock()
-        : m_lock(0), m_owner_cpu(0), m_recursion_count(0), m_rank(LockRank::None) {}
+        : m_next_ticket(0), m_now_serving(0), m_owner_cpu(0), m_recursion_count(0),
+          m_rank(LockRank::None) {}
 
     explicit constexpr Spinlock(LockRank rank)
-        : m_lock(0), m_owner_cpu(0), m_recursion_count(0), m_rank(rank) {}
+        : m_next_ticket(0), m_now_serving(0), m_owner_cpu(0), m_recursion_count(0),
+          m_rank(rank) {}
 
-    void lock() {
-        uint32_t cpu_id = 0;
-#ifdef __fkernel__
-        // Get CPU ID via local APIC ID (using assembly to avoid including APIC header)
-        // This is safe even before APIC is fully initialized by the manager.
-        uint32_t ebx;
-        asm volatile("cpuid" : "=b"(ebx) : "a"(1) : "rcx", "rdx");
-        cpu_id = (ebx >> 24) + 1;
+    explicit constexpr Spinlock(const char* class_name) : Spinlock(LockRank::None, class_name) {}
+
+    constexpr Spinlock(LockRank rank, [[maybe_unused]] const char* class_name) : Spinlock(rank) {
+#ifdef FKERNEL_LOCK_STAT
+        m_class_name = class_name;
 #endif
+    }
 
+    void lock() {
+        uint32_t cpu_id = current_cpu_slot();
         if (m_owner_cpu == cpu_id && cpu_id != 0) {
             m_recursion_count = m_recursion_count + 1;
             return;
@@ -37,39 +72,40 @@ public:
             ASSERT(current_cpu_lock_rank() < m_rank);
         }
 
-        while (__sync_lock_test_and_set(&m_lock, 1)) {
-            while (m_lock) {
-                asm volatile("pause");
-            }
+        uint32_t ticket = __atomic_fetch_add(&m_next_ticket, 1, __ATOMIC_RELAXED);
+#ifdef FKERNEL_LOCK_STAT
+        uint64_t spin_start = 0;
+        if (__atomic_load_n(&m_now_serving, __ATOMIC_ACQUIRE) != ticket)
+            spin_start = lock_stat_cycles();
+#endif
+        while (__atomic_load_n(&m_now_serving, __ATOMIC_ACQUIRE) != ticket) {
+            asm volatile("pause");
         }
 
-        m_owner_cpu = cpu_id;
-        m_recursion_count = 1;
-        if (m_rank != LockRank::None) {
-            m_prev_rank = current_cpu_lock_rank();
-            set_cpu_lock_rank(m_rank);
-        }
+        took_lock(cpu_id);
+#ifdef FKERNEL_LOCK_STAT
+        record_acquire(spin_start);
+#endif
     }
 
     bool try_lock() {
-        uint32_t cpu_id = 0;
-#ifdef __fkernel__
-        uint32_t ebx;
-        asm volatile("cpuid" : "=b"(ebx) : "a"(1) : "rcx", "rdx");
-        cpu_id = (ebx >> 24) + 1;
-#endif
-
+        uint32_t cpu_id = current_cpu_slot();
         if (m_owner_cpu == cpu_id && cpu_id != 0) {
             m_recursion_count = m_recursion_count + 1;
             return true;
         }
 
-        if (__sync_lock_test_and_set(&m_lock, 1)) {
+        // Free only while no ticket is outstanding; claim the next one atomically
+        uint32_t serving = __atomic_load_n(&m_now_serving, __ATOMIC_RELAXED);
+        if (!__atomic_compare_exchange_n(&m_next_ticket, &serving, serving + 1, false,
+                                         __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
             return false;
         }
 
-        m_owner_cpu = cpu_id;
-        m_recursion_count = 1;
+        took_lock(cpu_id);
+#ifdef FKERNEL_LOCK_STAT
+        record_acquire(0);
+#endif
         return true;
     }
 
@@ -77,22 +113,64 @@ public:
         uint32_t new_count = m_recursion_count - 1;
         m_recursion_count = new_count;
         if (new_count == 0) {
+#ifdef FKERNEL_LOCK_STAT
+            if (m_irqs_off)
+                lock_stat_raise(m_stats->max_hold_cycles, lock_stat_cycles() - m_acquired_at);
+#endif
             if (m_rank != LockRank::None)
                 set_cpu_lock_rank(m_prev_rank);
             m_owner_cpu = 0;
-            __sync_lock_release(&m_lock);
+            __atomic_store_n(&m_now_serving, m_now_serving + 1, __ATOMIC_RELEASE);
         }
     }
 
-    bool is_locked() const { return m_lock != 0; }
+    bool is_locked() const {
+        return __atomic_load_n(&m_next_ticket, __ATOMIC_RELAXED) !=
+               __atomic_load_n(&m_now_serving, __ATOMIC_RELAXED);
+    }
     LockRank rank() const { return m_rank; }
 
 private:
-    volatile int      m_lock;
+    void took_lock(uint32_t cpu_id) {
+        m_owner_cpu = cpu_id;
+        m_recursion_count = 1;
+        if (m_rank != LockRank::None) {
+            m_prev_rank = current_cpu_lock_rank();
+            set_cpu_lock_rank(m_rank);
+        }
+    }
+
+#ifdef FKERNEL_LOCK_STAT
+    // Runs with the lock held, so the lazily bound class needs no locking
+    void record_acquire(uint64_t spin_start) {
+        if (!m_stats)
+            m_stats = lock_class(m_class_name ? m_class_name : lock_rank_class_name(m_rank));
+        uint64_t now = lock_stat_cycles();
+        __atomic_fetch_add(&m_stats->acquisitions, 1, __ATOMIC_RELAXED);
+        if (spin_start) {
+            __atomic_fetch_add(&m_stats->contended, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&m_stats->spin_cycles, now - spin_start, __ATOMIC_RELAXED);
+            lock_stat_raise(m_stats->max_spin_cycles, now - spin_start);
+        }
+        uint64_t rflags;
+        asm volatile("pushfq ; popq %0" : "=r"(rflags));
+        m_irqs_off = !(rflags & (1ULL << 9));
+        m_acquired_at = now;
+    }
+#endif
+
+    uint32_t          m_next_ticket;
+    uint32_t          m_now_serving;
     volatile uint32_t m_owner_cpu;
     volatile uint32_t m_recursion_count;
     LockRank          m_rank;
     LockRank          m_prev_rank{LockRank::None};
+#ifdef FKERNEL_LOCK_STAT
+    const char*       m_class_name{nullptr};
+    LockClassStats*   m_stats{nullptr};
+    uint64_t          m_acquired_at{0};
+    bool              m_irqs_off{false};
+#endif
 };
 
 /**
@@ -134,6 +212,18 @@ private:
     Spinlock& m_lock;
     bool m_interrupt_state;
 };
+#else
+/**
+ * @brief Host builds have no interrupts to mask; the lock alone is taken.
+ */
+class ScopedLockIRQ {
+public:
+    explicit ScopedLockIRQ(Spinlock& lock) : m_lock(lock) { m_lock.lock(); }
+    ~ScopedLockIRQ() { m_lock.unlock(); }
+
+private:
+    Spinlock& m_lock;
+};
 #endif
 
 } // namespace fk::synchronization
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <LibC/stddef.h>
+
+namespace fk {
+namespace containers {
+
+template <typename T> struct IntrusiveRBNode {
+  T *parent = nullptr;
+  T *left = nullptr;
+  T *right = nullptr;
+  bool red = false;
+};
+
+/** @brief Augment policy for trees that keep no per-subtree data. */
+struct RBNoAugment {
+  template <typename T> static void update(T &) {}
+};
+
+/**
+ * @brief Intrusive red-black tree with optional subtree augmentation.
+ *
+ * Unlike rb_tree, nodes are embedded in the caller's objects, so there is no
+ * node pool and removal releases nothing; the caller owns the objects.
+ * Less{}(a, b) orders them. Augment::update(node) recomputes per-subtree data
+ * from a node and its children; it runs bottom-up after every insert, remove
+ * and rotation, so a subtree maximum stays exact and can steer an O(log n)
+ * descent.
+ *
+ * Example:
+ *   IntrusiveRBTree<Vma, &Vma::rb_node, VmaLess, VmaGapAugment>
+ */
+template <typename T, IntrusiveRBNode<T> T::*NodeMember, typename Less,
+          typename Augment = RBNoAugment>
+class IntrusiveRBTree {
+public:
+  IntrusiveRBTree() = default;
+
+  IntrusiveRBTree(const IntrusiveRBTree &) = delete;
+  IntrusiveRBTree &operator=(const IntrusiveRBTree &) = delete;
+
+  IntrusiveRBTree(IntrusiveRBTree &&other) : m_root(other.m_root), m_size(other.m_size) {
+    other.m_root = nullptr;
+    other.m_size = 0;
+  }
+
+  IntrusiveRBTree &operator=(IntrusiveRBTree &&other) {
+    if (this != &other) {
+      m_root = other.m_root;
+      m_size = other.m_size;
+      other.m_root = nullptr;
+      other.m_size = 0;
+    }
+    return *this;
+  }
+
+  T *root() const { return m_root; }
+  size_t size() const { return m_size; }
+  bool is_empty() const { return m_size == 0; }
+
+  static T *left(const T &obj) { return (obj.*NodeMember).left; }
+  static T *right(const T &obj) { return (obj.*NodeMember).right; }
+  static T *parent(const T &obj) { return (obj.*NodeMember).parent; }
+
+  T *first() const { return m_root ? leftmost(m_root) : nullptr; }
+  T *last() const { return m_root ? rightmost(m_root) : nullptr; }
+
+  /** @brief In-order successor, or nullptr for the last node. */
+  static T *next(const T &obj) {
+    if (right(obj))
+      return leftmost(right(obj));
+    const T *cur = &obj;
+    T *p = parent(obj);
+    while (p && cur == right(*p)) {
+      cur = p;
+      p = parent(*p);
+    }
+    return p;
+  }
+
+  /** @brief In-order predecessor, or nullptr for the first node. */
+  static T *prev(const T &obj) {
+    if (left(obj))
+      return rightmost(left(obj));
+    const T *cur = &obj;
+    T *p = parent(obj);
+    while (p && cur == left(*p)) {
+      cur = p;
+      p = parent(*p);
+    }
+    return p;
+  }
+
+  /** @brief Links obj into the tree; equal keys go after existing ones. */
+  void insert(T &obj) {
+    T *p = nullptr;
+    T *cur = m_root;
+    bool go_left = false;
+    while (cur) {
+      p = cur;
+      go_left = Less{}(obj, *cur);
+      cur = go_left ? left(*cur) : right(*cur);
+    }
+
+    auto &node = obj.*NodeMember;
+    node.parent = p;
+    node.left = nullptr;
+    node.right = nullptr;
+    node.red = true;
+    if (!p)
+      m_root = &obj;
+    else if (go_left)
+      link(p).left = &obj;
+    else
+      link(p).right = &obj;
+    ++m_size;
+
+    // Rotations keep each rotated subtree's node set, so fixing the path
+    // first leaves the ancestors valid through the rebalance.
+    propagate(&obj);
+    insert_fixup(&obj);
+  }
+
+  /** @brief Unlinks obj, which must be in this tree. */
+  void remove(T &obj) {
+    T *z = &obj;
+    T *x = nullptr;
+    T *x_parent = nullptr;
+    bool removed_red = link(z).red;
+
+    if (!left(*z)) {
+      x = right(*z);
+      x_parent = parent(*z);
+      transplant(z, x);
+    } else if (!right(*z)) {
+      x = left(*z);
+      x_parent = parent(*z);
+      transplant(z, x);
+    } else {
+      // Splice the successor into z's position
+      T *y = leftmost(right(*z));
+      removed_red = link(y).red;
+      x = right(*y);
+      if (parent(*y) == z) {
+        x_parent = y;
+      } else {
+        x_parent = parent(*y);
+        transplant(y, x);
+        link(y).right = right(*z);
+        link(right(*z)).parent = y;
+      }
+      transplant(z, y);
+      link(y).left = left(*z);
+      link(left(*z)).parent = y;
+      link(y).red = link(z).red;
+    }
+
+    link(z) = IntrusiveRBNode<T>{};
+    --m_size;
+
+    propagate(x_parent);
+    if (!removed_red)
+      remove_fixup(x, x_parent);
+  }
+
+  /** @brief Recomputes augmented data from obj up to the root. */
+  void propagate(T *obj) {
+    for (; obj; obj = parent(*obj))
+      Augment::update(*obj);
+  }
+
+  /** @brief Forgets every node without touching them; the caller frees them. */
+  void clear() {
+    m_root = nullptr;
+    m_size = 0;
+  }
+
+private:
+  T *m_root = nullptr;
+  size_t m_size = 0;
+
+  static IntrusiveRBNode<T> &link(T *obj) { return obj->*NodeMember; }
+  static bool is_red(T *obj) { return obj && link(obj).red; }
+
+  static T *leftmost(T *obj) {
+    while (left(*obj))
+      obj = left(*obj);
+    return obj;
+  }
+
+  static T *rightmost(T *obj) {
+    while (right(*obj))
+      obj = right(*obj);
+    return obj;
+  }
+
+  void transplant(T *u, T *v) {
+    T *p = parent(*u);
+    if (!p)
+      m_root = v;
+    else if (u == left(*p))
+      link(p).left = v;
+    else
+      link(p).right = v;
+    if (v)
+      link(v).parent = p;
+  }
+
+  void rotate_left(T *x) {
+    T *y = right(*x);
+    link(x).right = left(*y);
+    if (left(*y))
+      link(left(*y)).parent = x;
+    transplant(x, y);
+    link(y).left = x;
+    link(x).parent = y;
+    Augment::update(*x);
+    Augment::update(*y);
+  }
+
+  void rotate_right(T *x) {
+    T *y = left(*x);
+    link(x).left = right(*y);
+    if (right(*y))
+      link(right(*y)).parent = x;
+    transplant(x, y);
+    link(y).right = x;
+    link(x).parent = y;
+    Augment::update(*x);
+    Augment::update(*y);
+  }
+
+  void insert_fixup(T *n) {
+    while (is_red(parent(*n))) {
+      T *p = parent(*n);
+      T *g = parent(*p);
+      bool p_is_left = p == left(*g);
+      T *uncle = p_is_left ? right(*g) : left(*g);
+
+      if (is_red(uncle)) {
+        link(p).red = false;
+        link(uncle).red = false;
+        link(g).red = true;
+        n = g;
+        continue;
+      }
+
+      if (n == (p_is_left ? right(*p) : left(*p))) {
+        if (p_is_left)
+          rotate_left(p);
+        else
+          rotate_right(p);
+        n = p;
+        p = parent(*n);
+      }
+      link(p).red = false;
+      link(g).red = true;
+      if (p_is_left)
+        rotate_right(g);
+      else
+        rotate_left(g);
+    }
+    link(m_root).red = false;
+  }
+
+  // x may be null; x_parent disambiguates its side. The sibling of a
+  // doubly-black position always exists, so a null x is the null child.
+  void remove_fixup(T *x, T *x_parent) {
+    while (x != m_root && !is_red(x)) {
+      bool x_is_left = x == left(*x_parent);
+      T *w = x_is_left ? right(*x_parent) : left(*x_parent);
+
+      if (is_red(w)) {
+        link(w).red = false;
+        link(x_parent).red = true;
+        if (x_is_left)
+          rotate_left(x_parent);
+        else
+          rotate_right(x_parent);
+        w = x_is_left ? right(*x_parent) : left(*x_parent);
+      }
+
+      T *near = x_is_left ? left(*w) : right(*w);
+      T *far = x_is_left ? right(*w) : left(*w);
+      if (!is_red(near) && !is_red(far)) {
+        link(w).red = true;
+        x = x_parent;
+        x_parent = parent(*x);
+        continue;
+      }
+
+      if (!is_red(far)) {
+        link(near).red = false;
+        link(w).red = true;
+        if (x_is_left)
+          rotate_right(w);
+        else
+          rotate_left(w);
+        w = x_is_left ? right(*x_parent) : left(*x_parent);
+        far = x_is_left ? right(*w) : left(*w);
+      }
+
+      link(w).red = link(x_parent).red;
+      link(x_parent).red = false;
+      if (far)
+        link(far).red = false;
+      if (x_is_left)
+        rotate_left(x_parent);
+      else
+        rotate_right(x_parent);
+      x = m_root;
+      break;
+    }
+    if (x)
+      link(x).red = false;
+  }
+};
+
+} // namespace containers
+} // namespace fk
@@ -64,9 +64,58 @@ function InitrdBuilder.build_component(name, config, staging_path)
   return false
 end
 
+-- Pads the archive so the data of every regular file of a page or more
+-- starts on a 4 KiB boundary; the kernel then maps those pages straight from
+-- the initrd instead of copying them. The padding repeats the leading "./"
+-- entry, which the kernel skips and tar re-creates harmlessly.
+function InitrdBuilder.align_tar(tar_path)
+  local f = io.open(tar_path, "rb")
+  if not f then return false end
+  local data = f:read("*a")
+  f:close()
+
+  local pad = data:sub(1, 512)
+  if pad:sub(1, 3) ~= "./\0" then return true end
+
+  local out, written = {}, 0
+  local group, group_len = {}, 0
+  local pos = 1
+  while pos + 511 <= #data and data:byte(pos) ~= 0 do
+    local header = data:sub(pos, pos + 511)
+    local size = tonumber(header:sub(125, 136):match("[0-7]+") or "0", 8)
+    local entry_len = 512 + math.floor((size + 511) / 512) * 512
+    local kind = header:sub(157, 157)
+    group[#group + 1] = data:sub(pos, pos + entry_len - 1)
+    group_len = group_len + entry_len
+    pos = pos + entry_len
+
+    -- GNU long names and pax headers belong to the entry that follows them
+    if kind ~= "L" and kind ~= "K" and kind ~= "x" and kind ~= "g" then
+      if (kind == "0" or kind == "\0") and size >= 4096 then
+        local data_start = written + group_len - (entry_len - 512)
+        while data_start % 4096 ~= 0 do
+          out[#out + 1] = pad
+          written = written + 512
+          data_start = data_start + 512
+        end
+      end
+      for _, entry in ipairs(group) do out[#out + 1] = entry end
+      written = written + group_len
+      group, group_len = {}, 0
+    end
+  end
+  out[#out + 1] = string.rep("\0", 1024)
+
+  f = io.open(tar_path, "wb")
+  if not f then return false end
+  f:write(table.concat(out))
+  f:close()
+  return true
+end
+
 function InitrdBuilder.pack_tar(staging_path, output_tar)
   local cmd = string.format("tar -cf %s -C %s .", output_tar, staging_path)
-  if RunCommand(cmd) then
+  if RunCommand(cmd) and InitrdBuilder.align_tar(output_tar) then
     PrintMessage(false, "Packaged initrd: " .. output_tar)
     return true
   end
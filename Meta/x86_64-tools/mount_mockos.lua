@@ -14,7 +14,7 @@ local TAR_OUTPUT = "build/initrd.tar"
 local ONLY_INITRD = arg[1] == "--only-initrd"
 
 -- Read config before the staleness check (system type affects what to track)
-local config = { COMPONENTS = "init,shell,ls,cat,uname,clear", SYSTEM_TYPE = "minimal" }
+local config = { COMPONENTS = "init,shell,ls,cat,uname,clear,tracecat", SYSTEM_TYPE = "minimal" }
 local f = io.open(CONFIG_FILE, "r")
 if f then
   for line in f:lines() do
@@ -102,7 +102,7 @@ fk::core::Result<void, fk::core::Error> VESADriver::set_mode(uint16_t mode) {
         // Map pages for the framebuffer
         for (uintptr_t offset = 0; offset < lfb_size; offset += 0x1000) {
             MemoryManager::the().map_page(lfb_phys + offset, lfb_phys + offset, 
-                                          PageFlags::Present | PageFlags::Writable | PageFlags::CacheDisabled);
+                                          PageFlags::Present | PageFlags::Writable | PageFlags::WriteCombining);
         }
     }
 
@@ -1,6 +1,7 @@
 #include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
 #include <LibFK/Algorithms/log.h>
+#include <LibFK/Synchronization/spinlock.h>
 
 extern "C" void arch_cpuid(uint32_t leaf, uint32_t subleaf,
                             uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
@@ -28,6 +29,7 @@ extern "C" void arch_enable_cpu_features(bool has_smep, bool has_smap, bool has_
   asm volatile("mov %%cr0, %0" : "=r"(cr0));
   cr0 &= ~(1ULL << 2); // Clear EM (Emulation)
   cr0 |= (1ULL << 1);  // Set MP (Monitor Coprocessor)
+  cr0 |= (1ULL << 16); // WP: kernel writes honour read-only (copy-on-write) pages
   asm volatile("mov %0, %%cr0" ::"r"(cr0));
 
   asm volatile("mov %%cr4, %0" : "=r"(cr4));
@@ -85,3 +87,47 @@ extern "C" void arch_smap_begin() {
 extern "C" void arch_smap_end() {
   asm volatile("clac" ::: "memory");
 }
+
+extern "C" uint64_t arch_read_tsc() {
+  uint32_t lo, hi;
+  asm volatile("lfence\nrdtsc" : "=a"(lo), "=d"(hi) : : "memory");
+  return (static_cast<uint64_t>(hi) << 32) | lo;
+}
+
+// Shares the spinlock owner reader, so callers before init_syscalls() get the
+// boot CPU instead of whatever the firmware left at gs:32
+extern "C" uint32_t arch_current_cpu_id() {
+  return fk::synchronization::current_cpu_slot() - 1;
+}
+
+extern "C" void arch_enable_tlb_features(bool enable_pcid) {
+  uint64_t cr4;
+  asm volatile("mov %%cr4, %0" : "=r"(cr4));
+  cr4 |= (1ULL << 7); // PGE: keep global entries across CR3 loads
+  if (enable_pcid)
+    cr4 |= (1ULL << 17); // PCIDE: tag TLB entries with CR3[11:0]
+  asm volatile("mov %0, %%cr4" ::"r"(cr4) : "memory");
+}
+
+extern "C" void arch_program_pat() {
+  constexpr uint32_t MSR_PAT = 0x277;
+  // One byte per entry: 6 = WB, 4 = WT, 7 = UC-, 0 = UC, 1 = WC
+  constexpr uint64_t PAT_LAYOUT = 0x0007040100070406ULL;
+  // No line may stay cached under a type that is about to change
+  asm volatile("wbinvd" ::: "memory");
+  arch_write_msr(MSR_PAT, PAT_LAYOUT);
+  asm volatile("wbinvd" ::: "memory");
+}
+
+extern "C" void arch_load_cr3(uint64_t value) {
+  asm volatile("mov %0, %%cr3" ::"r"(value) : "memory");
+}
+
+extern "C" void arch_flush_tlb_all() {
+  uint64_t flags = arch_save_flags_and_disable();
+  uint64_t cr4;
+  asm volatile("mov %%cr4, %0" : "=r"(cr4));
+  asm volatile("mov %0, %%cr4" ::"r"(cr4 ^ (1ULL << 7)) : "memory");
+  asm volatile("mov %0, %%cr4" ::"r"(cr4) : "memory");
+  arch_restore_flags(flags);
+}
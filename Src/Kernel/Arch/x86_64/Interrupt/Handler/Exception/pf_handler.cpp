@@ -1,51 +1,106 @@
 #include <Kernel/Arch/x86_64/Interrupt/Handler/exception_macros.h>
 #include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
+#include <Kernel/Memory/VirtualMemory/file_page_cache.h>
 #include <Kernel/Memory/VirtualMemory/Pages/page_flags.h>
+#include <Kernel/Memory/VirtualMemory/transparent_huge_pages.h>
 #include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Utilities/memory.h>
 #include <LibFK/Algorithms/log.h>
 
-static void handle_demand_paging(Task*, uint64_t cr2, InterruptFrame*) {
-  uintptr_t vaddr = cr2 & ~0xFFFULL;
+static bool map_private_page(uintptr_t vaddr, PageFlags flags, const void* src, size_t length) {
   uintptr_t phys = PhysicalMemoryManager::the().alloc_page();
+  if (!phys)
+    return false;
+  auto* bytes = reinterpret_cast<uint8_t*>(phys);
+  if (length)
+    fk::memory::copy(bytes, src, length);
+  fk::memory::set(bytes + length, 0, 0x1000 - length);
+  VirtualMemoryManager::the().map_page(vaddr, phys, flags);
+  return true;
+}
 
-  VirtualMemoryManager::the().map_page(vaddr, phys,
-                                       PageFlags::Present | PageFlags::Writable | PageFlags::User);
+// Pages wholly inside the file data map the cached frame itself; a writable
+// mapping gets it read-only and copies it on the first write. The page that
+// holds the end of the file data is private, zeroed past it.
+static bool handle_file_fault(const fkernel::Vma& vma, uintptr_t vaddr, PageFlags flags) {
+  if (vaddr >= vma.file_end)
+    return map_private_page(vaddr, flags, nullptr, 0);
 
-  fk::memory::set(reinterpret_cast<void*>(vaddr), 0, 0x1000);
+  auto frame_res =
+      fkernel::FilePageCache::the().get_page(vma.file, vma.file_offset + (vaddr - vma.start));
+  if (frame_res.is_error())
+    return false;
+  uintptr_t frame = frame_res.value();
+
+  if (vaddr + 0x1000 <= vma.file_end) {
+    uint64_t shared = (static_cast<uint64_t>(flags) | static_cast<uint64_t>(PageFlags::Shared)) &
+                      ~static_cast<uint64_t>(PageFlags::Writable);
+    VirtualMemoryManager::the().map_page(vaddr, frame, static_cast<PageFlags>(shared));
+    return true;
+  }
+  return map_private_page(vaddr, flags, reinterpret_cast<const void*>(frame),
+                          vma.file_end - vaddr);
 }
 
-static void handle_write_protection(Task*, uint64_t cr2) {
+static bool handle_demand_paging(Task* task, const fkernel::Vma& vma, uint64_t cr2) {
+  PageFlags flags = vma.flags | PageFlags::Present | PageFlags::User;
+  uintptr_t vaddr = cr2 & ~0xFFFULL;
+  if (vma.is_file_backed())
+    return handle_file_fault(vma, vaddr, flags);
+
+  bool anonymous = vma.kind == fkernel::VmaKind::Anonymous || vma.kind == fkernel::VmaKind::Heap;
+  if (anonymous &&
+      fkernel::TransparentHugePages::the().try_map(task, cr2, vma.start, vma.end, flags))
+    return true;
+
+  return map_private_page(vaddr, flags, nullptr, 0);
+}
+
+static bool handle_write_protection(Task*, const fkernel::Vma& vma, uint64_t cr2) {
   uintptr_t vaddr = cr2 & ~0xFFFULL;
 
   auto flags_res = VirtualMemoryManager::the().get_page_flags(vaddr);
   if (flags_res.is_error())
-    return;
+    return false;
 
   PageFlags current = flags_res.value();
-  // error_code & 4 is always set when this is called — enforce User bit for CPL3 access
+  if (current & PageFlags::Shared) {
+    // Copy-on-write of a page-cache frame; other shared frames stay read-only
+    if (!vma.is_file_backed())
+      return false;
+    uintptr_t frame = VirtualMemoryManager::the().translate(vaddr);
+    return map_private_page(vaddr, vma.flags | PageFlags::Present | PageFlags::User,
+                            reinterpret_cast<const void*>(frame), 0x1000);
+  }
+
+  // A user write, or a kernel write on the user's behalf: enforce the User bit
   PageFlags fixed = current | PageFlags::Writable | PageFlags::User;
   VirtualMemoryManager::the().protect_page(vaddr, fixed);
+  return true;
 }
 
 void page_fault_handler(uint8_t vector, InterruptFrame* frame) {
   uint64_t cr2;
   asm volatile("mov %%cr2, %0" : "=r"(cr2));
 
+  // Kernel accesses to user memory (copy_to_user, relocations) fault pages in
+  // the same way the user's own accesses do
   auto* task = SchedulerManager::the().current();
-  if (task && !task->is_a_kernel_task() && (frame->error_code & 4)) {
+  bool user_access = task && !task->is_a_kernel_task() &&
+                     ((frame->error_code & 4) || fkernel::memory::is_user_address(cr2, 1));
+  if (user_access) {
     bool not_present = !(frame->error_code & 1);
     bool write_fault = (frame->error_code & 2) != 0;
 
-    if (not_present && task->is_address_in_allowed_regions(cr2)) {
-      handle_demand_paging(task, cr2, frame);
-      return;
-    }
-
-    if (write_fault && (frame->error_code & 1) && task->is_address_in_allowed_regions(cr2)) {
-      handle_write_protection(task, cr2);
-      return;
+    fkernel::Vma vma;
+    if (task->find_vma(cr2, vma)) {
+      if (not_present && handle_demand_paging(task, vma, cr2))
+        return;
+      if (!not_present && write_fault && vma.is_writable() &&
+          handle_write_protection(task, vma, cr2))
+        return;
     }
   }
 
@@ -57,7 +112,7 @@ void page_fault_handler(uint8_t vector, InterruptFrame* frame) {
       (frame->error_code & 16) ? "Instruction Fetch" : "Data Access", (void*)frame->rip,
       (void*)frame->rsp, (void*)cr2, task ? task->control.identity.id.value() : 0);
 
-  if (task && !task->is_a_kernel_task() && (frame->error_code & 4)) {
+  if (user_access) {
     fk::algorithms::kerror("PF", "User-mode Page Fault. Killing process %lu",
                            task->control.identity.id.value());
     SchedulerManager::the().terminate_current(-11);
@@ -0,0 +1,9 @@
+#include <Kernel/Arch/x86_64/Interrupt/Handler/handlers.h>
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/hardware_interrupt_manager.h>
+#include <Kernel/Driver/Serial/serial_port.h>
+
+void serial_handler(uint8_t vector, InterruptFrame* frame) {
+    (void)frame;
+    serial::handle_interrupt();
+    HardwareInterruptManager::the().send_eoi(vector);
+}
@@ -164,6 +164,17 @@ APIC::allocate_msix_vector(const PciDevice& device, uint16_t entry) {
 void APIC::enable_msi(uint8_t vector) { (void)vector; }
 void APIC::disable_msi(uint8_t vector) { (void)vector; }
 
+fk::core::Result<void, fk::core::Error> APIC::send_ipi(uint32_t apic_id, uint8_t vector) {
+  if (!lapic_base)
+    return fk::core::Error::NotImplemented;
+  // Writing the low half sends; wait for the previous IPI to leave first
+  while (read(APIC_REG_ICR_LOW) & APIC_ICR_DELIVERY_PENDING)
+    asm volatile("pause");
+  write(APIC_REG_ICR_HIGH, (apic_id & 0xFF) << 24);
+  write(APIC_REG_ICR_LOW, vector | APIC_ICR_LEVEL_ASSERT);
+  return {};
+}
+
 uint32_t APIC::get_id() const {
   if (!lapic_base)
     return 0;
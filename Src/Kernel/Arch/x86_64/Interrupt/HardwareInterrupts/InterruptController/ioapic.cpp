@@ -105,3 +105,10 @@ void IOAPIC::disable_msi(uint8_t vector) {
     (void)vector;
     // TODO: Track which device owns this vector to disable it
 }
+
+fk::core::Result<void, fk::core::Error> IOAPIC::send_ipi(uint32_t apic_id, uint8_t vector) {
+  // IPIs leave through the local APIC, like EOIs
+  if (CPU::the().has_x2apic())
+    return X2APIC::the().send_ipi(apic_id, vector);
+  return APIC::the().send_ipi(apic_id, vector);
+}
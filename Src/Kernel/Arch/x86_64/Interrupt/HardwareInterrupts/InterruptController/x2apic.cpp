@@ -86,3 +86,10 @@ X2APIC::allocate_msi_vector(const PciDevice& device) {
 
 void X2APIC::enable_msi(uint8_t vector) { (void)vector; }
 void X2APIC::disable_msi(uint8_t vector) { (void)vector; }
+
+fk::core::Result<void, fk::core::Error> X2APIC::send_ipi(uint32_t apic_id, uint8_t vector) {
+  // One MSR write carries destination and command; no delivery-status polling
+  CPU::the().write_msr(X2APIC_ICR_MSR, (static_cast<uint64_t>(apic_id) << 32) | vector |
+                                           APIC_ICR_LEVEL_ASSERT);
+  return {};
+}
@@ -118,3 +118,10 @@ void HardwareInterruptManager::disable_msi(uint8_t vector) {
   if (m_controller)
     m_controller->disable_msi(vector);
 }
+
+fk::core::Result<void, fk::core::Error> HardwareInterruptManager::send_ipi(uint32_t apic_id,
+                                                                          uint8_t vector) {
+  if (!m_controller)
+    return fk::core::Error::NotImplemented;
+  return m_controller->send_ipi(apic_id, vector);
+}
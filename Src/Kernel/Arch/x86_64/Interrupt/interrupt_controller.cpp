@@ -57,6 +57,7 @@ void InterruptController::initialize() {
   // NOTE: Interrupt Routine
   register_interrupt(timer_handler, 32);         // IRQ0 -> timer
   register_interrupt(keyboard_handler, 33);      // IRQ1 -> keyboard
+  register_interrupt(serial_handler, 36);        // IRQ4 -> COM1
   register_interrupt(mouse_handler, 44);         // IRQ12 -> PS/2 Mouse
   register_interrupt(clock_handler, 40);         // IRQ8 -> Clock;
   register_interrupt(ata_primary_handler, 46);   // IRQ14 -> primary ATA
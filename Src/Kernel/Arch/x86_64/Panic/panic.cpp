@@ -31,6 +31,7 @@ void print_stack_trace() {
 
 void __kernel_assert_fail(const char *expr, const char *file, int line,
                           const char *func) {
+  fk::algorithms::enter_panic_mode();
   uint32_t cpu_id = APIC::the().get_id();
   
   fk::algorithms::kexception("PANIC", "!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
@@ -47,6 +48,7 @@ void __kernel_assert_fail(const char *expr, const char *file, int line,
 }
 
 void panic(const char *reason) {
+  fk::algorithms::enter_panic_mode();
   uint32_t cpu_id = APIC::the().get_id();
   
   fk::algorithms::kexception("PANIC", "!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
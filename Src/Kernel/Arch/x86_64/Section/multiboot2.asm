@@ -25,6 +25,13 @@ header_start:
   dd 0          ; Height (0 = auto-detect best resolution)
   dd 32         ; BPP
 
+  ; Module Alignment Tag (Type 6) - load modules on page boundaries so
+  ; initrd file data can be mapped in place
+  align 8
+  dw 6          ; Type
+  dw 0          ; Flags
+  dd 8          ; Size
+
   ; End tag obrigatório
   align 8
   dw 0          ; Type
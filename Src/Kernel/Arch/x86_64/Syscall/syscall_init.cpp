@@ -3,6 +3,7 @@
 #include <Kernel/Hardware/Cpu/cpu.h>
 #include <Kernel/Hardware/Cpu/cpu_block.h>
 #include <LibFK/Algorithms/log.h>
+#include <LibFK/Synchronization/spinlock.h>
 
 extern "C" void syscall_stub();
 extern "C" uint64_t stack_top;
@@ -11,6 +12,10 @@ extern "C" uint64_t syscall_kernel_stack;
 // Global instance for single-core (TODO: Multi-core array)
 CpuControlBlock g_cpu_block;
 
+static_assert(offsetof(CpuControlBlock, cpu_id) ==
+                  fk::synchronization::GS_CPU_ID_OFFSET,
+              "Spinlock reads the CPU id at a fixed GS offset");
+
 // MSR for Kernel GS Base
 #define MSR_KERNEL_GS_BASE 0xC0000102
 
@@ -28,6 +33,7 @@ void init_syscalls() {
 
   // Since we are already in kernel mode, GS prefix should now work and 
   // point to g_cpu_block because we wrote to MSR_GS_BASE.
+  fk::synchronization::g_gs_cpu_id_ready = true;
 
   // Also initialize existing global for compatibility during transition
   syscall_kernel_stack = (uint64_t)&stack_top;
@@ -0,0 +1,294 @@
+[BITS 64]
+
+; vDSO image: a minimal ELF64 shared object (linux-vdso.so.1 compatible) that
+; VdsoMapper copies into one shared frame and maps into every process right
+; after the TimeKeeper data page. musl finds it through AT_SYSINFO_EHDR and
+; resolves __vdso_clock_gettime via DT_HASH/DT_SYMTAB, so no versioning tables.
+;
+; Layout inside the image (vaddr == file offset, PT_LOAD starts at 0):
+;   ELF header | program headers | section headers | hash | dynsym | dynstr
+;   | dynamic | text
+
+global vdso_image_start
+global vdso_image_end
+
+; VdsoData lives one page below the image (see Include/Kernel/Clock/Vdso/vdso_data.h)
+%define VDSO_DATA            (vdso_image_start - 0x1000)
+%define VD_SEQ               0
+%define VD_FLAGS             4
+%define VD_TSC_BASE          8
+%define VD_TSC_MULT          16
+%define VD_MONO_BASE         24
+%define VD_REALTIME_OFF      32
+%define VD_BOOTTIME_OFF      40
+%define VDSO_FLAG_TSC_USABLE 1
+
+%define CLOCK_REALTIME         0
+%define CLOCK_MONOTONIC        1
+%define CLOCK_MONOTONIC_RAW    4
+%define CLOCK_REALTIME_COARSE  5
+%define CLOCK_MONOTONIC_COARSE 6
+%define CLOCK_BOOTTIME         7
+
+%define SYS_GETTIMEOFDAY  96
+%define SYS_CLOCK_GETTIME 228
+
+%define NS_PER_SEC 1000000000
+
+%define IMG(label) ((label) - vdso_image_start)
+%define STR(label) ((label) - dynstr)
+
+%define STB_GLOBAL 1
+%define STB_WEAK   2
+%define STT_FUNC   2
+%define TEXT_SHNDX 1
+
+; Elf64_Sym: name, binding, function label
+%macro VDSO_SYMBOL 3
+    dd STR(%1)
+    db (%2 << 4) | STT_FUNC
+    db 0
+    dw TEXT_SHNDX
+    dq IMG(%3)
+    dq %3_end - %3
+%endmacro
+
+section .rodata
+align 4096
+vdso_image_start:
+
+; --- Elf64_Ehdr ---
+    db 0x7F, "ELF", 2, 1, 1, 0      ; ELFCLASS64, ELFDATA2LSB, EV_CURRENT, SYSV
+    times 8 db 0
+    dw 3                            ; ET_DYN
+    dw 62                           ; EM_X86_64
+    dd 1                            ; EV_CURRENT
+    dq 0                            ; e_entry
+    dq IMG(phdrs)                   ; e_phoff
+    dq IMG(shdrs)                   ; e_shoff
+    dd 0                            ; e_flags
+    dw 64                           ; e_ehsize
+    dw 56                           ; e_phentsize
+    dw 2                            ; e_phnum
+    dw 64                           ; e_shentsize
+    dw 2                            ; e_shnum
+    dw 0                            ; e_shstrndx (no section names)
+
+; --- Elf64_Phdr[2] ---
+phdrs:
+    dd 1                            ; PT_LOAD
+    dd 5                            ; PF_R | PF_X
+    dq 0                            ; p_offset
+    dq 0                            ; p_vaddr
+    dq 0                            ; p_paddr
+    dq IMG(vdso_image_end)          ; p_filesz
+    dq IMG(vdso_image_end)          ; p_memsz
+    dq 0x1000                       ; p_align
+
+    dd 2                            ; PT_DYNAMIC
+    dd 4                            ; PF_R
+    dq IMG(dynamic)
+    dq IMG(dynamic)
+    dq IMG(dynamic)
+    dq dynamic_end - dynamic
+    dq dynamic_end - dynamic
+    dq 8
+
+; --- Elf64_Shdr[2]: null + .text (symbols need a non-zero st_shndx) ---
+shdrs:
+    times 64 db 0
+    dd 0                            ; sh_name
+    dd 1                            ; SHT_PROGBITS
+    dq 6                            ; SHF_ALLOC | SHF_EXECINSTR
+    dq IMG(text)                    ; sh_addr
+    dq IMG(text)                    ; sh_offset
+    dq text_end - text              ; sh_size
+    dd 0                            ; sh_link
+    dd 0                            ; sh_info
+    dq 16                           ; sh_addralign
+    dq 0                            ; sh_entsize
+
+; --- DT_HASH: one bucket, every symbol chained in order ---
+align 8
+hash:
+    dd 1                            ; nbucket
+    dd 7                            ; nchain == symbol count
+    dd 1                            ; bucket[0]
+    dd 0, 2, 3, 4, 5, 6, 0          ; chain[0..6]
+
+; --- DT_SYMTAB ---
+align 8
+dynsym:
+    times 24 db 0                   ; STN_UNDEF
+    VDSO_SYMBOL str_vdso_clock_gettime, STB_GLOBAL, vdso_clock_gettime
+    VDSO_SYMBOL str_vdso_gettimeofday, STB_GLOBAL, vdso_gettimeofday
+    VDSO_SYMBOL str_vdso_time, STB_GLOBAL, vdso_time
+    VDSO_SYMBOL str_clock_gettime, STB_WEAK, vdso_clock_gettime
+    VDSO_SYMBOL str_gettimeofday, STB_WEAK, vdso_gettimeofday
+    VDSO_SYMBOL str_time, STB_WEAK, vdso_time
+
+; --- DT_STRTAB ---
+dynstr:
+    db 0
+str_vdso_clock_gettime: db "__vdso_clock_gettime", 0
+str_vdso_gettimeofday:  db "__vdso_gettimeofday", 0
+str_vdso_time:          db "__vdso_time", 0
+str_clock_gettime:      db "clock_gettime", 0
+str_gettimeofday:       db "gettimeofday", 0
+str_time:               db "time", 0
+str_soname:             db "linux-vdso.so.1", 0
+dynstr_end:
+
+; --- DT_DYNAMIC ---
+align 8
+dynamic:
+    dq 4, IMG(hash)                 ; DT_HASH
+    dq 5, IMG(dynstr)               ; DT_STRTAB
+    dq 6, IMG(dynsym)               ; DT_SYMTAB
+    dq 10, dynstr_end - dynstr      ; DT_STRSZ
+    dq 11, 24                       ; DT_SYMENT
+    dq 14, STR(str_soname)          ; DT_SONAME
+    dq 0, 0                         ; DT_NULL
+dynamic_end:
+
+; --- Code (position independent, runs in ring 3) ---
+align 16
+text:
+
+; Reads the TSC-based clock under the VdsoData sequence counter.
+; In:  r9  = VdsoData offset of an int64 added to monotonic time (0 = none)
+; Out: rax = nanoseconds, CF set when the TSC is unusable (take the syscall)
+; Clobbers rcx, rdx, r8, r10.
+vdso_read_ns:
+    lea r10, [rel VDSO_DATA]
+.retry:
+    mov r8d, [r10 + VD_SEQ]
+    test r8d, 1
+    jnz .busy
+    test dword [r10 + VD_FLAGS], VDSO_FLAG_TSC_USABLE
+    jz .unusable
+    lfence
+    rdtsc
+    shl rdx, 32
+    or rax, rdx
+    sub rax, [r10 + VD_TSC_BASE]
+    mul qword [r10 + VD_TSC_MULT]
+    shrd rax, rdx, 32
+    add rax, [r10 + VD_MONO_BASE]
+    test r9, r9
+    jz .check
+    add rax, [r10 + r9]
+.check:
+    cmp r8d, [r10 + VD_SEQ]
+    jne .retry
+    clc
+    ret
+.busy:
+    pause
+    jmp .retry
+.unusable:
+    stc
+    ret
+
+; int __vdso_clock_gettime(clockid_t clk (edi), struct timespec *ts (rsi))
+vdso_clock_gettime:
+    cmp edi, CLOCK_REALTIME
+    je .realtime
+    cmp edi, CLOCK_REALTIME_COARSE
+    je .realtime
+    cmp edi, CLOCK_MONOTONIC
+    je .monotonic
+    cmp edi, CLOCK_MONOTONIC_RAW
+    je .monotonic
+    cmp edi, CLOCK_MONOTONIC_COARSE
+    je .monotonic
+    cmp edi, CLOCK_BOOTTIME
+    je .boottime
+    jmp .syscall
+.realtime:
+    mov r9d, VD_REALTIME_OFF
+    jmp .read
+.boottime:
+    mov r9d, VD_BOOTTIME_OFF
+    jmp .read
+.monotonic:
+    xor r9d, r9d
+.read:
+    call vdso_read_ns
+    jc .syscall
+    xor edx, edx
+    mov rcx, NS_PER_SEC
+    div rcx
+    mov [rsi], rax
+    mov [rsi + 8], rdx
+    xor eax, eax
+    ret
+.syscall:
+    mov eax, SYS_CLOCK_GETTIME
+    syscall
+    ret
+vdso_clock_gettime_end:
+
+; int __vdso_gettimeofday(struct timeval *tv (rdi), struct timezone *tz (rsi))
+vdso_gettimeofday:
+    test rdi, rdi
+    jz .timezone
+    mov r9d, VD_REALTIME_OFF
+    call vdso_read_ns
+    jc .syscall
+    xor edx, edx
+    mov rcx, NS_PER_SEC
+    div rcx
+    mov [rdi], rax
+    mov rax, rdx
+    xor edx, edx
+    mov ecx, 1000
+    div rcx
+    mov [rdi + 8], rax
+.timezone:
+    test rsi, rsi
+    jz .done
+    mov qword [rsi], 0              ; tz_minuteswest = tz_dsttime = 0
+.done:
+    xor eax, eax
+    ret
+.syscall:
+    mov eax, SYS_GETTIMEOFDAY
+    syscall
+    ret
+vdso_gettimeofday_end:
+
+; time_t __vdso_time(time_t *t (rdi))
+vdso_time:
+    mov r9d, VD_REALTIME_OFF
+    call vdso_read_ns
+    jc .syscall
+    xor edx, edx
+    mov rcx, NS_PER_SEC
+    div rcx
+.store:
+    test rdi, rdi
+    jz .done
+    mov [rdi], rax
+.done:
+    ret
+.syscall:
+    ; There is no SYS_time; ask clock_gettime(CLOCK_REALTIME) on the stack.
+    push rdi
+    sub rsp, 16
+    xor edi, edi
+    mov rsi, rsp
+    mov eax, SYS_CLOCK_GETTIME
+    syscall
+    mov rcx, rax
+    mov rax, [rsp]
+    add rsp, 16
+    pop rdi
+    test rcx, rcx
+    jz .store
+    mov rax, rcx
+    ret
+vdso_time_end:
+
+text_end:
+vdso_image_end:
@@ -1,15 +1,10 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
 #include <Kernel/Boot/boot_timer.h>
 #include <LibFK/Algorithms/log.h>
 
-static inline uint64_t rdtsc_with_lfence() {
-  uint32_t lo, hi;
-  asm volatile("lfence\nrdtsc" : "=a"(lo), "=d"(hi));
-  return (static_cast<uint64_t>(hi) << 32) | lo;
-}
-
 void BootTimer::mark(const char* name) {
   if (m_count < MAX_MARKS) {
-    m_marks[m_count++] = {name, rdtsc_with_lfence()};
+    m_marks[m_count++] = {name, arch_read_tsc()};
   }
 }
 
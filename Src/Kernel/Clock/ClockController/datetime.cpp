@@ -9,6 +9,29 @@ fk::text::String DateTime::to_string() const {
   return fk::text::String(buffer);
 }
 
+static bool is_leap_year(int year) {
+  return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+int64_t DateTime::to_unix_epoch() const {
+  if (year < 1970)
+    return 0;
+
+  static const int days_in_month[] = {0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int64_t days = 0;
+  for (int y = 1970; y < year; ++y)
+    days += is_leap_year(y) ? 366 : 365;
+
+  for (int m = 1; m < month && m <= 12; ++m) {
+    days += days_in_month[m];
+    if (m == 2 && is_leap_year(year))
+      days++;
+  }
+
+  days += day - 1;
+  return days * 86400LL + hour * 3600LL + minute * 60LL + second;
+}
+
 void DateTime::print() {
   fk::algorithms::klog("CLOCK MANAGER", "%02u/%02u/%04u %02u:%02u:%02u", day,
                        month, year, hour, minute, second);
@@ -0,0 +1,111 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/TimerController/hpet.h>
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/TimerController/pit.h>
+#include <Kernel/Arch/x86_64/io.h>
+#include <Kernel/Clock/ClockSource/tsc_clock_source.h>
+#include <Kernel/Hardware/Acpi/acpi.h>
+#include <Kernel/Hardware/Acpi/hpet.h>
+#include <Kernel/Hardware/Cpu/cpu.h>
+#include <Kernel/Memory/memory_manager.h>
+#include <LibFK/Algorithms/log.h>
+
+static constexpr uint64_t NS_PER_SEC = 1000000000ULL;
+static constexpr uint64_t FS_PER_SEC = 1000000000000000ULL;
+static constexpr uint64_t CALIBRATION_MS = 10;
+static constexpr uint32_t PIT_BASE_HZ = 1193182;
+
+fk::core::Result<void> TscClockSource::initialize() {
+  if (m_usable)
+    return {};
+
+  if (!CPU::the().has_invariant_tsc()) {
+    fk::algorithms::kwarn("TSC", "No invariant TSC, falling back to tick timekeeping");
+    return fk::core::Error::NotImplemented;
+  }
+
+  uint64_t hz = 0;
+  const char* reference = "HPET";
+  if (CPU::the().has_hpet())
+    hz = calibrate_with_hpet();
+  if (hz == 0) {
+    reference = "PIT";
+    hz = calibrate_with_pit();
+  }
+  if (hz == 0) {
+    fk::algorithms::kwarn("TSC", "Calibration failed against both HPET and PIT");
+    return fk::core::Error::DeviceError;
+  }
+
+  m_frequency_hz = hz;
+  m_mult = (NS_PER_SEC << SHIFT) / hz;
+  m_usable = true;
+  fk::algorithms::klog("TSC", "Calibrated against %s: %llu kHz (mult=%llu)", reference,
+                       hz / 1000, m_mult);
+  return {};
+}
+
+uint64_t TscClockSource::calibrate_with_hpet() {
+  auto* table = static_cast<HPETTable*>(ACPIManager::the().find_table("HPET"));
+  if (!table)
+    return 0;
+
+  uintptr_t base = table->base_address.address;
+  MemoryManager::the().map_page(base, base,
+                                PageFlags::Present | PageFlags::Writable |
+                                    PageFlags::CacheDisabled);
+  auto* regs = reinterpret_cast<volatile uint64_t*>(base);
+
+  // The main counter only runs while ENABLE_CNF is set.
+  if (!(regs[GENERAL_CONFIGURATION / sizeof(uint64_t)] & 1ULL))
+    return 0;
+
+  uint64_t period_fs = regs[GENERAL_CAPABILITIES_ID / sizeof(uint64_t)] >> 32;
+  if (period_fs == 0)
+    return 0;
+
+  uint64_t target = (CALIBRATION_MS * FS_PER_SEC / 1000) / period_fs;
+  volatile uint64_t* counter = &regs[MAIN_COUNTER_VALUE / sizeof(uint64_t)];
+
+  uint64_t start_counter = *counter;
+  uint64_t start_tsc = arch_read_tsc();
+  while (*counter - start_counter < target)
+    arch_cpu_relax();
+  uint64_t end_tsc = arch_read_tsc();
+  uint64_t elapsed_counter = *counter - start_counter;
+
+  uint64_t elapsed_fs = elapsed_counter * period_fs;
+  if (elapsed_fs == 0)
+    return 0;
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(end_tsc - start_tsc) * FS_PER_SEC) /
+                               elapsed_fs);
+}
+
+uint64_t TscClockSource::calibrate_with_pit() {
+  // One-shot on channel 2: gate high, speaker off, mode 0, lobyte/hibyte.
+  constexpr uint16_t latch = static_cast<uint16_t>(PIT_BASE_HZ * CALIBRATION_MS / 1000);
+
+  uint64_t flags = arch_save_flags_and_disable();
+  outb(PIT_GATE_PORT, static_cast<uint8_t>((inb(PIT_GATE_PORT) & ~0x02) | 0x01));
+  outb(PIT_COMMAND, 0xB0);
+  outb(PIT_CHANNEL2, latch & 0xFF);
+  outb(PIT_CHANNEL2, latch >> 8);
+
+  uint64_t start_tsc = arch_read_tsc();
+  uint64_t spins = 0;
+  while (!(inb(PIT_GATE_PORT) & 0x20) && spins < 0x10000000ULL)
+    ++spins;
+  uint64_t end_tsc = arch_read_tsc();
+  arch_restore_flags(flags);
+
+  if (!(inb(PIT_GATE_PORT) & 0x20))
+    return 0;
+  return (end_tsc - start_tsc) * 1000 / CALIBRATION_MS;
+}
+
+uint64_t TscClockSource::read_cycles() const {
+  return arch_read_tsc();
+}
+
+uint64_t TscClockSource::cycles_to_ns(uint64_t cycles) const {
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(cycles) * m_mult) >> SHIFT);
+}
@@ -0,0 +1,101 @@
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
+#include <Kernel/Clock/ClockSource/tsc_clock_source.h>
+#include <Kernel/Clock/clock_interrupt.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <LibFK/Algorithms/log.h>
+#include <LibFK/Utilities/memory.h>
+
+static constexpr uint64_t NS_PER_SEC = 1000000000ULL;
+
+void TimeKeeper::initialize() {
+  if (m_initialized)
+    return;
+
+  if (TscClockSource::the().initialize().is_ok())
+    m_tsc_base = TscClockSource::the().read_cycles();
+
+  int64_t epoch = ClockManager::the().datetime().to_unix_epoch();
+  m_realtime_offset_ns = epoch * static_cast<int64_t>(NS_PER_SEC) -
+                         static_cast<int64_t>(monotonic_ns());
+
+  m_vdso_data_phys = PhysicalMemoryManager::the().alloc_page();
+  if (m_vdso_data_phys) {
+    fk::memory::set(reinterpret_cast<void*>(m_vdso_data_phys), 0, PAGE_SIZE);
+    m_vdso_data = reinterpret_cast<VdsoData*>(m_vdso_data_phys);
+  }
+  publish_vdso_data();
+
+  m_initialized = true;
+  fk::algorithms::klog("TIMEKEEPER", "Clocksource=%s realtime=%lld s",
+                       TscClockSource::the().is_usable() ? "tsc" : "ticks", epoch);
+}
+
+uint64_t TimeKeeper::monotonic_ns() const {
+  auto& tsc = TscClockSource::the();
+  if (tsc.is_usable())
+    return tsc.cycles_to_ns(tsc.read_cycles() - m_tsc_base);
+
+  uint64_t ticks = TickManager::the().get_ticks();
+  uint64_t freq = TickManager::the().get_frequency();
+  if (freq == 0)
+    freq = 1000;
+  return (ticks / freq) * NS_PER_SEC + (ticks % freq) * NS_PER_SEC / freq;
+}
+
+uint64_t TimeKeeper::realtime_ns() const {
+  return static_cast<uint64_t>(static_cast<int64_t>(monotonic_ns()) + m_realtime_offset_ns);
+}
+
+uint64_t TimeKeeper::boottime_ns() const {
+  return static_cast<uint64_t>(static_cast<int64_t>(monotonic_ns()) + m_boottime_offset_ns);
+}
+
+fk::core::Result<uint64_t> TimeKeeper::now_ns(uint32_t clock_id) const {
+  switch (static_cast<ClockId>(clock_id)) {
+  case ClockId::Realtime:
+  case ClockId::RealtimeCoarse:
+    return realtime_ns();
+  case ClockId::Monotonic:
+  case ClockId::MonotonicRaw:
+  case ClockId::MonotonicCoarse:
+    return monotonic_ns();
+  case ClockId::Boottime:
+    return boottime_ns();
+  case ClockId::ProcessCputime:
+  case ClockId::ThreadCputime:
+    // No per-task CPU accounting yet; time since boot is the best upper bound.
+    return monotonic_ns();
+  }
+  return fk::core::Error::InvalidParameter;
+}
+
+fk::core::Result<uint64_t> TimeKeeper::resolution_ns(uint32_t clock_id) const {
+  if (clock_id >= CLOCK_ID_COUNT)
+    return fk::core::Error::InvalidParameter;
+
+  auto id = static_cast<ClockId>(clock_id);
+  bool coarse = id == ClockId::RealtimeCoarse || id == ClockId::MonotonicCoarse;
+  if (TscClockSource::the().is_usable() && !coarse)
+    return static_cast<uint64_t>(1);
+
+  uint64_t freq = TickManager::the().get_frequency();
+  return freq ? NS_PER_SEC / freq : NS_PER_SEC / 1000;
+}
+
+void TimeKeeper::publish_vdso_data() {
+  if (!m_vdso_data)
+    return;
+
+  auto& tsc = TscClockSource::the();
+  m_vdso_data->seq = m_vdso_data->seq + 1;
+  asm volatile("" ::: "memory");
+  m_vdso_data->flags = tsc.is_usable() ? VDSO_FLAG_TSC_USABLE : 0;
+  m_vdso_data->tsc_base = m_tsc_base;
+  m_vdso_data->tsc_mult = tsc.mult();
+  m_vdso_data->monotonic_base_ns = 0;
+  m_vdso_data->realtime_offset_ns = m_realtime_offset_ns;
+  m_vdso_data->boottime_offset_ns = m_boottime_offset_ns;
+  asm volatile("" ::: "memory");
+  m_vdso_data->seq = m_vdso_data->seq + 1;
+}
@@ -3,27 +3,89 @@
 
 namespace fkernel {
 
-size_t PtyBuffer::read(uint8_t* dst, size_t len) {
-  size_t n = m_data.size() < len ? m_data.size() : len;
-  if (n == 0) return 0;
-  fk::memory::copy(dst, m_data.begin(), n);
-  for (size_t i = n; i < m_data.size(); ++i)
-    m_data[i - n] = m_data[i];
-  for (size_t i = 0; i < n; ++i)
-    m_data.pop_back();
+// At most two copies: up to the end of the ring, then from its start
+size_t PtyBuffer::copy_in_locked(const uint8_t* src, size_t len) {
+  size_t space = CAPACITY - (m_head - m_tail);
+  size_t n = len < space ? len : space;
+  size_t pos = m_head % CAPACITY;
+  size_t first = n < CAPACITY - pos ? n : CAPACITY - pos;
+  fk::memory::copy(m_data + pos, src, first);
+  fk::memory::copy(m_data, src + first, n - first);
+  m_head += n;
   return n;
 }
 
-size_t PtyBuffer::write(const uint8_t* src, size_t len) {
-  size_t space = CAPACITY - m_data.size();
-  size_t n = len < space ? len : space;
-  for (size_t i = 0; i < n; ++i)
-    m_data.push_back(src[i]);
-  if (n > 0) m_notification.signal(1);
+fk::core::Result<size_t, fk::core::Error> PtyBuffer::read(uint8_t* dst, size_t len) {
+  for (;;) {
+    WaitQueueEntry wait;
+    {
+      fk::synchronization::ScopedLockIRQ lock(m_lock);
+      size_t used = m_head - m_tail;
+      if (used) {
+        size_t n = len < used ? len : used;
+        size_t pos = m_tail % CAPACITY;
+        size_t first = n < CAPACITY - pos ? n : CAPACITY - pos;
+        fk::memory::copy(dst, m_data + pos, first);
+        fk::memory::copy(dst + first, m_data, n - first);
+        m_tail += n;
+        m_writers.wake_all();
+        return n;
+      }
+      m_readers.prepare_to_wait(wait);
+    }
+    if (m_readers.finish_wait(wait).is_error())
+      return fk::core::Error::Interrupted;
+  }
+}
+
+fk::core::Result<size_t, fk::core::Error> PtyBuffer::write(const uint8_t* src, size_t len) {
+  size_t written = 0;
+  while (written < len) {
+    WaitQueueEntry wait;
+    {
+      fk::synchronization::ScopedLockIRQ lock(m_lock);
+      size_t n = copy_in_locked(src + written, len - written);
+      written += n;
+      if (n)
+        m_readers.wake_all();
+      if (written == len)
+        break;
+      m_writers.prepare_to_wait(wait);
+    }
+    if (m_writers.finish_wait(wait).is_error()) {
+      if (written)
+        return written;
+      return fk::core::Error::Interrupted;
+    }
+  }
+  return written;
+}
+
+size_t PtyBuffer::try_write(const uint8_t* src, size_t len) {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  size_t n = copy_in_locked(src, len);
+  if (n)
+    m_readers.wake_all();
   return n;
 }
 
-bool PtyBuffer::is_empty() const { return m_data.is_empty(); }
-size_t PtyBuffer::available() const { return m_data.size(); }
+void PtyBuffer::echo(const char* data, size_t len) {
+  try_write(reinterpret_cast<const uint8_t*>(data), len);
+}
+
+bool PtyBuffer::is_empty() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_head == m_tail;
+}
+
+bool PtyBuffer::is_full() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_head - m_tail == CAPACITY;
+}
+
+size_t PtyBuffer::available() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_head - m_tail;
+}
 
 } // namespace fkernel
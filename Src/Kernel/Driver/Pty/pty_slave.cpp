@@ -3,10 +3,10 @@
 
 namespace fkernel {
 
-PtySlave::PtySlave(fk::RefPtr<PtyBuffer> from_master,
+PtySlave::PtySlave(fk::RefPtr<PtyLineDiscipline> ldisc,
                    fk::RefPtr<PtyBuffer> to_master,
                    uint32_t index)
-    : m_from_master(from_master), m_to_master(to_master) {
+    : m_ldisc(ldisc), m_to_master(to_master) {
   fk::text::String name("pts");
   char idx_buf[16];
   size_t i = 0;
@@ -24,15 +24,38 @@ PtySlave::PtySlave(fk::RefPtr<PtyBuffer> from_master,
 fk::core::Result<size_t, fk::core::Error>
 PtySlave::read(uint64_t, size_t size, uint8_t* buf) {
   if (!buf || size == 0) return fk::core::Error::InvalidParameter;
-  while (m_from_master->is_empty())
-    m_from_master->data_ready().wait();
-  return m_from_master->read(buf, size);
+  return m_ldisc->read(buf, size);
 }
 
 fk::core::Result<size_t, fk::core::Error>
 PtySlave::write(uint64_t, size_t size, const uint8_t* buf) {
   if (!buf || size == 0) return fk::core::Error::InvalidParameter;
-  return m_to_master->write(buf, size);
+  if (!m_ldisc->maps_nl_to_crnl()) return m_to_master->write(buf, size);
+
+  // ONLCR: each run up to a newline goes out as is, the newline as CR LF
+  size_t done = 0;
+  while (done < size) {
+    size_t run = 0;
+    while (done + run < size && buf[done + run] != '\n') ++run;
+    if (run) {
+      auto res = m_to_master->write(buf + done, run);
+      if (res.is_error()) return done ? fk::core::Result<size_t, fk::core::Error>(done) : res;
+      done += res.value();
+      if (res.value() < run) return done;
+      continue;
+    }
+    static const uint8_t crlf[2] = {'\r', '\n'};
+    auto res = m_to_master->write(crlf, sizeof(crlf));
+    if (res.is_error() || res.value() < sizeof(crlf))
+      return done ? fk::core::Result<size_t, fk::core::Error>(done) : res;
+    ++done;
+  }
+  return done;
+}
+
+fk::core::Result<int, fk::core::Error>
+PtySlave::ioctl(uint64_t request, uint64_t arg) {
+  return m_ldisc->ioctl(request, arg);
 }
 
 } // namespace fkernel
@@ -0,0 +1,42 @@
+#include <Kernel/Driver/Serial/serial_log_ring.h>
+
+namespace fkernel {
+
+size_t SerialLogRing::push(const char *data, size_t len) {
+  uint64_t head = m_head;
+  uint64_t tail = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+  size_t room = CAPACITY - static_cast<size_t>(head - tail);
+  if (len > room) len = room;
+
+  for (size_t i = 0; i < len; ++i)
+    m_data[(head + i) & (CAPACITY - 1)] = data[i];
+  // The bytes are in place before the consumer can see the new head
+  __atomic_store_n(&m_head, head + len, __ATOMIC_RELEASE);
+  return len;
+}
+
+size_t SerialLogRing::pop(char *out, size_t max, bool &line_end) {
+  uint64_t tail = m_tail;
+  uint64_t head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+  size_t count = 0;
+  line_end = false;
+
+  while (count < max && tail + count < head) {
+    char c = m_data[(tail + count) & (CAPACITY - 1)];
+    out[count++] = c;
+    if (c == '\n') {
+      line_end = true;
+      break;
+    }
+  }
+  // Copied out before the producer may reuse the space
+  __atomic_store_n(&m_tail, tail + count, __ATOMIC_RELEASE);
+  return count;
+}
+
+bool SerialLogRing::is_empty() const {
+  return __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE) ==
+         __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+}
+
+} // namespace fkernel
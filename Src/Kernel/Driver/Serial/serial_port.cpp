@@ -1,4 +1,15 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
+#include <Kernel/Driver/Serial/serial_log_ring.h>
 #include <Kernel/Driver/Serial/serial_port.h>
+#include <Kernel/Hardware/Cpu/cpu_block.h>
+#include <LibFK/Algorithms/log.h>
+
+static constexpr size_t FIFO_DEPTH = 16;
+
+static fkernel::SerialLogRing s_rings[MAX_CPUS];
+static bool s_async = false;
+static bool s_draining = false;
+static size_t s_current_ring = 0; ///< Ring being sent; only the drainer touches it
 
 void serial::init() {
   outb(COM1 + 1, 0x00);
@@ -10,14 +21,30 @@ void serial::init() {
   outb(COM1 + 4, 0x0B);
 }
 
+void serial::enable_async() {
+  outb(COM1 + 1, 0x02); // IER: transmitter holding register empty
+  __atomic_store_n(&s_async, true, __ATOMIC_RELEASE);
+}
+
 void serial::write_char(char c) {
-  while (!is_transmit_empty())
-    ;
-  outb(COM1, c);
+  write_buffer(&c, 1);
 }
 
 void serial::write_buffer(const char *data, size_t len) {
-  static constexpr size_t FIFO_DEPTH = 16;
+  if (!__atomic_load_n(&s_async, __ATOMIC_ACQUIRE)) {
+    write_sync(data, len);
+    return;
+  }
+  if (fk::algorithms::in_panic_mode()) {
+    // Whoever held the drain flag may never run again
+    flush_sync();
+    write_sync(data, len);
+    return;
+  }
+  queue(data, len);
+}
+
+void serial::write_sync(const char *data, size_t len) {
   size_t i = 0;
   while (i < len) {
     while (!is_transmit_empty())
@@ -30,6 +57,78 @@ void serial::write_buffer(const char *data, size_t len) {
   }
 }
 
+void serial::flush_sync() {
+  char chunk[FIFO_DEPTH];
+  bool line_end = false;
+  for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu) {
+    while (size_t n = s_rings[cpu].pop(chunk, sizeof(chunk), line_end))
+      write_sync(chunk, n);
+  }
+}
+
+void serial::queue(const char *data, size_t len) {
+  while (len) {
+    // Interrupts off make this CPU the ring's only producer; the ring is
+    // looked up again each pass since the task may have moved while waiting
+    uint64_t flags = arch_save_flags_and_disable();
+    fkernel::SerialLogRing &ring = s_rings[arch_current_cpu_id() % MAX_CPUS];
+    size_t queued = ring.push(data, len);
+    kick();
+    arch_restore_flags(flags);
+    data += queued;
+    len -= queued;
+
+    // Full: wait for the UART with the caller's interrupt state, so the THRE
+    // interrupt and the rest of the system keep running meanwhile
+    if (len) {
+      while (!is_transmit_empty())
+        arch_cpu_relax();
+    }
+  }
+}
+
+void serial::kick() {
+  for (;;) {
+    // Someone else is sending; they look for new bytes before they stop
+    if (__atomic_exchange_n(&s_draining, true, __ATOMIC_ACQUIRE)) return;
+    drain_fifo();
+    __atomic_store_n(&s_draining, false, __ATOMIC_RELEASE);
+
+    // Bytes queued while the flag was held are covered by the next THRE
+    // interrupt if the FIFO is busy, and by another pass if it is not
+    if (!is_transmit_empty()) return;
+    bool pending = false;
+    for (size_t cpu = 0; cpu < MAX_CPUS && !pending; ++cpu)
+      pending = !s_rings[cpu].is_empty();
+    if (!pending) return;
+  }
+}
+
+// Loads up to one FIFO's worth, keeping to one ring until its line is out
+void serial::drain_fifo() {
+  if (!is_transmit_empty()) return;
+  char chunk[FIFO_DEPTH];
+  size_t count = 0;
+  size_t idle = 0;
+  while (count < FIFO_DEPTH && idle < MAX_CPUS) {
+    bool line_end = false;
+    size_t taken = s_rings[s_current_ring].pop(chunk + count, FIFO_DEPTH - count, line_end);
+    count += taken;
+    if (taken == 0 || line_end) {
+      s_current_ring = (s_current_ring + 1) % MAX_CPUS;
+      idle = taken ? 0 : idle + 1;
+    }
+  }
+  for (size_t i = 0; i < count; ++i)
+    outb(COM1, chunk[i]);
+}
+
+void serial::handle_interrupt() {
+  // Reading IIR acknowledges the THRE interrupt
+  (void)inb(COM1 + 2);
+  kick();
+}
+
 void serial::write(const char *str) {
   size_t len = 0;
   while (str[len]) ++len;
@@ -0,0 +1,362 @@
+#include <Kernel/Driver/Terminal/line_discipline.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
+#include <Kernel/Posix/signal_defs.h>
+#include <Kernel/Scheduler/scheduler.h>
+
+namespace fkernel {
+namespace terminal {
+
+using namespace tty;
+
+/// VEOF is queued as this byte, carrying a line-end mark
+static constexpr uint8_t EOF_MARK = 0;
+
+static bool is_enabled(uint8_t cc, uint8_t c) {
+  return cc != 0 && cc == c; // 0 is _POSIX_VDISABLE
+}
+
+LineDiscipline::LineDiscipline(LineDisciplineDelegate* delegate) : m_delegate(delegate) {
+  // Linux's tty_std_termios
+  m_termios.c_iflag = ICRNL | IXON;
+  m_termios.c_oflag = OPOST | ONLCR;
+  m_termios.c_cflag = 0xBF; // B38400 | CS8 | CREAD | HUPCL
+  m_termios.c_lflag = ISIG | ICANON | ECHO | ECHOE | ECHOK | ECHOCTL | ECHOKE | IEXTEN;
+  m_termios.c_cc[VINTR] = 0x03;
+  m_termios.c_cc[VQUIT] = 0x1C;
+  m_termios.c_cc[VERASE] = 0x7F;
+  m_termios.c_cc[VKILL] = 0x15;
+  m_termios.c_cc[VEOF] = 0x04;
+  m_termios.c_cc[VMIN] = 1;
+  m_termios.c_cc[VSTART] = 0x11;
+  m_termios.c_cc[VSTOP] = 0x13;
+  m_termios.c_cc[VSUSP] = 0x1A;
+  m_termios.c_cc[VWERASE] = 0x17;
+}
+
+bool LineDiscipline::is_line_end(size_t pos) const {
+  pos %= BUFFER_SIZE;
+  return m_line_ends[pos / 64] & (1ULL << (pos % 64));
+}
+
+void LineDiscipline::set_line_end(size_t pos, bool value) {
+  pos %= BUFFER_SIZE;
+  if (value)
+    m_line_ends[pos / 64] |= 1ULL << (pos % 64);
+  else
+    m_line_ends[pos / 64] &= ~(1ULL << (pos % 64));
+}
+
+void LineDiscipline::echo_locked(const char* data, size_t len) {
+  if (m_delegate)
+    m_delegate->echo(data, len);
+}
+
+void LineDiscipline::echo_char_locked(uint8_t c) {
+  if ((m_termios.c_lflag & ECHOCTL) && (c < 0x20 || c == 0x7F) && c != '\t' && c != '\n') {
+    char caret[2] = {'^', static_cast<char>(c == 0x7F ? '?' : c + 0x40)};
+    echo_locked(caret, sizeof(caret));
+    return;
+  }
+  char ch = static_cast<char>(c);
+  echo_locked(&ch, 1);
+}
+
+// Removes the last byte of the line being edited and rubs it out on screen
+bool LineDiscipline::erase_one_locked() {
+  if (m_head == m_canon_head)
+    return false;
+  uint8_t c = at(--m_head);
+  if ((m_termios.c_lflag & (ECHO | ECHOE)) == (ECHO | ECHOE)) {
+    bool caret = (m_termios.c_lflag & ECHOCTL) && (c < 0x20 || c == 0x7F) && c != '\t';
+    echo_locked("\b \b", 3);
+    if (caret)
+      echo_locked("\b \b", 3);
+  }
+  return true;
+}
+
+void LineDiscipline::flush_input_locked() {
+  m_read_tail = m_canon_head = m_head;
+  for (auto& word : m_line_ends)
+    word = 0;
+  m_writers.wake_all();
+}
+
+LineDiscipline::InputResult LineDiscipline::receive_char_locked(uint8_t c, int& signal) {
+  const uint8_t* cc = m_termios.c_cc;
+  uint32_t lflag = m_termios.c_lflag;
+
+  if (m_termios.c_iflag & ISTRIP)
+    c &= 0x7F;
+  if (c == '\r') {
+    if (m_termios.c_iflag & IGNCR)
+      return InputResult::Accepted;
+    if (m_termios.c_iflag & ICRNL)
+      c = '\n';
+  } else if (c == '\n' && (m_termios.c_iflag & INLCR)) {
+    c = '\r';
+  }
+
+  if (lflag & ISIG) {
+    if (is_enabled(cc[VINTR], c))
+      signal = SIGINT;
+    else if (is_enabled(cc[VQUIT], c))
+      signal = SIGQUIT;
+    else if (is_enabled(cc[VSUSP], c))
+      signal = SIGTSTP;
+    if (signal) {
+      if (!(lflag & NOFLSH))
+        flush_input_locked();
+      if (lflag & ECHO)
+        echo_char_locked(c);
+      return InputResult::Accepted;
+    }
+  }
+
+  size_t space = BUFFER_SIZE - used_locked();
+
+  if (!is_canonical()) {
+    if (space == 0)
+      return InputResult::Full;
+    at(m_head++) = c;
+    m_canon_head = m_head;
+    if (lflag & ECHO)
+      echo_char_locked(c);
+    return InputResult::Accepted;
+  }
+
+  if (is_enabled(cc[VERASE], c)) {
+    erase_one_locked();
+    return InputResult::Accepted;
+  }
+  if ((lflag & IEXTEN) && is_enabled(cc[VWERASE], c)) {
+    while (m_head != m_canon_head && at(m_head - 1) == ' ')
+      erase_one_locked();
+    while (m_head != m_canon_head && at(m_head - 1) != ' ')
+      erase_one_locked();
+    return InputResult::Accepted;
+  }
+  if (is_enabled(cc[VKILL], c)) {
+    if ((lflag & (ECHOKE | ECHOE)) == (ECHOKE | ECHOE)) {
+      while (erase_one_locked()) {}
+      return InputResult::Accepted;
+    }
+    m_head = m_canon_head;
+    if (lflag & ECHO) {
+      echo_char_locked(c);
+      if (lflag & ECHOK)
+        echo_locked("\n", 1);
+    }
+    return InputResult::Accepted;
+  }
+
+  bool is_eof = is_enabled(cc[VEOF], c);
+  bool ends_line = is_eof || c == '\n' || is_enabled(cc[VEOL], c);
+  // The last slot is kept for a terminator, so a full line can still be ended
+  if (space == 0 || (!ends_line && space == 1))
+    return m_canon_head != m_read_tail ? InputResult::Full : InputResult::Accepted;
+
+  at(m_head) = is_eof ? EOF_MARK : c;
+  set_line_end(m_head, ends_line);
+  ++m_head;
+  if (c == '\n') {
+    if (lflag & (ECHO | ECHONL))
+      echo_locked("\n", 1);
+  } else if ((lflag & ECHO) && !is_eof) {
+    echo_char_locked(c);
+  }
+  if (ends_line)
+    m_canon_head = m_head;
+  return InputResult::Accepted;
+}
+
+fk::core::Result<size_t, fk::core::Error> LineDiscipline::receive(const uint8_t* data,
+                                                                  size_t len, bool can_block) {
+  size_t done = 0;
+  while (done < len) {
+    WaitQueueEntry wait;
+    int signal = 0;
+    int pgid = 0;
+    bool full = false;
+    {
+      fk::synchronization::ScopedLockIRQ lock(m_lock);
+      while (done < len && !signal) {
+        if (receive_char_locked(data[done], signal) == InputResult::Full && can_block) {
+          full = true;
+          break;
+        }
+        // Input that finds no room and cannot wait is dropped
+        ++done;
+      }
+      if (can_read_locked())
+        m_readers.wake_all();
+      if (full)
+        m_writers.prepare_to_wait(wait);
+      pgid = m_foreground_pgid;
+    }
+
+    if (signal)
+      SchedulerManager::the().send_signal_to_pgrp(pgid, signal);
+    if (full && m_writers.finish_wait(wait).is_error()) {
+      if (done)
+        return done;
+      return fk::core::Error::Interrupted;
+    }
+  }
+  return done;
+}
+
+bool LineDiscipline::can_read_locked() const {
+  if (m_read_tail != m_canon_head)
+    return true;
+  return !is_canonical() && m_termios.c_cc[VMIN] == 0;
+}
+
+bool LineDiscipline::can_read() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_read_tail != m_canon_head;
+}
+
+fk::core::Result<size_t, fk::core::Error> LineDiscipline::read(uint8_t* dst, size_t len) {
+  for (;;) {
+    WaitQueueEntry wait;
+    {
+      fk::synchronization::ScopedLockIRQ lock(m_lock);
+      if (can_read_locked()) {
+        bool canonical = is_canonical();
+        size_t n = 0;
+        while (n < len && m_read_tail != m_canon_head) {
+          size_t pos = m_read_tail++;
+          uint8_t c = at(pos);
+          if (is_line_end(pos)) {
+            set_line_end(pos, false);
+            if (c != EOF_MARK)
+              dst[n++] = c;
+            // A canonical read returns at most one line; a bare VEOF reads as 0
+            if (canonical)
+              break;
+            continue;
+          }
+          dst[n++] = c;
+        }
+        m_writers.wake_all();
+        return n;
+      }
+      m_readers.prepare_to_wait(wait);
+    }
+    if (m_readers.finish_wait(wait).is_error())
+      return fk::core::Error::Interrupted;
+  }
+}
+
+bool LineDiscipline::maps_nl_to_crnl() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return (m_termios.c_oflag & (OPOST | ONLCR)) == (OPOST | ONLCR);
+}
+
+void LineDiscipline::flush_input() {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  flush_input_locked();
+}
+
+Termios LineDiscipline::termios() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_termios;
+}
+
+void LineDiscipline::set_termios(const Termios& termios) {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  bool was_canonical = is_canonical();
+  m_termios = termios;
+  // Leaving canonical mode hands the line being edited to readers as it is
+  if (was_canonical && !is_canonical())
+    m_canon_head = m_head;
+  m_readers.wake_all();
+}
+
+fk::core::Result<int, fk::core::Error> LineDiscipline::ioctl(uint64_t request, uint64_t arg) {
+  static constexpr uint64_t TCGETS = 0x5401;
+  static constexpr uint64_t TCSETS = 0x5402;
+  static constexpr uint64_t TCSETSW = 0x5403;
+  static constexpr uint64_t TCSETSF = 0x5404;
+  static constexpr uint64_t TCFLSH = 0x540B;
+  static constexpr uint64_t TIOCSCTTY = 0x540E;
+  static constexpr uint64_t TIOCGPGRP = 0x540F;
+  static constexpr uint64_t TIOCSPGRP = 0x5410;
+  static constexpr uint64_t TIOCGWINSZ = 0x5413;
+  static constexpr uint64_t TIOCSWINSZ = 0x5414;
+  static constexpr uint64_t FIONREAD = 0x541B;
+
+  void* user = reinterpret_cast<void*>(arg);
+  switch (request) {
+  case TCGETS: {
+    Termios t = termios();
+    if (memory::copy_to_user(user, &t, sizeof(t)).is_error())
+      return fk::core::Error::BadAddress;
+    return 0;
+  }
+  case TCSETS:
+  case TCSETSW: // Output is never queued, so there is nothing to drain
+  case TCSETSF: {
+    Termios t;
+    if (memory::copy_from_user(&t, user, sizeof(t)).is_error())
+      return fk::core::Error::BadAddress;
+    if (request == TCSETSF)
+      flush_input();
+    set_termios(t);
+    return 0;
+  }
+  case TCFLSH:
+    if (arg > 2)
+      return fk::core::Error::InvalidParameter;
+    if (arg != 1) // TCIFLUSH or TCIOFLUSH
+      flush_input();
+    return 0;
+  case TIOCSCTTY: {
+    Task* task = SchedulerManager::the().current();
+    if (task)
+      m_foreground_pgid = static_cast<int>(task->control.identity.pgid.value());
+    return 0;
+  }
+  case TIOCGPGRP:
+    if (memory::copy_to_user(user, &m_foreground_pgid, sizeof(int)).is_error())
+      return fk::core::Error::BadAddress;
+    return 0;
+  case TIOCSPGRP: {
+    int pgid = 0;
+    if (memory::copy_from_user(&pgid, user, sizeof(pgid)).is_error())
+      return fk::core::Error::BadAddress;
+    m_foreground_pgid = pgid;
+    return 0;
+  }
+  case TIOCGWINSZ:
+    if (memory::copy_to_user(user, &m_winsize, sizeof(m_winsize)).is_error())
+      return fk::core::Error::BadAddress;
+    return 0;
+  case TIOCSWINSZ: {
+    WindowSize winsize;
+    if (memory::copy_from_user(&winsize, user, sizeof(winsize)).is_error())
+      return fk::core::Error::BadAddress;
+    bool changed = winsize.rows != m_winsize.rows || winsize.cols != m_winsize.cols;
+    m_winsize = winsize;
+    if (changed)
+      SchedulerManager::the().send_signal_to_pgrp(m_foreground_pgid, SIGWINCH);
+    return 0;
+  }
+  case FIONREAD: {
+    int pending = 0;
+    {
+      fk::synchronization::ScopedLockIRQ lock(m_lock);
+      pending = static_cast<int>(m_canon_head - m_read_tail);
+    }
+    if (memory::copy_to_user(user, &pending, sizeof(pending)).is_error())
+      return fk::core::Error::BadAddress;
+    return 0;
+  }
+  default:
+    return fk::core::Error::NotImplemented;
+  }
+}
+
+} // namespace terminal
+} // namespace fkernel
@@ -35,18 +35,20 @@ void TerminalRenderer::restore_cursor() {
     vga::the().set_cursor_pos(m_saved_x, m_saved_y);
 }
 
+// Edits go through the Display cell operations: the framebuffer console
+// applies them to its text grid and redraws the damage on the next flush.
+
 void TerminalRenderer::clear_screen(uint8_t mode, uint16_t rows) {
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_h = fb.height / rows;
+    uint32_t cols = Display::the().get_width();
 
     if (mode == 0) { // Cursor to end
-        if (y + 1 < rows) {
-            Display::the().clear_rect(0, (y + 1) * char_h, fb.width, fb.height - (y + 1) * char_h);
+        for (uint32_t row = y + 1; row < rows; ++row) {
+            Display::the().clear_cells(row, 0, cols);
         }
     } else if (mode == 1) { // Start to cursor
-        if (y > 0) {
-            Display::the().clear_rect(0, 0, fb.width, y * char_h);
+        for (uint32_t row = 0; row < y && row < rows; ++row) {
+            Display::the().clear_cells(row, 0, cols);
         }
     } else { // Entire screen
         vga::the().clear();
@@ -54,108 +56,79 @@ void TerminalRenderer::clear_screen(uint8_t mode, uint16_t rows) {
     }
 }
 
-void TerminalRenderer::clear_line(uint8_t mode, uint16_t rows, uint16_t cols) {
+void TerminalRenderer::clear_line(uint8_t mode, uint16_t, uint16_t cols) {
     uint32_t x = vga::the().get_cursor_x();
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_w = fb.width / cols;
-    uint32_t char_h = fb.height / rows;
+    if (x > cols) x = cols;
 
     if (mode == 0) {
-        Display::the().clear_rect(x * char_w, y * char_h, fb.width - (x * char_w), char_h);
+        Display::the().clear_cells(y, x, cols - x);
     } else if (mode == 1) {
-        Display::the().clear_rect(0, y * char_h, (x + 1) * char_w, char_h);
+        Display::the().clear_cells(y, 0, x + 1 < cols ? x + 1 : cols);
     } else {
-        Display::the().clear_rect(0, y * char_h, fb.width, char_h);
+        Display::the().clear_cells(y, 0, cols);
     }
 }
 
 void TerminalRenderer::scroll_up(uint16_t count, uint16_t rows) {
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_h = fb.height / rows;
     if (count < rows) {
-        Display::the().copy_rect(0, count * char_h, 0, 0, fb.width, (rows - count) * char_h);
-        Display::the().clear_rect(0, (rows - count) * char_h, fb.width, count * char_h);
+        Display::the().scroll_rows(0, rows, count, true);
     } else {
         vga::the().clear();
     }
 }
 
 void TerminalRenderer::scroll_down(uint16_t count, uint16_t rows) {
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_h = fb.height / rows;
     if (count < rows) {
-        Display::the().copy_rect(0, 0, 0, count * char_h, fb.width, (rows - count) * char_h);
-        Display::the().clear_rect(0, 0, fb.width, count * char_h);
+        Display::the().scroll_rows(0, rows, count, false);
     } else {
         vga::the().clear();
     }
 }
 
-void TerminalRenderer::insert_chars(uint16_t count, uint16_t rows, uint16_t cols) {
+void TerminalRenderer::insert_chars(uint16_t count, uint16_t, uint16_t cols) {
     uint32_t x = vga::the().get_cursor_x();
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_w = fb.width / cols;
-    uint32_t char_h = fb.height / rows;
+    if (x >= cols) return;
+    if (x + count > cols) count = static_cast<uint16_t>(cols - x);
 
     if (x + count < cols) {
-        Display::the().copy_rect(x * char_w, y * char_h, (x + count) * char_w, y * char_h, (cols - x - count) * char_w, char_h);
+        Display::the().move_cells(y, x, x + count, cols - x - count);
     }
-    Display::the().clear_rect(x * char_w, y * char_h, count * char_w, char_h);
+    Display::the().clear_cells(y, x, count);
 }
 
-void TerminalRenderer::delete_chars(uint16_t count, uint16_t rows, uint16_t cols) {
+void TerminalRenderer::delete_chars(uint16_t count, uint16_t, uint16_t cols) {
     uint32_t x = vga::the().get_cursor_x();
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_w = fb.width / cols;
-    uint32_t char_h = fb.height / rows;
+    if (x >= cols) return;
 
     if (x + count < cols) {
-        Display::the().copy_rect((x + count) * char_w, y * char_h, x * char_w, y * char_h, (cols - x - count) * char_w, char_h);
-        Display::the().clear_rect((cols - count) * char_w, y * char_h, fb.width - (cols - count) * char_w, char_h);
+        Display::the().move_cells(y, x + count, x, cols - x - count);
+        Display::the().clear_cells(y, cols - count, count);
     } else {
-        Display::the().clear_rect(x * char_w, y * char_h, fb.width - (x * char_w), char_h);
+        Display::the().clear_cells(y, x, cols - x);
     }
 }
 
-void TerminalRenderer::erase_chars(uint16_t count, uint16_t rows, uint16_t cols) {
+void TerminalRenderer::erase_chars(uint16_t count, uint16_t, uint16_t cols) {
     uint32_t x = vga::the().get_cursor_x();
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_w = fb.width / cols;
-    uint32_t char_h = fb.height / rows;
+    if (x >= cols) return;
 
-    if (x + count >= cols) {
-        Display::the().clear_rect(x * char_w, y * char_h, fb.width - (x * char_w), char_h);
-    } else {
-        Display::the().clear_rect(x * char_w, y * char_h, count * char_w, char_h);
-    }
+    Display::the().clear_cells(y, x, x + count >= cols ? cols - x : count);
 }
 
 void TerminalRenderer::insert_lines(uint16_t count, uint16_t rows) {
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_h = fb.height / rows;
-
-    if (y + count < rows) {
-        Display::the().copy_rect(0, y * char_h, 0, (y + count) * char_h, fb.width, (rows - y - count) * char_h);
-    }
-    Display::the().clear_rect(0, y * char_h, fb.width, count * char_h);
+    if (y >= rows) return;
+    Display::the().scroll_rows(y, rows, count, false);
 }
 
 void TerminalRenderer::delete_lines(uint16_t count, uint16_t rows) {
     uint32_t y = vga::the().get_cursor_y();
-    auto fb = Display::the().get_framebuffer_info();
-    uint32_t char_h = fb.height / rows;
-
-    if (y + count < rows) {
-        Display::the().copy_rect(0, (y + count) * char_h, 0, y * char_h, fb.width, (rows - y - count) * char_h);
-        Display::the().clear_rect(0, (rows - count) * char_h, fb.width, count * char_h);
-    } else {
-        Display::the().clear_rect(0, y * char_h, fb.width, (rows - y) * char_h);
-    }
+    if (y >= rows) return;
+    Display::the().scroll_rows(y, rows, count, true);
 }
 
 uint32_t TerminalRenderer::cursor_x() const { return vga::the().get_cursor_x(); }
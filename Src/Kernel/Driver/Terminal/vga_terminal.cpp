@@ -1,7 +1,5 @@
 #include <Kernel/Driver/Terminal/terminal_manager.h>
 #include <Kernel/Driver/Terminal/vga_terminal.h>
-#include <Kernel/Posix/signal_defs.h>
-#include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Algorithms/log.h>
 #include <LibFK/Utilities/memory.h>
 
@@ -10,11 +8,18 @@ namespace terminal {
 
 static VGATerminal* s_vga_tty = nullptr;
 
-VGATerminal::VGATerminal(int index) : m_index(index), m_ansi_parser(*this), m_renderer(25, 80) {
+VGATerminal::VGATerminal(int index)
+    : m_index(index), m_ldisc(this), m_ansi_parser(*this), m_renderer(25, 80) {
   if (index == 0)
     s_vga_tty = this;
   m_state.rows = static_cast<uint16_t>(Display::the().get_height());
   m_state.cols = static_cast<uint16_t>(Display::the().get_width());
+  m_ldisc.set_window_size({.rows = m_state.rows, .cols = m_state.cols});
+
+  // The keyboard driver sends ^H for backspace, not DEL
+  Termios termios = m_ldisc.termios();
+  termios.c_cc[tty::VERASE] = '\b';
+  m_ldisc.set_termios(termios);
 
   char name[16];
   snprintf(name, sizeof(name), "tty%d", index);
@@ -29,83 +34,23 @@ VGATerminal& VGATerminal::the() {
 }
 
 void VGATerminal::on_char(char c) {
-  fk::synchronization::ScopedLock lock(m_lock);
-  bool is_active = (TerminalManager::the().active_terminal() == this);
-
-  // Control character signal delivery (ISIG)
-  if (!m_state.raw_mode && m_state.foreground_pgid > 0) {
-    if (c == '\x03') { // Ctrl+C → SIGINT
-      SchedulerManager::the().send_signal_to_pgrp(m_state.foreground_pgid, SIGINT);
-      return;
-    }
-    if (c == '\x1C') { // Ctrl+\ → SIGQUIT
-      SchedulerManager::the().send_signal_to_pgrp(m_state.foreground_pgid, SIGQUIT);
-      return;
-    }
-    if (c == '\x1A') { // Ctrl+Z → SIGTSTP
-      SchedulerManager::the().send_signal_to_pgrp(m_state.foreground_pgid, SIGTSTP);
-      return;
-    }
-  }
-
-  if (c == '\b' && !m_state.raw_mode) {
-    if (m_state.line_chars > 0) {
-      m_input_queue.remove_last();
-      m_state.line_chars--;
-      if (m_state.echo_enabled && is_active) {
-        m_renderer.put_char('\b');
-        Display::the().flush();
-      }
-    }
-    return;
-  }
+  m_ldisc.receive_char(c);
+}
 
-  if (c == '\n' || c == '\r') {
-    c = '\n';
-    m_state.line_chars = 0;
-    if (m_state.echo_enabled && !m_state.raw_mode && is_active) {
-      m_renderer.put_char('\n');
-      Display::the().flush();
-    }
-    m_input_queue.enqueue(c);
+void VGATerminal::echo(const char* data, size_t len) {
+  fk::synchronization::ScopedLock lock(m_lock);
+  if (TerminalManager::the().active_terminal() != this)
     return;
-  }
-
-  if (!m_state.raw_mode)
-    m_state.line_chars++;
-  if (m_state.echo_enabled && !m_state.raw_mode && is_active) {
-    m_renderer.put_char(c);
-    Display::the().flush();
-  }
-  m_input_queue.enqueue(c);
+  for (size_t i = 0; i < len; ++i)
+    m_renderer.put_char(data[i]);
+  Display::the().flush();
 }
 
 fk::core::Result<size_t, fk::core::Error> VGATerminal::read(uint64_t, size_t size,
                                                             uint8_t* buffer) {
   if (size == 0 || !buffer)
     return fk::core::Error::InvalidParameter;
-
-  if (m_state.raw_mode) {
-    if (m_input_queue.is_empty()) {
-      SchedulerManager::the().yield();
-      return 0;
-    }
-    buffer[0] = static_cast<uint8_t>(m_input_queue.dequeue());
-    return 1;
-  }
-
-  // Canonical mode: wait for full line
-  while (true) {
-    for (size_t i = 0; i < m_input_queue.size(); ++i) {
-      if (m_input_queue[i] == '\n') {
-        size_t to_copy = (i + 1 < size) ? (i + 1) : size;
-        for (size_t j = 0; j < to_copy; ++j)
-          buffer[j] = m_input_queue.dequeue();
-        return to_copy;
-      }
-    }
-    SchedulerManager::the().yield();
-  }
+  return m_ldisc.read(buffer, size);
 }
 
 fk::core::Result<size_t, fk::core::Error> VGATerminal::write(uint64_t, size_t size,
@@ -114,8 +59,8 @@ fk::core::Result<size_t, fk::core::Error> VGATerminal::write(uint64_t, size_t si
     return fk::core::Error::InvalidParameter;
   fk::synchronization::ScopedLock lock(m_lock);
   if (TerminalManager::the().active_terminal() == this) {
+    // Drawn by the timer's background flush, so bursts of output share one redraw
     m_ansi_parser.process_data(reinterpret_cast<const char*>(buffer), size);
-    Display::the().flush();
   }
   return size;
 }
@@ -208,6 +153,7 @@ TerminalCapabilities VGATerminal::capabilities() const {
 fk::core::Result<void, fk::core::Error> VGATerminal::set_size(uint16_t r, uint16_t c) {
   m_state.rows = r;
   m_state.cols = c;
+  m_ldisc.set_window_size({.rows = r, .cols = c});
   return {};
 }
 
@@ -219,8 +165,8 @@ void VGATerminal::get_size(uint16_t& r, uint16_t& c) const {
 void VGATerminal::respond(const char* data) {
   if (!data)
     return;
-  while (*data)
-    m_input_queue.enqueue(*data++);
+  // Replies (cursor position reports and the like) arrive as typed input
+  m_ldisc.receive(reinterpret_cast<const uint8_t*>(data), strlen(data), false);
 }
 
 void VGATerminal::move_cursor_up(uint16_t n) {
@@ -250,63 +196,7 @@ void VGATerminal::set_line_drawing_mode(bool e) {
 }
 
 fk::core::Result<int, fk::core::Error> VGATerminal::ioctl(uint64_t request, uint64_t arg) {
-  fk::synchronization::ScopedLock lock(m_lock);
-
-  // Linux struct termios (x86_64 ABI: 4x uint32 + cc_t[19])
-  struct linux_termios {
-    unsigned int c_iflag, c_oflag, c_cflag, c_lflag;
-    unsigned char c_line;
-    unsigned char c_cc[19];
-  };
-  static constexpr unsigned int ICANON = 0x2;
-  static constexpr unsigned int ECHO   = 0x8;
-  static constexpr unsigned int ISIG   = 0x1;
-
-  if (request == 0x5401 /* TCGETS */) {
-    auto* t = reinterpret_cast<linux_termios*>(arg);
-    if (!t) return fk::core::Error::InvalidParameter;
-    fk::memory::set(t, 0, sizeof(*t));
-    t->c_cflag = 0xBF;  // B9600 | CS8
-    if (m_state.echo_enabled) t->c_lflag |= ECHO;
-    if (!m_state.raw_mode)    t->c_lflag |= ICANON;
-    t->c_lflag |= ISIG;
-    t->c_cc[4] = 1;  // VMIN
-    t->c_cc[5] = 0;  // VTIME
-    return 0;
-  }
-  if (request == 0x5402 /* TCSETS */ || request == 0x5403 /* TCSETSW */ ||
-      request == 0x5404 /* TCSETSF */) {
-    auto* t = reinterpret_cast<const linux_termios*>(arg);
-    if (!t) return fk::core::Error::InvalidParameter;
-    m_state.echo_enabled = (t->c_lflag & ECHO)   != 0;
-    m_state.raw_mode     = (t->c_lflag & ICANON) == 0;
-    return 0;
-  }
-  if (request == 0x5413 /* TIOCGWINSZ */) {
-    struct ws { uint16_t r, c, x, y; }* w = (ws*)arg;
-    if (!w) return fk::core::Error::InvalidParameter;
-    w->r = m_state.rows;
-    w->c = m_state.cols;
-    return 0;
-  }
-  if (request == 0x540F /* TIOCGPGRP */) {
-    int* pgid_ptr = reinterpret_cast<int*>(arg);
-    if (!pgid_ptr) return fk::core::Error::InvalidParameter;
-    *pgid_ptr = m_state.foreground_pgid;
-    return 0;
-  }
-  if (request == 0x5410 /* TIOCSPGRP */) {
-    const int* pgid_ptr = reinterpret_cast<const int*>(arg);
-    if (!pgid_ptr) return fk::core::Error::InvalidParameter;
-    m_state.foreground_pgid = *pgid_ptr;
-    return 0;
-  }
-  if (request == 0x540E /* TIOCSCTTY */) {
-    Task* task = SchedulerManager::the().current();
-    if (task) m_state.foreground_pgid = (int)task->control.identity.pgid.value();
-    return 0;
-  }
-  return fk::core::Error::NotImplemented;
+  return m_ldisc.ioctl(request, arg);
 }
 
 } // namespace terminal
@@ -24,9 +24,9 @@ void DisplayFramebuffer::initialize_framebuffer() {
     if (MemoryManager::the().is_initialized()) {
       uintptr_t fb_addr = reinterpret_cast<uintptr_t>(framebuffer);
       size_t fb_size = fb_height * fb_pitch;
-      for (uintptr_t addr = fb_addr; addr < fb_addr + fb_size; addr += 4096) MemoryManager::the().map_page(addr, addr, PageFlags::Present | PageFlags::Writable | PageFlags::WriteThrough);
+      for (uintptr_t addr = fb_addr; addr < fb_addr + fb_size; addr += 4096) MemoryManager::the().map_page(addr, addr, PageFlags::Present | PageFlags::Writable | PageFlags::WriteCombining);
     }
-    allocate_back_buffer(); allocate_dirty_tiles();
+    allocate_back_buffer(); allocate_dirty_tiles(); initialize_text_grid();
   } else if (vesa::VESADriver::the().is_available()) {
     framebuffer = vesa::VESADriver::the().get_framebuffer();
     fb_width = vesa::VESADriver::the().get_width(); fb_height = vesa::VESADriver::the().get_height(); fb_pitch = vesa::VESADriver::the().get_pitch(); fb_bpp = vesa::VESADriver::the().get_bpp();
@@ -34,9 +34,9 @@ void DisplayFramebuffer::initialize_framebuffer() {
     if (MemoryManager::the().is_initialized()) {
       uintptr_t fb_addr = reinterpret_cast<uintptr_t>(framebuffer);
       size_t fb_size = fb_height * fb_pitch;
-      for (uintptr_t addr = fb_addr; addr < fb_addr + fb_size; addr += 4096) MemoryManager::the().map_page(addr, addr, PageFlags::Present | PageFlags::Writable | PageFlags::WriteThrough);
+      for (uintptr_t addr = fb_addr; addr < fb_addr + fb_size; addr += 4096) MemoryManager::the().map_page(addr, addr, PageFlags::Present | PageFlags::Writable | PageFlags::WriteCombining);
     }
-    allocate_back_buffer(); allocate_dirty_tiles();
+    allocate_back_buffer(); allocate_dirty_tiles(); initialize_text_grid();
   }
 }
 
@@ -107,6 +107,16 @@ void DisplayFramebuffer::render_char(uint32_t x, uint32_t y, char c, uint32_t fg
   uint32_t font_w = m_current_font.width * m_current_font.scale; uint32_t font_h = m_current_font.height * m_current_font.scale;
   const Vga::Font &font = m_current_font; if (!font.data) return;
   if (c < font.first_char || c > font.last_char) c = '?';
+  if (m_atlas.is_ready() && fb_bpp == 32 && x + font_w <= fb_width && y + font_h <= fb_height) {
+    // Pre-rasterized masks: one select per pixel, no bit tests or scale loops
+    const uint32_t *mask = m_atlas.glyph(static_cast<uint8_t>(c));
+    for (uint32_t row = 0; row < font_h; ++row, mask += font_w) {
+      uint32_t *dst = reinterpret_cast<uint32_t *>(target + (y + row) * fb_pitch) + x;
+      for (uint32_t col = 0; col < font_w; ++col) dst[col] = (fg_color & mask[col]) | (bg_color & ~mask[col]);
+    }
+    mark_dirty(x, y, font_w, font_h);
+    return;
+  }
   uint32_t char_index = c - font.first_char; const uint8_t *glyph = font.data + (char_index * font.height); uint8_t scale = font.scale;
   for (uint32_t row = 0; row < font.height; ++row) {
     uint8_t bits = glyph[row];
@@ -130,6 +140,7 @@ void DisplayFramebuffer::scroll() {
   uint8_t *target = get_render_buffer(); if (!target) return;
   uint32_t font_h = m_current_font.height * m_current_font.scale; uint32_t max_rows = get_height();
   if (cursor_y < max_rows) return;
+  if (m_grid.is_ready()) { m_grid.scroll(0, max_rows, cursor_y - max_rows + 1, true, blank_cell()); cursor_y = max_rows - 1; return; }
   uint32_t scroll_bytes = font_h * fb_pitch; uint32_t total_bytes = fb_height * fb_pitch;
   if (scroll_bytes < total_bytes) fk::memory::move(target, target + scroll_bytes, total_bytes - scroll_bytes);
   uint32_t bg_pixel = color_to_pixel(current_bg);
@@ -146,48 +157,80 @@ void DisplayFramebuffer::scroll() {
 void DisplayFramebuffer::put_codepoint(uint32_t codepoint) {
   fk::synchronization::ScopedLockIRQ lock(Display::lock());
   erase_cursor();
-  uint32_t font_w = m_current_font.width * m_current_font.scale; uint32_t font_h = m_current_font.height * m_current_font.scale;
   if (codepoint == '\n') { cursor_x = 0; cursor_y++; scroll(); draw_cursor(); return; }
   if (codepoint == '\r') { cursor_x = 0; draw_cursor(); return; }
-  uint32_t fg = use_rgb_color ? rgb_to_pixel_internal(current_fg_rgb) : color_to_pixel(current_fg);
-  uint32_t bg = use_rgb_color ? rgb_to_pixel_internal(current_bg_rgb) : color_to_pixel(current_bg);
+  uint32_t fg = fg_pixel(); uint32_t bg = bg_pixel();
   if (codepoint == '\t') {
     uint32_t next_tab = (cursor_x + 8) & ~7;
-    while (cursor_x < next_tab && cursor_x < get_width()) { render_char(cursor_x * font_w, cursor_y * font_h, ' ', fg, bg); cursor_x++; }
+    while (cursor_x < next_tab && cursor_x < get_width()) { place_char(cursor_x, cursor_y, ' ', fg, bg); cursor_x++; }
     if (cursor_x >= get_width()) { cursor_x = 0; cursor_y++; scroll(); }
     draw_cursor(); return;
   }
   if (codepoint == '\b') {
     if (cursor_x > 0) cursor_x--; else if (cursor_y > 0) { cursor_y--; cursor_x = get_width() - 1; }
     else { draw_cursor(); return; }
-    render_char(cursor_x * font_w, cursor_y * font_h, ' ', fg, bg); draw_cursor(); return;
+    place_char(cursor_x, cursor_y, ' ', fg, bg); draw_cursor(); return;
   }
-  if (codepoint == ' ') { render_char(cursor_x * font_w, cursor_y * font_h, ' ', fg, bg); cursor_x++; if (cursor_x >= get_width()) { cursor_x = 0; cursor_y++; scroll(); } draw_cursor(); return; }
+  if (codepoint == ' ') { place_char(cursor_x, cursor_y, ' ', fg, bg); cursor_x++; if (cursor_x >= get_width()) { cursor_x = 0; cursor_y++; scroll(); } draw_cursor(); return; }
   if (cursor_x >= get_width()) { cursor_x = 0; cursor_y++; scroll(); }
   if (codepoint < 32 && codepoint != 27) { draw_cursor(); return; }
   char c = (codepoint < 128) ? static_cast<char>(codepoint) : '?';
-  render_char(cursor_x * font_w, cursor_y * font_h, c, fg, bg); cursor_x++; draw_cursor();
+  place_char(cursor_x, cursor_y, c, fg, bg); cursor_x++; draw_cursor();
 }
 
-void DisplayFramebuffer::draw_cursor() {
-  uint8_t *target = get_render_buffer(); if (!target) return;
+void DisplayFramebuffer::place_char(uint32_t col, uint32_t row, char c, uint32_t fg, uint32_t bg) {
+  if (m_grid.is_ready()) { m_grid.put(row, col, {static_cast<uint8_t>(c), fg, bg}); return; }
   uint32_t font_w = m_current_font.width * m_current_font.scale; uint32_t font_h = m_current_font.height * m_current_font.scale;
-  uint32_t px_start = cursor_x * font_w; uint32_t py_start = cursor_y * font_h + (font_h - 2);
-  uint32_t color = use_rgb_color ? rgb_to_pixel_internal(current_fg_rgb) : color_to_pixel(current_fg);
-  for (uint32_t y = py_start; y < py_start + 2 && y < fb_height; ++y) {
-    uint8_t* line = target + (y * fb_pitch);
-    for (uint32_t x = px_start; x < px_start + font_w && x < fb_width; ++x) {
-      if (fb_bpp == 32) reinterpret_cast<uint32_t *>(line)[x] = color;
-    }
+  render_char(col * font_w, row * font_h, c, fg, bg);
+}
+
+uint32_t DisplayFramebuffer::fg_pixel() const { return use_rgb_color ? rgb_to_pixel_internal(current_fg_rgb) : color_to_pixel(current_fg); }
+uint32_t DisplayFramebuffer::bg_pixel() const { return use_rgb_color ? rgb_to_pixel_internal(current_bg_rgb) : color_to_pixel(current_bg); }
+fkernel::TextCell DisplayFramebuffer::blank_cell() const { return {' ', fg_pixel(), bg_pixel()}; }
+
+void DisplayFramebuffer::initialize_text_grid() {
+  if (!MemoryManager::the().is_initialized()) return;
+  if (!m_atlas.build(m_current_font)) fk::algorithms::kwarn("DISPLAY", "No memory for the glyph atlas, drawing glyphs bit by bit");
+  if (!m_grid.initialize(get_width(), get_height(), blank_cell())) { fk::algorithms::kwarn("DISPLAY", "No memory for the text grid, drawing characters as they arrive"); return; }
+  // What is already on screen stays until its cells are written; the old cursor is erased on the first flush
+  m_grid.clear(blank_cell());
+  m_cursor_drawn = true; m_drawn_cursor_x = cursor_x; m_drawn_cursor_y = cursor_y;
+}
+
+void DisplayFramebuffer::render_cells(uint32_t row, uint32_t first_col, uint32_t end_col) {
+  uint32_t font_w = m_current_font.width * m_current_font.scale; uint32_t font_h = m_current_font.height * m_current_font.scale;
+  for (uint32_t col = first_col; col < end_col; ++col) {
+    const fkernel::TextCell &cell = m_grid.cell(row, col);
+    render_char(col * font_w, row * font_h, static_cast<char>(cell.codepoint), cell.fg, cell.bg);
   }
-  mark_dirty(px_start, py_start, font_w, 2);
 }
 
-void DisplayFramebuffer::erase_cursor() {
+// Brings the pixels up to date with the grid: one shift for all the lines
+// scrolled since the last call, then only the cells that changed
+void DisplayFramebuffer::render_grid() {
+  if (!m_grid.is_ready()) return;
+  uint8_t *target = get_render_buffer(); if (!target) return;
+  uint32_t font_h = m_current_font.height * m_current_font.scale; uint32_t rows = m_grid.rows();
+  uint32_t shift = m_grid.take_pending_scroll();
+  if (shift) {
+    // A whole screen's worth leaves every row dirty, so nothing is worth
+    // moving. Nor is VRAM read back to scroll it: write-combined reads are uncached
+    if (shift < rows && target == back_buffer) { fk::memory::move(target, target + shift * font_h * fb_pitch, (rows - shift) * font_h * fb_pitch); m_full_redraw_requested = true; }
+    else m_grid.mark_all_dirty();
+    if (m_drawn_cursor_y >= shift) m_drawn_cursor_y -= shift; else m_cursor_drawn = false;
+  }
+  if (m_cursor_drawn) m_grid.mark_dirty(m_drawn_cursor_y, m_drawn_cursor_x, m_drawn_cursor_x + 1);
+  uint32_t first = 0, end = 0;
+  for (uint32_t row = 0; row < rows; ++row)
+    if (m_grid.take_dirty(row, first, end)) render_cells(row, first, end);
+  m_cursor_drawn = m_cursor_visible && cursor_x < m_grid.cols() && cursor_y < rows;
+  if (m_cursor_drawn) { paint_cursor(cursor_x, cursor_y, fg_pixel()); m_drawn_cursor_x = cursor_x; m_drawn_cursor_y = cursor_y; }
+}
+
+void DisplayFramebuffer::paint_cursor(uint32_t col, uint32_t row, uint32_t color) {
   uint8_t *target = get_render_buffer(); if (!target) return;
   uint32_t font_w = m_current_font.width * m_current_font.scale; uint32_t font_h = m_current_font.height * m_current_font.scale;
-  uint32_t px_start = cursor_x * font_w; uint32_t py_start = cursor_y * font_h + (font_h - 2);
-  uint32_t color = use_rgb_color ? rgb_to_pixel_internal(current_bg_rgb) : color_to_pixel(current_bg);
+  uint32_t px_start = col * font_w; uint32_t py_start = row * font_h + (font_h - 2);
   for (uint32_t y = py_start; y < py_start + 2 && y < fb_height; ++y) {
     uint8_t* line = target + (y * fb_pitch);
     for (uint32_t x = px_start; x < px_start + font_w && x < fb_width; ++x) {
@@ -197,6 +240,10 @@ void DisplayFramebuffer::erase_cursor() {
   mark_dirty(px_start, py_start, font_w, 2);
 }
 
+// With a text grid the cursor is drawn by render_grid() instead
+void DisplayFramebuffer::draw_cursor() { if (!m_grid.is_ready()) paint_cursor(cursor_x, cursor_y, fg_pixel()); }
+void DisplayFramebuffer::erase_cursor() { if (!m_grid.is_ready()) paint_cursor(cursor_x, cursor_y, bg_pixel()); }
+
 void DisplayFramebuffer::put_char(char c) { put_codepoint(static_cast<uint8_t>(c)); }
 void DisplayFramebuffer::write(const char *str) {
   size_t i = 0;
@@ -240,8 +287,9 @@ void DisplayFramebuffer::clear() {
 
   // Force all tiles to be marked clean since we just synced manually
   if (m_dirty_tiles) fk::memory::set(m_dirty_tiles, 0, (m_tiles_x * m_tiles_y + 7) / 8);
+  if (m_grid.is_ready()) m_grid.clear(blank_cell());
   
-  cursor_x = 0; cursor_y = 0; m_full_redraw_requested = false;
+  cursor_x = 0; cursor_y = 0; m_full_redraw_requested = false; m_cursor_drawn = false;
 }
 
 void DisplayFramebuffer::clear_rect(uint32_t x, uint32_t y, uint32_t width, uint32_t height) {
@@ -272,10 +320,23 @@ void DisplayFramebuffer::copy_rect(uint32_t src_x, uint32_t src_y, uint32_t dst_
   mark_dirty(dst_x, dst_y, width, height);
 }
 
+void DisplayFramebuffer::clear_cells(uint32_t row, uint32_t col, uint32_t count) {
+  if (!m_grid.is_ready()) { Display::clear_cells(row, col, count); return; }
+  fk::synchronization::ScopedLockIRQ lock(Display::lock()); m_grid.fill(row, col, count, blank_cell());
+}
+void DisplayFramebuffer::move_cells(uint32_t row, uint32_t src_col, uint32_t dst_col, uint32_t count) {
+  if (!m_grid.is_ready()) { Display::move_cells(row, src_col, dst_col, count); return; }
+  fk::synchronization::ScopedLockIRQ lock(Display::lock()); m_grid.move(row, src_col, dst_col, count);
+}
+void DisplayFramebuffer::scroll_rows(uint32_t top, uint32_t bottom, uint32_t count, bool up) {
+  if (!m_grid.is_ready()) { Display::scroll_rows(top, bottom, count, up); return; }
+  fk::synchronization::ScopedLockIRQ lock(Display::lock()); m_grid.scroll(top, bottom, count, up, blank_cell());
+}
+
 void DisplayFramebuffer::set_color(Color fg, Color bg) { fk::synchronization::ScopedLockIRQ lock(Display::lock()); current_fg = fg; current_bg = bg; use_rgb_color = false; }
 void DisplayFramebuffer::set_colors_rgb(uint32_t fg, uint32_t bg) { fk::synchronization::ScopedLockIRQ lock(Display::lock()); current_fg_rgb = fg; current_bg_rgb = bg; use_rgb_color = true; }
 void DisplayFramebuffer::set_cursor_pos(uint32_t x, uint32_t y) { fk::synchronization::ScopedLockIRQ lock(Display::lock()); erase_cursor(); cursor_x = x; cursor_y = y; draw_cursor(); }
-void DisplayFramebuffer::show_cursor(bool visible) { if (visible) draw_cursor(); else erase_cursor(); }
+void DisplayFramebuffer::show_cursor(bool visible) { fk::synchronization::ScopedLockIRQ lock(Display::lock()); m_cursor_visible = visible; if (visible) draw_cursor(); else erase_cursor(); }
 void DisplayFramebuffer::write_ansi(const char *str) { write_ansi_n(str, fk::memory::length(str)); }
 void DisplayFramebuffer::write_ansi_n([[maybe_unused]] const char *str, [[maybe_unused]] size_t size) { /* Implementação ANSI processada pelo delegate VGATerminal */ }
 
@@ -304,31 +365,41 @@ void DisplayFramebuffer::mark_dirty(uint32_t x, uint32_t y, uint32_t width, uint
   }
 }
 
+// VRAM is mapped write-combining: it is only ever written, from the back
+// buffer, in runs as long as the damage allows. Adjacent dirty tiles in a tile
+// row go out as one copy per scanline, and a fully dirty tile row as one copy.
 void DisplayFramebuffer::update_dirty_rectangles() {
   if (!m_dirty_tiles || !double_buffering_enabled) return;
-  if (m_full_redraw_requested) { fk::memory::copy(framebuffer, back_buffer, fb_height * fb_pitch); m_full_redraw_requested = false; return; }
+  if (m_full_redraw_requested) { fk::memory::copy(framebuffer, back_buffer, fb_height * fb_pitch); m_full_redraw_requested = false; fk::memory::set(m_dirty_tiles, 0, (m_tiles_x * m_tiles_y + 7) / 8); return; }
   uint32_t bpp_bytes = fb_bpp / 8;
+  auto is_dirty = [&](uint32_t tile_idx) { return m_dirty_tiles[tile_idx / 8] & (1 << (tile_idx % 8)); };
   for (uint32_t ty = 0; ty < m_tiles_y; ++ty) {
-    for (uint32_t tx = 0; tx < m_tiles_x; ++tx) {
-      uint32_t tile_idx = ty * m_tiles_x + tx;
-      if (m_dirty_tiles[tile_idx / 8] & (1 << (tile_idx % 8))) {
-        uint32_t x = tx * TILE_SIZE; uint32_t y = ty * TILE_SIZE; uint32_t w = TILE_SIZE; uint32_t h = TILE_SIZE;
-        if (x + w > fb_width) w = fb_width - x; if (y + h > fb_height) h = fb_height - y;
-        uint32_t line_size = w * bpp_bytes;
-        for (uint32_t i = 0; i < h; ++i) fk::memory::copy(framebuffer + (y + i) * fb_pitch + x * bpp_bytes, back_buffer + (y + i) * fb_pitch + x * bpp_bytes, line_size);
-        m_dirty_tiles[tile_idx / 8] &= ~(1 << (tile_idx % 8));
-      }
+    uint32_t y = ty * TILE_SIZE; uint32_t h = TILE_SIZE; if (y + h > fb_height) h = fb_height - y;
+    for (uint32_t tx = 0; tx < m_tiles_x;) {
+      if (!is_dirty(ty * m_tiles_x + tx)) { ++tx; continue; }
+      uint32_t run_end = tx;
+      while (run_end < m_tiles_x && is_dirty(ty * m_tiles_x + run_end)) { uint32_t tile_idx = ty * m_tiles_x + run_end; m_dirty_tiles[tile_idx / 8] &= ~(1 << (tile_idx % 8)); ++run_end; }
+      uint32_t x = tx * TILE_SIZE; uint32_t w = (run_end - tx) * TILE_SIZE; if (x + w > fb_width) w = fb_width - x;
+      if (tx == 0 && run_end == m_tiles_x) fk::memory::copy(framebuffer + y * fb_pitch, back_buffer + y * fb_pitch, h * fb_pitch);
+      else for (uint32_t i = 0; i < h; ++i) fk::memory::copy(framebuffer + (y + i) * fb_pitch + x * bpp_bytes, back_buffer + (y + i) * fb_pitch + x * bpp_bytes, w * bpp_bytes);
+      tx = run_end;
     }
   }
 }
 
 uint8_t* DisplayFramebuffer::get_render_buffer() { if (double_buffering_enabled && back_buffer) return back_buffer; return framebuffer; }
-void DisplayFramebuffer::flush() { if (!double_buffering_enabled || !back_buffer || !m_dirty_tiles) return; fk::synchronization::ScopedLockIRQ lock(Display::lock()); update_dirty_rectangles(); m_last_flush_tick = TickManager::the().get_ticks(); }
+void DisplayFramebuffer::flush() {
+  bool blit = double_buffering_enabled && back_buffer && m_dirty_tiles;
+  if (!blit && !m_grid.is_ready()) return;
+  fk::synchronization::ScopedLockIRQ lock(Display::lock()); render_grid(); if (blit) update_dirty_rectangles(); m_last_flush_tick = TickManager::the().get_ticks();
+}
+// Terminal output is only rendered here, at most ~60 times a second, however much of it arrives in between
 void DisplayFramebuffer::background_flush() {
-  if (!double_buffering_enabled || !back_buffer || !m_dirty_tiles) return;
+  bool blit = double_buffering_enabled && back_buffer && m_dirty_tiles;
+  if (!blit && !m_grid.is_ready()) return;
   uint64_t current_tick = TickManager::the().get_ticks(); uint32_t freq = TickManager::the().get_frequency(); if (freq == 0) freq = 100;
   if (current_tick >= m_last_flush_tick + (freq / 60)) {
-    if (Display::lock().try_lock()) { update_dirty_rectangles(); m_last_flush_tick = current_tick; Display::lock().unlock(); }
+    if (Display::lock().try_lock()) { render_grid(); if (blit) update_dirty_rectangles(); m_last_flush_tick = current_tick; Display::lock().unlock(); }
   }
 }
 void DisplayFramebuffer::next_frame() {}
@@ -340,7 +411,7 @@ void DisplayFramebuffer::allocate_dirty_tiles() {
   if (m_dirty_tiles) fk::memory::set(m_dirty_tiles, 0xFF, bitset_size);
 }
 void DisplayFramebuffer::free_dirty_tiles() { if (m_dirty_tiles) { MemoryManager::the().free(m_dirty_tiles); m_dirty_tiles = nullptr; } }
-void DisplayFramebuffer::finalize_initialization() { allocate_back_buffer(); allocate_dirty_tiles(); }
-void DisplayFramebuffer::save_screen() { if (!back_buffer) return; size_t buffer_size = fb_height * fb_pitch; if (!saved_buffer) saved_buffer = static_cast<uint8_t*>(MemoryManager::the().allocate(buffer_size)); if (saved_buffer) fk::memory::copy(saved_buffer, back_buffer, buffer_size); }
-void DisplayFramebuffer::restore_screen() { if (!back_buffer || !saved_buffer) return; size_t buffer_size = fb_height * fb_pitch; fk::memory::copy(back_buffer, saved_buffer, buffer_size); m_full_redraw_requested = true; }
+void DisplayFramebuffer::finalize_initialization() { allocate_back_buffer(); allocate_dirty_tiles(); if (!m_grid.is_ready()) initialize_text_grid(); }
+void DisplayFramebuffer::save_screen() { if (m_grid.is_ready()) { fk::synchronization::ScopedLockIRQ lock(Display::lock()); m_grid.save(); return; } if (!back_buffer) return; size_t buffer_size = fb_height * fb_pitch; if (!saved_buffer) saved_buffer = static_cast<uint8_t*>(MemoryManager::the().allocate(buffer_size)); if (saved_buffer) fk::memory::copy(saved_buffer, back_buffer, buffer_size); }
+void DisplayFramebuffer::restore_screen() { if (m_grid.is_ready()) { fk::synchronization::ScopedLockIRQ lock(Display::lock()); m_grid.restore(); return; } if (!back_buffer || !saved_buffer) return; size_t buffer_size = fb_height * fb_pitch; fk::memory::copy(back_buffer, saved_buffer, buffer_size); m_full_redraw_requested = true; }
 void DisplayFramebuffer::test_render() {}
\ No newline at end of file
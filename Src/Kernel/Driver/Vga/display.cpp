@@ -43,4 +43,38 @@ void Display::switch_to(Display &driver) {
   s_current_display = &driver;
   s_current_display->clear();
   fk::algorithms::klog("DISPLAY", "Switched to new display driver");
-}
\ No newline at end of file
+}
+
+// Cell operations in terms of pixel rectangles, for backends without a text
+// model. In text mode a "pixel" is a cell, so the same arithmetic holds.
+void Display::clear_cells(uint32_t row, uint32_t col, uint32_t count) {
+  auto fb = get_framebuffer_info();
+  uint32_t char_w = fb.width / get_width();
+  uint32_t char_h = fb.height / get_height();
+  clear_rect(col * char_w, row * char_h, count * char_w, char_h);
+}
+
+void Display::move_cells(uint32_t row, uint32_t src_col, uint32_t dst_col, uint32_t count) {
+  auto fb = get_framebuffer_info();
+  uint32_t char_w = fb.width / get_width();
+  uint32_t char_h = fb.height / get_height();
+  copy_rect(src_col * char_w, row * char_h, dst_col * char_w, row * char_h, count * char_w, char_h);
+}
+
+void Display::scroll_rows(uint32_t top, uint32_t bottom, uint32_t count, bool up) {
+  auto fb = get_framebuffer_info();
+  uint32_t char_h = fb.height / get_height();
+  if (top >= bottom) return;
+  if (count >= bottom - top) {
+    clear_rect(0, top * char_h, fb.width, (bottom - top) * char_h);
+    return;
+  }
+  uint32_t kept = (bottom - top - count) * char_h;
+  if (up) {
+    copy_rect(0, (top + count) * char_h, 0, top * char_h, fb.width, kept);
+    clear_rect(0, (bottom - count) * char_h, fb.width, count * char_h);
+  } else {
+    copy_rect(0, top * char_h, 0, (top + count) * char_h, fb.width, kept);
+    clear_rect(0, top * char_h, fb.width, count * char_h);
+  }
+}
@@ -0,0 +1,49 @@
+#include <Kernel/Driver/Vga/glyph_atlas.h>
+#include <Kernel/Memory/memory_manager.h>
+
+namespace fkernel {
+
+GlyphAtlas::~GlyphAtlas() { reset(); }
+
+bool GlyphAtlas::build(const Vga::Font& font) {
+    reset();
+    if (!font.data || font.last_char < font.first_char) return false;
+
+    uint32_t scale = font.scale ? font.scale : 1;
+    uint32_t width = font.width * scale;
+    uint32_t height = font.height * scale;
+    uint32_t count = font.last_char - font.first_char + 1;
+    m_masks = static_cast<uint32_t*>(
+        MemoryManager::the().allocate(size_t(count) * width * height * sizeof(uint32_t)));
+    if (!m_masks) return false;
+
+    for (uint32_t g = 0; g < count; ++g) {
+        const uint8_t* bits = font.data + g * font.height;
+        uint32_t* out = m_masks + size_t(g) * width * height;
+        for (uint32_t y = 0; y < height; ++y) {
+            uint8_t row = bits[y / scale];
+            for (uint32_t x = 0; x < width; ++x)
+                out[y * width + x] = (row & (0x80 >> (x / scale))) ? ~0u : 0u;
+        }
+    }
+    m_glyph_width = width;
+    m_glyph_height = height;
+    m_first_char = font.first_char;
+    m_last_char = font.last_char;
+    return true;
+}
+
+void GlyphAtlas::reset() {
+    if (m_masks) {
+        MemoryManager::the().free(m_masks);
+        m_masks = nullptr;
+    }
+    m_glyph_width = m_glyph_height = 0;
+}
+
+const uint32_t* GlyphAtlas::glyph(uint32_t codepoint) const {
+    if (codepoint < m_first_char || codepoint > m_last_char) codepoint = '?';
+    return m_masks + size_t(codepoint - m_first_char) * m_glyph_width * m_glyph_height;
+}
+
+} // namespace fkernel
@@ -0,0 +1,157 @@
+#include <Kernel/Driver/Vga/text_grid.h>
+#include <Kernel/Memory/memory_manager.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+
+TextGrid::~TextGrid() { reset(); }
+
+bool TextGrid::initialize(uint32_t cols, uint32_t rows, const TextCell& blank) {
+    reset();
+    if (!cols || !rows || cols > 0xFFFF) return false;
+    size_t count = size_t(cols) * rows;
+    m_cells = static_cast<TextCell*>(MemoryManager::the().allocate(count * sizeof(TextCell)));
+    m_dirty = static_cast<DirtySpan*>(MemoryManager::the().allocate(rows * sizeof(DirtySpan)));
+    if (!m_cells || !m_dirty) {
+        reset();
+        return false;
+    }
+    m_cols = cols;
+    m_rows = rows;
+    m_top = 0;
+    m_pending_scroll = 0;
+    for (size_t i = 0; i < count; ++i) m_cells[i] = blank;
+    mark_all_dirty();
+    return true;
+}
+
+void TextGrid::reset() {
+    if (m_cells) MemoryManager::the().free(m_cells);
+    if (m_saved) MemoryManager::the().free(m_saved);
+    if (m_dirty) MemoryManager::the().free(m_dirty);
+    m_cells = m_saved = nullptr;
+    m_dirty = nullptr;
+    m_cols = m_rows = 0;
+}
+
+void TextGrid::mark_dirty(uint32_t row, uint32_t first_col, uint32_t end_col) {
+    if (row >= m_rows || first_col >= end_col) return;
+    if (end_col > m_cols) end_col = m_cols;
+    DirtySpan& span = m_dirty[row];
+    if (span.first >= span.end) {
+        span = {uint16_t(first_col), uint16_t(end_col)};
+        return;
+    }
+    if (first_col < span.first) span.first = uint16_t(first_col);
+    if (end_col > span.end) span.end = uint16_t(end_col);
+}
+
+void TextGrid::mark_all_dirty() {
+    for (uint32_t row = 0; row < m_rows; ++row) m_dirty[row] = {0, uint16_t(m_cols)};
+}
+
+bool TextGrid::take_dirty(uint32_t row, uint32_t& first_col, uint32_t& end_col) {
+    DirtySpan& span = m_dirty[row];
+    if (span.first >= span.end) return false;
+    first_col = span.first;
+    end_col = span.end;
+    span = {0, 0};
+    return true;
+}
+
+uint32_t TextGrid::take_pending_scroll() {
+    uint32_t lines = m_pending_scroll;
+    m_pending_scroll = 0;
+    return lines;
+}
+
+void TextGrid::put(uint32_t row, uint32_t col, const TextCell& cell) {
+    if (row >= m_rows || col >= m_cols) return;
+    TextCell& target = row_cells(row)[col];
+    if (target == cell) return;
+    target = cell;
+    mark_dirty(row, col, col + 1);
+}
+
+void TextGrid::fill(uint32_t row, uint32_t col, uint32_t count, const TextCell& blank) {
+    if (row >= m_rows || col >= m_cols) return;
+    if (count > m_cols - col) count = m_cols - col;
+    TextCell* cells = row_cells(row);
+    for (uint32_t i = col; i < col + count; ++i) cells[i] = blank;
+    mark_dirty(row, col, col + count);
+}
+
+void TextGrid::move(uint32_t row, uint32_t src_col, uint32_t dst_col, uint32_t count) {
+    if (row >= m_rows || src_col >= m_cols || dst_col >= m_cols) return;
+    uint32_t limit = m_cols - (src_col > dst_col ? src_col : dst_col);
+    if (count > limit) count = limit;
+    if (!count) return;
+    TextCell* cells = row_cells(row);
+    fk::memory::move(cells + dst_col, cells + src_col, count * sizeof(TextCell));
+    mark_dirty(row, dst_col, dst_col + count);
+}
+
+void TextGrid::scroll(uint32_t top, uint32_t bottom, uint32_t count, bool up,
+                      const TextCell& blank) {
+    if (bottom > m_rows) bottom = m_rows;
+    if (top >= bottom || !count) return;
+    uint32_t height = bottom - top;
+    if (count > height) count = height;
+
+    if (up && top == 0 && bottom == m_rows) {
+        // Whole screen: rotate the ring; the old top rows come back blank at the bottom
+        for (uint32_t i = 0; i < count; ++i) {
+            TextCell* cells = row_cells(0);
+            for (uint32_t col = 0; col < m_cols; ++col) cells[col] = blank;
+            m_top = (m_top + 1) % m_rows;
+        }
+        // Pending damage moves with the text, which the renderer shifts too
+        for (uint32_t row = 0; row + count < m_rows; ++row) m_dirty[row] = m_dirty[row + count];
+        for (uint32_t row = m_rows - count; row < m_rows; ++row) m_dirty[row] = {0, uint16_t(m_cols)};
+        m_pending_scroll += count;
+        if (m_pending_scroll >= m_rows) {
+            m_pending_scroll = m_rows;
+            mark_all_dirty();
+        }
+        return;
+    }
+
+    // A region: copy the rows that stay, then redraw the whole region
+    for (uint32_t i = 0; i < height - count; ++i) {
+        uint32_t dst = up ? top + i : bottom - 1 - i;
+        uint32_t src = up ? dst + count : dst - count;
+        fk::memory::copy(row_cells(dst), row_cells(src), m_cols * sizeof(TextCell));
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        TextCell* cells = row_cells(up ? bottom - 1 - i : top + i);
+        for (uint32_t col = 0; col < m_cols; ++col) cells[col] = blank;
+    }
+    for (uint32_t row = top; row < bottom; ++row) m_dirty[row] = {0, uint16_t(m_cols)};
+}
+
+void TextGrid::clear(const TextCell& blank) {
+    size_t count = size_t(m_cols) * m_rows;
+    for (size_t i = 0; i < count; ++i) m_cells[i] = blank;
+    for (uint32_t row = 0; row < m_rows; ++row) m_dirty[row] = {0, 0};
+    m_top = 0;
+    m_pending_scroll = 0;
+}
+
+bool TextGrid::save() {
+    size_t bytes = size_t(m_cols) * m_rows * sizeof(TextCell);
+    if (!m_saved) m_saved = static_cast<TextCell*>(MemoryManager::the().allocate(bytes));
+    if (!m_saved) return false;
+    for (uint32_t row = 0; row < m_rows; ++row)
+        fk::memory::copy(m_saved + row * m_cols, row_cells(row), m_cols * sizeof(TextCell));
+    return true;
+}
+
+void TextGrid::restore() {
+    if (!m_saved) return;
+    m_top = 0;
+    m_pending_scroll = 0;
+    fk::memory::copy(m_cells, m_saved, size_t(m_cols) * m_rows * sizeof(TextCell));
+    mark_all_dirty();
+}
+
+} // namespace fkernel
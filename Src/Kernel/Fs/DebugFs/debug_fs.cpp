@@ -1,4 +1,5 @@
 #include <Kernel/Fs/DebugFs/debug_fs.h>
+#include <Kernel/Trace/tracer.h>
 #include <LibFK/Utilities/memory.h>
 #include <LibFK/Memory/new.h>
 
@@ -39,36 +40,62 @@ size_t DebugLogNode::size() const {
     return m_buffer.size();
 }
 
-SyscallLogNode::SyscallLogNode() {}
+TraceNode::TraceNode() {}
 
-fk::RefPtr<SyscallLogNode> SyscallLogNode::the() {
-    static fk::RefPtr<SyscallLogNode> instance = fk::make_ref<SyscallLogNode>().value();
+fk::RefPtr<TraceNode> TraceNode::the() {
+    static fk::RefPtr<TraceNode> instance = fk::make_ref<TraceNode>().value();
     return instance;
 }
 
-void SyscallLogNode::append(const char* str, size_t len) {
-    fk::synchronization::ScopedLockIRQ lock(m_lock);
-    for (size_t i = 0; i < len; ++i) {
-        if (m_buffer.size() >= MAX_LOG_SIZE) m_buffer.clear();
-        m_buffer.push_back(static_cast<uint8_t>(str[i]));
+fk::core::Result<size_t, fk::core::Error> TraceNode::read(uint64_t, size_t size, uint8_t* buffer) {
+    using fkernel::trace::TraceEvent;
+    if (size < sizeof(TraceEvent)) return fk::core::Error::InvalidParameter;
+
+    // Drain in small batches so the consumer lock is never held for long.
+    TraceEvent batch[8];
+    size_t wanted = size / sizeof(TraceEvent);
+    size_t copied = 0;
+    while (copied < wanted) {
+        size_t chunk = wanted - copied;
+        if (chunk > 8) chunk = 8;
+        size_t got = fkernel::trace::Tracer::the().consume(batch, chunk);
+        if (got == 0) break;
+        fk::memory::copy(buffer + copied * sizeof(TraceEvent), batch, got * sizeof(TraceEvent));
+        copied += got;
     }
+    return copied * sizeof(TraceEvent);
 }
 
-fk::core::Result<size_t, fk::core::Error> SyscallLogNode::read(uint64_t offset, size_t size, uint8_t* buffer) {
-    fk::synchronization::ScopedLockIRQ lock(m_lock);
-    if (offset >= m_buffer.size()) return 0;
-    size_t to_read = (offset + size > m_buffer.size()) ? (m_buffer.size() - offset) : size;
-    fk::memory::copy(buffer, m_buffer.begin() + offset, to_read);
-    return to_read;
+fk::core::Result<size_t, fk::core::Error> TraceNode::write(uint64_t, size_t size, const uint8_t*) {
+    fkernel::trace::Tracer::the().clear();
+    return size;
 }
 
-fk::core::Result<size_t, fk::core::Error> SyscallLogNode::write(uint64_t, size_t size, const uint8_t* buffer) {
-    append(reinterpret_cast<const char*>(buffer), size);
-    return size;
+size_t TraceNode::size() const {
+    return fkernel::trace::Tracer::the().pending() * sizeof(fkernel::trace::TraceEvent);
 }
 
-size_t SyscallLogNode::size() const {
-    return m_buffer.size();
+TraceControlNode::TraceControlNode() {}
+
+fk::RefPtr<TraceControlNode> TraceControlNode::the() {
+    static fk::RefPtr<TraceControlNode> instance = fk::make_ref<TraceControlNode>().value();
+    return instance;
+}
+
+fk::core::Result<size_t, fk::core::Error> TraceControlNode::read(uint64_t offset, size_t size, uint8_t* buffer) {
+    const char state[2] = {fkernel::trace::Tracer::the().is_enabled() ? '1' : '0', '\n'};
+    if (offset >= sizeof(state)) return 0;
+    size_t to_read = (offset + size > sizeof(state)) ? (sizeof(state) - offset) : size;
+    fk::memory::copy(buffer, state + offset, to_read);
+    return to_read;
+}
+
+fk::core::Result<size_t, fk::core::Error> TraceControlNode::write(uint64_t, size_t size, const uint8_t* buffer) {
+    if (size == 0) return fk::core::Error::InvalidParameter;
+    if (buffer[0] == '1') fkernel::trace::Tracer::the().set_enabled(true);
+    else if (buffer[0] == '0') fkernel::trace::Tracer::the().set_enabled(false);
+    else return fk::core::Error::InvalidParameter;
+    return size;
 }
 
 DebugFsNode::DebugFsNode() {}
@@ -77,11 +104,11 @@ fk::core::Result<fk::RefPtr<Node>, fk::core::Error> DebugFsNode::lookup(const ch
     if (fk::memory::compare(name, "klog") == 0) {
         return fk::RefPtr<Node>(DebugLogNode::the());
     }
-    if (fk::memory::compare(name, "syscalls") == 0) {
-        return fk::RefPtr<Node>(SyscallLogNode::the());
+    if (fk::memory::compare(name, "trace") == 0) {
+        return fk::RefPtr<Node>(TraceNode::the());
     }
-    if (fk::memory::compare(name, "ipc") == 0) {
-        return fk::RefPtr<Node>(IpcLogNode::the());
+    if (fk::memory::compare(name, "tracing_on") == 0) {
+        return fk::RefPtr<Node>(TraceControlNode::the());
     }
     return fk::core::Error::NotFound;
 }
@@ -92,15 +119,15 @@ fk::core::Result<void, fk::core::Error> DebugFsNode::list_dir(fk::containers::Ve
     klog_de.type = 0;
     entries.push_back(klog_de);
 
-    DirectoryEntry syscalls_de;
-    fk::memory::copy_string(syscalls_de.name, "syscalls");
-    syscalls_de.type = 0;
-    entries.push_back(syscalls_de);
+    DirectoryEntry trace_de;
+    fk::memory::copy_string(trace_de.name, "trace");
+    trace_de.type = 0;
+    entries.push_back(trace_de);
 
-    DirectoryEntry ipc_de;
-    fk::memory::copy_string(ipc_de.name, "ipc");
-    ipc_de.type = 0;
-    entries.push_back(ipc_de);
+    DirectoryEntry tracing_on_de;
+    fk::memory::copy_string(tracing_on_de.name, "tracing_on");
+    tracing_on_de.type = 0;
+    entries.push_back(tracing_on_de);
 
     return {};
 }
@@ -10,6 +10,8 @@
 #include <Kernel/Fs/ProcFs/proc_sys_node.h>
 #include <Kernel/Fs/ProcFs/proc_loadavg_node.h>
 #include <Kernel/Fs/ProcFs/proc_cpuinfo_node.h>
+#include <Kernel/Fs/ProcFs/proc_syscall_stats_node.h>
+#include <Kernel/Fs/ProcFs/proc_lock_stat_node.h>
 #include <Kernel/Fs/ProcFs/proc_pid_dir_node.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Algorithms/log.h>
@@ -68,6 +70,18 @@ fk::core::Result<void, fk::core::Error> ProcFsNode::list_dir(fk::containers::Vec
   cpuinfo_de.type = 0;
   entries.push_back(cpuinfo_de);
 
+  DirectoryEntry syscall_stats_de;
+  fk::memory::copy_n(syscall_stats_de.name, "syscall_stats", sizeof(syscall_stats_de.name));
+  syscall_stats_de.type = 0;
+  entries.push_back(syscall_stats_de);
+
+#ifdef FKERNEL_LOCK_STAT
+  DirectoryEntry lock_stat_de;
+  fk::memory::copy_n(lock_stat_de.name, "lock_stat", sizeof(lock_stat_de.name));
+  lock_stat_de.type = 0;
+  entries.push_back(lock_stat_de);
+#endif
+
   auto& scheduler = SchedulerManager::the();
   uint64_t max_pid = scheduler.last_pid();
   for (uint64_t pid = 1; pid < max_pid; ++pid) {
@@ -110,6 +124,12 @@ fk::core::Result<fk::RefPtr<Node>, fk::core::Error> ProcFsNode::lookup(const cha
     return fk::RefPtr<Node>(fk::make_ref<ProcLoadavgNode>().value());
   if (fk::memory::compare(name, "cpuinfo") == 0)
     return fk::RefPtr<Node>(fk::make_ref<ProcCpuinfoNode>().value());
+  if (fk::memory::compare(name, "syscall_stats") == 0)
+    return fk::RefPtr<Node>(fk::make_ref<ProcSyscallStatsNode>().value());
+#ifdef FKERNEL_LOCK_STAT
+  if (fk::memory::compare(name, "lock_stat") == 0)
+    return fk::RefPtr<Node>(fk::make_ref<ProcLockStatNode>().value());
+#endif
 
   uint64_t pid = 0;
   const char* p = name;
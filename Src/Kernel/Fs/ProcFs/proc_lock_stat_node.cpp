@@ -0,0 +1,57 @@
+#include <Kernel/Fs/ProcFs/proc_lock_stat_node.h>
+
+#ifdef FKERNEL_LOCK_STAT
+#include <Kernel/Clock/ClockSource/tsc_clock_source.h>
+#include <LibFK/Synchronization/lock_stat.h>
+
+using namespace fk::core;
+
+void ProcLockStatNode::ensure_cached() {
+  if (!m_cached.is_empty()) return;
+
+  auto append = [this](const char* s, int len) {
+    for (int i = 0; i < len; ++i) m_cached.push_back(static_cast<uint8_t>(s[i]));
+  };
+
+  char line[256];
+  int len = snprintf(line, sizeof(line),
+                     "# write to this file to reset the counters\n"
+                     "# cycles are TSC cycles; max_hold only counts holds with interrupts off\n"
+                     "tsc_khz %llu\n"
+                     "# class                 acquisitions   contended   avg_spin   max_spin   max_hold\n",
+                     (unsigned long long)(TscClockSource::the().frequency_hz() / 1000));
+  append(line, len);
+
+  using fk::synchronization::g_lock_classes;
+  uint32_t count = __atomic_load_n(&fk::synchronization::g_lock_class_count, __ATOMIC_ACQUIRE);
+  for (size_t i = 0; i < fk::synchronization::LOCK_STAT_MAX_CLASSES; ++i) {
+    const auto& c = g_lock_classes[i];
+    if (i >= count && !c.acquisitions) continue;
+    uint64_t contended = __atomic_load_n(&c.contended, __ATOMIC_RELAXED);
+    uint64_t spin = __atomic_load_n(&c.spin_cycles, __ATOMIC_RELAXED);
+    len = snprintf(line, sizeof(line), "%-22s %14llu %11llu %10llu %10llu %10llu\n",
+                   c.name ? c.name : "?",
+                   (unsigned long long)__atomic_load_n(&c.acquisitions, __ATOMIC_RELAXED),
+                   (unsigned long long)contended,
+                   (unsigned long long)(contended ? spin / contended : 0),
+                   (unsigned long long)__atomic_load_n(&c.max_spin_cycles, __ATOMIC_RELAXED),
+                   (unsigned long long)__atomic_load_n(&c.max_hold_cycles, __ATOMIC_RELAXED));
+    append(line, len);
+  }
+}
+
+fk::core::Result<size_t, fk::core::Error> ProcLockStatNode::read(uint64_t offset, size_t size, uint8_t* buffer) {
+  ensure_cached();
+  if (offset >= m_cached.size()) return static_cast<size_t>(0);
+  size_t available = m_cached.size() - (size_t)offset;
+  size_t to_copy = (size < available) ? size : available;
+  for (size_t i = 0; i < to_copy; ++i) buffer[i] = m_cached[(size_t)offset + i];
+  return to_copy;
+}
+
+fk::core::Result<size_t, fk::core::Error> ProcLockStatNode::write(uint64_t, size_t size, const uint8_t*) {
+  fk::synchronization::lock_stat_reset();
+  m_cached.clear();
+  return size;
+}
+#endif
@@ -1,6 +1,8 @@
 #include <Kernel/Fs/ProcFs/proc_meminfo_node.h>
 #include <Kernel/Memory/memory_manager.h>
 #include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <Kernel/Memory/VirtualMemory/file_page_cache.h>
+#include <Kernel/Memory/VirtualMemory/transparent_huge_pages.h>
 #include <LibFK/Algorithms/log.h>
 
 using namespace fk::core;
@@ -17,17 +19,29 @@ fk::core::Result<size_t, fk::core::Error> ProcMeminfoNode::read(uint64_t offset,
   size_t total_phys = PhysicalMemoryManager::the().total_memory();
   size_t heap_total = 0, heap_free = 0;
   MemoryManager::the().heap_stats(heap_total, heap_free);
-  char buf[512];
+  auto thp = fkernel::TransparentHugePages::the().counters();
+  size_t cached_pages = fkernel::FilePageCache::the().cached_pages();
+  char buf[768];
   int len = snprintf(buf, sizeof(buf),
     "MemTotal:     %8zu kB\n"
     "MemFree:      %8zu kB\n"
     "MemAvailable: %8zu kB\n"
     "Buffers:             0 kB\n"
-    "Cached:              0 kB\n"
+    "Cached:       %8zu kB\n"
     "SwapTotal:           0 kB\n"
-    "SwapFree:            0 kB\n",
+    "SwapFree:            0 kB\n"
+    "AnonHugePages: %8lu kB\n"
+    "Hugepagesize:     2048 kB\n"
+    "ThpFaultAlloc:    %8lu\n"
+    "ThpFaultFallback: %8lu\n"
+    "ThpSplit:         %8lu\n",
     total_phys / 1024,
     heap_free / 1024,
-    heap_free / 1024);
+    heap_free / 1024,
+    cached_pages * (PAGE_SIZE / 1024),
+    thp.anon_pages * (PAGE_SIZE_2M / 1024),
+    thp.fault_alloc,
+    thp.fault_fallback,
+    thp.split);
   return read_from_buf(buf, (size_t)len, offset, size, buffer);
 }
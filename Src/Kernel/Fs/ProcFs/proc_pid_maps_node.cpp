@@ -0,0 +1,41 @@
+#include <Kernel/Fs/ProcFs/proc_pid_maps_node.h>
+#include <Kernel/Memory/VirtualMemory/vma_tree.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <LibFK/Algorithms/log.h>
+
+using namespace fk::core;
+
+void ProcPidMapsNode::ensure_cached() {
+  if (!m_cached.is_empty()) return;
+  auto t = SchedulerManager::the().find_task(fk::ProcessId(m_pid));
+  if (!t) return;
+
+  fk::RefPtr<fkernel::VmaTree> vmas;
+  {
+    fk::synchronization::ScopedLock task_lock(t->lock);
+    vmas = t->resources.memory.vmas;
+  }
+  if (!vmas) return;
+
+  // Same layout as Linux; there is no device to report
+  vmas->for_each([this](const fkernel::Vma& vma) {
+    char line[128];
+    snprintf(line, sizeof(line), "%012lx-%012lx %c%c%cp %08lx 00:00 %lu %s\n",
+             (unsigned long)vma.start, (unsigned long)vma.end,
+             (vma.flags & PageFlags::Present) ? 'r' : '-',
+             (vma.flags & PageFlags::Writable) ? 'w' : '-',
+             (vma.flags & PageFlags::ExecuteDisable) ? '-' : 'x',
+             (unsigned long)vma.file_offset,
+             vma.is_file_backed() ? (unsigned long)vma.file->inode() : 0UL, vma.name.c_str());
+    for (size_t i = 0; line[i]; ++i) m_cached.push_back(static_cast<uint8_t>(line[i]));
+  });
+}
+
+fk::core::Result<size_t, fk::core::Error> ProcPidMapsNode::read(uint64_t offset, size_t size, uint8_t* buffer) {
+  ensure_cached();
+  if (offset >= m_cached.size()) return static_cast<size_t>(0);
+  size_t available = m_cached.size() - (size_t)offset;
+  size_t to_copy = (size < available) ? size : available;
+  for (size_t i = 0; i < to_copy; ++i) buffer[i] = m_cached[(size_t)offset + i];
+  return to_copy;
+}
@@ -0,0 +1,76 @@
+#include <Kernel/Clock/ClockSource/tsc_clock_source.h>
+#include <Kernel/Fs/ProcFs/proc_syscall_stats_node.h>
+#include <Kernel/Syscall/syscall_stats.h>
+#include <LibFK/Algorithms/log.h>
+#include <LibFK/Memory/heap_malloc.h>
+
+using namespace fk::core;
+
+// Upper bound (in cycles) of the histogram bucket holding the given percentile.
+static uint64_t percentile_cycles(const fkernel::SyscallCounters& c, uint64_t percent) {
+  uint64_t target = (c.calls * percent + 99) / 100;
+  uint64_t seen = 0;
+  for (size_t b = 0; b < fkernel::SYSCALL_LATENCY_BUCKETS; ++b) {
+    seen += c.latency[b];
+    if (seen >= target) return 2ULL << b;
+  }
+  return 2ULL << (fkernel::SYSCALL_LATENCY_BUCKETS - 1);
+}
+
+void ProcSyscallStatsNode::ensure_cached() {
+  if (!m_cached.is_empty()) return;
+
+  auto* totals = static_cast<fkernel::SyscallCounters*>(
+      kmalloc(sizeof(fkernel::SyscallCounters) * SYS_MAX));
+  if (!totals) return;
+  fkernel::SyscallStats::the().snapshot(totals);
+
+  auto append = [this](const char* s, int len) {
+    for (int i = 0; i < len; ++i) m_cached.push_back(static_cast<uint8_t>(s[i]));
+  };
+
+  char line[512];
+  int len = snprintf(line, sizeof(line),
+                     "# write to this file to reset the counters\n"
+                     "# histogram k:n = n calls took [2^k, 2^(k+1)) TSC cycles\n"
+                     "tsc_khz %llu\n"
+                     "#  nr        calls     errors    avg_cyc    p50_cyc    p99_cyc  histogram\n",
+                     (unsigned long long)(TscClockSource::the().frequency_hz() / 1000));
+  append(line, len);
+
+  for (size_t nr = 0; nr < SYS_MAX; ++nr) {
+    const auto& c = totals[nr];
+    if (c.calls == 0) continue;
+    len = snprintf(line, sizeof(line), "%5zu %12llu %10llu %10llu %10llu %10llu  ", nr,
+                   (unsigned long long)c.calls, (unsigned long long)c.errors,
+                   (unsigned long long)(c.cycles / c.calls),
+                   (unsigned long long)percentile_cycles(c, 50),
+                   (unsigned long long)percentile_cycles(c, 99));
+    bool first = true;
+    for (size_t b = 0; b < fkernel::SYSCALL_LATENCY_BUCKETS && len < (int)sizeof(line) - 24; ++b) {
+      if (!c.latency[b]) continue;
+      len += snprintf(line + len, sizeof(line) - len, "%s%zu:%u", first ? "" : ",", b,
+                      c.latency[b]);
+      first = false;
+    }
+    line[len++] = '\n';
+    append(line, len);
+  }
+
+  kfree(totals);
+}
+
+fk::core::Result<size_t, fk::core::Error> ProcSyscallStatsNode::read(uint64_t offset, size_t size, uint8_t* buffer) {
+  ensure_cached();
+  if (offset >= m_cached.size()) return static_cast<size_t>(0);
+  size_t available = m_cached.size() - (size_t)offset;
+  size_t to_copy = (size < available) ? size : available;
+  for (size_t i = 0; i < to_copy; ++i) buffer[i] = m_cached[(size_t)offset + i];
+  return to_copy;
+}
+
+fk::core::Result<size_t, fk::core::Error> ProcSyscallStatsNode::write(uint64_t, size_t size, const uint8_t*) {
+  fkernel::SyscallStats::the().reset();
+  m_cached.clear();
+  return size;
+}
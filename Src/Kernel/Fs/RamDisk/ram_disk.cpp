@@ -1,6 +1,6 @@
+#include <Kernel/Arch/x86_64/arch_defs.h>
 #include <Kernel/Fs/RamDisk/ram_disk.h>
 
-#include <LibFK/Algorithms/container_algorithms.h>
 #include <LibFK/Algorithms/log.h>
 #include <LibFK/Memory/new.h>
 #include <LibFK/Utilities/memory.h>
@@ -16,6 +16,16 @@ fk::core::Result<size_t, fk::core::Error> RamFileNode::read(uint64_t offset, siz
   return to_read;
 }
 
+// The initrd is identity mapped and reserved for good, so a page of file data
+// that starts on a frame boundary is a frame of its own. The page holding the
+// end of the file is not: the next TAR header follows it.
+uintptr_t RamFileNode::backing_frame(uint64_t offset) const {
+  if (offset + PAGE_SIZE > m_size)
+    return 0;
+  uintptr_t addr = reinterpret_cast<uintptr_t>(m_data) + offset;
+  return (addr % PAGE_SIZE) ? 0 : addr;
+}
+
 fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error> RamDiskNode::create(uintptr_t start,
                                                                                uintptr_t end) {
   auto res = TRY(fk::make_ref<RamDiskNode>(start, end));
@@ -23,6 +33,22 @@ fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error> RamDiskNode::create(u
   return fk::core::Result<fk::RefPtr<RamDiskNode>>(res);
 }
 
+// Copies the first component of path into component and returns what
+// follows it, or nullptr if the component does not fit
+static const char* next_component(const char* path, char* component, size_t capacity) {
+  size_t len = 0;
+  while (path[len] && path[len] != '/')
+    ++len;
+  if (len >= capacity)
+    return nullptr;
+  fk::memory::copy_n(component, path, len);
+  component[len] = '\0';
+  path += len;
+  while (*path == '/')
+    ++path;
+  return path;
+}
+
 void RamDiskNode::parse_tar() {
   uint8_t* ptr = reinterpret_cast<uint8_t*>(m_start);
   fk::algorithms::klog("RAMDISK", "Parsing TAR at %p - %p (size: %zu)", (void*)m_start,
@@ -41,57 +67,45 @@ void RamDiskNode::parse_tar() {
       fk::algorithms::kwarn("RAMDISK", "Suspicious TAR magic at %p: '%.6s'", ptr, header->magic);
     }
 
-    char safe_filename[101];
-    fk::memory::copy_n(safe_filename, header->filename, 100);
-    safe_filename[100] = '\0';
-
     size_t file_size = fk::archive::TarParser::octal_to_int(header->size, 12);
     uint8_t* data_ptr = ptr + 512;
 
-    const char* final_filename = safe_filename;
+    char path[101];
+    const char* final_filename = header->filename;
     // Strip leading ./ or /
     while (final_filename[0] == '.' && final_filename[1] == '/')
       final_filename += 2;
     while (final_filename[0] == '/')
       final_filename += 1;
-
-    if (final_filename[0] == '\0') {
+    size_t len = strnlen(final_filename, 100 - (final_filename - header->filename));
+    // Strip trailing slashes for consistency
+    while (len > 0 && final_filename[len - 1] == '/')
+      --len;
+    fk::memory::copy_n(path, final_filename, len);
+    path[len] = '\0';
+
+    if (path[0] == '\0') {
       ptr += 512 + ((file_size + 511) & ~511u);
       continue;
     }
 
+    const char* name_ptr = strrnchr(path, '/', sizeof(path));
+    name_ptr = name_ptr ? name_ptr + 1 : path;
+
+    fk::RefPtr<Node> leaf;
     if (header->typeflag[0] == '0' || header->typeflag[0] == '\0') {
       auto file_node_res = fk::make_ref<RamFileNode>(data_ptr, file_size);
       if (!file_node_res.is_error()) {
-        auto file_node = file_node_res.value();
-
-        const char* name_ptr = strrnchr(final_filename, '/', 100);
-        if (name_ptr)
-          name_ptr++;
-        else
-          name_ptr = final_filename;
-
-        file_node->set_name(name_ptr);
-        file_node->set_parent(fk::RefPtr<Node>(this));
-        m_files.push_back({final_filename, file_node});
-        fk::algorithms::klog("RAMDISK", "Loaded file: %s (%zu bytes) as '%s'", final_filename,
-                             file_size, name_ptr);
-        files_loaded++;
+        leaf = file_node_res.value();
+        fk::algorithms::klog("RAMDISK", "Loaded file: %s (%zu bytes) as '%s'", path, file_size,
+                             name_ptr);
       }
     } else if (header->typeflag[0] == '5') {
-      // Explicit directory entry
-      // Strip trailing slash if present for consistency
-      size_t len = fk::memory::length(final_filename);
-      char temp[256];
-      if (len > 0 && final_filename[len - 1] == '/') {
-        fk::memory::copy_n(temp, final_filename, len - 1);
-        temp[len - 1] = '\0';
-      } else {
-        fk::memory::copy_n(temp, final_filename, sizeof(temp) - 1);
-        temp[sizeof(temp) - 1] = '\0';
-      }
-      m_directories.push_back(temp);
-      fk::algorithms::klog("RAMDISK", "Found explicit directory: %s", temp);
+      // Explicit directory entry; it may have no files under it
+      if (ensure_path(path, true).is_error())
+        fk::algorithms::kwarn("RAMDISK", "Could not create directory %s", path);
+      else
+        fk::algorithms::klog("RAMDISK", "Found explicit directory: %s", path);
     } else if (header->typeflag[0] == '2') {
       // Symbolic link
       char link_target[100];
@@ -100,21 +114,18 @@ void RamDiskNode::parse_tar() {
 
       auto symlink_node_res = fk::make_ref<RamSymlinkNode>(link_target);
       if (!symlink_node_res.is_error()) {
-        auto symlink_node = symlink_node_res.value();
-
-        const char* name_ptr = strrnchr(final_filename, '/', 100);
-        if (name_ptr)
-          name_ptr++;
-        else
-          name_ptr = final_filename;
+        leaf = symlink_node_res.value();
+        fk::algorithms::klog("RAMDISK", "Loaded symlink: %s -> %s as '%s'", path, link_target,
+                             name_ptr);
+      }
+    }
 
-        symlink_node->set_name(name_ptr);
-        symlink_node->set_parent(fk::RefPtr<Node>(this));
-        m_files.push_back({final_filename, symlink_node});
-        fk::algorithms::klog("RAMDISK", "Loaded symlink: %s -> %s as '%s'", final_filename,
-                             link_target, name_ptr);
+    if (leaf) {
+      auto dir_res = ensure_path(path, false);
+      if (dir_res.is_error() || dir_res.value()->add_child(name_ptr, leaf).is_error())
+        fk::algorithms::kwarn("RAMDISK", "Could not add %s", path);
+      else
         files_loaded++;
-      }
     }
 
     ptr += 512 + ((file_size + 511) & ~511u);
@@ -122,159 +133,115 @@ void RamDiskNode::parse_tar() {
   fk::algorithms::klog("RAMDISK", "TAR parsing complete. %zu entries loaded.", files_loaded);
 }
 
-fk::core::Result<fk::RefPtr<Node>, fk::core::Error> RamDiskNode::lookup(const char* name) {
-  if (!name || name[0] == '\0' || fk::memory::compare(name, ".") == 0)
-    return fk::RefPtr<Node>(this);
-  if (fk::memory::compare(name, "..") == 0) {
-    if (m_parent)
-      return m_parent;
-    return fk::RefPtr<Node>(this);
-  }
+fk::RefPtr<Node> RamDiskNode::find_child(const char* name) const {
+  auto index = m_child_index.get(fk::text::String(name));
+  if (!index.has_value())
+    return fk::RefPtr<Node>();
+  return m_children[index.value()].node;
+}
 
-  const char* clean_name = (name[0] == '/') ? name + 1 : name;
-  char full_lookup[512];
-  if (m_prefix.is_empty()) {
-    fk::memory::copy_n(full_lookup, clean_name, sizeof(full_lookup) - 1);
-  } else {
-    snprintf(full_lookup, sizeof(full_lookup), "%s%s", m_prefix.c_str(), clean_name);
+fk::core::Result<void, fk::core::Error> RamDiskNode::add_child(const char* name,
+                                                              fk::RefPtr<Node> node) {
+  node->set_name(name);
+  node->set_parent(fk::RefPtr<Node>(this));
+
+  fk::text::String key(name);
+  auto index = m_child_index.get(key);
+  if (index.has_value()) {
+    // A later archive member of the same name replaces the earlier one
+    m_children[index.value()].node = node;
+    return {};
   }
-  full_lookup[sizeof(full_lookup) - 1] = '\0';
+  auto insert_res = m_child_index.insert(key, m_children.size());
+  if (insert_res.is_error())
+    return insert_res.error();
+  m_children.push_back({key, node});
+  return {};
+}
 
-  for (auto& entry : m_files) {
-    if (entry.name == full_lookup) {
-      entry.node->set_parent(fk::RefPtr<Node>(this));
-      return entry.node;
-    }
+fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error>
+RamDiskNode::ensure_directory(const char* name) {
+  auto child = find_child(name);
+  if (child) {
+    if (!child->is_directory())
+      return fk::core::Error::NotADirectory;
+    // Every directory in the tree is a RamDiskNode
+    return fk::RefPtr<RamDiskNode>(static_cast<RamDiskNode*>(child.get()));
   }
 
-  // Check if this is an implied directory (it's a prefix for other files)
-  char dir_prefix[512];
-  snprintf(dir_prefix, sizeof(dir_prefix), "%s/", full_lookup);
-
-  bool found_prefix = false;
-  for (auto& entry : m_files) {
-    if (fk::memory::compare_n(entry.name.c_str(), dir_prefix, fk::memory::length(dir_prefix)) == 0) {
-      found_prefix = true;
-      break;
-    }
-  }
+  auto dir_res = fk::make_ref<RamDiskNode>(m_start, m_end);
+  if (dir_res.is_error())
+    return dir_res.error();
+  auto dir = dir_res.value();
+  auto add_res = add_child(name, dir);
+  if (add_res.is_error())
+    return add_res.error();
+  return dir;
+}
 
-  bool is_explicit_dir = false;
-  for (const auto& dir : m_directories) {
-    if (dir == full_lookup) {
-      is_explicit_dir = true;
+fk::core::Result<fk::RefPtr<RamDiskNode>, fk::core::Error>
+RamDiskNode::ensure_path(const char* path, bool create_last) {
+  fk::RefPtr<RamDiskNode> dir(this);
+  char component[101];
+  while (*path) {
+    const char* rest = next_component(path, component, sizeof(component));
+    if (!rest)
+      return fk::core::Error::InvalidParameter;
+    if (*rest == '\0' && !create_last)
       break;
-    }
+    auto next_res = dir->ensure_directory(component);
+    if (next_res.is_error())
+      return next_res.error();
+    dir = next_res.value();
+    path = rest;
   }
+  return dir;
+}
 
-  if (found_prefix || is_explicit_dir) {
-    auto dir_node_res = fk::make_ref<RamDiskNode>(m_start, m_end);
-    if (dir_node_res.is_error())
-      return dir_node_res.error();
-    auto dir_node = dir_node_res.value();
-    dir_node->set_name(clean_name);
+fk::core::Result<fk::RefPtr<Node>, fk::core::Error> RamDiskNode::lookup(const char* name) {
+  if (!name)
+    return fk::RefPtr<Node>(this);
+  while (*name == '/')
+    ++name;
+  if (*name == '\0')
+    return fk::RefPtr<Node>(this);
 
-    // Copy m_files and m_directories to the new directory node so it can find its own children
-    for (auto& f : m_files)
-      dir_node->m_files.push_back(f);
-    for (auto& d : m_directories)
-      dir_node->m_directories.push_back(d);
+  char component[256];
+  const char* rest = next_component(name, component, sizeof(component));
+  if (!rest)
+    return fk::core::Error::NotFound;
 
-    dir_node->m_prefix = dir_prefix;
-    dir_node->set_parent(fk::RefPtr<Node>(this));
-    return fk::RefPtr<Node>(dir_node);
+  fk::RefPtr<Node> child;
+  if (fk::memory::compare(component, ".") == 0) {
+    child = fk::RefPtr<Node>(this);
+  } else if (fk::memory::compare(component, "..") == 0) {
+    child = m_parent ? m_parent : fk::RefPtr<Node>(this);
+  } else {
+    child = find_child(component);
+    if (!child)
+      return fk::core::Error::NotFound;
   }
 
-  return fk::core::Error::NotFound;
+  // Multi-component names continue in the child, whatever filesystem it is
+  if (*rest == '\0')
+    return child;
+  if (!child->is_directory())
+    return fk::core::Error::NotADirectory;
+  return child->lookup(rest);
 }
 
 fk::core::Result<void, fk::core::Error>
 RamDiskNode::list_dir(fk::containers::Vector<DirectoryEntry>& entries) {
-  size_t prefix_len = m_prefix.length();
-
-  for (auto& entry : m_files) {
-    if (prefix_len > 0 && fk::memory::compare_n(entry.name.c_str(), m_prefix.c_str(), prefix_len) != 0)
-      continue;
-
-    const char* relative_name = entry.name.c_str() + prefix_len;
-    if (relative_name[0] == '\0')
-      continue;
-
-    char component[256];
-    const char* slash = strnchr(relative_name, '/', 256);
-    bool is_dir = false;
-
-    if (slash) {
-      size_t len = slash - relative_name;
-      if (len == 0) { // Entry started with / but we already skipped prefix
-        relative_name++;
-        slash = strnchr(relative_name, '/', 256);
-        if (slash)
-          len = slash - relative_name;
-        else {
-          fk::memory::copy_n(component, relative_name, sizeof(component) - 1);
-          is_dir = false;
-          goto skip_slash_logic;
-        }
-      }
-      fk::memory::copy_n(component, relative_name, len);
-      component[len] = '\0';
-      is_dir = true;
-    } else {
-      fk::memory::copy_n(component, relative_name, sizeof(component) - 1);
-      component[sizeof(component) - 1] = '\0';
-      is_dir = false;
-    }
-
-  skip_slash_logic:
-    if (fk::algorithms::find_if(entries.begin(), entries.size(),
-          [&](const DirectoryEntry& e) { return fk::memory::compare(e.name, component) == 0; })
-        == entries.size()) {
-      DirectoryEntry de;
-      fk::memory::set(&de, 0, sizeof(de));
-      fk::memory::copy_n(de.name, component, sizeof(de.name) - 1);
-      if (is_dir) {
-        de.type = 1; // DT_DIR
-      } else {
-        de.type = entry.node->is_symlink() ? 2 : 0; // DT_LNK : DT_REG
-      }
-      entries.push_back(de);
-    }
-  }
-
-  // Add explicit directories that might be empty (not implied by files)
-  for (const auto& dir_path : m_directories) {
-    if (prefix_len > 0 && fk::memory::compare_n(dir_path.c_str(), m_prefix.c_str(), prefix_len) != 0)
-      continue;
-
-    const char* relative_name = dir_path.c_str() + prefix_len;
-    if (relative_name[0] == '\0')
-      continue;
-
-    char component[256];
-    const char* slash = strnchr(relative_name, '/', 256);
-
-    if (slash) {
-      // Should not happen if m_directories contains clean paths, but safe to handle
-      size_t len = slash - relative_name;
-      fk::memory::copy_n(component, relative_name, len);
-      component[len] = '\0';
-    } else {
-      fk::memory::copy_n(component, relative_name, sizeof(component) - 1);
-      component[sizeof(component) - 1] = '\0';
-    }
-
-    if (fk::algorithms::find_if(entries.begin(), entries.size(),
-          [&](const DirectoryEntry& e) { return fk::memory::compare(e.name, component) == 0; })
-        == entries.size()) {
-      DirectoryEntry de;
-      fk::memory::set(&de, 0, sizeof(de));
-      fk::memory::copy_n(de.name, component, sizeof(de.name) - 1);
+  for (const auto& child : m_children) {
+    DirectoryEntry de;
+    fk::memory::set(&de, 0, sizeof(de));
+    fk::memory::copy_n(de.name, child.name.c_str(), sizeof(de.name) - 1);
+    if (child.node->is_directory())
       de.type = 1; // DT_DIR
-      entries.push_back(de);
-    }
+    else
+      de.type = child.node->is_symlink() ? 2 : 0; // DT_LNK : DT_REG
+    entries.push_back(de);
   }
-
   return {};
 }
 
@@ -3,6 +3,7 @@
 #include <Kernel/Fs/Vfs/dentry.h>
 #include <Kernel/Fs/Vfs/virtual_filesystem.h>
 #include <Kernel/Fs/PipeFs/pipe_node.h>
+#include <Kernel/Loader/elf_image_cache.h>
 #include <LibFK/Algorithms/log.h>
 
 FileDescription::FileDescription(fk::RefPtr<fkernel::Dentry> dentry, int flags)
@@ -73,6 +74,9 @@ FileDescription::write(size_t size, const uint8_t *buffer) {
   m_offset_lock.unlock();
 
   auto result = m_node->write(write_offset, size, buffer);
+  // After the write, so an execve parsing the file meanwhile cannot re-cache
+  // the old headers; a failed write may still have changed some bytes
+  fkernel::ElfImageCache::the().invalidate(*m_node);
   if (result.is_error()) return result.error();
 
   m_offset_lock.lock();
@@ -41,10 +41,7 @@ fk::core::Result<int, fk::core::Error> KQueueNode::kevent(const struct kevent* c
             if (triggered >= nevents) break;
 
             int fd = static_cast<int>(reg.event.ident);
-            // Basic validation of FD against current process
-            if (fd < 0 || static_cast<size_t>(fd) >= current->resources.files.descriptors.size()) continue;
-
-            auto& desc = current->resources.files.descriptors[fd];
+            auto desc = current->get_file_descriptor(fd);
             if (!desc) continue;
 
             auto node = desc->node();
@@ -6,12 +6,12 @@
 
 namespace fkernel {
 
-PathResolver::PathResolver(VirtualFileSystem& vfs, fk::synchronization::Spinlock& lock)
+PathResolver::PathResolver(VirtualFileSystem& vfs, RwSemaphore& lock)
     : m_vfs(vfs), m_lock(lock) {}
 
 fk::core::Result<fk::RefPtr<Dentry>, fk::core::Error>
 PathResolver::resolve(const char* path, fk::RefPtr<Dentry> base, int depth) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  ReadLocker lock(m_lock);
   return resolve_unlocked(path, base, depth);
 }
 
@@ -74,7 +74,7 @@ PathResolver::resolve_unlocked(const char* path, fk::RefPtr<Dentry> base, int de
 
 fk::core::Result<fk::utilities::Pair<fk::RefPtr<Dentry>, fk::text::String>, fk::core::Error>
 PathResolver::resolve_to_parent(const char* path, int depth) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  ReadLocker lock(m_lock);
   return resolve_to_parent_unlocked(path, depth);
 }
 
@@ -9,7 +9,7 @@ namespace fkernel {
 
 fk::core::Result<void, fk::core::Error>
 VirtualFileSystem::readdir(const char *path, fk::containers::Vector<DirectoryEntry> &entries) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  ReadLocker lock(m_lock);
   auto dentry_res = resolve_path_unlocked(path);
   if (dentry_res.is_error()) return dentry_res.error();
   
@@ -35,7 +35,7 @@ VirtualFileSystem::readdir(const char *path, fk::containers::Vector<DirectoryEnt
 fk::core::Result<size_t, fk::core::Error>
 VirtualFileSystem::readdir(fk::RefPtr<FileDescription> description, uint8_t *buffer, size_t max_bytes) {
   if (!buffer) return fk::core::Error::InvalidParameter;
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  ReadLocker lock(m_lock);
 
   fk::containers::Vector<DirectoryEntry> entries;
   DirectoryEntry dot; fk::memory::copy_string(dot.name, "."); dot.type = 1; add_directory_entry(entries, dot);
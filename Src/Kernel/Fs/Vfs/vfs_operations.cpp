@@ -3,6 +3,7 @@
 #include <Kernel/Fs/Vfs/file_description.h>
 #include <Kernel/Fs/Vfs/virtual_filesystem.h>
 #include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
+#include <Kernel/Loader/elf_image_cache.h>
 #include <LibFK/Algorithms/log.h>
 #include <LibFK/Utilities/memory.h>
 
@@ -19,8 +20,10 @@ open_existing(fk::RefPtr<fkernel::Dentry> dentry, int flags) {
     return fk::core::Error::NotFound;
   if ((flags & O_DIRECTORY) && !node->is_directory())
     return fk::core::Error::NotADirectory;
-  if ((flags & O_TRUNC) && !node->is_directory())
+  if ((flags & O_TRUNC) && !node->is_directory()) {
     node->truncate(0);
+    ElfImageCache::the().invalidate(*node);
+  }
   auto open_result = node->on_open();
   if (open_result.is_error())
     return open_result.error();
@@ -30,7 +33,8 @@ open_existing(fk::RefPtr<fkernel::Dentry> dentry, int flags) {
 fk::core::Result<fk::RefPtr<FileDescription>, fk::core::Error>
 VirtualFileSystem::open(const char* path, int flags) {
   fk::algorithms::kdebug("VFS", "open(%s, flags=%d)", path, flags);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  // Exclusive: it may create or truncate, and on_open() hooks expect to be serialized
+  WriteLocker lock(m_lock);
   auto dentry_res = resolve_path_unlocked(path);
 
   if (dentry_res.is_ok()) {
@@ -75,7 +79,7 @@ static fk::RefPtr<Node> find_writable_directory_node(fk::RefPtr<Dentry> dentry)
 
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::mkdir(const char* path, int mode) {
   fk::algorithms::kdebug("VFS", "mkdir(%s)", path);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto parent_res = resolve_path_to_parent_unlocked(path);
   if (parent_res.is_error()) {
     fk::algorithms::kwarn("VFS", "mkdir: resolve failed for %s", path);
@@ -99,7 +103,7 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::mkdir(const char* pat
 
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::symlink(const char* path,
                                                                    const char* target) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto parent_res = resolve_path_to_parent_unlocked(path);
   if (parent_res.is_error())
     return parent_res.error();
@@ -115,7 +119,7 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::symlink(const char* p
 }
 
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::rmdir(const char* path) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto parent_res = resolve_path_to_parent_unlocked(path);
   if (parent_res.is_error())
     return parent_res.error();
@@ -132,7 +136,7 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::rmdir(const char* pat
 
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::unlink(const char* path) {
   fk::algorithms::kdebug("VFS", "unlink(%s)", path);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto parent_res = resolve_path_to_parent_unlocked(path);
   if (parent_res.is_error())
     return parent_res.error();
@@ -149,7 +153,7 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::unlink(const char* pa
 
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::link(const char* path,
                                                                 const char* target) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto parent_res = resolve_path_to_parent_unlocked(path);
   if (parent_res.is_error())
     return parent_res.error();
@@ -167,7 +171,7 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::link(const char* path
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::rename(const char* old_path,
                                                                    const char* new_path) {
   fk::algorithms::kdebug("VFS", "rename(%s, %s)", old_path, new_path);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
 
   auto old_parent_res = resolve_path_to_parent_unlocked(old_path);
   if (old_parent_res.is_error())
@@ -193,7 +197,7 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::rename(const char* ol
 fk::core::Result<void, fk::core::Error> VirtualFileSystem::stat(const char* path,
                                                                  struct stat* buf) {
   fk::algorithms::kdebug("VFS", "stat(%s)", path);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  ReadLocker lock(m_lock);
   auto dentry_res = resolve_path_unlocked(path);
   if (dentry_res.is_error())
     return dentry_res.error();
@@ -226,14 +230,17 @@ fk::core::Result<void, fk::core::Error> VirtualFileSystem::stat(const char* path
 
 fk::core::Result<void, fk::core::Error>
 VirtualFileSystem::truncate(const char* path, uint64_t size) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto dentry_res = resolve_path_unlocked(path);
   if (dentry_res.is_error())
     return dentry_res.error();
   auto node = dentry_res.value()->top_node();
   if (!node)
     return fk::core::Error::NotFound;
-  return node->truncate(size);
+  auto result = node->truncate(size);
+  // After the change, so a concurrent execve cannot re-cache the old image
+  ElfImageCache::the().invalidate(*node);
+  return result;
 }
 
 fk::core::Result<void, fk::core::Error>
@@ -248,7 +255,7 @@ VirtualFileSystem::fsync(fk::RefPtr<FileDescription> desc) {
 
 fk::core::Result<void, fk::core::Error>
 VirtualFileSystem::chmod(const char* path, uint32_t mode) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto dentry_res = resolve_path_unlocked(path);
   if (dentry_res.is_error())
     return dentry_res.error();
@@ -261,7 +268,7 @@ VirtualFileSystem::chmod(const char* path, uint32_t mode) {
 
 fk::core::Result<void, fk::core::Error>
 VirtualFileSystem::chown(const char* path, uint32_t uid, uint32_t gid) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto dentry_res = resolve_path_unlocked(path);
   if (dentry_res.is_error())
     return dentry_res.error();
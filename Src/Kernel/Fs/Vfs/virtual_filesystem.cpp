@@ -105,7 +105,7 @@ void VirtualFileSystem::mount_root(fk::RefPtr<Node> node) {
 fk::core::Result<void, fk::core::Error>
 VirtualFileSystem::mount(const char *path, fk::RefPtr<Node> node, const char* fstype) {
   if (!path || !node) return fk::core::Error::InvalidParameter;
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
 
   auto dentry = TRY(resolve_path_unlocked(path));
   dentry->push_node(node);
@@ -145,7 +145,7 @@ uint32_t VirtualFileSystem::dev_id_for_path(const char* path) {
 
 fk::core::Result<void, fk::core::Error>
 VirtualFileSystem::unmount(const char *path) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WriteLocker lock(m_lock);
   auto dentry = TRY(resolve_path_unlocked(path));
   dentry->pop_node();
 
@@ -71,6 +71,16 @@ void CPU::detect_cpu_features() {
     m_has_smep = true;
   if (ebx & (1 << 20))
     m_has_smap = true;
+
+  // Invariant TSC (CPUID 0x80000007, EDX bit 8): constant rate across P/C-states
+  cpuid(0x80000000, 0, &eax, &ebx, &ecx, &edx);
+  if (eax < 0x80000007)
+    return;
+  cpuid(0x80000007, 0, &eax, &ebx, &ecx, &edx);
+  if (edx & (1 << 8)) {
+    fk::algorithms::kdebug("CPU", "Found invariant TSC");
+    m_has_invariant_tsc = true;
+  }
 }
 
 void CPU::initialize_features() {
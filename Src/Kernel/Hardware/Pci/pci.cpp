@@ -26,9 +26,8 @@ void PciManager::initialize() {
       size_t bus_count  = static_cast<size_t>(m_mcfg_end_bus - m_mcfg_start_bus) + 1;
       size_t mmio_bytes = bus_count * 32UL * 8UL * 4096UL;
       uintptr_t mmio_base = m_mcfg_base + static_cast<uintptr_t>(m_mcfg_start_bus) * 32UL * 8UL * 4096UL;
-      for (uintptr_t addr = mmio_base; addr < mmio_base + mmio_bytes; addr += 4096) {
-          MemoryManager::the().map_page(addr, addr, PageFlags::Present | PageFlags::Writable | PageFlags::CacheDisabled);
-      }
+      MemoryManager::the().map_range(mmio_base, mmio_base, mmio_bytes,
+                                     PageFlags::Present | PageFlags::Writable | PageFlags::CacheDisabled);
     }
   }
 
@@ -2,14 +2,17 @@
 #include <Kernel/Boot/Stages/init.h>
 #include <Kernel/Boot/boot_info.h>
 #include <Kernel/Boot/boot_timer.h>
+#include <Kernel/Clock/time_keeper.h>
 #include <Kernel/Driver/Keyboard/ps2_keyboard.h>
 #include <Kernel/Driver/Mouse/ps2_mouse.h>
+#include <Kernel/Driver/Serial/serial_port.h>
 #include <Kernel/Driver/Storage/Ata/ata_controller.h>
 #include <Kernel/Driver/Storage/Partitions/partition_manager.h>
 #include <Kernel/Driver/Vga/display_framebuffer.h>
 #include <Kernel/Driver/driver_registry.h>
 #include <Kernel/Fs/Vfs/virtual_filesystem.h>
 #include <Kernel/Hardware/Pci/pci.h>
+#include <Kernel/Memory/VirtualMemory/tlb_shootdown.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Arch/x86_64/Interrupt/interrupt_controller.h>
@@ -25,6 +28,11 @@ void init() {
   fk::algorithms::set_log_targets(fk::algorithms::LogTarget::Serial);
   fk::algorithms::klog("SYSTEM", "FKernel Live-Minimal starting on real hardware...");
 
+  // Calibrate the TSC and publish the vDSO clock page before any task runs
+  fk::algorithms::klog("INIT", "Initializing timekeeping...");
+  TimeKeeper::the().initialize();
+  BootTimer::the().mark("timekeeper_init");
+
   // Initialize PCI Manager (required for driver registry)
   fk::algorithms::klog("INIT", "Initializing PCI manager...");
   PciManager::the().initialize();
@@ -95,6 +103,8 @@ void init() {
   SyscallManager::the().initialize();
   if (!SyscallManager::the().is_initialized())
     fk::algorithms::kfatal("INIT", "Syscall manager failed to initialize");
+  // Registers this CPU by its id, which is read through the GS base loaded above
+  fkernel::TlbShootdown::the().initialize();
   BootTimer::the().mark("scheduler_init");
 
   fk::algorithms::klog("INIT", "Enabling hardware interrupts...");
@@ -104,6 +114,9 @@ void init() {
   HardwareInterruptManager::the().unmask_interrupt(12); // PS/2 Mouse
   HardwareInterruptManager::the().unmask_interrupt(14); // Primary ATA
   HardwareInterruptManager::the().unmask_interrupt(15); // Secondary ATA
+  HardwareInterruptManager::the().unmask_interrupt(4);  // COM1
+  // Log output stops waiting on the UART from here on
+  serial::enable_async();
   InterruptController::the().enable_interrupt();
 
   fk::algorithms::klog("INIT", "Starting scheduler...");
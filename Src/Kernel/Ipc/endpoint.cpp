@@ -1,6 +1,6 @@
 #include <Kernel/Ipc/endpoint.h>
-#include <Kernel/Ipc/ipc_log_node.h>
 #include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Trace/tracer.h>
 #include <LibFK/Algorithms/log.h>
 
 namespace fkernel {
@@ -10,7 +10,7 @@ void Endpoint::deliver_message(Task& sender, Task& receiver, MessageInfo info) {
   uint32_t sender_id = sender.control.identity.id.value();
   uint32_t receiver_id = receiver.control.identity.id.value();
 
-  IpcLogNode::the()->log_endpoint_operation("deliver_message", sender_id, receiver_id, info.raw());
+  trace::tracepoint(trace::TraceEventId::IpcDeliver, sender_id, receiver_id, info.raw());
 
   // 1. Copy Short Message (Registers)
   // We assume registers rdi-r9 are used for short message data
@@ -37,7 +37,7 @@ fk::core::Result<MessageInfo> Endpoint::send(MessageInfo info) {
     fk::synchronization::ScopedLockIRQ lock(m_lock);
     if (m_receivers.empty()) {
 
-      IpcLogNode::the()->log_endpoint_operation("send_blocked", sender_id, 0, info.raw());
+      trace::tracepoint(trace::TraceEventId::IpcSendBlocked, sender_id, 0, info.raw());
       m_senders.push_back(current);
       scheduler.block_current_noqueue();
       return MessageInfo(current->registers().rax); // Result set by deliver_message
@@ -47,7 +47,7 @@ fk::core::Result<MessageInfo> Endpoint::send(MessageInfo info) {
     m_receivers.remove(receiver);
     uint32_t receiver_id = receiver->control.identity.id.value();
 
-    IpcLogNode::the()->log_endpoint_operation("send_immediate", sender_id, receiver_id, info.raw());
+    trace::tracepoint(trace::TraceEventId::IpcSendImmediate, sender_id, receiver_id, info.raw());
     deliver_message(*current, *receiver, info);
     scheduler.wake_task(receiver);
   }
@@ -64,7 +64,7 @@ fk::core::Result<MessageInfo> Endpoint::receive() {
     fk::synchronization::ScopedLockIRQ lock(m_lock);
     if (m_senders.empty()) {
 
-      IpcLogNode::the()->log_endpoint_operation("receive_blocked", receiver_id, 0, 0);
+      trace::tracepoint(trace::TraceEventId::IpcReceiveBlocked, receiver_id, 0, 0);
       m_receivers.push_back(current);
       scheduler.block_current();
       return MessageInfo(current->registers().rax);
@@ -76,8 +76,8 @@ fk::core::Result<MessageInfo> Endpoint::receive() {
 
     MessageInfo info(sender->registers().rax); // Assuming info was in rax
 
-    IpcLogNode::the()->log_endpoint_operation("receive_immediate", receiver_id, sender_id,
-                                              info.raw());
+    trace::tracepoint(trace::TraceEventId::IpcReceiveImmediate, receiver_id, sender_id,
+                      info.raw());
     deliver_message(*sender, *current, info);
 
     scheduler.wake_task(sender);
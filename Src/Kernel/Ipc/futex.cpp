@@ -0,0 +1,231 @@
+#include <Kernel/Ipc/futex.h>
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
+#include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <LibFK/Synchronization/interrupt_disabler.h>
+
+namespace fkernel {
+namespace ipc {
+
+static fk::core::Result<uint32_t, fk::core::Error> read_futex_word(uintptr_t uaddr) {
+  uint32_t value = 0;
+  if (memory::copy_from_user(&value, reinterpret_cast<const void*>(uaddr), sizeof(value))
+          .is_error())
+    return fk::core::Error::BadAddress;
+  return value;
+}
+
+// Bucket locks are held with interrupts off, where a page fault must not be
+// taken. Reads only a word whose page is mapped; otherwise BadAddress, and the
+// caller drops the lock and faults it in with read_futex_word().
+static fk::core::Result<uint32_t, fk::core::Error> read_futex_word_locked(uintptr_t uaddr) {
+  auto flags = VirtualMemoryManager::the().get_page_flags(uaddr & ~(PAGE_SIZE - 1));
+  if (flags.is_error() || !(flags.value() & PageFlags::Present) ||
+      !(flags.value() & PageFlags::User))
+    return fk::core::Error::BadAddress;
+  return read_futex_word(uaddr);
+}
+
+// Rounded up so a sleeper never wakes before its deadline
+static uint64_t ns_to_ticks(uint64_t ns) {
+  uint64_t freq = TickManager::the().get_frequency();
+  if (freq == 0) freq = 1000;
+  uint64_t us = ns / 1000 + 1;
+  uint64_t ticks = (us / 1000000) * freq + ((us % 1000000) * freq + 999999) / 1000000;
+  return ticks ? ticks : 1;
+}
+
+// Marks the caller asleep; called with its bucket lock held so a wake in
+// between still finds it blocked. The caller schedules after dropping the lock.
+// An untimed waiter goes on the scheduler's wait list so kill, process group
+// signals and wait4 still see it.
+static void futex_sleep(uint64_t deadline_ns) {
+  auto& scheduler = SchedulerManager::the();
+  if (!deadline_ns) {
+    scheduler.block_current();
+    return;
+  }
+  // The deadline may have passed since the caller checked it
+  uint64_t now = TimeKeeper::the().monotonic_ns();
+  scheduler.sleep_current(ns_to_ticks(deadline_ns > now ? deadline_ns - now : 0));
+}
+
+static bool deadline_passed(uint64_t deadline_ns) {
+  return deadline_ns && TimeKeeper::the().monotonic_ns() >= deadline_ns;
+}
+
+fk::core::Result<FutexKey, fk::core::Error> FutexTable::key_for(uintptr_t uaddr,
+                                                                bool is_private) {
+  if (uaddr % sizeof(uint32_t))
+    return fk::core::Error::InvalidParameter;
+  if (!memory::is_user_address(uaddr, sizeof(uint32_t)))
+    return fk::core::Error::BadAddress;
+
+  Task* task = SchedulerManager::the().current();
+  FutexKey key{task->memory().cr3, uaddr};
+  if (is_private)
+    return key;
+
+  // Fault the page in, then see whether other address spaces map the frame
+  auto value = read_futex_word(uaddr);
+  if (value.is_error())
+    return value.error();
+  auto& vmm = VirtualMemoryManager::the();
+  uintptr_t page = uaddr & ~(PAGE_SIZE - 1);
+  auto flags = vmm.get_page_flags(page);
+  if (flags.is_error())
+    return fk::core::Error::BadAddress;
+  if (flags.value() & PageFlags::Shared)
+    key = {0, vmm.translate(page) + (uaddr - page)};
+  return key;
+}
+
+FutexBucket& FutexTable::bucket_for(const FutexKey& key) {
+  uint64_t hash = (key.space ^ (key.address >> 2)) * 0x9E3779B97F4A7C15ull;
+  return m_buckets[hash >> 56];
+}
+
+uint32_t FutexTable::wake_locked(FutexBucket& bucket, const FutexKey& key, uint32_t count,
+                                 uint32_t bitset) {
+  uint32_t woken = 0;
+  for (FutexWaiter* waiter = bucket.waiters.first(); waiter && woken < count;) {
+    FutexWaiter* next = waiter->node.next;
+    if (waiter->key == key && (waiter->bitset & bitset)) {
+      bucket.waiters.remove(*waiter);
+      waiter->woken = true;
+      SchedulerManager::the().wake_task(waiter->task);
+      ++woken;
+    }
+    waiter = next;
+  }
+  return woken;
+}
+
+fk::core::Result<void, fk::core::Error> FutexTable::wait(const FutexKey& key, uintptr_t uaddr,
+                                                         uint32_t expected, uint32_t bitset,
+                                                         uint64_t deadline_ns) {
+  FutexWaiter waiter;
+  waiter.key = key;
+  waiter.bitset = bitset;
+  waiter.task = SchedulerManager::the().current();
+  waiter.bucket = &bucket_for(key);
+
+  for (;;) {
+    auto faulted = read_futex_word(uaddr);
+    if (faulted.is_error())
+      return faulted.error();
+
+    fk::synchronization::ScopedLockIRQ lock(waiter.bucket->lock);
+    auto value = read_futex_word_locked(uaddr);
+    if (value.is_error())
+      continue; // Unmapped again since the first read; fault it back in
+    if (value.value() != expected)
+      return fk::core::Error::WouldBlock;
+    if (deadline_passed(deadline_ns))
+      return fk::core::Error::Timeout;
+    waiter.bucket->waiters.append(waiter);
+    futex_sleep(deadline_ns);
+    break;
+  }
+
+  bool asleep = true;
+  for (;;) {
+    if (asleep)
+      SchedulerManager::the().schedule();
+    asleep = true;
+
+    // A requeue may move us between reading the bucket and locking it
+    FutexBucket* bucket = __atomic_load_n(&waiter.bucket, __ATOMIC_ACQUIRE);
+    fk::synchronization::ScopedLockIRQ lock(bucket->lock);
+    if (bucket != waiter.bucket) {
+      asleep = false;
+      continue;
+    }
+
+    if (waiter.woken)
+      return {};
+    if (waiter.task->has_pending_signals()) {
+      bucket->waiters.remove(waiter);
+      return fk::core::Error::Interrupted;
+    }
+    if (deadline_passed(deadline_ns)) {
+      bucket->waiters.remove(waiter);
+      return fk::core::Error::Timeout;
+    }
+    // Woken for some other reason (or a tick early): keep waiting
+    futex_sleep(deadline_ns);
+  }
+}
+
+uint32_t FutexTable::wake(const FutexKey& key, uint32_t count, uint32_t bitset) {
+  FutexBucket& bucket = bucket_for(key);
+  fk::synchronization::ScopedLockIRQ lock(bucket.lock);
+  return wake_locked(bucket, key, count, bitset);
+}
+
+fk::core::Result<uint32_t, fk::core::Error>
+FutexTable::requeue(const FutexKey& from, const FutexKey& to, uint32_t wake_count,
+                    uint32_t requeue_count, bool compare, uintptr_t uaddr, uint32_t expected) {
+  FutexBucket& source = bucket_for(from);
+  FutexBucket& target = bucket_for(to);
+
+  // Two buckets are always locked in address order
+  FutexBucket* first = &source < &target ? &source : &target;
+  FutexBucket* second = &source < &target ? &target : &source;
+  for (;;) {
+    if (compare) {
+      auto faulted = read_futex_word(uaddr);
+      if (faulted.is_error())
+        return faulted.error();
+    }
+
+    fk::synchronization::ScopedInterruptDisabler irq;
+    fk::synchronization::ScopedLock lock(first->lock);
+    if (second != first)
+      second->lock.lock();
+
+    auto result = requeue_locked(source, target, from, to, wake_count, requeue_count, compare,
+                                 uaddr, expected);
+    if (second != first)
+      second->lock.unlock();
+    // BadAddress only comes from the locked read: the page went away again
+    if (!result.is_error() || result.error() != fk::core::Error::BadAddress)
+      return result;
+  }
+}
+
+fk::core::Result<uint32_t, fk::core::Error>
+FutexTable::requeue_locked(FutexBucket& source, FutexBucket& target, const FutexKey& from,
+                           const FutexKey& to, uint32_t wake_count, uint32_t requeue_count,
+                           bool compare, uintptr_t uaddr, uint32_t expected) {
+  if (compare) {
+    auto value = read_futex_word_locked(uaddr);
+    if (value.is_error())
+      return value.error();
+    if (value.value() != expected)
+      return fk::core::Error::WouldBlock;
+  }
+
+  uint32_t woken = wake_locked(source, from, wake_count, FUTEX_BITSET_MATCH_ANY);
+  uint32_t moved = 0;
+  for (FutexWaiter* waiter = source.waiters.first(); waiter && moved < requeue_count;) {
+    FutexWaiter* next = waiter->node.next;
+    if (waiter->key == from) {
+      // Within one bucket only the key changes; the waiter keeps its place
+      if (&target != &source) {
+        source.waiters.remove(*waiter);
+        target.waiters.append(*waiter);
+        __atomic_store_n(&waiter->bucket, &target, __ATOMIC_RELEASE);
+      }
+      waiter->key = to;
+      ++moved;
+    }
+    waiter = next;
+  }
+  return woken + moved;
+}
+
+} // namespace ipc
+} // namespace fkernel
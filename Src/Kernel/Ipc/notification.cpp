@@ -1,6 +1,6 @@
-#include <Kernel/Ipc/ipc_log_node.h>
 #include <Kernel/Ipc/notification.h>
 #include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Trace/tracer.h>
 #include <LibFK/Algorithms/log.h>
 
 namespace fkernel {
@@ -20,12 +20,12 @@ void Notification::signal(uint64_t bits) {
     uint64_t delivered_bits = m_pending_bits;
     m_pending_bits = 0;
 
-    IpcLogNode::the()->log_notification_operation("signal_wake", task_id, delivered_bits);
+    trace::tracepoint(trace::TraceEventId::NotifySignalWake, task_id, delivered_bits);
     SchedulerManager::the().wake_task(&task);
   } else {
     // No task waiting, just store bits
 
-    IpcLogNode::the()->log_notification_operation("signal_queue", 0, bits);
+    trace::tracepoint(trace::TraceEventId::NotifySignalQueue, 0, bits);
   }
 }
 
@@ -40,11 +40,11 @@ uint64_t Notification::wait() {
       uint64_t bits = m_pending_bits;
       m_pending_bits = 0;
 
-      IpcLogNode::the()->log_notification_operation("wait_immediate", task_id, bits);
+      trace::tracepoint(trace::TraceEventId::NotifyWaitImmediate, task_id, bits);
       return bits;
     }
 
-    IpcLogNode::the()->log_notification_operation("wait_blocked", task_id, m_pending_bits);
+    trace::tracepoint(trace::TraceEventId::NotifyWaitBlocked, task_id, m_pending_bits);
     m_waiting_tasks.append(*current);
     scheduler.block_current_noqueue();
   }
@@ -52,7 +52,7 @@ uint64_t Notification::wait() {
   // Result will be set in rax by signal()
   uint64_t result = current->registers().rax;
 
-  IpcLogNode::the()->log_notification_operation("wait_woken", task_id, result);
+  trace::tracepoint(trace::TraceEventId::NotifyWaitWoken, task_id, result);
   return result;
 }
 
@@ -63,7 +63,7 @@ uint64_t Notification::poll() {
 
   if (bits != 0) {
   }
-  IpcLogNode::the()->log_notification_operation("poll", 0, bits);
+  trace::tracepoint(trace::TraceEventId::NotifyPoll, 0, bits);
   return bits;
 }
 
@@ -3,10 +3,10 @@
 #include <Kernel/Ipc/notification.h>
 #include <Kernel/Ipc/signal_delivery.h>
 #include <Kernel/Ipc/signal_frame.h>
-#include <Kernel/Ipc/ipc_log_node.h>
 #include <Kernel/Hardware/Cpu/cpu_block.h>
 #include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Trace/tracer.h>
 
 #include <LibFK/Algorithms/log.h>
 #include <LibFK/Utilities/memory.h>
@@ -148,6 +148,8 @@ bool SignalDelivery::install_handler_frame(Task* task, PtRegs* regs, int sig,
                          (unsigned long)k_frame.saved_regs.rax);
     fk::algorithms::klog("SIGNAL", "Task %lu redirected to handler %p for signal %d",
                           pid, (void*)handler_addr, sig);
+    fkernel::trace::tracepoint(fkernel::trace::TraceEventId::SignalDeliver, pid, sig,
+                               handler_addr, user_sp);
     return true;
 }
 
@@ -1,7 +1,6 @@
 #include <Kernel/Loader/Domains/interpreter_domain.h>
-#include <Kernel/Loader/Domains/parser_domain.h>
 #include <Kernel/Loader/Domains/load_domain.h>
-#include <Kernel/Loader/Domains/memory_domain.h>
+#include <Kernel/Loader/elf_image_cache.h>
 #include <Kernel/Fs/Vfs/virtual_filesystem.h>
 #include <Kernel/Fs/Vfs/dentry.h>
 #include <LibFK/Algorithms/log.h>
@@ -48,24 +47,19 @@ InterpreterDomain::load_interpreter(const fk::text::String& interpreter_path) {
         return node_res.error();
     }
     
-    ParserDomain parser(node_res.value());
-    auto header_res = parser.validate_header();
-    if (header_res.is_error())
-        return header_res.error();
-        
-    auto headers_res = parser.parse_program_headers(header_res.value());
-    if (headers_res.is_error())
-        return headers_res.error();
+    auto image_res = ElfImageCache::the().get(node_res.value());
+    if (image_res.is_error())
+        return image_res.error();
+    auto image = image_res.value();
     
     LoadDomain loader(node_res.value());
-    MemoryDomain memory(node_res.value());
     
     uintptr_t interpreter_base = 0x70000000;
-    auto load_res = loader.process_load_segments(headers_res.value(), interpreter_base);
+    auto load_res = loader.process_load_segments(image->program_headers, interpreter_base);
     if (load_res.is_error())
         return load_res.error();
     
-    return reinterpret_cast<uintptr_t>(header_res.value().e_entry + interpreter_base);
+    return reinterpret_cast<uintptr_t>(image->header.e_entry + interpreter_base);
 }
 
 fk::core::Result<bool, fk::core::Error>
@@ -1,5 +1,7 @@
 #include <Kernel/Loader/Domains/load_domain.h>
 #include <Kernel/Loader/Domains/memory_domain.h>
+#include <Kernel/Memory/VirtualMemory/file_page_cache.h>
+#include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Algorithms/log.h>
 #include <LibFK/Utilities/memory.h>
 
@@ -14,7 +16,7 @@ LoadDomain::process_load_segments(const fk::containers::Vector<Elf64_Phdr>& head
 
   for (const auto& phdr : headers) {
     if (phdr.p_type == PT_LOAD) {
-      auto process_res = process_single_load_segment(phdr, load_base);
+      auto process_res = process_single_load_segment(phdr, load_base, headers);
       if (process_res.is_error())
         return process_res.error();
     }
@@ -52,26 +54,38 @@ MemoryRegion LoadDomain::calculate_memory_region(const Elf64_Phdr& phdr, uintptr
 }
 
 fk::core::Result<void, fk::core::Error> LoadDomain::copy_segment_data(const MemoryRegion& region) {
-  if (region.file_size == 0) {
+  // Only the file bytes that fall inside [start_vaddr, end_vaddr) are copied
+  uintptr_t data_start =
+      region.actual_vaddr > region.start_vaddr ? region.actual_vaddr : region.start_vaddr;
+  uintptr_t data_end = region.actual_vaddr + region.file_size;
+  if (data_end > region.end_vaddr)
+    data_end = region.end_vaddr;
+  if (data_start >= data_end)
     return {};
-  }
 
-  auto read_res = read_from_node(region.file_offset, region.file_size,
-                                 reinterpret_cast<uint8_t*>(region.actual_vaddr));
+  size_t size = data_end - data_start;
+  auto read_res = read_from_node(region.file_offset + (data_start - region.actual_vaddr), size,
+                                 reinterpret_cast<uint8_t*>(data_start));
   if (read_res.is_error())
     return read_res.error();
-  if (read_res.value() < region.file_size)
+  if (read_res.value() < size)
     return fk::core::Error::InvalidParameter;
 
   return {};
 }
 
 void LoadDomain::zero_fill_bss(const MemoryRegion& region) {
-  if (region.memory_size > region.file_size) {
-    uintptr_t bss_start = region.actual_vaddr + region.file_size;
-    size_t bss_size = region.memory_size - region.file_size;
-    fk::memory::set(reinterpret_cast<void*>(bss_start), 0, bss_size);
-  }
+  if (region.memory_size <= region.file_size)
+    return;
+
+  uintptr_t bss_start = region.actual_vaddr + region.file_size;
+  uintptr_t bss_end = region.actual_vaddr + region.memory_size;
+  if (bss_start < region.start_vaddr)
+    bss_start = region.start_vaddr;
+  if (bss_end > region.end_vaddr)
+    bss_end = region.end_vaddr;
+  if (bss_start < bss_end)
+    fk::memory::set(reinterpret_cast<void*>(bss_start), 0, bss_end - bss_start);
 }
 
 fk::core::Result<bool, fk::core::Error>
@@ -85,25 +99,104 @@ LoadDomain::has_load_segments(const fk::containers::Vector<Elf64_Phdr>& headers)
 }
 
 fk::core::Result<void, fk::core::Error>
-LoadDomain::process_single_load_segment(const Elf64_Phdr& phdr, uintptr_t load_base) {
+LoadDomain::process_single_load_segment(const Elf64_Phdr& phdr, uintptr_t load_base,
+                                        const fk::containers::Vector<Elf64_Phdr>& headers) {
   MemoryDomain memory(m_node);
   MemoryRegion region = calculate_memory_region(phdr, load_base);
 
-  auto alloc_res = memory.allocate_memory_region(region, true);
+  if (!can_demand_page(region)) {
+    auto load_res = load_pages(memory, region, region.start_vaddr, region.end_vaddr);
+    if (load_res.is_error())
+      return load_res.error();
+    return record_mapping(region, false);
+  }
+
+  // Pages that are already populated (the ELF header page) or shared with
+  // another segment are filled now so they hold both segments' bytes; the
+  // rest faults in from the page cache on first touch
+  uintptr_t lazy_start = region.start_vaddr;
+  uintptr_t lazy_end = region.end_vaddr;
+  while (lazy_start < lazy_end && needs_eager_page(memory, phdr, load_base, headers, lazy_start))
+    lazy_start += 0x1000;
+  while (lazy_end > lazy_start &&
+         needs_eager_page(memory, phdr, load_base, headers, lazy_end - 0x1000))
+    lazy_end -= 0x1000;
+
+  auto head_res = load_pages(memory, region, region.start_vaddr, lazy_start);
+  if (head_res.is_error())
+    return head_res.error();
+  auto tail_res = load_pages(memory, region, lazy_end, region.end_vaddr);
+  if (tail_res.is_error())
+    return tail_res.error();
+
+  return record_mapping(region, true);
+}
+
+bool LoadDomain::can_demand_page(const MemoryRegion& region) const {
+  // Cached pages are mapped whole, so file and memory must agree on the page offset
+  return FilePageCache::can_cache(*m_node) &&
+         (region.file_offset & 0xFFF) == (region.actual_vaddr & 0xFFF);
+}
+
+bool LoadDomain::needs_eager_page(MemoryDomain& memory, const Elf64_Phdr& phdr,
+                                  uintptr_t load_base,
+                                  const fk::containers::Vector<Elf64_Phdr>& headers,
+                                  uintptr_t page) {
+  if (memory.is_already_mapped(page))
+    return true;
+  for (const auto& other : headers) {
+    if (other.p_type != PT_LOAD || &other == &phdr)
+      continue;
+    MemoryRegion other_region = calculate_memory_region(other, load_base);
+    if (page >= other_region.start_vaddr && page < other_region.end_vaddr)
+      return true;
+  }
+  return false;
+}
+
+fk::core::Result<void, fk::core::Error> LoadDomain::load_pages(MemoryDomain& memory,
+                                                               const MemoryRegion& region,
+                                                               uintptr_t start, uintptr_t end) {
+  if (start >= end)
+    return {};
+
+  MemoryRegion window = region;
+  window.start_vaddr = start;
+  window.end_vaddr = end;
+
+  auto alloc_res = memory.allocate_memory_region(window, true);
   if (alloc_res.is_error())
     return alloc_res.error();
 
-  auto copy_res = copy_segment_data(region);
+  auto copy_res = copy_segment_data(window);
   if (copy_res.is_error())
     return copy_res.error();
 
-  zero_fill_bss(region);
+  zero_fill_bss(window);
 
-  auto perm_res = memory.apply_final_permissions(region);
-  if (perm_res.is_error())
-    return perm_res.error();
+  return memory.apply_final_permissions(window);
+}
 
-  return {};
+fk::core::Result<void, fk::core::Error> LoadDomain::record_mapping(const MemoryRegion& region,
+                                                                   bool file_backed) {
+  auto* task = SchedulerManager::the().current();
+  if (!task || !task->memory().vmas)
+    return {};
+
+  // Segments that share a page: the later one owns it, as in the page tables
+  auto& vmas = task->memory().vmas;
+  auto remove_res = vmas->remove_range(region.start_vaddr, region.end_vaddr);
+  if (remove_res.is_error())
+    return remove_res.error();
+
+  fk::text::String path = m_node->get_path();
+  if (!file_backed)
+    return vmas->insert(region.start_vaddr, region.end_vaddr, region.permissions, VmaKind::Image,
+                        path.c_str());
+
+  uint64_t file_offset = region.file_offset - (region.actual_vaddr - region.start_vaddr);
+  return vmas->insert_file(region.start_vaddr, region.end_vaddr, region.permissions, path.c_str(),
+                           m_node, file_offset, region.actual_vaddr + region.file_size);
 }
 
 } // namespace fkernel::elf_domains
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include <Kernel/Loader/Domains/interpreter_domain.h>
+#include <Kernel/Loader/Domains/parser_domain.h>
+#include <Kernel/Loader/elf_image_cache.h>
+
+namespace fkernel {
+
+static uintptr_t page_align_up(uintptr_t value) {
+  return (value + 0xFFF) & ~0xFFFULL;
+}
+
+fk::core::Result<fk::RefPtr<ElfImage>, fk::core::Error>
+ElfImageCache::parse(const fk::RefPtr<Node>& node) {
+  elf_domains::ParserDomain parser(node);
+  auto header_res = parser.validate_header();
+  if (header_res.is_error())
+    return header_res.error();
+
+  auto headers_res = parser.parse_program_headers(header_res.value());
+  if (headers_res.is_error())
+    return headers_res.error();
+
+  elf_domains::InterpreterDomain interpreter(node);
+  auto interp_res = interpreter.extract_interpreter_path(headers_res.value());
+  if (interp_res.is_error())
+    return interp_res.error();
+
+  auto image_res = fk::make_ref<ElfImage>();
+  if (image_res.is_error())
+    return image_res.error();
+  auto image = image_res.value();
+  image->header = header_res.value();
+  image->program_headers = fk::types::move(headers_res.value());
+  image->interpreter_path = interp_res.value();
+  image->file_size = node->size();
+
+  bool have_relro = false;
+  for (const auto& phdr : image->program_headers) {
+    switch (phdr.p_type) {
+    case PT_PHDR:
+      if (!image->phdr_vaddr)
+        image->phdr_vaddr = phdr.p_vaddr;
+      break;
+    case PT_LOAD:
+      if (page_align_up(phdr.p_vaddr + phdr.p_memsz) > image->load_end)
+        image->load_end = page_align_up(phdr.p_vaddr + phdr.p_memsz);
+      break;
+    case PT_GNU_STACK:
+      image->stack_executable = (phdr.p_flags & PF_X) != 0;
+      break;
+    case PT_TLS:
+      if (phdr.p_memsz == 0)
+        break;
+      image->tls.vaddr = static_cast<uintptr_t>(phdr.p_vaddr);
+      image->tls.filesz = static_cast<size_t>(phdr.p_filesz);
+      image->tls.memsz = static_cast<size_t>(phdr.p_memsz);
+      image->tls.align = phdr.p_align ? static_cast<size_t>(phdr.p_align) : 8;
+      image->tls.present = true;
+      break;
+    case PT_DYNAMIC:
+      image->has_dynamic = true;
+      break;
+    case PT_GNU_RELRO:
+      if (have_relro)
+        break;
+      image->relro_start = phdr.p_vaddr & ~0xFFFULL;
+      image->relro_end = page_align_up(phdr.p_vaddr + phdr.p_memsz);
+      have_relro = true;
+      break;
+    default:
+      break;
+    }
+  }
+  return image;
+}
+
+fk::core::Result<fk::RefPtr<ElfImage>, fk::core::Error>
+ElfImageCache::get(const fk::RefPtr<Node>& node) {
+  uint64_t inode = node->inode();
+  uint64_t generation;
+  {
+    fk::synchronization::ScopedLockIRQ lock(m_lock);
+    generation = m_generation;
+    auto cached = m_images.get(inode);
+    if (cached.has_value()) {
+      if (cached.value()->file_size == node->size())
+        return cached.value();
+      remove_locked(inode);
+    }
+  }
+
+  // Parse unlocked; if two execs race on a miss the second insert wins
+  auto image_res = parse(node);
+  if (image_res.is_error())
+    return image_res.error();
+  auto image = image_res.value();
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  // A write may have finished while we parsed; what we read could be stale
+  if (m_generation != generation)
+    return image;
+  if (m_images.contains(inode))
+    remove_locked(inode);
+  while (m_order.size() >= ELF_IMAGE_CACHE_CAPACITY)
+    remove_locked(m_order[0]);
+  if (m_images.insert(inode, image).is_ok())
+    m_order.push_back(inode);
+  return image;
+}
+
+void ElfImageCache::invalidate(const Node& node) {
+  // Pipes, sockets and terminals are written constantly and never executed
+  if (node.is_pipe() || node.is_socket() || node.is_character_device())
+    return;
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  ++m_generation;
+  if (m_images.contains(node.inode()))
+    remove_locked(node.inode());
+}
+
+void ElfImageCache::remove_locked(uint64_t inode) {
+  m_images.remove(inode);
+  for (size_t i = 0; i < m_order.size(); ++i) {
+    if (m_order[i] == inode) {
+      m_order.remove_at(i);
+      break;
+    }
+  }
+}
+
+} // namespace fkernel
@@ -1,11 +1,24 @@
 #include <Kernel/Loader/elf_loader.h>
 #include <Kernel/Loader/elf_loader_core.h>
+#include <Kernel/Loader/vdso_mapper.h>
+#include <LibFK/Algorithms/log.h>
 
 namespace fkernel {
 
 ElfLoadOperationResult
 ElfLoader::load(fk::RefPtr<Node> node) {
-    return load_with_base(node, 0);
+    auto result = load_with_base(node, 0);
+    if (result.is_error())
+        return result;
+
+    // A missing vDSO is not fatal: libc falls back to the time syscalls.
+    ElfLoadResult loaded = result.value();
+    auto vdso = VdsoMapper::the().map_into_current();
+    if (vdso.is_error())
+        fk::algorithms::kwarn("ELF", "vDSO not mapped, time calls will use syscalls");
+    else
+        loaded.vdso_base = vdso.value();
+    return loaded;
 }
 
 ElfLoadOperationResult
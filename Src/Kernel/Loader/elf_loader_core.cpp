@@ -2,6 +2,7 @@
 #include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
 #include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
 #include <Kernel/Memory/VirtualMemory/Pages/page_flags.h>
+#include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Algorithms/log.h>
 
 namespace fkernel {
@@ -39,32 +40,18 @@ ElfLoadOperationResult ElfLoaderCore::execute_load_with_base(uintptr_t load_base
 }
 
 fk::core::Result<void, fk::core::Error> ElfLoaderCore::parse_and_validate() {
-  auto header_res = m_parser.validate_header();
-  if (header_res.is_error()) {
+  auto image_res = ElfImageCache::the().get(m_node);
+  if (image_res.is_error()) {
     fk::algorithms::kwarn("ELF", "Invalid ELF header");
-    return header_res.error();
+    return image_res.error();
   }
 
-  m_context.header = header_res.value();
-
-  auto headers_res = m_parser.parse_program_headers(m_context.header);
-  if (headers_res.is_error())
-    return headers_res.error();
-
+  m_image = image_res.value();
+  m_context.header = m_image->header;
   m_context.load_base = m_parser.calculate_load_base(m_context.header, m_context.load_base);
-
-  auto interp_check = m_interpreter.check_interpreter_needed(headers_res.value());
-  if (interp_check.is_error())
-    return interp_check.error();
-
-  m_context.has_interpreter = interp_check.value();
-
-  if (m_context.has_interpreter) {
-    auto interp_res = m_interpreter.extract_interpreter_path(headers_res.value());
-    if (interp_res.is_error())
-      return interp_res.error();
-    m_context.interpreter_path = interp_res.value();
-  }
+  m_context.has_interpreter = m_image->has_interpreter();
+  if (m_context.has_interpreter)
+    m_context.interpreter_path = m_image->interpreter_path;
 
   return {};
 }
@@ -83,10 +70,6 @@ fk::core::Result<void, fk::core::Error> ElfLoaderCore::handle_interpreter() {
 }
 
 fk::core::Result<void, fk::core::Error> ElfLoaderCore::load_segments() {
-  auto headers_res = m_parser.parse_program_headers(m_context.header);
-  if (headers_res.is_error())
-    return headers_res.error();
-
   // Always map the first page of the ELF file (containing the header and PHDRs)
   // Most ELFs have a PT_LOAD that covers this, but we ensure it here just in case.
   uintptr_t first_page_vaddr = m_context.load_base;
@@ -97,7 +80,7 @@ fk::core::Result<void, fk::core::Error> ElfLoaderCore::load_segments() {
   if (read_res.is_error())
     return read_res.error();
 
-  auto load_res = m_loader.process_load_segments(headers_res.value(), m_context.load_base);
+  auto load_res = m_loader.process_load_segments(m_image->program_headers, m_context.load_base);
   if (load_res.is_error())
     return load_res.error();
 
@@ -105,30 +88,32 @@ fk::core::Result<void, fk::core::Error> ElfLoaderCore::load_segments() {
 }
 
 fk::core::Result<void, fk::core::Error> ElfLoaderCore::process_dynamic() {
-  auto headers_res = m_parser.parse_program_headers(m_context.header);
-  if (headers_res.is_error())
-    return headers_res.error();
-
-  auto reloc_res = m_dynamic.process_dynamic_segment(headers_res.value(), m_context.load_base);
-  if (reloc_res.is_error())
-    return reloc_res;
+  if (m_image->has_dynamic) {
+    auto reloc_res =
+        m_dynamic.process_dynamic_segment(m_image->program_headers, m_context.load_base);
+    if (reloc_res.is_error())
+      return reloc_res;
+  }
 
-  apply_relro(headers_res.value());
+  apply_relro();
   return {};
 }
 
-void ElfLoaderCore::apply_relro(const fk::containers::Vector<Elf64_Phdr>& headers) {
-  for (const auto& phdr : headers) {
-    if (phdr.p_type != PT_GNU_RELRO)
-      continue;
-    uintptr_t start = (phdr.p_vaddr + m_context.load_base) & ~0xFFFULL;
-    uintptr_t end   = (phdr.p_vaddr + m_context.load_base + phdr.p_memsz + 0xFFF) & ~0xFFFULL;
-    PageFlags ro_flags = PageFlags::Present | PageFlags::User | PageFlags::ExecuteDisable;
-    for (uintptr_t page = start; page < end; page += 0x1000)
-      VirtualMemoryManager::the().protect_page(page, ro_flags);
-    fk::algorithms::klog("ELF", "RELRO: 0x%lx-0x%lx protected", start, end);
-    break;
-  }
+void ElfLoaderCore::apply_relro() {
+  if (m_image->relro_start == m_image->relro_end)
+    return;
+
+  uintptr_t start = m_image->relro_start + m_context.load_base;
+  uintptr_t end = m_image->relro_end + m_context.load_base;
+  PageFlags ro_flags = PageFlags::Present | PageFlags::User | PageFlags::ExecuteDisable;
+  for (uintptr_t page = start; page < end; page += 0x1000)
+    VirtualMemoryManager::the().protect_page(page, ro_flags);
+  // Pages of a file-backed segment that were never touched fault in later
+  // with the mapping's flags, so the mapping has to say read-only too
+  auto* task = SchedulerManager::the().current();
+  if (task && task->memory().vmas)
+    task->memory().vmas->protect_range(start, end, ro_flags);
+  fk::algorithms::klog("ELF", "RELRO: 0x%lx-0x%lx protected", start, end);
 }
 
 ElfLoadOperationResult ElfLoaderCore::calculate_entry_point() {
@@ -143,46 +128,16 @@ ElfLoadOperationResult ElfLoaderCore::calculate_entry_point() {
     }
   }
 
-  auto headers_res = m_parser.parse_program_headers(m_context.header);
-  if (headers_res.is_error())
-    return headers_res.error();
-
-  auto& headers = headers_res.value();
-  uintptr_t ph_addr = 0;
-  for (const auto& phdr : headers) {
-    if (phdr.p_type == PT_PHDR) {
-      ph_addr = phdr.p_vaddr + m_context.load_base;
-      break;
-    }
-  }
-
   // Fallback: If no PT_PHDR, it usually follows the ELF header
-  if (ph_addr == 0) {
-    ph_addr = m_context.load_base + m_context.header.e_phoff;
-  }
+  uintptr_t ph_addr = m_image->phdr_vaddr ? m_image->phdr_vaddr + m_context.load_base
+                                          : m_context.load_base + m_context.header.e_phoff;
 
-  bool stack_executable = false;
-  TlsInfo tls;
-  for (const auto& phdr : headers) {
-    if (phdr.p_type == PT_GNU_STACK)
-      stack_executable = (phdr.p_flags & PF_X) != 0;
-    if (phdr.p_type == PT_TLS && phdr.p_memsz > 0) {
-      tls.vaddr   = static_cast<uintptr_t>(phdr.p_vaddr) + m_context.load_base;
-      tls.filesz  = static_cast<size_t>(phdr.p_filesz);
-      tls.memsz   = static_cast<size_t>(phdr.p_memsz);
-      tls.align   = phdr.p_align ? static_cast<size_t>(phdr.p_align) : 8;
-      tls.present = true;
-    }
-  }
+  bool stack_executable = m_image->stack_executable;
+  TlsInfo tls = m_image->tls;
+  if (tls.present)
+    tls.vaddr += m_context.load_base;
 
-  uintptr_t highest_load_end = 0;
-  for (const auto& phdr : headers) {
-    if (phdr.p_type != PT_LOAD)
-      continue;
-    uintptr_t seg_end = (phdr.p_vaddr + m_context.load_base + phdr.p_memsz + 0xFFF) & ~0xFFFULL;
-    if (seg_end > highest_load_end)
-      highest_load_end = seg_end;
-  }
+  uintptr_t highest_load_end = m_image->load_end ? m_image->load_end + m_context.load_base : 0;
 
   return ElfLoadResult{.entry = entry,
                        .ph_addr = ph_addr,
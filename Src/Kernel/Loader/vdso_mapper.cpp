@@ -0,0 +1,69 @@
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Loader/vdso_mapper.h>
+#include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <Kernel/Memory/VirtualMemory/Pages/page_flags.h>
+#include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <LibFK/Algorithms/log.h>
+#include <LibFK/Utilities/memory.h>
+
+extern "C" uint8_t vdso_image_start[];
+extern "C" uint8_t vdso_image_end[];
+
+namespace fkernel {
+
+fk::core::Result<void, fk::core::Error> VdsoMapper::prepare_image() {
+  if (m_text_phys)
+    return {};
+
+  // The code reaches its data page RIP-relative at -4 KiB, so the whole image
+  // has to live in the single page that follows it.
+  size_t image_size = static_cast<size_t>(vdso_image_end - vdso_image_start);
+  if (image_size > 0x1000) {
+    fk::algorithms::kerror("VDSO", "Image is %zu bytes, expected one page", image_size);
+    return fk::core::Error::InvalidData;
+  }
+
+  uintptr_t phys = PhysicalMemoryManager::the().alloc_page();
+  if (!phys)
+    return fk::core::Error::OutOfMemory;
+
+  fk::memory::set(reinterpret_cast<void*>(phys), 0, 0x1000);
+  fk::memory::copy(reinterpret_cast<void*>(phys), vdso_image_start, image_size);
+
+  m_text_phys = phys;
+  fk::algorithms::klog("VDSO", "Image ready: %zu bytes at phys %p", image_size,
+                       reinterpret_cast<void*>(phys));
+  return {};
+}
+
+fk::core::Result<uintptr_t, fk::core::Error> VdsoMapper::map_into_current() {
+  uintptr_t data_phys = TimeKeeper::the().vdso_data_phys();
+  if (!data_phys)
+    return fk::core::Error::NotFound;
+
+  auto prepared = prepare_image();
+  if (prepared.is_error())
+    return prepared.error();
+
+  VirtualMemoryManager::the().map_page(VDSO_DATA_VADDR, data_phys,
+                                       PageFlags::Present | PageFlags::User |
+                                           PageFlags::Shared |
+                                           PageFlags::ExecuteDisable);
+  VirtualMemoryManager::the().map_page(VDSO_TEXT_VADDR, m_text_phys,
+                                       PageFlags::Present | PageFlags::User |
+                                           PageFlags::Shared);
+
+  auto* task = SchedulerManager::the().current();
+  if (task && task->memory().vmas) {
+    auto& vmas = task->memory().vmas;
+    vmas->insert(VDSO_DATA_VADDR, VDSO_DATA_VADDR + PAGE_SIZE,
+                 PageFlags::Present | PageFlags::User | PageFlags::ExecuteDisable,
+                 VmaKind::Special, "[vvar]");
+    vmas->insert(VDSO_TEXT_VADDR, VDSO_TEXT_VADDR + PAGE_SIZE, PageFlags::Present | PageFlags::User,
+                 VmaKind::Special, "[vdso]");
+  }
+  return VDSO_TEXT_VADDR;
+}
+
+} // namespace fkernel
@@ -259,6 +259,20 @@ void PhysicalMemoryManager::free_page(uintptr_t phys) {
   m_free_memory += FRAME_SIZE;
 }
 
+// The bitmap and the buddy allocator describe the same frames. A block is
+// only handed out once none of its frames is owned through the bitmap, and
+// its frames are then marked there so alloc_page() skips them.
+static bool claim_block_frames(PhysicalZone* pz, uintptr_t phys, size_t bytes) {
+  size_t first = (phys - pz->zone.base()) / FRAME_SIZE;
+  size_t count = bytes / FRAME_SIZE;
+  if (first + count > pz->bitmap.size()) return false;
+  for (size_t i = 0; i < count; ++i)
+    if (pz->bitmap.get(first + i)) return false;
+  for (size_t i = 0; i < count; ++i)
+    pz->bitmap.set(first + i, true);
+  return true;
+}
+
 uintptr_t PhysicalMemoryManager::alloc_contiguous(size_t order, ZoneType preferred,
                                                   uint32_t preferred_node) {
   assert(m_is_initialized);
@@ -270,7 +284,27 @@ uintptr_t PhysicalMemoryManager::alloc_contiguous(size_t order, ZoneType preferr
     return 0;
   }
 
-  void* block = pz->buddy.alloc(order);
+  size_t block_order = order < MIN_ORDER ? MIN_ORDER : order;
+  size_t bytes = order_to_size(block_order);
+
+  // Blocks overlapping bitmap-owned frames are held aside and returned
+  // afterwards so the buddy allocator does not offer them again here
+  static constexpr size_t MAX_BUSY_BLOCKS = 8;
+  void* busy[MAX_BUSY_BLOCKS];
+  size_t busy_count = 0;
+  void* block = nullptr;
+  while ((block = pz->buddy.alloc(block_order)) != nullptr) {
+    if (claim_block_frames(pz, reinterpret_cast<uintptr_t>(block), bytes)) break;
+    if (busy_count == MAX_BUSY_BLOCKS) {
+      pz->buddy.free(block, block_order);
+      block = nullptr;
+      break;
+    }
+    busy[busy_count++] = block;
+  }
+  for (size_t i = 0; i < busy_count; ++i)
+    pz->buddy.free(busy[i], block_order);
+
   if (!block) {
     fk::algorithms::kwarn("PHYSICAL MEMORY MANAGER",
                           "alloc_contiguous: Buddy allocation failed for order "
@@ -280,7 +314,7 @@ uintptr_t PhysicalMemoryManager::alloc_contiguous(size_t order, ZoneType preferr
   }
 
   uintptr_t phys = reinterpret_cast<uintptr_t>(block);
-  m_free_memory -= (FRAME_SIZE << order);
+  m_free_memory -= bytes;
   return phys;
 }
 
@@ -296,6 +330,12 @@ void PhysicalMemoryManager::free_contiguous(uintptr_t phys, size_t order) {
     return;
   }
 
-  pz->buddy.free(reinterpret_cast<void*>(phys), order);
-  m_free_memory += (FRAME_SIZE << order);
+  size_t block_order = order < MIN_ORDER ? MIN_ORDER : order;
+  size_t bytes = order_to_size(block_order);
+  size_t first = (phys - pz->zone.base()) / FRAME_SIZE;
+  for (size_t i = 0; i < bytes / FRAME_SIZE && first + i < pz->bitmap.size(); ++i)
+    pz->bitmap.clear(first + i);
+
+  pz->buddy.free(reinterpret_cast<void*>(phys), block_order);
+  m_free_memory += bytes;
 }
\ No newline at end of file
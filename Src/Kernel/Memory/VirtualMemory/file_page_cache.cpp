@@ -0,0 +1,78 @@
+#include <Kernel/Arch/x86_64/arch_defs.h>
+#include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <Kernel/Memory/VirtualMemory/file_page_cache.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+
+FilePageCache::CachedFile* FilePageCache::file_for(const fk::RefPtr<Node>& node) {
+  auto found = m_files.get(node->inode());
+  if (found.has_value())
+    return found.value();
+
+  auto* file = new CachedFile();
+  if (!file)
+    return nullptr;
+  file->node = node;
+  size_t pages = (node->size() + PAGE_SIZE - 1) / PAGE_SIZE;
+  file->frames.resize(pages);
+  if (file->frames.size() < pages || m_files.insert(node->inode(), file).is_error()) {
+    delete file;
+    return nullptr;
+  }
+  return file;
+}
+
+fk::core::Result<uintptr_t, fk::core::Error>
+FilePageCache::get_page(const fk::RefPtr<Node>& node, uint64_t offset) {
+  if (!node || !can_cache(*node) || (offset % PAGE_SIZE) != 0)
+    return fk::core::Error::InvalidParameter;
+  if (uintptr_t frame = node->backing_frame(offset))
+    return frame;
+  size_t index = offset / PAGE_SIZE;
+
+  {
+    fk::synchronization::ScopedLockIRQ lock(m_lock);
+    CachedFile* file = file_for(node);
+    if (!file)
+      return fk::core::Error::OutOfMemory;
+    if (index >= file->frames.size())
+      return fk::core::Error::InvalidParameter;
+    if (file->frames[index])
+      return file->frames[index];
+  }
+
+  // Read outside the lock; a racing reader of the same page loses and frees its copy
+  uintptr_t frame = PhysicalMemoryManager::the().alloc_page();
+  if (!frame)
+    return fk::core::Error::OutOfMemory;
+  auto* bytes = reinterpret_cast<uint8_t*>(frame);
+  auto read_res = node->read(offset, PAGE_SIZE, bytes);
+  if (read_res.is_error()) {
+    PhysicalMemoryManager::the().free_page(frame);
+    return read_res.error();
+  }
+  if (read_res.value() < PAGE_SIZE)
+    fk::memory::set(bytes + read_res.value(), 0, PAGE_SIZE - read_res.value());
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  CachedFile* file = file_for(node);
+  if (file && file->frames[index]) {
+    PhysicalMemoryManager::the().free_page(frame);
+    return file->frames[index];
+  }
+  if (!file) {
+    PhysicalMemoryManager::the().free_page(frame);
+    return fk::core::Error::OutOfMemory;
+  }
+  file->frames[index] = frame;
+  ++m_pages;
+  return frame;
+}
+
+size_t FilePageCache::cached_pages() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_pages;
+}
+
+} // namespace fkernel
@@ -0,0 +1,42 @@
+#include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <Kernel/Memory/VirtualMemory/mmu_gather.h>
+
+namespace fkernel {
+
+void MmuGather::add_page(uintptr_t virt) {
+  if (m_page_count < TLB_FLUSH_ALL_THRESHOLD) {
+    m_pages[m_page_count++] = virt;
+    return;
+  }
+  m_flush_all = true;
+}
+
+void MmuGather::defer_free(uintptr_t phys, uint8_t order) {
+  if (is_full()) {
+    // Callers check is_full() and finish outside their lock; this is a bug
+    // guard, not a path
+    finish();
+  }
+  m_frames[m_frame_count++] = DeferredFrame{phys, order};
+}
+
+void MmuGather::finish() {
+  if (m_page_count == 0 && !m_flush_all && m_frame_count == 0) return;
+
+  if (m_flush_all || m_page_count > 0)
+    TlbShootdown::the().flush(m_root, m_flush_all ? nullptr : m_pages, m_page_count);
+
+  auto& pmm = PhysicalMemoryManager::the();
+  for (size_t i = 0; i < m_frame_count; ++i) {
+    if (m_frames[i].order == PAGE_FRAME)
+      pmm.free_page(m_frames[i].phys);
+    else
+      pmm.free_contiguous(m_frames[i].phys, m_frames[i].order);
+  }
+
+  m_page_count = 0;
+  m_flush_all = false;
+  m_frame_count = 0;
+}
+
+} // namespace fkernel
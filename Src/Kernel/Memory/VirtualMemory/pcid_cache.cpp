@@ -0,0 +1,48 @@
+#include <Kernel/Memory/VirtualMemory/pcid_cache.h>
+
+namespace fkernel {
+
+uint64_t PcidCache::cr3_for(uint32_t cpu, uintptr_t root) {
+  if (cpu >= MAX_CPUS) cpu = 0;
+  CpuSlots& cs = m_cpus[cpu];
+  uint64_t now = ++cs.clock;
+
+  size_t victim = 0;
+  for (size_t i = 0; i < PCID_SLOTS_PER_CPU; ++i) {
+    Slot& slot = cs.slots[i];
+    if (__atomic_load_n(&slot.root, __ATOMIC_RELAXED) == root) {
+      slot.last_used = now;
+      return root | (i + 1) | CR3_NOFLUSH;
+    }
+    if (slot.last_used < cs.slots[victim].last_used) victim = i;
+  }
+
+  // Miss: whatever the evicted slot's PCID still caches belongs to another
+  // address space, so load it without NOFLUSH
+  __atomic_store_n(&cs.slots[victim].root, root, __ATOMIC_RELAXED);
+  cs.slots[victim].last_used = now;
+  return root | (victim + 1);
+}
+
+void PcidCache::forget(uintptr_t root) {
+  for (uint32_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+    drop(cpu, root);
+}
+
+void PcidCache::drop(uint32_t cpu, uintptr_t root) {
+  if (cpu >= MAX_CPUS) return;
+  for (size_t i = 0; i < PCID_SLOTS_PER_CPU; ++i) {
+    Slot& slot = m_cpus[cpu].slots[i];
+    uintptr_t expected = root;
+    __atomic_compare_exchange_n(&slot.root, &expected, 0, false, __ATOMIC_SEQ_CST,
+                                __ATOMIC_RELAXED);
+  }
+}
+
+void PcidCache::drop_inactive(uintptr_t root, uint32_t keep_mask) {
+  for (uint32_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+    if (!(keep_mask & (1u << cpu)))
+      drop(cpu, root);
+}
+
+} // namespace fkernel
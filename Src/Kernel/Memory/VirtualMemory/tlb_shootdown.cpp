@@ -0,0 +1,105 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/hardware_interrupt_manager.h>
+#include <Kernel/Arch/x86_64/Interrupt/interrupt_controller.h>
+#include <Kernel/Memory/VirtualMemory/pcid_cache.h>
+#include <Kernel/Memory/VirtualMemory/tlb_shootdown.h>
+#include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
+#include <LibFK/Algorithms/log.h>
+
+namespace fkernel {
+
+static constexpr uint64_t CR3_ROOT_MASK = 0x000FFFFFFFFFF000ULL;
+
+void TlbShootdown::initialize() {
+  InterruptController::the().register_interrupt(ipi_handler, TLB_SHOOTDOWN_VECTOR);
+
+  // Initial APIC ID from CPUID.1 EBX[31:24]
+  uint32_t eax, ebx, ecx, edx;
+  arch_cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+  register_cpu(arch_current_cpu_id(), ebx >> 24);
+  fk::algorithms::klog("TLB", "Shootdown IPI on vector 0x%X", TLB_SHOOTDOWN_VECTOR);
+}
+
+void TlbShootdown::register_cpu(uint32_t cpu, uint32_t apic_id) {
+  if (cpu >= MAX_CPUS) return;
+  m_apic_ids[cpu] = apic_id;
+  __atomic_or_fetch(&m_online_mask, 1u << cpu, __ATOMIC_SEQ_CST);
+}
+
+void TlbShootdown::note_active(uint32_t cpu, uintptr_t root) {
+  if (cpu >= MAX_CPUS) return;
+  // Pairs with the fence in flush(): either the flusher sees this CPU, or
+  // this CPU's PCID lookup sees the slot the flusher dropped
+  __atomic_store_n(&m_active_roots[cpu], root, __ATOMIC_SEQ_CST);
+}
+
+uint32_t TlbShootdown::cpus_using(uintptr_t root) const {
+  uint32_t mask = 0;
+  for (uint32_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+    if (__atomic_load_n(&m_active_roots[cpu], __ATOMIC_SEQ_CST) == root)
+      mask |= 1u << cpu;
+  return mask;
+}
+
+void TlbShootdown::flush_local(const uintptr_t* pages, size_t count) {
+  if (!pages || count > TLB_FLUSH_ALL_THRESHOLD) {
+    // Reloading CR3 without NOFLUSH drops the current PCID's non-global entries
+    arch_load_cr3(read_on_cr3());
+    return;
+  }
+  for (size_t i = 0; i < count; ++i)
+    invalid_tlb(pages[i]);
+}
+
+void TlbShootdown::service_pending(uint32_t cpu) {
+  uint32_t bit = 1u << cpu;
+  if (!(__atomic_load_n(&m_request.pending, __ATOMIC_SEQ_CST) & bit)) return;
+
+  if ((read_on_cr3() & CR3_ROOT_MASK) == m_request.root)
+    flush_local(m_request.pages, m_request.count);
+  else
+    // Switched away since the mask was taken: the entries now sit in an
+    // idle PCID, so give that up instead
+    PcidCache::the().drop(cpu, m_request.root);
+  __atomic_and_fetch(&m_request.pending, ~bit, __ATOMIC_SEQ_CST);
+}
+
+void TlbShootdown::ipi_handler(uint8_t vector, InterruptFrame*) {
+  the().service_pending(arch_current_cpu_id());
+  HardwareInterruptManager::the().send_eoi(vector);
+}
+
+void TlbShootdown::flush(uintptr_t root, const uintptr_t* pages, size_t count) {
+  uint32_t self = arch_current_cpu_id();
+
+  // The cleared entries must be visible before the active set is sampled
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  uint32_t active = cpus_using(root);
+  PcidCache::the().drop_inactive(root, active);
+  if (active & (1u << self))
+    flush_local(pages, count);
+
+  uint32_t targets = active & m_online_mask & ~(1u << self);
+  if (!targets) return;
+
+  // Two CPUs may shoot at each other: keep answering while waiting our turn
+  while (!m_lock.try_lock()) {
+    service_pending(self);
+    asm volatile("pause");
+  }
+  m_request.root = root;
+  m_request.pages = count > TLB_FLUSH_ALL_THRESHOLD ? nullptr : pages;
+  m_request.count = count;
+  __atomic_store_n(&m_request.pending, targets, __ATOMIC_SEQ_CST);
+
+  for (uint32_t cpu = 0; cpu < MAX_CPUS; ++cpu) {
+    if (!(targets & (1u << cpu))) continue;
+    if (HardwareInterruptManager::the().send_ipi(m_apic_ids[cpu], TLB_SHOOTDOWN_VECTOR).is_error())
+      __atomic_and_fetch(&m_request.pending, ~(1u << cpu), __ATOMIC_SEQ_CST);
+  }
+  while (__atomic_load_n(&m_request.pending, __ATOMIC_SEQ_CST))
+    asm volatile("pause");
+  m_lock.unlock();
+}
+
+} // namespace fkernel
@@ -0,0 +1,77 @@
+#include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
+#include <Kernel/Memory/VirtualMemory/transparent_huge_pages.h>
+#include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+
+bool TransparentHugePages::is_allowed(const Task* task, uintptr_t vaddr) const {
+  uintptr_t block = vaddr & ~static_cast<uintptr_t>(PAGE_SIZE_2M - 1);
+  const auto& vmas = task->memory().vmas;
+  return !vmas || vmas->allows_huge_pages(block, block + PAGE_SIZE_2M);
+}
+
+bool TransparentHugePages::try_map(Task* task, uintptr_t vaddr, uintptr_t region_start,
+                                   uintptr_t region_end, PageFlags flags) {
+  uintptr_t block = vaddr & ~static_cast<uintptr_t>(PAGE_SIZE_2M - 1);
+  if (block < region_start || block + PAGE_SIZE_2M > region_end)
+    return false;
+  if (!is_allowed(task, block))
+    return false;
+
+  auto& vmm = VirtualMemoryManager::the();
+  if (!vmm.can_map_large_page(block, PAGE_SIZE_2M))
+    return false;
+
+  uintptr_t phys = PhysicalMemoryManager::the().alloc_contiguous(PAGE_SIZE_2M_ORDER);
+  if (!phys) {
+    __atomic_fetch_add(&m_counters.fault_fallback, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+  if (!vmm.map_large_page(block, phys, PAGE_SIZE_2M, flags | PageFlags::Writable)) {
+    PhysicalMemoryManager::the().free_contiguous(phys, PAGE_SIZE_2M_ORDER);
+    __atomic_fetch_add(&m_counters.fault_fallback, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+
+  // Zero through the user mapping: frames above 4 GiB are not identity mapped.
+  // CR0.WP applies to the kernel too, so the block is writable until then.
+  fk::memory::set(reinterpret_cast<void*>(block), 0, PAGE_SIZE_2M);
+  if (!(flags & PageFlags::Writable))
+    vmm.map_large_page(block, phys, PAGE_SIZE_2M, flags);
+  __atomic_fetch_add(&m_counters.fault_alloc, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&m_counters.anon_pages, 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+fk::core::Result<void, fk::core::Error> TransparentHugePages::advise(Task* task, uintptr_t start,
+                                                                     uintptr_t end, bool enable) {
+  auto& vmas = task->memory().vmas;
+  if (!vmas) return {};
+  return vmas->set_no_huge_pages(start, end, !enable);
+}
+
+void TransparentHugePages::note_released() {
+  __atomic_fetch_sub(&m_counters.anon_pages, 1, __ATOMIC_RELAXED);
+}
+
+void TransparentHugePages::note_split() {
+  __atomic_fetch_sub(&m_counters.anon_pages, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&m_counters.split, 1, __ATOMIC_RELAXED);
+}
+
+void TransparentHugePages::note_copied() {
+  __atomic_fetch_add(&m_counters.anon_pages, 1, __ATOMIC_RELAXED);
+}
+
+ThpCounters TransparentHugePages::counters() const {
+  ThpCounters out;
+  out.anon_pages = __atomic_load_n(&m_counters.anon_pages, __ATOMIC_RELAXED);
+  out.fault_alloc = __atomic_load_n(&m_counters.fault_alloc, __ATOMIC_RELAXED);
+  out.fault_fallback = __atomic_load_n(&m_counters.fault_fallback, __ATOMIC_RELAXED);
+  out.split = __atomic_load_n(&m_counters.split, __ATOMIC_RELAXED);
+  return out;
+}
+
+} // namespace fkernel
@@ -1,12 +1,101 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
 #include <Kernel/Boot/boot_info.h>
+#include <Kernel/Memory/PhysicalMemory/Buddy/buddy_order.h>
 #include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
-#include <Kernel/Memory/VirtualMemory/RegionSplitter/region_splitter.h>
+#include <Kernel/Memory/VirtualMemory/mmu_gather.h>
+#include <Kernel/Memory/VirtualMemory/pcid_cache.h>
+#include <Kernel/Memory/VirtualMemory/tlb_shootdown.h>
+#include <Kernel/Memory/VirtualMemory/transparent_huge_pages.h>
 #include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Utilities/memory.h>
 #include <LibFK/Algorithms/log.h>
 
-VirtualMemoryManager::VirtualMemoryManager() : m_pml4(nullptr), m_pml4_phys(0) {
+static constexpr uint64_t ENTRY_ADDR_MASK = 0x000FFFFFFFFFF000ULL;
+/// PAT selector: bit 7 in a PTE, bit 12 in a 2 MiB / 1 GiB entry (where bit 7 is PS)
+static constexpr uint64_t PTE_PAT_BIT = 1ULL << 7;
+static constexpr uint64_t LARGE_PAT_BIT = 1ULL << 12;
+
+static bool is_large_leaf(uint64_t entry) {
+  return (entry & static_cast<uint64_t>(PageFlags::Present)) &&
+         (entry & static_cast<uint64_t>(PageFlags::HugePage));
+}
+
+static uint64_t large_frame(uint64_t entry, size_t page_size) {
+  return entry & ENTRY_ADDR_MASK & ~static_cast<uint64_t>(page_size - 1);
+}
+
+// Returns an owned 4 KiB user frame to the allocator it came from
+static void free_user_frame(uint64_t pte) {
+  uintptr_t frame = pte & ENTRY_ADDR_MASK;
+  if (pte & static_cast<uint64_t>(PageFlags::HugeFragment))
+    PhysicalMemoryManager::the().free_contiguous(frame, MIN_ORDER);
+  else
+    PhysicalMemoryManager::the().free_page(frame);
+}
+
+static void defer_free_user_frame(fkernel::MmuGather& gather, uint64_t pte) {
+  uintptr_t frame = pte & ENTRY_ADDR_MASK;
+  if (pte & static_cast<uint64_t>(PageFlags::HugeFragment))
+    gather.defer_free(frame, MIN_ORDER);
+  else
+    gather.defer_free(frame);
+}
+
+namespace {
+
+// Holds an address space's root lock and, when the change reaches tables
+// shared by every address space, the kernel lock too. The root lock is always
+// taken first, so the two never deadlock.
+class PageTableGuard {
+public:
+  PageTableGuard(fk::synchronization::Spinlock& root_lock,
+                 fk::synchronization::Spinlock& kernel_lock, bool shared)
+      : m_root(root_lock), m_kernel_lock(kernel_lock) {
+    if (shared) lock_kernel();
+  }
+  ~PageTableGuard() {
+    if (m_kernel_held) m_kernel_lock.unlock();
+  }
+
+  void lock_kernel() {
+    if (m_kernel_held) return;
+    m_kernel_lock.lock();
+    m_kernel_held = true;
+  }
+
+private:
+  fk::synchronization::ScopedLockIRQ m_root;
+  fk::synchronization::Spinlock& m_kernel_lock;
+  bool m_kernel_held = false;
+};
+
+} // namespace
+
+// Kernel-only entries, and everything in the higher half, sit in tables that
+// create_address_space() shares between roots
+static bool touches_shared_tables(uintptr_t virt, PageFlags flags) {
+  return virt >= KERNEL_VIRT_BASE || !(flags & PageFlags::User);
+}
+
+static bool is_kernel_entry(uint64_t entry) {
+  return (entry & static_cast<uint64_t>(PageFlags::Present)) &&
+         !(entry & static_cast<uint64_t>(PageFlags::User));
+}
+
+// Flag bits for a protection change of a present 4 KiB entry. Shared frames
+// stay shared and read-only: a write has to fault so the page-fault handler
+// can give the process a private copy first.
+static uint64_t protected_entry_flags(uint64_t old_entry, PageFlags flags) {
+  uint64_t shared = static_cast<uint64_t>(PageFlags::Shared);
+  uint64_t kept = old_entry & (static_cast<uint64_t>(PageFlags::HugeFragment) | shared);
+  uint64_t entry = static_cast<uint64_t>(flags) | kept;
+  if (kept & shared)
+    entry &= ~static_cast<uint64_t>(PageFlags::Writable);
+  return entry;
+}
+
+VirtualMemoryManager::VirtualMemoryManager() : m_pml4(nullptr) {
   /*TODO: Apply this log when we work with LogLevel
   fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "Ctor (empty)");
   */
@@ -17,22 +106,61 @@ VirtualMemoryManager& VirtualMemoryManager::the() {
   return inst;
 }
 
+PageTable* VirtualMemoryManager::active_root() const {
+  if (!m_is_initialized)
+    return m_pml4;
+  // CR3 is per CPU; bits 0-11 carry the PCID when it is enabled
+  return reinterpret_cast<PageTable*>(read_on_cr3() & ENTRY_ADDR_MASK);
+}
+
+fk::synchronization::Spinlock& VirtualMemoryManager::root_lock(uintptr_t root_phys) {
+  return m_root_locks[(root_phys >> 12) % PAGE_TABLE_LOCK_STRIPES].lock;
+}
+
 void VirtualMemoryManager::invlpg(uintptr_t addr) {
   invalid_tlb(addr);
 }
 
 void VirtualMemoryManager::flush_tlb() {
-  write_on_cr3(reinterpret_cast<void*>(read_on_cr3()));
+  // A CR3 reload would keep global entries and other PCIDs' entries
+  arch_flush_tlb_all();
+}
+
+void VirtualMemoryManager::invalidate_page(uintptr_t virt, uint64_t old_entry) {
+  // A non-global kernel entry may be cached under every PCID, and INVLPG
+  // only reaches the current one
+  uint64_t shared_bits = static_cast<uint64_t>(PageFlags::User) |
+                         static_cast<uint64_t>(PageFlags::Global);
+  if (m_pcid_enabled && (old_entry & static_cast<uint64_t>(PageFlags::Present)) &&
+      !(old_entry & shared_bits)) {
+    flush_tlb();
+    return;
+  }
+  invlpg(virt);
+}
+
+static PageFlags with_global_bit(uintptr_t virt, PageFlags flags) {
+  // The higher half is never overridden by user mappings, so its entries can
+  // survive address-space switches
+  if (virt >= KERNEL_VIRT_BASE && !(flags & PageFlags::User))
+    return flags | PageFlags::Global;
+  return flags;
+}
+
+// Without PAT the selector bit is reserved, so write-combining degrades to uncached
+PageFlags VirtualMemoryManager::with_cache_type(PageFlags flags) const {
+  if (m_has_pat || !(flags & PageFlags::WriteCombining)) return flags;
+  return static_cast<PageFlags>((static_cast<uint64_t>(flags) &
+                                 ~static_cast<uint64_t>(PageFlags::WriteCombining)) |
+                                static_cast<uint64_t>(PageFlags::CacheDisabled));
 }
 
 void VirtualMemoryManager::perform_initial_identity_mapping() {
-  size_t pages = INITIAL_IDENTITY_MAPPING_SIZE / PAGE_SIZE;
-  fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "Identity mapping start: pages=%zu", pages);
+  size_t page_size = m_has_1g_pages ? PAGE_SIZE_1G : PAGE_SIZE_2M;
+  fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "Identity mapping start: pages=%zu (%zu KiB)",
+                       INITIAL_IDENTITY_MAPPING_SIZE / page_size, page_size / fk::types::KiB);
 
-  for (size_t i = 0; i < pages; i++) {
-    uintptr_t phys = i * PAGE_SIZE;
-    map_page(phys, phys, PageFlags::Present | PageFlags::Writable);
-  }
+  map_range(0, 0, INITIAL_IDENTITY_MAPPING_SIZE, PageFlags::Present | PageFlags::Writable);
 
   fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "Identity mapping done");
 }
@@ -44,44 +172,75 @@ void VirtualMemoryManager::initialize() {
   }
 
   // Aloca PML4 com uma página
-  m_pml4_phys = PhysicalMemoryManager::the().alloc_page();
-  if (m_pml4_phys == 0) {
+  m_kernel_pml4_phys = PhysicalMemoryManager::the().alloc_page();
+  if (m_kernel_pml4_phys == 0) {
     fk::algorithms::kfatal("VMM", "initialize: failed to allocate PML4 page");
     return;
   }
-  m_kernel_pml4_phys = m_pml4_phys;
 
   /*TODO: Apply this log when we work with LogLevel
   fk::algorithms::kdebug(
       "VIRTUAL MEMORY MANAGER",
       "PML4 allocated: phys=%p",
-      m_pml4_phys
+      m_kernel_pml4_phys
   );
   */
 
-  m_pml4 = reinterpret_cast<PageTable*>(m_pml4_phys);
+  m_pml4 = reinterpret_cast<PageTable*>(m_kernel_pml4_phys);
   fk::memory::set(m_pml4, 0, PAGE_SIZE);
 
+  // CPU::the() is not usable yet (it consults ACPI), so probe PCID and
+  // PDPE1GB directly
+  uint32_t eax, ebx, ecx, edx;
+  arch_cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+  bool has_pcid = ecx & (1u << 17);
+  m_has_pat = edx & (1u << 16);
+  arch_cpuid(0x80000000, 0, &eax, &ebx, &ecx, &edx);
+  if (eax >= 0x80000001) {
+    arch_cpuid(0x80000001, 0, &eax, &ebx, &ecx, &edx);
+    m_has_1g_pages = edx & (1u << 26);
+  }
+
   perform_initial_identity_mapping();
   if (boot::BootInfo::the().has_framebuffer()) {
     auto fb = boot::BootInfo::the().get_framebuffer_info();
     uintptr_t start = fb.addr & ~0xFFFULL;
     uintptr_t end = (fb.addr + fb.pitch * fb.height + 0xFFF) & ~0xFFFULL;
-    for (uintptr_t v = start; v < end; v += 0x1000) {
-      map_page(v, v, PageFlags::Present | PageFlags::Writable);
-    }
+    map_range(start, start, end - start,
+              PageFlags::Present | PageFlags::Writable | PageFlags::WriteCombining);
     fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "Mapped framebuffer: %p - %p", (void*)start,
                          (void*)end);
   }
 
+  // The kernel heap and PMM bitmap are never overridden by user mappings:
+  // keep their TLB entries across switches
+  extern uint8_t __heap_start[];
+  extern uint8_t __pmm_bitmap_end[];
+  uintptr_t global_start = reinterpret_cast<uintptr_t>(__heap_start) & ~(PAGE_SIZE - 1);
+  uintptr_t global_end =
+      (reinterpret_cast<uintptr_t>(__pmm_bitmap_end) + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+  map_range(global_start, global_start, global_end - global_start,
+            PageFlags::Present | PageFlags::Writable | PageFlags::Global);
+
+  // The bootloader's tables may use PAT types of their own: switch the layout
+  // and the tables together, with nothing mapped through the PAT bit between
+  if (m_has_pat)
+    arch_program_pat();
+  else
+    fk::algorithms::kwarn("VIRTUAL MEMORY MANAGER", "No PAT: write-combining mappings are uncached");
   write_on_cr3(static_cast<void*>(m_pml4));
+  arch_enable_tlb_features(has_pcid);
+  m_pcid_enabled = has_pcid;
+  if (m_pcid_enabled)
+    fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "PCID enabled: %zu ids per CPU",
+                         fkernel::PCID_SLOTS_PER_CPU);
 
   fk::algorithms::klog("VIRTUAL MEMORY MANAGER", "Initialize done: cr3=%p", m_pml4);
   m_is_initialized = true;
 }
 
-PageTable* VirtualMemoryManager::ensure_table(PageTable* parent, size_t index, PageFlags flags,
-                                              bool& changed) {
+PageTable* VirtualMemoryManager::ensure_table(PageTable* parent, size_t index, size_t entry_size,
+                                              PageFlags flags, bool& changed) {
   uint64_t user_bit = static_cast<uint64_t>(flags) & static_cast<uint64_t>(PageFlags::User);
   uint64_t write_bit = static_cast<uint64_t>(flags) & static_cast<uint64_t>(PageFlags::Writable);
 
@@ -91,14 +250,24 @@ PageTable* VirtualMemoryManager::ensure_table(PageTable* parent, size_t index, P
       return nullptr;
     }
     fk::memory::set(reinterpret_cast<void*>(new_table), 0, PAGE_SIZE);
+    // Not-present entries are never cached, so a new table needs no flush
     parent->entries[index] =
         new_table | static_cast<uint64_t>(PageFlags::Present) | write_bit | user_bit;
-    changed = true;
     return reinterpret_cast<PageTable*>(new_table);
   }
 
   uint64_t existing = parent->entries[index];
 
+  // A large leaf covers the slot: break it up into a fresh table. The new
+  // table is private, so the User bit can be added without the copy below.
+  if (is_large_leaf(existing)) {
+    PageTable* table = split_large_entry(parent, index, entry_size);
+    if (!table) return nullptr;
+    parent->entries[index] |= (user_bit | write_bit);
+    changed = true;
+    return table;
+  }
+
   // If we need the User bit but the existing intermediate entry is kernel-only,
   // copy the pointed-to table into a fresh page so we never modify shared kernel
   // page tables (PDPT_K / PD_K / their leaf PTs).
@@ -106,6 +275,8 @@ PageTable* VirtualMemoryManager::ensure_table(PageTable* parent, size_t index, P
     uintptr_t old_addr = existing & 0x000FFFFFFFFFF000ULL;
     uintptr_t new_table = PhysicalMemoryManager::the().alloc_page();
     if (new_table == 0) return nullptr;
+    // The source is shared; keep kernel mappers out while it is copied
+    fk::synchronization::ScopedLock kernel_lock(m_kernel_lock);
     fk::memory::copy(reinterpret_cast<void*>(new_table),
            reinterpret_cast<void*>(old_addr), PAGE_SIZE);
     parent->entries[index] = new_table | (existing & 0xFFFULL) | user_bit | write_bit;
@@ -125,7 +296,10 @@ PageTable* VirtualMemoryManager::ensure_table(PageTable* parent, size_t index, P
 void VirtualMemoryManager::map_page(uintptr_t virt, uintptr_t phys, PageFlags flags) {
   assert((virt % PAGE_SIZE) == 0);
   assert((phys % PAGE_SIZE) == 0);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  PageTable* root = active_root();
+  PageTableGuard guard(root_lock(reinterpret_cast<uintptr_t>(root)), m_kernel_lock,
+                       touches_shared_tables(virt, flags));
+  flags = with_cache_type(with_global_bit(virt, flags));
 
   size_t pml4_idx = (virt >> 39) & 0x1FF;
   size_t pdpt_idx = (virt >> 30) & 0x1FF;
@@ -134,24 +308,25 @@ void VirtualMemoryManager::map_page(uintptr_t virt, uintptr_t phys, PageFlags fl
 
   bool changed_parents = false;
 
-  PageTable* pdpt = ensure_table(m_pml4, pml4_idx, flags, changed_parents);
+  PageTable* pdpt = ensure_table(root, pml4_idx, 0, flags, changed_parents);
   if (!pdpt) {
     fk::algorithms::kwarn("VMM", "map_page: failed to ensure PDPT");
     return;
   }
 
-  PageTable* pd = ensure_table(pdpt, pdpt_idx, flags, changed_parents);
+  PageTable* pd = ensure_table(pdpt, pdpt_idx, PAGE_SIZE_1G, flags, changed_parents);
   if (!pd) {
     fk::algorithms::kwarn("VMM", "map_page: failed to ensure PD");
     return;
   }
 
-  PageTable* pt = ensure_table(pd, pd_idx, flags, changed_parents);
+  PageTable* pt = ensure_table(pd, pd_idx, PAGE_SIZE_2M, flags, changed_parents);
   if (!pt) {
     fk::algorithms::kwarn("VMM", "map_page: failed to ensure PT");
     return;
   }
 
+  uint64_t old_entry = pt->entries[pt_idx];
   pt->entries[pt_idx] =
       phys | static_cast<uint64_t>(flags) | static_cast<uint64_t>(PageFlags::Present);
 
@@ -160,87 +335,214 @@ void VirtualMemoryManager::map_page(uintptr_t virt, uintptr_t phys, PageFlags fl
     return;
   }
 
+  invalidate_page(virt, old_entry);
+}
+
+bool VirtualMemoryManager::map_large_page(uintptr_t virt, uintptr_t phys, size_t page_size,
+                                          PageFlags flags) {
+  if (page_size != PAGE_SIZE_2M && page_size != PAGE_SIZE_1G) return false;
+  if (page_size == PAGE_SIZE_1G && !m_has_1g_pages) return false;
+  if ((virt | phys) & (page_size - 1)) return false;
+  PageTable* root = active_root();
+  PageTableGuard guard(root_lock(reinterpret_cast<uintptr_t>(root)), m_kernel_lock,
+                       touches_shared_tables(virt, flags));
+  flags = with_cache_type(with_global_bit(virt, flags));
+
+  size_t pml4_idx = (virt >> 39) & 0x1FF;
+  size_t pdpt_idx = (virt >> 30) & 0x1FF;
+  size_t pd_idx = (virt >> 21) & 0x1FF;
+
+  bool changed_parents = false;
+
+  PageTable* parent = ensure_table(root, pml4_idx, 0, flags, changed_parents);
+  if (!parent) {
+    fk::algorithms::kwarn("VMM", "map_large_page: failed to ensure PDPT");
+    return false;
+  }
+  size_t index = pdpt_idx;
+
+  if (page_size == PAGE_SIZE_2M) {
+    parent = ensure_table(parent, pdpt_idx, PAGE_SIZE_1G, flags, changed_parents);
+    if (!parent) {
+      fk::algorithms::kwarn("VMM", "map_large_page: failed to ensure PD");
+      return false;
+    }
+    index = pd_idx;
+  }
+
+  // A lower-level table may hold finer mappings and be referenced from other
+  // address spaces, so it is never replaced here; the caller falls back.
+  uint64_t existing = parent->entries[index];
+  if ((existing & static_cast<uint64_t>(PageFlags::Present)) && !is_large_leaf(existing))
+    return false;
+
+  // Flags come in 4 KiB form, where bit 7 is the PAT selector
+  uint64_t attrs = static_cast<uint64_t>(flags) & ~static_cast<uint64_t>(PageFlags::HugePage);
+  if (flags & PageFlags::WriteCombining) attrs |= LARGE_PAT_BIT;
+  parent->entries[index] = phys | attrs | static_cast<uint64_t>(PageFlags::Present) |
+                           static_cast<uint64_t>(PageFlags::HugePage);
+
+  if (changed_parents || existing) {
+    flush_tlb();
+    return true;
+  }
+
   invlpg(virt);
+  return true;
+}
+
+bool VirtualMemoryManager::can_map_large_page(uintptr_t virt, size_t page_size) {
+  PageTable* root = active_root();
+  fk::synchronization::ScopedLockIRQ lock(root_lock(reinterpret_cast<uintptr_t>(root)));
+  size_t pml4_idx = (virt >> 39) & 0x1FF;
+  size_t pdpt_idx = (virt >> 30) & 0x1FF;
+  size_t pd_idx = (virt >> 21) & 0x1FF;
+
+  uint64_t pml4e = root->entries[pml4_idx];
+  if (!(pml4e & static_cast<uint64_t>(PageFlags::Present))) return true;
+  auto* pdpt = reinterpret_cast<PageTable*>(pml4e & ENTRY_ADDR_MASK);
+  uint64_t pdpte = pdpt->entries[pdpt_idx];
+  if (!(pdpte & static_cast<uint64_t>(PageFlags::Present)) || is_large_leaf(pdpte)) return true;
+  if (page_size == PAGE_SIZE_1G) return false;
+  auto* pd = reinterpret_cast<PageTable*>(pdpte & ENTRY_ADDR_MASK);
+  uint64_t pde = pd->entries[pd_idx];
+  return !(pde & static_cast<uint64_t>(PageFlags::Present)) || is_large_leaf(pde);
+}
+
+PageTable* VirtualMemoryManager::split_large_entry(PageTable* parent, size_t index,
+                                                   size_t page_size) {
+  uint64_t entry = parent->entries[index];
+  uintptr_t new_table = PhysicalMemoryManager::the().alloc_page();
+  if (new_table == 0) {
+    fk::algorithms::kwarn("VMM", "split_large_entry: failed to allocate table");
+    return nullptr;
+  }
+
+  size_t child_size = page_size / 512;
+  uint64_t base = large_frame(entry, page_size);
+  uint64_t attrs = entry & ~ENTRY_ADDR_MASK;
+  if (child_size == PAGE_SIZE) {
+    attrs &= ~static_cast<uint64_t>(PageFlags::HugePage);
+    if (entry & LARGE_PAT_BIT) attrs |= PTE_PAT_BIT;
+    // An owned 2 MiB block is now released page by page
+    if ((entry & static_cast<uint64_t>(PageFlags::User)) &&
+        !(entry & static_cast<uint64_t>(PageFlags::Shared))) {
+      attrs |= static_cast<uint64_t>(PageFlags::HugeFragment);
+      fkernel::TransparentHugePages::the().note_split();
+    }
+  } else if (entry & LARGE_PAT_BIT) {
+    attrs |= LARGE_PAT_BIT;
+  }
+
+  auto* table = reinterpret_cast<PageTable*>(new_table);
+  for (size_t i = 0; i < 512; ++i)
+    table->entries[i] = (base + i * child_size) | attrs;
+
+  parent->entries[index] = new_table | (entry & (static_cast<uint64_t>(PageFlags::Present) |
+                                                 static_cast<uint64_t>(PageFlags::Writable) |
+                                                 static_cast<uint64_t>(PageFlags::User)));
+  // Same translations as before, but drop the cached large entry so the
+  // caller's next change to a 4 KiB entry is not shadowed by it
+  flush_tlb();
+  return table;
+}
+
+uint64_t* VirtualMemoryManager::find_leaf(PageTable* root, uintptr_t virt, size_t& page_size) {
+  size_t pml4_idx = (virt >> 39) & 0x1FF;
+  size_t pdpt_idx = (virt >> 30) & 0x1FF;
+  size_t pd_idx = (virt >> 21) & 0x1FF;
+  size_t pt_idx = (virt >> 12) & 0x1FF;
+
+  if (!(root->entries[pml4_idx] & (uint64_t)PageFlags::Present))
+    return nullptr;
+  PageTable* pdpt = reinterpret_cast<PageTable*>(root->entries[pml4_idx] & ENTRY_ADDR_MASK);
+  if (!(pdpt->entries[pdpt_idx] & (uint64_t)PageFlags::Present))
+    return nullptr;
+  if (is_large_leaf(pdpt->entries[pdpt_idx])) {
+    page_size = PAGE_SIZE_1G;
+    return &pdpt->entries[pdpt_idx];
+  }
+  PageTable* pd = reinterpret_cast<PageTable*>(pdpt->entries[pdpt_idx] & ENTRY_ADDR_MASK);
+  if (!(pd->entries[pd_idx] & (uint64_t)PageFlags::Present))
+    return nullptr;
+  if (is_large_leaf(pd->entries[pd_idx])) {
+    page_size = PAGE_SIZE_2M;
+    return &pd->entries[pd_idx];
+  }
+  PageTable* pt = reinterpret_cast<PageTable*>(pd->entries[pd_idx] & ENTRY_ADDR_MASK);
+  if (!(pt->entries[pt_idx] & (uint64_t)PageFlags::Present))
+    return nullptr;
+  page_size = PAGE_SIZE;
+  return &pt->entries[pt_idx];
 }
 
 void VirtualMemoryManager::unmap_page(uintptr_t virt) {
   fk::algorithms::kdebug("VMM", "unmap_page(%p)", (void*)virt);
   assert((virt % PAGE_SIZE) == 0);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-
-  uint64_t* pte_ptr = get_pte(virt);
+  PageTable* root = active_root();
+  PageTableGuard guard(root_lock(reinterpret_cast<uintptr_t>(root)), m_kernel_lock,
+                       virt >= KERNEL_VIRT_BASE);
+  size_t page_size = 0;
+  uint64_t* leaf = find_leaf(root, virt, page_size);
+  if (leaf && is_kernel_entry(*leaf)) guard.lock_kernel();
+
+  uint64_t* pte_ptr = get_pte_in(root, virt, false);
   if (pte_ptr && (*pte_ptr & static_cast<uint64_t>(PageFlags::Present))) {
+    uint64_t old_entry = *pte_ptr;
     *pte_ptr = 0;
-    invlpg(virt);
+    invalidate_page(virt, old_entry);
   }
 }
 
 void VirtualMemoryManager::protect_page(uintptr_t virt, PageFlags flags) {
   fk::algorithms::kdebug("VMM", "protect_page(%p, flags=0x%lx)", (void*)virt, (uint64_t)flags);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-  uint64_t* pte = get_pte(virt, false);
+  PageTable* root = active_root();
+  PageTableGuard guard(root_lock(reinterpret_cast<uintptr_t>(root)), m_kernel_lock,
+                       touches_shared_tables(virt, flags));
+  size_t page_size = 0;
+  uint64_t* leaf = find_leaf(root, virt, page_size);
+  if (leaf && is_kernel_entry(*leaf)) guard.lock_kernel();
+
+  uint64_t* pte = get_pte_in(root, virt, false);
   if (!pte || !(*pte & static_cast<uint64_t>(PageFlags::Present)))
     return;
   uintptr_t phys = *pte & 0x000FFFFFFFFFF000ULL;
-  *pte = phys | static_cast<uint64_t>(flags);
-  invlpg(virt);
+  uint64_t old_entry = *pte;
+  *pte = phys | protected_entry_flags(old_entry, with_cache_type(flags));
+  invalidate_page(virt, old_entry);
 }
 
 uintptr_t VirtualMemoryManager::translate(uintptr_t virt) {
   assert((virt % PAGE_SIZE) == 0);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-
-  size_t pml4_idx = (virt >> 39) & 0x1FF;
-  size_t pdpt_idx = (virt >> 30) & 0x1FF;
-  size_t pd_idx = (virt >> 21) & 0x1FF;
-  size_t pt_idx = (virt >> 12) & 0x1FF;
-
-  if (!(m_pml4->entries[pml4_idx] & (uint64_t)PageFlags::Present)) {
-    return 0;
-  }
-
-  PageTable* pdpt = reinterpret_cast<PageTable*>(m_pml4->entries[pml4_idx] & 0x000FFFFFFFFFF000);
+  PageTable* root = active_root();
+  fk::synchronization::ScopedLockIRQ lock(root_lock(reinterpret_cast<uintptr_t>(root)));
 
-  if (!(pdpt->entries[pdpt_idx] & (uint64_t)PageFlags::Present)) {
+  size_t page_size = 0;
+  uint64_t* leaf = find_leaf(root, virt, page_size);
+  if (!leaf) {
     return 0;
   }
 
-  PageTable* pd = reinterpret_cast<PageTable*>(pdpt->entries[pdpt_idx] & 0x000FFFFFFFFFF000);
-
-  if (!(pd->entries[pd_idx] & (uint64_t)PageFlags::Present)) {
-    return 0;
-  }
-
-  PageTable* pt = reinterpret_cast<PageTable*>(pd->entries[pd_idx] & 0x000FFFFFFFFFF000);
-
-  if (!(pt->entries[pt_idx] & (uint64_t)PageFlags::Present)) {
-    return 0;
-  }
-
-  uintptr_t phys = (pt->entries[pt_idx] & 0x000FFFFFFFFFF000) + (virt & 0xFFF);
+  uintptr_t phys = large_frame(*leaf, page_size) + (virt & (page_size - 1));
   return phys;
 }
 
 fk::core::Result<PageFlags, fk::core::Error> VirtualMemoryManager::get_page_flags(uintptr_t virt) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-  size_t pml4_idx = (virt >> 39) & 0x1FF;
-  size_t pdpt_idx = (virt >> 30) & 0x1FF;
-  size_t pd_idx = (virt >> 21) & 0x1FF;
-  size_t pt_idx = (virt >> 12) & 0x1FF;
-
-  if (!(m_pml4->entries[pml4_idx] & (uint64_t)PageFlags::Present))
-    return fk::core::Error::NotFound;
-  PageTable* pdpt = reinterpret_cast<PageTable*>(m_pml4->entries[pml4_idx] & 0x000FFFFFFFFFF000);
-  if (!(pdpt->entries[pdpt_idx] & (uint64_t)PageFlags::Present))
-    return fk::core::Error::NotFound;
-  PageTable* pd = reinterpret_cast<PageTable*>(pdpt->entries[pdpt_idx] & 0x000FFFFFFFFFF000);
-  if (!(pd->entries[pd_idx] & (uint64_t)PageFlags::Present))
-    return fk::core::Error::NotFound;
-  PageTable* pt = reinterpret_cast<PageTable*>(pd->entries[pd_idx] & 0x000FFFFFFFFFF000);
-  if (!(pt->entries[pt_idx] & (uint64_t)PageFlags::Present))
+  PageTable* root = active_root();
+  fk::synchronization::ScopedLockIRQ lock(root_lock(reinterpret_cast<uintptr_t>(root)));
+  size_t page_size = 0;
+  uint64_t* leaf = find_leaf(root, virt, page_size);
+  if (!leaf)
     return fk::core::Error::NotFound;
 
-  return static_cast<PageFlags>(pt->entries[pt_idx] & ~0x000FFFFFFFFFF000ULL);
+  // Report large mappings in 4 KiB PTE form so callers can hand the flags
+  // straight back to protect_page()
+  uint64_t flags = *leaf & ~ENTRY_ADDR_MASK;
+  if (page_size != PAGE_SIZE) {
+    flags &= ~static_cast<uint64_t>(PageFlags::HugePage);
+    if (*leaf & LARGE_PAT_BIT) flags |= PTE_PAT_BIT;
+  }
+  return static_cast<PageFlags>(flags);
 }
 
 uintptr_t clone_table_recursive(uintptr_t old_phys, int level, bool deep_copy) {
@@ -261,6 +563,25 @@ uintptr_t clone_table_recursive(uintptr_t old_phys, int level, bool deep_copy) {
       continue;
     }
 
+    // Shared frames (vDSO, shared text) are mapped, not owned: copy the entry
+    if (level == 1 && (old_table->entries[i] & static_cast<uint64_t>(PageFlags::Shared))) {
+      new_table->entries[i] = old_table->entries[i];
+      continue;
+    }
+
+    // User 2 MiB pages own a whole buddy block; copy it like a PT entry
+    if (level == 2 && (old_table->entries[i] & static_cast<uint64_t>(PageFlags::HugePage))) {
+      if (!deep_copy) continue;
+      uintptr_t old_page = large_frame(old_table->entries[i], PAGE_SIZE_2M);
+      uintptr_t new_page = PhysicalMemoryManager::the().alloc_contiguous(PAGE_SIZE_2M_ORDER);
+      if (!new_page) continue;
+      fk::memory::copy(reinterpret_cast<void*>(new_page), reinterpret_cast<void*>(old_page), PAGE_SIZE_2M);
+      new_table->entries[i] = new_page | (old_table->entries[i] & ~ENTRY_ADDR_MASK) |
+                              (old_table->entries[i] & LARGE_PAT_BIT);
+      fkernel::TransparentHugePages::the().note_copied();
+      continue;
+    }
+
     // User mappings:
     if (level > 1) {
       uintptr_t old_sub = old_table->entries[i] & 0x000FFFFFFFFFF000;
@@ -274,7 +595,8 @@ uintptr_t clone_table_recursive(uintptr_t old_phys, int level, bool deep_copy) {
         uintptr_t new_page = PhysicalMemoryManager::the().alloc_page();
         if (!new_page) continue;
         fk::memory::copy(reinterpret_cast<void*>(new_page), reinterpret_cast<void*>(old_page), 0x1000);
-        new_table->entries[i] = new_page | (old_table->entries[i] & 0xFFF);
+        new_table->entries[i] = new_page | (old_table->entries[i] & 0xFFF &
+                                            ~static_cast<uint64_t>(PageFlags::HugeFragment));
       } else {
         new_table->entries[i] = 0;
       }
@@ -285,9 +607,9 @@ uintptr_t clone_table_recursive(uintptr_t old_phys, int level, bool deep_copy) {
 
 uintptr_t VirtualMemoryManager::create_address_space() {
   fk::algorithms::kdebug("VMM", "create_address_space()");
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-  // Always clone from the kernel's root PML4, not from m_pml4_phys which tracks
-  // the current task's (possibly user) address space and can become stale after frees.
+  PageTableGuard guard(root_lock(m_kernel_pml4_phys), m_kernel_lock, true);
+  // Always clone from the kernel's root PML4, not from the active one, which
+  // may be a user address space and carries its user mappings.
   uintptr_t new_cr3 = clone_table_recursive(m_kernel_pml4_phys, 4, false);
   fk::algorithms::kdebug("VMM", "create_address_space() -> %p", (void*)new_cr3);
   return new_cr3;
@@ -295,7 +617,8 @@ uintptr_t VirtualMemoryManager::create_address_space() {
 
 uintptr_t VirtualMemoryManager::clone_address_space(uintptr_t source_cr3) {
   fk::algorithms::kdebug("VMM", "clone_address_space(%p)", (void*)source_cr3);
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  // Only the source is locked: faults in other processes carry on meanwhile
+  fk::synchronization::ScopedLockIRQ lock(root_lock(source_cr3));
   return clone_table_recursive(source_cr3, 4, true);
 }
 
@@ -303,9 +626,13 @@ void VirtualMemoryManager::switch_address_space(uintptr_t cr3) {
   fk::algorithms::kdebug("VMM", "switch_address_space(%p)", (void*)cr3);
   if (cr3 == 0)
     return;
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-  m_pml4_phys = cr3;
-  m_pml4 = reinterpret_cast<PageTable*>(cr3);
+  // CR3 is this CPU's alone and PcidCache is lock-free: no page-table lock
+  uint32_t cpu = arch_current_cpu_id();
+  fkernel::TlbShootdown::the().note_active(cpu, cr3);
+  if (m_pcid_enabled) {
+    arch_load_cr3(fkernel::PcidCache::the().cr3_for(cpu, cr3));
+    return;
+  }
   write_on_cr3(reinterpret_cast<void*>(cr3));
 }
 
@@ -313,7 +640,14 @@ void VirtualMemoryManager::free_address_space(uintptr_t cr3) {
   fk::algorithms::kdebug("VMM", "free_address_space(%p)", (void*)cr3);
   if (cr3 == 0 || cr3 == m_kernel_pml4_phys) return;
 
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  // Nothing maps into a dying address space, so one flush up front lets every
+  // frame below be freed right away instead of through a gather
+  fkernel::TlbShootdown::the().flush(cr3, nullptr, 0);
+
+  fk::synchronization::ScopedLockIRQ lock(root_lock(cr3));
+  // The PML4 page may come back as another address space's root
+  if (m_pcid_enabled)
+    fkernel::PcidCache::the().forget(cr3);
   auto* pml4 = reinterpret_cast<PageTable*>(cr3);
 
   // Walk only the user-space half of PML4 (entries 0-255 for 48-bit canonical)
@@ -328,6 +662,8 @@ void VirtualMemoryManager::free_address_space(uintptr_t cr3) {
       uint64_t pdpte = pdpt->entries[pdpt_i];
       if (!(pdpte & 1) || !(pdpte & 4)) continue;
 
+      if (pdpte & static_cast<uint64_t>(PageFlags::HugePage)) continue;
+
       uintptr_t pd_phys = pdpte & 0x000FFFFFFFFFF000ULL;
       auto* pd = reinterpret_cast<PageTable*>(pd_phys);
 
@@ -335,13 +671,23 @@ void VirtualMemoryManager::free_address_space(uintptr_t cr3) {
         uint64_t pde = pd->entries[pd_i];
         if (!(pde & 1) || !(pde & 4)) continue;
 
+        if (pde & static_cast<uint64_t>(PageFlags::HugePage)) {
+          if (!(pde & static_cast<uint64_t>(PageFlags::Shared))) {
+            PhysicalMemoryManager::the().free_contiguous(large_frame(pde, PAGE_SIZE_2M),
+                                                         PAGE_SIZE_2M_ORDER);
+            fkernel::TransparentHugePages::the().note_released();
+          }
+          continue;
+        }
+
         uintptr_t pt_phys = pde & 0x000FFFFFFFFFF000ULL;
         auto* pt = reinterpret_cast<PageTable*>(pt_phys);
 
         for (int pt_i = 0; pt_i < 512; ++pt_i) {
           uint64_t pte = pt->entries[pt_i];
           if (!(pte & 1) || !(pte & 4)) continue;
-          PhysicalMemoryManager::the().free_page(pte & 0x000FFFFFFFFFF000ULL);
+          if (pte & static_cast<uint64_t>(PageFlags::Shared)) continue;
+          free_user_frame(pte);
         }
         PhysicalMemoryManager::the().free_page(pt_phys);
       }
@@ -353,6 +699,7 @@ void VirtualMemoryManager::free_address_space(uintptr_t cr3) {
 }
 
 static PageTable* get_or_create_table(PageTable* parent, size_t index, bool create) {
+  if (is_large_leaf(parent->entries[index])) return nullptr;
   if (parent->entries[index] & static_cast<uint64_t>(PageFlags::Present))
     return reinterpret_cast<PageTable*>(parent->entries[index] & 0x000FFFFFFFFFF000);
   if (!create) return nullptr;
@@ -366,17 +713,28 @@ static PageTable* get_or_create_table(PageTable* parent, size_t index, bool crea
 }
 
 uint64_t* VirtualMemoryManager::get_pte(uintptr_t virt, bool create) {
+  PageTable* root = active_root();
+  fk::synchronization::ScopedLockIRQ lock(root_lock(reinterpret_cast<uintptr_t>(root)));
+  return get_pte_in(root, virt, create);
+}
+
+uint64_t* VirtualMemoryManager::get_pte_in(PageTable* root, uintptr_t virt, bool create) {
   size_t pml4_idx = (virt >> 39) & 0x1FF;
   size_t pdpt_idx = (virt >> 30) & 0x1FF;
   size_t pd_idx = (virt >> 21) & 0x1FF;
   size_t pt_idx = (virt >> 12) & 0x1FF;
 
-  PageTable* pdpt = get_or_create_table(m_pml4, pml4_idx, create);
+  PageTable* pdpt = get_or_create_table(root, pml4_idx, create);
   if (!pdpt) return nullptr;
 
+  if (is_large_leaf(pdpt->entries[pdpt_idx]) &&
+      !split_large_entry(pdpt, pdpt_idx, PAGE_SIZE_1G))
+    return nullptr;
   PageTable* pd = get_or_create_table(pdpt, pdpt_idx, create);
   if (!pd) return nullptr;
 
+  if (is_large_leaf(pd->entries[pd_idx]) && !split_large_entry(pd, pd_idx, PAGE_SIZE_2M))
+    return nullptr;
   PageTable* pt = get_or_create_table(pd, pd_idx, create);
   if (!pt) return nullptr;
 
@@ -389,26 +747,55 @@ static bool is_table_empty(PageTable* pt) {
   return true;
 }
 
-void VirtualMemoryManager::unmap_page_range(uintptr_t start, uintptr_t end) {
+uintptr_t VirtualMemoryManager::unmap_page_range(PageTable* root, uintptr_t start, uintptr_t end,
+                                                fkernel::MmuGather& gather) {
   for (uintptr_t addr = start; addr < end; addr += PAGE_SIZE) {
-    uint64_t* pte_ptr = get_pte(addr);
+    // Up to four frees per page (frame plus three tables): stop early and
+    // let the caller flush outside the lock
+    if (gather.deferred_frames() + 4 > fkernel::MmuGather::MAX_DEFERRED_FRAMES)
+      return addr;
+
+    size_t page_size = 0;
+    uint64_t* leaf = find_leaf(root, addr, page_size);
+    if (leaf && page_size != PAGE_SIZE) {
+      uintptr_t base = addr & ~static_cast<uintptr_t>(page_size - 1);
+      // Kernel large mappings (identity map, MMIO) are never torn down from here
+      if (!(*leaf & static_cast<uint64_t>(PageFlags::User))) {
+        addr = base + page_size - PAGE_SIZE;
+        continue;
+      }
+      if (base == addr && addr + page_size <= end) {
+        if (page_size == PAGE_SIZE_2M && !(*leaf & static_cast<uint64_t>(PageFlags::Shared))) {
+          gather.defer_free(large_frame(*leaf, page_size), PAGE_SIZE_2M_ORDER);
+          fkernel::TransparentHugePages::the().note_released();
+        }
+        *leaf = 0;
+        gather.add_page(addr);
+        addr = base + page_size - PAGE_SIZE;
+        continue;
+      }
+      // Partial unmap: get_pte() splits the page into HugeFragment PTEs
+    }
+
+    uint64_t* pte_ptr = get_pte_in(root, addr, false);
     if (!pte_ptr) continue;
     if (!(*pte_ptr & static_cast<uint64_t>(PageFlags::Present))) continue;
 
-    uint64_t frame = *pte_ptr & 0x000FFFFFFFFFF000;
-    if (*pte_ptr & static_cast<uint64_t>(PageFlags::User))
-      PhysicalMemoryManager::the().free_page(frame);
+    bool owned = (*pte_ptr & static_cast<uint64_t>(PageFlags::User)) &&
+                 !(*pte_ptr & static_cast<uint64_t>(PageFlags::Shared));
+    if (owned)
+      defer_free_user_frame(gather, *pte_ptr);
 
     *pte_ptr = 0;
-    invlpg(addr);
+    gather.add_page(addr);
 
     // Free empty intermediate tables
     size_t pml4_idx = (addr >> 39) & 0x1FF;
     size_t pdpt_idx = (addr >> 30) & 0x1FF;
     size_t pd_idx   = (addr >> 21) & 0x1FF;
 
-    if (!(m_pml4->entries[pml4_idx] & 1)) continue;
-    auto* pdpt = reinterpret_cast<PageTable*>(m_pml4->entries[pml4_idx] & 0x000FFFFFFFFFF000ULL);
+    if (!(root->entries[pml4_idx] & 1)) continue;
+    auto* pdpt = reinterpret_cast<PageTable*>(root->entries[pml4_idx] & 0x000FFFFFFFFFF000ULL);
 
     if (!(pdpt->entries[pdpt_idx] & 1)) continue;
     auto* pd = reinterpret_cast<PageTable*>(pdpt->entries[pdpt_idx] & 0x000FFFFFFFFFF000ULL);
@@ -416,18 +803,22 @@ void VirtualMemoryManager::unmap_page_range(uintptr_t start, uintptr_t end) {
     if (!(pd->entries[pd_idx] & 1)) continue;
     auto* pt = reinterpret_cast<PageTable*>(pd->entries[pd_idx] & 0x000FFFFFFFFFF000ULL);
 
+    // Paging-structure caches may still point at a freed table: the whole
+    // address space is flushed before it is reused
     if (!is_table_empty(pt)) continue;
-    PhysicalMemoryManager::the().free_page(reinterpret_cast<uintptr_t>(pt));
+    gather.defer_free(reinterpret_cast<uintptr_t>(pt));
+    gather.flush_all();
     pd->entries[pd_idx] = 0;
 
     if (!is_table_empty(pd)) continue;
-    PhysicalMemoryManager::the().free_page(reinterpret_cast<uintptr_t>(pd));
+    gather.defer_free(reinterpret_cast<uintptr_t>(pd));
     pdpt->entries[pdpt_idx] = 0;
 
     if (!is_table_empty(pdpt)) continue;
-    PhysicalMemoryManager::the().free_page(reinterpret_cast<uintptr_t>(pdpt));
-    m_pml4->entries[pml4_idx] = 0;
+    gather.defer_free(reinterpret_cast<uintptr_t>(pdpt));
+    root->entries[pml4_idx] = 0;
   }
+  return end;
 }
 
 fk::core::Result<int, fk::core::Error> VirtualMemoryManager::munmap(uintptr_t addr, size_t length) {
@@ -436,31 +827,95 @@ fk::core::Result<int, fk::core::Error> VirtualMemoryManager::munmap(uintptr_t ad
   }
 
   uintptr_t aligned_end = (addr + length + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+  PageTable* root = active_root();
+  uintptr_t root_phys = reinterpret_cast<uintptr_t>(root);
+
+  // 1. Unmap from page tables in batches; each batch is flushed and its
+  // frames freed after the lock is dropped
+  fkernel::MmuGather gather(root_phys);
+  for (uintptr_t cursor = addr; cursor < aligned_end;) {
+    {
+      fk::synchronization::ScopedLockIRQ lock(root_lock(root_phys));
+      cursor = unmap_page_range(root, cursor, aligned_end, gather);
+    }
+    gather.finish();
+  }
 
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
-
-  // 1. Unmap from page tables
-  unmap_page_range(addr, aligned_end);
-
-  // 2. Update memory regions
+  // 2. Drop the range from the task's VMA tree
   auto* current_task = SchedulerManager::the().current();
   if (!current_task)
     return fk::core::Error::PermissionDenied;
 
-  auto& regions = current_task->resources.memory.regions.list;
-  fkernel::RegionSplitter splitter(regions);
-  splitter.split(addr, aligned_end);
+  auto& vmas = current_task->resources.memory.vmas;
+  if (vmas) {
+    auto res = vmas->remove_range(addr, aligned_end);
+    if (res.is_error())
+      return res.error();
+  }
   return 0;
 }
 
-void VirtualMemoryManager::map_range(uintptr_t start, uintptr_t size, PageFlags flags) {
+// Only changes that take rights away leave dangerous TLB entries behind;
+// a stale, stricter entry just faults and is refetched
+static bool revokes_access(uint64_t old_entry, uint64_t new_entry) {
+  uint64_t present = static_cast<uint64_t>(PageFlags::Present);
+  uint64_t writable = static_cast<uint64_t>(PageFlags::Writable);
+  uint64_t nx = static_cast<uint64_t>(PageFlags::ExecuteDisable);
+  if ((old_entry & present) && !(new_entry & present)) return true;
+  if ((old_entry & writable) && !(new_entry & writable)) return true;
+  return !(old_entry & nx) && (new_entry & nx);
+}
+
+void VirtualMemoryManager::protect_range(uintptr_t start, uintptr_t end, PageFlags flags) {
   assert((start % PAGE_SIZE) == 0);
+  PageTable* root = active_root();
+  uintptr_t root_phys = reinterpret_cast<uintptr_t>(root);
+
+  fkernel::MmuGather gather(root_phys);
+  {
+    fk::synchronization::ScopedLockIRQ lock(root_lock(root_phys));
+    for (uintptr_t page = start; page < end; page += PAGE_SIZE) {
+      uint64_t* pte = get_pte_in(root, page, false);
+      // Kernel entries are not changed on a user's behalf
+      if (!pte || !(*pte & static_cast<uint64_t>(PageFlags::Present)) ||
+          !(*pte & static_cast<uint64_t>(PageFlags::User)))
+        continue;
+      uint64_t old_entry = *pte;
+      *pte = (old_entry & ENTRY_ADDR_MASK) | protected_entry_flags(old_entry, flags);
+      if (revokes_access(old_entry, *pte))
+        gather.add_page(page);
+    }
+  }
+  gather.finish();
+}
+
+void VirtualMemoryManager::map_range(uintptr_t start, uintptr_t size, PageFlags flags) {
+  // Here we assume identity mapping for simpler use cases or that
+  // the caller wants to map virtual to physical identical addresses
+  // This is commonly used for MMIO or kernel regions.
+  map_range(start, start, size, flags);
+}
+
+void VirtualMemoryManager::map_range(uintptr_t virt, uintptr_t phys, size_t size,
+                                     PageFlags flags) {
+  assert((virt % PAGE_SIZE) == 0);
+  assert((phys % PAGE_SIZE) == 0);
   assert((size % PAGE_SIZE) == 0);
 
-  for (uintptr_t offset = 0; offset < size; offset += PAGE_SIZE) {
-    // Here we assume identity mapping for simpler use cases or that
-    // the caller wants to map virtual to physical identical addresses
-    // This is commonly used for MMIO or kernel regions.
-    map_page(start + offset, start + offset, flags);
+  size_t offset = 0;
+  while (offset < size) {
+    size_t remaining = size - offset;
+    if (remaining >= PAGE_SIZE_1G &&
+        map_large_page(virt + offset, phys + offset, PAGE_SIZE_1G, flags)) {
+      offset += PAGE_SIZE_1G;
+      continue;
+    }
+    if (remaining >= PAGE_SIZE_2M &&
+        map_large_page(virt + offset, phys + offset, PAGE_SIZE_2M, flags)) {
+      offset += PAGE_SIZE_2M;
+      continue;
+    }
+    map_page(virt + offset, phys + offset, flags);
+    offset += PAGE_SIZE;
   }
 }
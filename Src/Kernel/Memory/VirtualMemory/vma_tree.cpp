@@ -0,0 +1,353 @@
+#include <Kernel/Arch/x86_64/arch_defs.h>
+#include <Kernel/Memory/VirtualMemory/vma_tree.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+
+static bool same_name(const Vma& a, const Vma& b) {
+  return fk::memory::compare(a.name.c_str(), b.name.c_str()) == 0;
+}
+
+// Only plain anonymous memory is coalesced; image segments, the heap and the
+// stack keep their own entries so /proc/<pid>/maps stays readable.
+static bool can_merge(const Vma& a, const Vma& b) {
+  return a.end == b.start && a.kind == VmaKind::Anonymous && b.kind == VmaKind::Anonymous &&
+         a.flags == b.flags && a.no_huge_pages == b.no_huge_pages && same_name(a, b);
+}
+
+static uintptr_t align_up(uintptr_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+}
+
+void VmaTree::GapAugment::update(Vma& vma) {
+  Vma* left = vma.rb_node.left;
+  Vma* right = vma.rb_node.right;
+  vma.subtree_start = left ? left->subtree_start : vma.start;
+  vma.subtree_end = right ? right->subtree_end : vma.end;
+
+  uintptr_t gap = 0;
+  if (left) {
+    gap = left->subtree_gap;
+    if (vma.start - left->subtree_end > gap) gap = vma.start - left->subtree_end;
+  }
+  if (right) {
+    if (right->subtree_gap > gap) gap = right->subtree_gap;
+    if (right->subtree_start - vma.end > gap) gap = right->subtree_start - vma.end;
+  }
+  vma.subtree_gap = gap;
+}
+
+VmaTree::~VmaTree() {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  destroy_all_locked();
+}
+
+fk::core::Result<fk::RefPtr<VmaTree>, fk::core::Error> VmaTree::create() {
+  return fk::make_ref<VmaTree>();
+}
+
+fk::core::Result<fk::RefPtr<VmaTree>, fk::core::Error> VmaTree::clone() const {
+  auto copy_res = create();
+  if (copy_res.is_error()) return copy_res.error();
+  auto copy = copy_res.value();
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  for (Vma* vma = m_tree.first(); vma; vma = Tree::next(*vma)) {
+    Vma* dup = new Vma();
+    if (!dup) return fk::core::Error::OutOfMemory;
+    dup->start = vma->start;
+    dup->end = vma->end;
+    dup->flags = vma->flags;
+    dup->kind = vma->kind;
+    dup->no_huge_pages = vma->no_huge_pages;
+    dup->name = vma->name;
+    dup->file = vma->file;
+    dup->file_offset = vma->file_offset;
+    dup->file_end = vma->file_end;
+    copy->m_tree.insert(*dup);
+  }
+  return copy;
+}
+
+fk::core::Result<void, fk::core::Error> VmaTree::insert(uintptr_t start, uintptr_t end,
+                                                        PageFlags flags, VmaKind kind,
+                                                        const char* name) {
+  if (start >= end) return fk::core::Error::InvalidParameter;
+
+  Vma* vma = new Vma();
+  if (!vma) return fk::core::Error::OutOfMemory;
+  vma->start = start;
+  vma->end = end;
+  vma->flags = flags;
+  vma->kind = kind;
+  vma->name = fk::text::fixed_string<64>(name ? name : "");
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return link_locked(vma);
+}
+
+fk::core::Result<void, fk::core::Error>
+VmaTree::insert_file(uintptr_t start, uintptr_t end, PageFlags flags, const char* name,
+                     fk::RefPtr<Node> file, uint64_t file_offset, uintptr_t file_end) {
+  if (start >= end || (file_offset & (PAGE_SIZE - 1))) return fk::core::Error::InvalidParameter;
+
+  Vma* vma = new Vma();
+  if (!vma) return fk::core::Error::OutOfMemory;
+  vma->start = start;
+  vma->end = end;
+  vma->flags = flags;
+  vma->kind = VmaKind::Image;
+  vma->name = fk::text::fixed_string<64>(name ? name : "");
+  vma->file = fk::types::move(file);
+  vma->file_offset = file_offset;
+  vma->file_end = file_end;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return link_locked(vma);
+}
+
+bool VmaTree::lookup(uintptr_t addr, Vma& out) const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  Vma* vma = find_locked(addr);
+  if (!vma) return false;
+  out = *vma;
+  out.rb_node = {};
+  return true;
+}
+
+bool VmaTree::is_range_free(uintptr_t start, uintptr_t end) const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  Vma* next = first_ending_after(start);
+  return !next || next->start >= end;
+}
+
+fk::core::Result<uintptr_t, fk::core::Error>
+VmaTree::find_free_range(size_t length, size_t alignment, uintptr_t low, uintptr_t high) const {
+  if (length == 0 || low >= high) return fk::core::Error::InvalidParameter;
+  if (alignment < PAGE_SIZE) alignment = PAGE_SIZE;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  uintptr_t addr = search_gap(m_tree.root(), 0, ~static_cast<uintptr_t>(0), length, alignment,
+                              low, high);
+  if (!addr) return fk::core::Error::OutOfMemory;
+  return addr;
+}
+
+fk::core::Result<void, fk::core::Error> VmaTree::remove_range(uintptr_t start, uintptr_t end) {
+  if (start >= end) return fk::core::Error::InvalidParameter;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  Vma* vma = first_ending_after(start);
+  while (vma && vma->start < end) {
+    if (vma->start < start && vma->end > end) {
+      // Punching a hole: keep the tail as its own mapping
+      if (!split_locked(vma, end)) return fk::core::Error::OutOfMemory;
+      vma->end = start;
+      m_tree.propagate(vma);
+      break;
+    }
+    if (vma->start < start) {
+      vma->end = start;
+      m_tree.propagate(vma);
+      vma = Tree::next(*vma);
+      continue;
+    }
+    if (vma->end > end) {
+      // Nothing else lives in [vma->start, end), so the order is unchanged
+      if (vma->is_file_backed()) vma->file_offset += end - vma->start;
+      vma->start = end;
+      m_tree.propagate(vma);
+      break;
+    }
+    Vma* next = Tree::next(*vma);
+    m_tree.remove(*vma);
+    delete vma;
+    vma = next;
+  }
+  return {};
+}
+
+// Applies apply to every mapping inside [start, end), splitting the ones that
+// straddle an edge, then merges the run back with compatible neighbours.
+template <typename Apply>
+fk::core::Result<void, fk::core::Error> VmaTree::update_range_locked(uintptr_t start,
+                                                                     uintptr_t end, Apply apply) {
+  Vma* vma = first_ending_after(start);
+  if (vma && vma->start < start) {
+    vma = split_locked(vma, start);
+    if (!vma) return fk::core::Error::OutOfMemory;
+  }
+
+  Vma* last = nullptr;
+  while (vma && vma->start < end) {
+    if (vma->end > end && !split_locked(vma, end)) return fk::core::Error::OutOfMemory;
+    apply(*vma);
+    last = vma;
+    vma = Tree::next(*vma);
+  }
+  if (!last) return {};
+
+  // Fold the updated run back together, then into its neighbours
+  merge_with_next_locked(last);
+  Vma* cur = Tree::prev(*last);
+  while (cur && cur->end > start) {
+    Vma* prev = Tree::prev(*cur);
+    merge_with_next_locked(cur);
+    cur = prev;
+  }
+  if (cur) merge_with_next_locked(cur);
+  return {};
+}
+
+fk::core::Result<void, fk::core::Error> VmaTree::protect_range(uintptr_t start, uintptr_t end,
+                                                               PageFlags flags) {
+  if (start >= end) return fk::core::Error::InvalidParameter;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return update_range_locked(start, end, [flags](Vma& vma) { vma.flags = flags; });
+}
+
+fk::core::Result<void, fk::core::Error> VmaTree::set_no_huge_pages(uintptr_t start, uintptr_t end,
+                                                                   bool no_huge) {
+  if (start >= end) return fk::core::Error::InvalidParameter;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return update_range_locked(start, end, [no_huge](Vma& vma) { vma.no_huge_pages = no_huge; });
+}
+
+bool VmaTree::allows_huge_pages(uintptr_t start, uintptr_t end) const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  for (Vma* vma = first_ending_after(start); vma && vma->start < end; vma = Tree::next(*vma)) {
+    if (vma->no_huge_pages) return false;
+  }
+  return true;
+}
+
+fk::core::Result<void, fk::core::Error> VmaTree::resize(uintptr_t start, uintptr_t new_end) {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  Vma* vma = find_locked(start);
+  if (!vma || vma->start != start) return fk::core::Error::NotFound;
+  if (new_end <= start) return fk::core::Error::InvalidParameter;
+
+  Vma* next = Tree::next(*vma);
+  if (next && new_end > next->start) return fk::core::Error::OutOfMemory;
+  vma->end = new_end;
+  m_tree.propagate(vma);
+  return {};
+}
+
+Vma* VmaTree::find_locked(uintptr_t addr) const {
+  Vma* node = m_tree.root();
+  while (node) {
+    if (addr < node->start)
+      node = Tree::left(*node);
+    else if (addr >= node->end)
+      node = Tree::right(*node);
+    else
+      return node;
+  }
+  return nullptr;
+}
+
+// Mappings never overlap, so ends are ordered like starts
+Vma* VmaTree::first_ending_after(uintptr_t addr) const {
+  Vma* node = m_tree.root();
+  Vma* best = nullptr;
+  while (node) {
+    if (node->end > addr) {
+      best = node;
+      node = Tree::left(*node);
+    } else {
+      node = Tree::right(*node);
+    }
+  }
+  return best;
+}
+
+fk::core::Result<void, fk::core::Error> VmaTree::link_locked(Vma* vma) {
+  Vma* next = first_ending_after(vma->start);
+  if (next && next->start < vma->end) {
+    delete vma;
+    return fk::core::Error::AlreadyExists;
+  }
+  m_tree.insert(*vma);
+
+  merge_with_next_locked(vma);
+  if (Vma* prev = Tree::prev(*vma)) merge_with_next_locked(prev);
+  return {};
+}
+
+Vma* VmaTree::split_locked(Vma* vma, uintptr_t at) {
+  Vma* tail = new Vma();
+  if (!tail) return nullptr;
+  tail->start = at;
+  tail->end = vma->end;
+  tail->flags = vma->flags;
+  tail->kind = vma->kind;
+  tail->no_huge_pages = vma->no_huge_pages;
+  tail->name = vma->name;
+  if (vma->is_file_backed()) {
+    tail->file = vma->file;
+    tail->file_offset = vma->file_offset + (at - vma->start);
+    tail->file_end = vma->file_end;
+  }
+
+  vma->end = at;
+  m_tree.propagate(vma);
+  m_tree.insert(*tail);
+  return tail;
+}
+
+void VmaTree::merge_with_next_locked(Vma* vma) {
+  Vma* next = Tree::next(*vma);
+  if (!next || !can_merge(*vma, *next)) return;
+  uintptr_t end = next->end;
+  m_tree.remove(*next);
+  delete next;
+  vma->end = end;
+  m_tree.propagate(vma);
+}
+
+// Post-order, so no node is read after it is freed; depth is O(log n)
+static void destroy_subtree(Vma* vma) {
+  if (!vma) return;
+  destroy_subtree(VmaTree::Tree::left(*vma));
+  destroy_subtree(VmaTree::Tree::right(*vma));
+  delete vma;
+}
+
+void VmaTree::destroy_all_locked() {
+  destroy_subtree(m_tree.root());
+  m_tree.clear();
+}
+
+// before/after bound the hole around node's subtree: the end of its in-order
+// predecessor and the start of its successor. Subtrees whose widest hole,
+// including the two edges, is too small are skipped.
+uintptr_t VmaTree::search_gap(const Vma* node, uintptr_t before, uintptr_t after, size_t length,
+                              size_t alignment, uintptr_t low, uintptr_t high) const {
+  if (after <= low || before >= high) return 0;
+
+  if (!node) {
+    uintptr_t start = align_up(before > low ? before : low, alignment);
+    uintptr_t limit = after < high ? after : high;
+    if (start < limit && limit - start >= length) return start;
+    return 0;
+  }
+
+  if (node->subtree_end <= low)
+    return search_gap(nullptr, node->subtree_end, after, length, alignment, low, high);
+  if (node->subtree_start >= high)
+    return search_gap(nullptr, before, node->subtree_start, length, alignment, low, high);
+
+  uintptr_t widest = node->subtree_gap;
+  if (node->subtree_start - before > widest) widest = node->subtree_start - before;
+  if (after - node->subtree_end > widest) widest = after - node->subtree_end;
+  if (widest < length) return 0;
+
+  uintptr_t addr = search_gap(Tree::left(*node), before, node->start, length, alignment, low, high);
+  if (addr) return addr;
+  return search_gap(Tree::right(*node), node->end, after, length, alignment, low, high);
+}
+
+} // namespace fkernel
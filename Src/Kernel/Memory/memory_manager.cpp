@@ -218,6 +218,10 @@ void MemoryManager::map_page(uintptr_t virt, uintptr_t phys, PageFlags flags){
   VirtualMemoryManager::the().map_page(virt, phys, flags);
 }
 
+void MemoryManager::map_range(uintptr_t virt, uintptr_t phys, size_t size, PageFlags flags) {
+  VirtualMemoryManager::the().map_range(virt, phys, size, flags);
+}
+
 void MemoryManager::unmap_page(uintptr_t virt) {
     VirtualMemoryManager::the().unmap_page(virt);
 }
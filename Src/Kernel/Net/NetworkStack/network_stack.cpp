@@ -241,39 +241,80 @@ void NetworkStack::handle_tcp(const uint8_t* data, size_t len,
     if (len < header_len) return;
     const uint8_t* payload = data + header_len;
     size_t payload_len = len - header_len;
+    IPv4Address src = IPv4Address::from_network(src_ip);
+    IPv4Address dst = IPv4Address::from_network(dst_ip);
 
-    fk::synchronization::ScopedLock lock(m_tcp_lock);
-    for (size_t i = 0; i < MAX_TCP_BINDINGS; ++i) {
-        if (m_tcp_sockets[i].port == dst_port && m_tcp_sockets[i].socket) {
-            m_tcp_sockets[i].socket->on_segment(hdr, payload, payload_len);
-            break;
-        }
+    // Exact 4-tuple first, then a listener bound to the destination address,
+    // then a wildcard listener on the port.
+    fk::RefPtr<TcpSocket> socket;
+    {
+        fk::synchronization::ScopedLock lock(m_tcp_lock);
+        TcpFourTuple tuple{dst.value, src.value, dst_port, ntohs(hdr->src_port)};
+        auto found = m_tcp_connections.get(tuple);
+        if (!found.has_value()) found = m_tcp_listeners.get({dst.value, dst_port});
+        if (!found.has_value()) found = m_tcp_listeners.get({IPv4Address::any().value, dst_port});
+        // A socket being torn down unregisters as soon as it can take
+        // m_tcp_lock; try_ref() refuses it until then.
+        if (found.has_value() && found.value()->try_ref())
+            socket = fk::RefPtr<TcpSocket>(fk::RefPtr<TcpSocket>::Adopt, found.value());
     }
+    // Dispatch without m_tcp_lock: a listener registers its child connections.
+    if (socket) socket->on_segment(hdr, src, dst, payload, payload_len);
 }
 
-bool NetworkStack::register_tcp_socket(uint16_t port, TcpSocket* socket) {
+bool NetworkStack::register_tcp_listener(TcpListenKey key, TcpSocket* socket) {
     fk::synchronization::ScopedLock lock(m_tcp_lock);
-    for (size_t i = 0; i < MAX_TCP_BINDINGS; ++i) {
-        if (m_tcp_sockets[i].socket && m_tcp_sockets[i].port == port) return false;
-    }
-    for (size_t i = 0; i < MAX_TCP_BINDINGS; ++i) {
-        if (!m_tcp_sockets[i].socket) {
-            m_tcp_sockets[i] = {port, socket};
-            fk::algorithms::kdebug("NET", "TCP: bound port %u", port);
-            return true;
-        }
-    }
-    return false;
+    if (m_tcp_listeners.contains(key)) return false;
+    if (m_tcp_listeners.insert(key, socket).is_error()) return false;
+    fk::algorithms::kdebug("NET", "TCP: bound port %u", key.port);
+    return true;
 }
 
-void NetworkStack::unregister_tcp_socket(uint16_t port) {
+void NetworkStack::unregister_tcp_listener(TcpListenKey key) {
     fk::synchronization::ScopedLock lock(m_tcp_lock);
-    for (size_t i = 0; i < MAX_TCP_BINDINGS; ++i) {
-        if (m_tcp_sockets[i].port == port) {
-            m_tcp_sockets[i] = {};
-            break;
+    m_tcp_listeners.remove(key);
+}
+
+bool NetworkStack::register_tcp_connection(TcpFourTuple tuple, TcpSocket* socket) {
+    fk::synchronization::ScopedLock lock(m_tcp_lock);
+    if (m_tcp_connections.contains(tuple)) return false;
+    return !m_tcp_connections.insert(tuple, socket).is_error();
+}
+
+void NetworkStack::unregister_tcp_connection(TcpFourTuple tuple) {
+    fk::synchronization::ScopedLock lock(m_tcp_lock);
+    m_tcp_connections.remove(tuple);
+}
+
+// With a tuple, a port it already uses as a connection is skipped too, so a
+// wrapped cursor never hands out a port still talking to the same peer.
+uint16_t NetworkStack::next_tcp_port_locked(TcpFourTuple* tuple) {
+    static constexpr uint16_t EPHEMERAL_FIRST = 49152;
+    static constexpr uint32_t EPHEMERAL_COUNT = 65536 - EPHEMERAL_FIRST;
+    for (uint32_t i = 0; i < EPHEMERAL_COUNT; ++i) {
+        uint16_t port = m_tcp_next_ephemeral;
+        m_tcp_next_ephemeral = port == 65535 ? EPHEMERAL_FIRST : (uint16_t)(port + 1);
+        if (m_tcp_listeners.contains({IPv4Address::any().value, port})) continue;
+        if (m_tcp_listeners.contains({m_ip.value, port})) continue;
+        if (tuple) {
+            tuple->local_port = port;
+            if (m_tcp_connections.contains(*tuple)) continue;
         }
+        return port;
     }
+    return 0;
+}
+
+uint16_t NetworkStack::allocate_tcp_port() {
+    fk::synchronization::ScopedLock lock(m_tcp_lock);
+    return next_tcp_port_locked(nullptr);
+}
+
+uint16_t NetworkStack::register_tcp_connection_ephemeral(TcpFourTuple tuple, TcpSocket* socket) {
+    fk::synchronization::ScopedLock lock(m_tcp_lock);
+    uint16_t port = next_tcp_port_locked(&tuple);
+    if (port == 0 || m_tcp_connections.insert(tuple, socket).is_error()) return 0;
+    return port;
 }
 
 } // namespace net
@@ -0,0 +1,78 @@
+#include <Kernel/Net/Tcp/tcp_congestion.h>
+#include <Kernel/Net/Tcp/tcp_header.h>
+
+namespace fkernel {
+namespace net {
+
+// RFC 6928 initial window: min(10 * MSS, max(2 * MSS, 14600))
+TcpCongestionControl::TcpCongestionControl(uint32_t mss)
+    : m_mss(mss) {
+    uint32_t ten = 10 * mss;
+    uint32_t floor = 2 * mss > 14600 ? 2 * mss : 14600;
+    m_cwnd = ten < floor ? ten : floor;
+}
+
+uint32_t TcpCongestionControl::halved_flight(uint32_t flight_size) const {
+    // RFC 5681 (4): ssthresh = max(FlightSize / 2, 2 * SMSS)
+    uint32_t half = flight_size / 2;
+    return half > 2 * m_mss ? half : 2 * m_mss;
+}
+
+TcpCongestionControl::Action TcpCongestionControl::on_ack(
+    uint32_t ack, uint32_t bytes_acked, uint32_t flight_size) {
+    m_dup_acks = 0;
+    if (m_after_timeout && seq_geq(ack, m_recover)) m_after_timeout = false;
+    if (m_in_recovery) {
+        if (seq_geq(ack, m_recover)) {
+            // Full acknowledgment: deflate the window and leave recovery
+            uint32_t flight_after = flight_size - bytes_acked;
+            uint32_t floor = (flight_after > m_mss ? flight_after : m_mss) + m_mss;
+            m_cwnd = m_ssthresh < floor ? m_ssthresh : floor;
+            m_in_recovery = false;
+            return Action::None;
+        }
+        // Partial acknowledgment: the next hole is lost too
+        m_cwnd = m_cwnd > bytes_acked ? m_cwnd - bytes_acked : 0;
+        if (bytes_acked >= m_mss) m_cwnd += m_mss;
+        if (m_cwnd < m_mss) m_cwnd = m_mss;
+        return Action::Retransmit;
+    }
+    if (m_cwnd < m_ssthresh) {
+        // Slow start (RFC 5681 (2)), with appropriate byte counting capped at one SMSS
+        m_cwnd += bytes_acked < m_mss ? bytes_acked : m_mss;
+    } else {
+        // Congestion avoidance (RFC 5681 (3))
+        uint32_t inc = m_mss * m_mss / m_cwnd;
+        m_cwnd += inc ? inc : 1;
+    }
+    return Action::None;
+}
+
+TcpCongestionControl::Action TcpCongestionControl::on_dup_ack(
+    uint32_t flight_size, uint32_t send_unacked, uint32_t send_next) {
+    if (m_in_recovery) {
+        // Every further duplicate means a segment has left the network
+        m_cwnd += m_mss;
+        return Action::None;
+    }
+    if (++m_dup_acks != TCP_DUP_ACK_THRESHOLD) return Action::None;
+    if (m_after_timeout && seq_lt(send_unacked, m_recover)) return Action::None;
+    m_ssthresh = halved_flight(flight_size);
+    m_cwnd = m_ssthresh + TCP_DUP_ACK_THRESHOLD * m_mss;
+    m_recover = send_next;
+    m_in_recovery = true;
+    return Action::Retransmit;
+}
+
+void TcpCongestionControl::on_timeout(uint32_t flight_size, uint32_t send_next) {
+    m_ssthresh = halved_flight(flight_size);
+    m_cwnd = m_mss;
+    m_dup_acks = 0;
+    m_in_recovery = false;
+    // RFC 6582 section 4: no fast retransmit for losses from before the timeout
+    m_recover = send_next;
+    m_after_timeout = true;
+}
+
+} // namespace net
+} // namespace fkernel
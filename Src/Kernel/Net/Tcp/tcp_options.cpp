@@ -0,0 +1,74 @@
+#include <Kernel/Net/Tcp/tcp_options.h>
+
+namespace fkernel {
+namespace net {
+
+static uint16_t read_be16(const uint8_t* p) { return (uint16_t)(p[0] << 8 | p[1]); }
+static uint32_t read_be32(const uint8_t* p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+static void write_be16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+static void write_be32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24); p[1] = (uint8_t)(v >> 16); p[2] = (uint8_t)(v >> 8); p[3] = (uint8_t)v;
+}
+
+TcpOptions TcpOptions::parse(const TcpHeader* hdr) {
+    TcpOptions opts;
+    size_t hdr_len = hdr->header_length();
+    if (hdr_len <= TCP_HEADER_SIZE) return opts;
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(hdr) + TCP_HEADER_SIZE;
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(hdr) + hdr_len;
+    while (p < end) {
+        uint8_t kind = p[0];
+        if (kind == TCP_OPT_END) break;
+        if (kind == TCP_OPT_NOP) { ++p; continue; }
+        if (end - p < 2) break;
+        uint8_t len = p[1];
+        if (len < 2 || len > end - p) break;
+        if (kind == TCP_OPT_MSS && len == 4) {
+            opts.has_mss = true;
+            opts.mss = read_be16(p + 2);
+        } else if (kind == TCP_OPT_WSCALE && len == 3) {
+            opts.has_wscale = true;
+            // RFC 7323 2.3: larger shifts are logged and treated as 14
+            opts.wscale = p[2] > TCP_MAX_WSCALE ? TCP_MAX_WSCALE : p[2];
+        } else if (kind == TCP_OPT_TIMESTAMP && len == 10) {
+            opts.has_timestamp = true;
+            opts.ts_val = read_be32(p + 2);
+            opts.ts_ecr = read_be32(p + 6);
+        }
+        p += len;
+    }
+    return opts;
+}
+
+size_t TcpOptions::write(uint8_t* out) const {
+    size_t n = 0;
+    if (has_mss) {
+        out[n++] = TCP_OPT_MSS;
+        out[n++] = 4;
+        write_be16(out + n, mss);
+        n += 2;
+    }
+    if (has_wscale) {
+        out[n++] = TCP_OPT_NOP;
+        out[n++] = TCP_OPT_WSCALE;
+        out[n++] = 3;
+        out[n++] = wscale;
+    }
+    if (has_timestamp) {
+        // Appendix A layout: NOP, NOP, then the 10-byte option, 4-byte aligned
+        out[n++] = TCP_OPT_NOP;
+        out[n++] = TCP_OPT_NOP;
+        out[n++] = TCP_OPT_TIMESTAMP;
+        out[n++] = 10;
+        write_be32(out + n, ts_val);
+        write_be32(out + n + 4, ts_ecr);
+        n += 8;
+    }
+    while (n % 4) out[n++] = TCP_OPT_END;
+    return n;
+}
+
+} // namespace net
+} // namespace fkernel
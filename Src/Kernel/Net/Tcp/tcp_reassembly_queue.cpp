@@ -0,0 +1,65 @@
+#include <Kernel/Net/Tcp/tcp_reassembly_queue.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+namespace net {
+
+TcpReassemblyQueue::~TcpReassemblyQueue() {
+    clear();
+}
+
+bool TcpReassemblyQueue::insert(uint32_t seq, const uint8_t* data, uint32_t len) {
+    if (len == 0) return false;
+    size_t i = 0;
+    while (i < m_fragments.size() && seq_lt(m_fragments[i].seq, seq)) ++i;
+
+    // Trim the front against the preceding fragment
+    if (i > 0) {
+        uint32_t prev_end = m_fragments[i - 1].end();
+        if (seq_geq(prev_end, seq + len)) return false;
+        if (seq_gt(prev_end, seq)) {
+            uint32_t overlap = prev_end - seq;
+            seq += overlap;
+            data += overlap;
+            len -= overlap;
+        }
+    }
+    // Drop fragments the new data covers completely
+    while (i < m_fragments.size() && seq_leq(m_fragments[i].end(), seq + len)) {
+        m_bytes -= m_fragments[i].len;
+        kfree(m_fragments[i].data);
+        m_fragments.remove_at(i);
+    }
+    // Trim the tail against the following fragment
+    if (i < m_fragments.size() && seq_lt(m_fragments[i].seq, seq + len)) {
+        len = m_fragments[i].seq - seq;
+        if (len == 0) return false;
+    }
+
+    Fragment frag;
+    frag.seq = seq;
+    frag.len = len;
+    frag.data = static_cast<uint8_t*>(kmalloc(len));
+    if (!frag.data) return false;
+    fk::memory::copy(frag.data, data, len);
+    m_fragments.insert_at(i, frag);
+    m_bytes += len;
+    return true;
+}
+
+void TcpReassemblyQueue::release_prefix(Fragment& frag, uint32_t count) {
+    fk::memory::move(frag.data, frag.data + count, frag.len - count);
+    frag.len -= count;
+    frag.seq += count;
+    m_bytes -= count;
+}
+
+void TcpReassemblyQueue::clear() {
+    for (auto& frag : m_fragments)
+        kfree(frag.data);
+    m_fragments.clear();
+    m_bytes = 0;
+}
+
+} // namespace net
+} // namespace fkernel
@@ -0,0 +1,66 @@
+#include <Kernel/Net/Tcp/tcp_retransmit_queue.h>
+#include <LibFK/Memory/heap_malloc.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+namespace net {
+
+TcpRetransmitQueue::~TcpRetransmitQueue() {
+    clear();
+}
+
+bool TcpRetransmitQueue::push(uint32_t seq, uint8_t flags, const uint8_t* data,
+                              uint32_t len, uint64_t now) {
+    TcpSegment seg;
+    seg.seq = seq;
+    seg.len = len;
+    seg.flags = flags;
+    seg.sent_ticks = now;
+    if (len > 0) {
+        seg.data = static_cast<uint8_t*>(kmalloc(len));
+        if (!seg.data) return false;
+        fk::memory::copy(seg.data, data, len);
+    }
+    m_segments.push_back(seg);
+    return true;
+}
+
+TcpRetransmitQueue::AckResult TcpRetransmitQueue::acknowledge(uint32_t ack) {
+    AckResult result;
+    while (!m_segments.is_empty()) {
+        TcpSegment& seg = m_segments[0];
+        if (seq_leq(seg.end(), ack)) {
+            result.has_rtt_sample = !seg.retransmitted;
+            result.sample_sent_ticks = seg.sent_ticks;
+            ++result.segments;
+            if (seg.data) kfree(seg.data);
+            m_segments.remove_at(0);
+            continue;
+        }
+        if (seq_leq(ack, seg.seq)) break;
+
+        // Partially acknowledged: drop the covered SYN and payload prefix
+        uint32_t covered = ack - seg.seq;
+        if (seg.flags & TCP_FLAG_SYN) {
+            seg.flags &= (uint8_t)~TCP_FLAG_SYN;
+            ++seg.seq;
+            --covered;
+        }
+        if (covered > 0) {
+            fk::memory::move(seg.data, seg.data + covered, seg.len - covered);
+            seg.len -= covered;
+            seg.seq += covered;
+        }
+        break;
+    }
+    return result;
+}
+
+void TcpRetransmitQueue::clear() {
+    for (auto& seg : m_segments)
+        if (seg.data) kfree(seg.data);
+    m_segments.clear();
+}
+
+} // namespace net
+} // namespace fkernel
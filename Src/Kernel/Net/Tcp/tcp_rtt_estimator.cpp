@@ -0,0 +1,35 @@
+#include <Kernel/Net/Tcp/tcp_rtt_estimator.h>
+
+namespace fkernel {
+namespace net {
+
+void TcpRttEstimator::sample(uint32_t rtt_ms, uint32_t granularity_ms) {
+    if (!m_has_sample) {
+        // (2.2) first measurement
+        m_srtt_ms = rtt_ms;
+        m_rttvar_ms = rtt_ms / 2;
+        m_has_sample = true;
+    } else {
+        // (2.3) RTTVAR before SRTT, with beta = 1/4 and alpha = 1/8
+        uint32_t delta = m_srtt_ms > rtt_ms ? m_srtt_ms - rtt_ms : rtt_ms - m_srtt_ms;
+        m_rttvar_ms = (3 * m_rttvar_ms + delta) / 4;
+        m_srtt_ms = (7 * m_srtt_ms + rtt_ms) / 8;
+    }
+    uint32_t var = 4 * m_rttvar_ms;
+    m_rto_ms = m_srtt_ms + (var > granularity_ms ? var : granularity_ms);
+    m_backoff = 0;
+}
+
+void TcpRttEstimator::back_off() {
+    if (rto_ms() < TCP_MAX_RTO_MS) ++m_backoff;
+}
+
+uint32_t TcpRttEstimator::rto_ms() const {
+    // (2.4) lower bound; 200 ms rather than 1 s, as most stacks do
+    uint64_t rto = m_rto_ms < TCP_MIN_RTO_MS ? TCP_MIN_RTO_MS : m_rto_ms;
+    rto <<= m_backoff;
+    return rto > TCP_MAX_RTO_MS ? TCP_MAX_RTO_MS : (uint32_t)rto;
+}
+
+} // namespace net
+} // namespace fkernel
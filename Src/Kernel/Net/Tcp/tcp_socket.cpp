@@ -2,8 +2,9 @@
 #include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
 #include <Kernel/Net/Ip/ipv4_header.h>
 #include <Kernel/Net/NetworkStack/network_stack.h>
+#include <Kernel/Net/Tcp/tcp_options.h>
+#include <Kernel/Net/Tcp/tcp_timer_registry.h>
 #include <Kernel/Net/byte_order.h>
-#include <LibFK/Algorithms/container_algorithms.h>
 #include <LibFK/Algorithms/internet_checksum.h>
 #include <LibFK/Synchronization/spinlock.h>
 #include <LibFK/Utilities/memory.h>
@@ -32,20 +33,52 @@ static uint16_t tcp_checksum(IPv4Address dst, const uint8_t* seg, size_t seg_len
     return cs.finalize();
 }
 
+static uint32_t ticks_to_ms(uint64_t ticks) {
+    uint32_t freq = TickManager::the().get_frequency();
+    if (freq == 0) return (uint32_t)ticks;
+    return (uint32_t)(ticks * 1000 / freq);
+}
+
+static uint64_t ms_to_ticks(uint32_t ms) {
+    uint32_t freq = TickManager::the().get_frequency();
+    if (freq == 0) return ms;
+    uint64_t ticks = (uint64_t)ms * freq / 1000;
+    return ticks ? ticks : 1;
+}
+
 TcpSocket::TcpSocket(TcpEndpoint local, TcpEndpoint remote)
     : m_connection(local, remote) {}
 
+TcpSocket::~TcpSocket() {
+    // First, so tcp_timer_registry::tick_all() never sees a half-destroyed socket
+    if (m_timer_registered)
+        tcp_timer_registry::unregister_socket(this);
+    if (m_connection_registered)
+        NetworkStack::the().unregister_tcp_connection(m_connection.tuple());
+    if (m_listener_registered)
+        NetworkStack::the().unregister_tcp_listener(m_connection.listen_key());
+    // A child's on_segment() reads m_listener under the child's lock
+    for (auto& child : m_accept_queue) {
+        fk::synchronization::ScopedLock lock(child->m_lock);
+        child->m_listener = nullptr;
+    }
+}
+
 fk::core::Result<void, fk::core::Error> TcpSocket::bind(const char* path) {
     if (!path) return fk::core::Error::InvalidParameter;
+    if (m_listener_registered || m_connection_registered)
+        return fk::core::Error::InvalidParameter;
     // path is struct sockaddr_in* cast to const char*
     // Layout: uint16_t sin_family, uint16_t sin_port (network order), uint32_t sin_addr
     const uint16_t* sin_port_ptr = reinterpret_cast<const uint16_t*>(path + 2);
     uint16_t port = ntohs(*sin_port_ptr);
+    IPv4Address ip = IPv4Address::from_network(*reinterpret_cast<const uint32_t*>(path + 4));
     if (port == 0) return fk::core::Error::InvalidParameter;
-    if (!NetworkStack::the().register_tcp_socket(port, this))
+    if (!NetworkStack::the().register_tcp_listener({ip.value, port}, this))
         return fk::core::Error::AlreadyExists;
-    m_connection.set_local_port(port);
-    fk::algorithms::kdebug("TCP", "bind(%u)", port);
+    m_listener_registered = true;
+    m_connection.set_local({ip, port});
+    fk::algorithms::kdebug("TCP", "bind(%s:%u)", ip.to_string().c_str(), port);
     return {};
 }
 
@@ -59,24 +92,38 @@ fk::core::Result<void, fk::core::Error> TcpSocket::connect(const char* path) {
 
     {
         fk::synchronization::ScopedLock lock(m_lock);
-        static uint16_t s_ephemeral{49152};
-        uint16_t local_port = __sync_fetch_and_add(&s_ephemeral, 1);
-        m_connection.set_local_port(local_port);
+        if (m_connection_registered) return fk::core::Error::InvalidParameter;
+        auto& stack = NetworkStack::the();
+        // A bound socket keeps its port but moves from the listener table to
+        // the connection table; an unbound one picks an ephemeral port that
+        // is not already connected to this peer.
+        IPv4Address local_ip = m_connection.local().ip;
+        if (local_ip == IPv4Address::any()) local_ip = stack.ip();
         m_connection.set_remote({IPv4Address(ntohl(remote_ip_be)), remote_port});
-        NetworkStack::the().register_tcp_socket(local_port, this);
+        if (m_listener_registered) {
+            stack.unregister_tcp_listener(m_connection.listen_key());
+            m_listener_registered = false;
+            m_connection.set_local({local_ip, m_connection.local().port});
+            if (!stack.register_tcp_connection(m_connection.tuple(), this))
+                return fk::core::Error::AlreadyExists;
+        } else {
+            m_connection.set_local({local_ip, 0});
+            uint16_t local_port = stack.register_tcp_connection_ephemeral(m_connection.tuple(), this);
+            if (local_port == 0) return fk::core::Error::DeviceBusy;
+            m_connection.set_local({local_ip, local_port});
+        }
+        m_connection_registered = true;
+        register_connection_timers();
 
         m_connection.send_next = (uint32_t)TickManager::the().get_ticks();
         m_connection.send_unacked = m_connection.send_next;
         m_connection.state = TcpState::SynSent;
-
-        uint8_t syn[TCP_HEADER_SIZE];
-        auto* syn_hdr = reinterpret_cast<TcpHeader*>(syn);
-        syn_hdr->fill(local_port, remote_port, m_connection.send_next, 0,
-                      TCP_FLAG_SYN, 65535);
-        syn_hdr->checksum = tcp_checksum(IPv4Address(ntohl(remote_ip_be)), syn, TCP_HEADER_SIZE);
-        ++m_connection.send_next;
-        NetworkStack::the().send_ipv4(IPv4Address(ntohl(remote_ip_be)),
-                                      IP_PROTO_TCP, syn, TCP_HEADER_SIZE);
+        // Offer window scaling sized to the receive buffer; dropped again if
+        // the SYN-ACK does not carry the option.
+        m_connection.rcv_wscale = TcpConnection::wscale_for(m_connection.recv_buf.capacity());
+        // Queued like data, so a lost SYN is retransmitted on RTO
+        auto res = transmit(TCP_FLAG_SYN, nullptr, 0);
+        if (res.is_error()) return res.error();
     }
 
     while (m_connection.state == TcpState::SynSent)
@@ -88,6 +135,17 @@ fk::core::Result<void, fk::core::Error> TcpSocket::connect(const char* path) {
 }
 
 fk::core::Result<void, fk::core::Error> TcpSocket::listen() {
+    fk::synchronization::ScopedLock lock(m_lock);
+    if (m_connection_registered) return fk::core::Error::InvalidParameter;
+    if (!m_listener_registered) {
+        // listen() without bind(): take an ephemeral port on the wildcard address
+        uint16_t port = NetworkStack::the().allocate_tcp_port();
+        if (port == 0) return fk::core::Error::DeviceBusy;
+        m_connection.set_local({IPv4Address::any(), port});
+        if (!NetworkStack::the().register_tcp_listener(m_connection.listen_key(), this))
+            return fk::core::Error::AlreadyExists;
+        m_listener_registered = true;
+    }
     m_connection.state = TcpState::Listen;
     fk::algorithms::kdebug("TCP", "listen()");
     return {};
@@ -111,76 +169,204 @@ fk::core::Result<fk::RefPtr<Socket>, fk::core::Error> TcpSocket::accept() {
 fk::core::Result<size_t, fk::core::Error> TcpSocket::read(
     [[maybe_unused]] uint64_t offset, size_t size, uint8_t* buf) {
     fk::synchronization::ScopedLock lock(m_lock);
-    auto& rb = m_connection.recv_buf;
-    if (rb.is_empty()) return (size_t)0;
-    size_t to_copy = size < rb.size() ? size : rb.size();
-    fk::memory::copy(buf, rb.begin(), to_copy);
-    fk::algorithms::dequeue_front(rb, to_copy);
-    return to_copy;
+    auto& c = m_connection;
+    size_t copied = c.recv_buf.read(buf, size);
+    if (copied > 0 && c.state == TcpState::Established) {
+        // Receiver-side SWS avoidance (RFC 1122 4.2.3.3): announce the opened
+        // window once it grew by a full segment or half the buffer.
+        uint32_t threshold = (uint32_t)(c.recv_buf.capacity() / 2);
+        if (threshold > c.send_mss()) threshold = c.send_mss();
+        // Compare before subtracting: the window can be below the last
+        // advertisement (e.g. after SO_RCVBUF shrank the buffer).
+        uint32_t window = c.recv_window();
+        if (window > c.last_advertised && window - c.last_advertised >= threshold) send_ack();
+    }
+    return copied;
 }
 
 fk::core::Result<size_t, fk::core::Error> TcpSocket::write(
     [[maybe_unused]] uint64_t offset, size_t size, const uint8_t* buf) {
-    fk::synchronization::ScopedLock lock(m_lock);
-    if (m_connection.state != TcpState::Established)
-        return fk::core::Error::NotImplemented;
-    static constexpr size_t MSS = 1460;
     size_t sent = 0;
-    while (sent < size) {
-        uint16_t wnd = m_connection.peer_window;
-        if (wnd == 0) break;
-        size_t chunk = size - sent;
-        if (chunk > MSS) chunk = MSS;
-        if (chunk > wnd) chunk = wnd;
-        uint8_t packet[TCP_HEADER_SIZE + MSS];
-        auto* hdr = reinterpret_cast<TcpHeader*>(packet);
-        hdr->fill(m_connection.local().port, m_connection.remote().port,
-                  m_connection.send_next, m_connection.recv_next,
-                  TCP_FLAG_ACK | TCP_FLAG_PSH, m_connection.recv_window());
-        fk::memory::copy(packet + TCP_HEADER_SIZE, buf + sent, chunk);
-        hdr->checksum = tcp_checksum(m_connection.remote().ip, packet, TCP_HEADER_SIZE + chunk);
-        auto res = NetworkStack::the().send_ipv4(
-            m_connection.remote().ip, IP_PROTO_TCP, packet, TCP_HEADER_SIZE + chunk);
-        if (res.is_error()) return res.error();
-        m_connection.send_next += (uint32_t)chunk;
-        if (m_connection.peer_window >= (uint16_t)chunk)
-            m_connection.peer_window -= (uint16_t)chunk;
-        else
-            m_connection.peer_window = 0;
-        sent += chunk;
+    while (true) {
+        {
+            fk::synchronization::ScopedLock lock(m_lock);
+            auto& c = m_connection;
+            if (c.state != TcpState::Established)
+                return sent > 0 ? fk::core::Result<size_t, fk::core::Error>(sent)
+                                : fk::core::Error::NotImplemented;
+            while (sent < size) {
+                // Usable window: min(rwnd, cwnd) minus what is already in flight
+                // and the SO_SNDBUF bound on unacknowledged bytes
+                uint32_t wnd = c.peer_window < c.congestion.cwnd() ? c.peer_window : c.congestion.cwnd();
+                if (wnd > c.send_buffer_size) wnd = (uint32_t)c.send_buffer_size;
+                uint32_t flight = c.flight_size();
+                if (flight >= wnd) break;
+                size_t chunk = size - sent;
+                if (chunk > c.send_mss()) chunk = c.send_mss();
+                if (chunk > wnd - flight) chunk = wnd - flight;
+                auto res = transmit(TCP_FLAG_ACK | TCP_FLAG_PSH, buf + sent, chunk);
+                if (res.is_error()) {
+                    if (sent > 0) return sent;
+                    return res.error();
+                }
+                sent += chunk;
+            }
+            if (sent == size) return sent;
+        }
+        // Blocks until an ACK frees window space (or the connection dies)
+        m_connection.send_space.wait();
     }
-    return sent;
 }
 
-void TcpSocket::on_segment(const TcpHeader* hdr, const uint8_t* data, size_t data_len) {
+void TcpSocket::on_segment(const TcpHeader* hdr, IPv4Address src_ip, IPv4Address dst_ip,
+                           const uint8_t* data, size_t data_len) {
     fk::synchronization::ScopedLock lock(m_lock);
     uint8_t flags = hdr->flags;
     uint32_t seq = ntohl(hdr->seq_num);
+    TcpOptions opts = TcpOptions::parse(hdr);
+
+    auto& c = m_connection;
+    if (c.ts_ok && opts.has_timestamp && !(flags & (TCP_FLAG_RST | TCP_FLAG_SYN))) {
+        // PAWS (RFC 7323 5.3): a timestamp older than TS.Recent is a stale duplicate
+        if (seq_lt(opts.ts_val, c.ts_recent) && c.state == TcpState::Established) {
+            send_ack();
+            return;
+        }
+        // RFC 7323 4.3: remember TSval of segments at or left of the ACK point
+        if (seq_leq(seq, c.recv_next)) c.ts_recent = opts.ts_val;
+    }
 
-    process_handshake(hdr, flags, seq);
-    process_ack(hdr, flags);
+    process_handshake(hdr, flags, seq, src_ip, dst_ip, opts);
+    process_ack(hdr, flags, data_len, opts);
     process_data(hdr, flags, data, data_len, seq);
-    process_fin(hdr, flags);
+    process_fin(hdr, flags, data_len, seq);
+}
+
+bool TcpSocket::timer_due(uint64_t now_ticks) const {
+    const auto& c = m_connection;
+    auto passed = [now_ticks](uint64_t deadline) { return deadline != 0 && now_ticks >= deadline; };
+    return passed(c.rto_deadline) || passed(c.persist_deadline) ||
+           (c.state == TcpState::TimeWait && now_ticks >= c.time_wait_deadline);
+}
+
+void TcpSocket::on_timer(uint64_t now_ticks) {
+    fk::synchronization::ScopedLock lock(m_lock);
+    auto& c = m_connection;
+    if (c.rto_deadline != 0 && now_ticks >= c.rto_deadline) {
+        if (c.retransmit_queue.is_empty()) {
+            c.rto_deadline = 0;
+        } else if (++c.retransmits > TCP_MAX_RETRANSMITS) {
+            fk::algorithms::kwarn("TCP", "%s:%u: retransmission limit reached, dropping connection",
+                c.remote().ip.to_string().c_str(), c.remote().port);
+            c.retransmit_queue.clear();
+            c.rto_deadline = 0;
+            c.state = TcpState::Closed;
+            m_so_error = 110; // ETIMEDOUT
+            c.state_changed.signal(1);
+            c.send_space.signal(1);
+        } else {
+            // RFC 6298 (5.4)-(5.6) and RFC 5681 (4)
+            c.congestion.on_timeout(c.flight_size(), c.send_next);
+            c.rtt.back_off();
+            retransmit_oldest(now_ticks);
+            arm_retransmit_timer(now_ticks);
+        }
+    }
+    if (c.state == TcpState::TimeWait && now_ticks >= c.time_wait_deadline) {
+        c.state = TcpState::Closed;
+        c.state_changed.signal(1);
+    }
+    if (c.persist_deadline != 0 && now_ticks >= c.persist_deadline) {
+        // Zero-window probe: an old sequence number forces the peer to ACK
+        // with its current window, covering a lost window update.
+        send_segment(c.send_next - 1, TCP_FLAG_ACK, nullptr, 0);
+        c.persist_deadline = now_ticks + ms_to_ticks(c.rtt.rto_ms());
+    }
 }
 
-void TcpSocket::process_handshake(const TcpHeader* hdr, uint8_t flags, uint32_t seq) {
+void TcpSocket::register_connection_timers() {
+    if (m_timer_registered) return;
+    tcp_timer_registry::register_socket(this);
+    m_timer_registered = true;
+}
+
+void TcpSocket::send_segment(uint32_t seq, uint8_t flags, const uint8_t* data, size_t len) {
+    uint8_t packet[TCP_HEADER_SIZE + TCP_MAX_OPTIONS_SIZE + TCP_DEFAULT_MSS];
+    if (len > TCP_DEFAULT_MSS) return;
+    auto& c = m_connection;
+    bool syn = flags & TCP_FLAG_SYN;
+
+    // A SYN offers MSS, window scale and timestamps; the active side always
+    // offers, the passive side only echoes what the peer's SYN carried.
+    TcpOptions opts;
+    if (syn) {
+        opts.has_mss = true;
+        opts.mss = (uint16_t)TCP_DEFAULT_MSS;
+        opts.has_wscale = c.state == TcpState::SynSent || c.wscale_ok;
+        opts.wscale = c.rcv_wscale;
+    }
+    if (c.ts_ok || (syn && c.state == TcpState::SynSent)) {
+        opts.has_timestamp = true;
+        opts.ts_val = ticks_to_ms(TickManager::the().get_ticks());
+        opts.ts_ecr = c.ts_recent;
+    }
+
+    auto* hdr = reinterpret_cast<TcpHeader*>(packet);
+    uint16_t window = c.window_field(syn);
+    hdr->fill(c.local().port, c.remote().port, seq, c.recv_next, flags, window);
+    size_t hdr_len = TCP_HEADER_SIZE + opts.write(packet + TCP_HEADER_SIZE);
+    hdr->set_header_length(hdr_len);
+    if (!syn) c.last_advertised = (uint32_t)window << c.rcv_wscale;
+    if (len > 0) fk::memory::copy(packet + hdr_len, data, len);
+    hdr->checksum = tcp_checksum(c.remote().ip, packet, hdr_len + len);
+    // A failed send is recovered by the retransmission timer
+    NetworkStack::the().send_ipv4(c.remote().ip, IP_PROTO_TCP, packet, hdr_len + len);
+}
+
+fk::core::Result<void, fk::core::Error> TcpSocket::transmit(
+    uint8_t flags, const uint8_t* data, size_t len) {
+    auto& c = m_connection;
+    uint64_t now = TickManager::the().get_ticks();
+    uint32_t seq = c.send_next;
+    if (!c.retransmit_queue.push(seq, flags, data, (uint32_t)len, now))
+        return fk::core::Error::OutOfMemory;
+    send_segment(seq, flags, data, len);
+    c.send_next += (uint32_t)len;
+    if (flags & TCP_FLAG_SYN) ++c.send_next;
+    if (flags & TCP_FLAG_FIN) ++c.send_next;
+    // RFC 6298 (5.1)
+    if (c.rto_deadline == 0) arm_retransmit_timer(now);
+    return {};
+}
+
+void TcpSocket::retransmit_oldest(uint64_t now) {
+    TcpSegment* seg = m_connection.retransmit_queue.front();
+    if (!seg) return;
+    // Karn: an ACK for this segment is now ambiguous and yields no RTT sample
+    seg->retransmitted = true;
+    seg->sent_ticks = now;
+    send_segment(seg->seq, seg->flags, seg->data, seg->len);
+}
+
+void TcpSocket::arm_retransmit_timer(uint64_t now) {
+    m_connection.rto_deadline = now + ms_to_ticks(m_connection.rtt.rto_ms());
+}
+
+void TcpSocket::process_handshake(const TcpHeader* hdr, uint8_t flags, uint32_t seq,
+                                  IPv4Address src_ip, IPv4Address dst_ip,
+                                  const TcpOptions& opts) {
     if (m_connection.state == TcpState::SynSent) {
         if ((flags & (TCP_FLAG_SYN | TCP_FLAG_ACK)) != (TCP_FLAG_SYN | TCP_FLAG_ACK)) {
             fk::algorithms::kwarn("TCP", "handshake failed: state=%d", (int)m_connection.state);
             return;
         }
+        if (ntohl(hdr->ack_num) != m_connection.send_next) return;
         m_connection.recv_next = seq + 1;
         m_connection.peer_window = ntohs(hdr->window);
-        m_connection.send_unacked = ntohl(hdr->ack_num);
+        apply_syn_options(opts);
+        // process_ack() releases the queued SYN and takes the first RTT sample
         m_connection.state = TcpState::Established;
-        uint8_t ack[TCP_HEADER_SIZE];
-        auto* reply = reinterpret_cast<TcpHeader*>(ack);
-        reply->fill(m_connection.local().port, m_connection.remote().port,
-                    m_connection.send_next, m_connection.recv_next,
-                    TCP_FLAG_ACK, m_connection.recv_window());
-        reply->checksum = tcp_checksum(m_connection.remote().ip, ack, TCP_HEADER_SIZE);
-        NetworkStack::the().send_ipv4(m_connection.remote().ip, IP_PROTO_TCP,
-                                      ack, TCP_HEADER_SIZE);
+        send_ack();
         m_connection.state_changed.signal(1);
         return;
     }
@@ -189,91 +375,196 @@ void TcpSocket::process_handshake(const TcpHeader* hdr, uint8_t flags, uint32_t
         fk::algorithms::kwarn("TCP", "handshake failed: state=%d", (int)m_connection.state);
         return;
     }
-    // Create child socket for this connection
-    TcpEndpoint any_ep{IPv4Address(0u), 0};
-    auto child_res = fk::make_ref<TcpSocket>(m_connection.local(), any_ep);
+    // Create a child socket for this connection; it gets its own 4-tuple
+    // entry, so the rest of the handshake and all data bypass the listener.
+    TcpEndpoint local_ep{dst_ip, m_connection.local().port};
+    TcpEndpoint remote_ep{src_ip, ntohs(hdr->src_port)};
+    auto child_res = fk::make_ref<TcpSocket>(local_ep, remote_ep);
     if (child_res.is_error()) return;
     auto child = child_res.value();
+    if (!NetworkStack::the().register_tcp_connection(child->m_connection.tuple(), child.get()))
+        return;
+    child->m_connection_registered = true;
+    child->register_connection_timers();
+    child->m_listener = this;
     child->m_connection.recv_next = seq + 1;
     child->m_connection.peer_window = ntohs(hdr->window);
+    child->m_connection.recv_buf.set_capacity(m_connection.recv_buf.capacity());
+    child->m_connection.send_buffer_size = m_connection.send_buffer_size;
+    child->m_connection.rcv_wscale = TcpConnection::wscale_for(m_connection.recv_buf.capacity());
+    child->apply_syn_options(opts);
     child->m_connection.send_next = (uint32_t)TickManager::the().get_ticks();
-    child->m_connection.set_remote(m_connection.remote());
-    child->m_connection.state = TcpState::SynReceived;
-
-    uint8_t synack[TCP_HEADER_SIZE];
-    auto* reply = reinterpret_cast<TcpHeader*>(synack);
-    reply->fill(m_connection.local().port, m_connection.remote().port,
-                child->m_connection.send_next, child->m_connection.recv_next,
-                TCP_FLAG_SYN | TCP_FLAG_ACK, child->m_connection.recv_window());
-    reply->checksum = tcp_checksum(m_connection.remote().ip, synack, TCP_HEADER_SIZE);
     child->m_connection.send_unacked = child->m_connection.send_next;
-    ++child->m_connection.send_next;
-    NetworkStack::the().send_ipv4(m_connection.remote().ip, IP_PROTO_TCP,
-                                  synack, TCP_HEADER_SIZE);
+    child->m_connection.state = TcpState::SynReceived;
+    if (child->transmit(TCP_FLAG_SYN | TCP_FLAG_ACK, nullptr, 0).is_error()) return;
 
-    // Parent stays registered; process_ack will complete the handshake via m_accept_queue
+    // The child's own process_ack completes the handshake and wakes accept()
     m_accept_queue.push_back(child);
 }
 
-void TcpSocket::process_ack(const TcpHeader* hdr, uint8_t flags) {
+void TcpSocket::apply_syn_options(const TcpOptions& opts) {
+    auto& c = m_connection;
+    if (opts.has_mss && opts.mss > 0) c.peer_mss = opts.mss;
+    // Scaling is only in effect if both SYNs carried the option
+    c.wscale_ok = opts.has_wscale;
+    c.snd_wscale = opts.has_wscale ? opts.wscale : 0;
+    if (!opts.has_wscale) c.rcv_wscale = 0;
+    c.ts_ok = opts.has_timestamp;
+    if (opts.has_timestamp) c.ts_recent = opts.ts_val;
+}
+
+void TcpSocket::process_ack(const TcpHeader* hdr, uint8_t flags, size_t data_len,
+                            const TcpOptions& opts) {
     if (!(flags & TCP_FLAG_ACK)) return;
+    auto& c = m_connection;
     uint32_t ack = ntohl(hdr->ack_num);
+    uint32_t window = (flags & TCP_FLAG_SYN) ? ntohs(hdr->window)
+                                             : (uint32_t)ntohs(hdr->window) << c.snd_wscale;
 
-    if (m_connection.state == TcpState::Listen) {
-        // Complete the 3-way handshake for the matching SynReceived child
-        for (auto& child : m_accept_queue) {
-            if (child->m_connection.state != TcpState::SynReceived) continue;
-            if (ack != child->m_connection.send_next) continue;
-            child->m_connection.state = TcpState::Established;
-            child->m_connection.send_unacked = ack;
-            child->m_connection.peer_window = ntohs(hdr->window);
-            m_connection.state_changed.signal(1);
-            return;
+    if (c.state == TcpState::Listen) return;
+
+    if (c.state == TcpState::SynReceived) {
+        if (ack != c.send_next) return;
+        c.state = TcpState::Established;
+        c.state_changed.signal(1);
+        if (m_listener) {
+            m_listener->m_connection.state_changed.signal(1);
+            m_listener = nullptr;
         }
+    }
+    if (seq_gt(ack, c.send_next)) {
+        // Acknowledges data we never sent
+        send_ack();
         return;
     }
 
-    if (m_connection.state == TcpState::SynReceived) {
-        m_connection.state = TcpState::Established;
-        m_connection.state_changed.signal(1);
+    uint64_t now = TickManager::the().get_ticks();
+    if (seq_gt(ack, c.send_unacked)) {
+        uint32_t flight = c.flight_size();
+        uint32_t bytes_acked = ack - c.send_unacked;
+        auto acked = c.retransmit_queue.acknowledge(ack);
+        uint32_t freq = TickManager::the().get_frequency();
+        uint32_t granularity = freq ? (1000 + freq - 1) / freq : 1;
+        if (c.ts_ok && opts.has_timestamp && opts.ts_ecr != 0) {
+            // RFC 7323 4.1: the echoed timestamp times retransmitted segments too
+            c.rtt.sample(ticks_to_ms(now) - opts.ts_ecr, granularity);
+        } else if (acked.has_rtt_sample) {
+            c.rtt.sample(ticks_to_ms(now - acked.sample_sent_ticks), granularity);
+        }
+        c.send_unacked = ack;
+        c.peer_window = window;
+        c.retransmits = 0;
+        if (c.congestion.on_ack(ack, bytes_acked, flight) == TcpCongestionControl::Action::Retransmit)
+            retransmit_oldest(now);
+        // RFC 6298 (5.2), (5.3)
+        if (c.retransmit_queue.is_empty()) c.rto_deadline = 0;
+        else arm_retransmit_timer(now);
+        c.send_space.signal(1);
+        if (c.fin_acked()) process_fin_ack();
+    } else if (ack == c.send_unacked && data_len == 0 && window == c.peer_window
+               && c.flight_size() > 0 && !(flags & (TCP_FLAG_SYN | TCP_FLAG_FIN))) {
+        // Duplicate ACK (RFC 5681 section 2)
+        if (c.congestion.on_dup_ack(c.flight_size(), c.send_unacked, c.send_next)
+                == TcpCongestionControl::Action::Retransmit)
+            retransmit_oldest(now);
+        // An inflated cwnd may admit new data
+        c.send_space.signal(1);
+    } else if (window != c.peer_window) {
+        c.peer_window = window;
+        if (window > 0) c.send_space.signal(1);
+    }
+
+    if (c.peer_window == 0 && c.retransmit_queue.is_empty()) {
+        if (c.persist_deadline == 0)
+            c.persist_deadline = now + ms_to_ticks(c.rtt.rto_ms());
+    } else {
+        c.persist_deadline = 0;
+    }
+}
+
+void TcpSocket::process_fin_ack() {
+    auto& c = m_connection;
+    switch (c.state) {
+    case TcpState::FinWait1:
+        c.state = TcpState::FinWait2;
+        break;
+    case TcpState::Closing:
+        enter_time_wait();
+        break;
+    case TcpState::LastAck:
+        c.state = TcpState::Closed;
+        c.state_changed.signal(1);
+        break;
+    default:
+        break;
     }
-    if (ack > m_connection.send_unacked && ack <= m_connection.send_next)
-        m_connection.send_unacked = ack;
-    m_connection.peer_window = ntohs(hdr->window);
 }
 
 void TcpSocket::process_data(const TcpHeader*, uint8_t, const uint8_t* data, size_t data_len, uint32_t seq) {
     if (data_len == 0) return;
-    if (m_connection.state != TcpState::Established) return;
-    if (seq != m_connection.recv_next) return;
-    uint16_t avail = m_connection.recv_window();
-    size_t to_store = data_len < avail ? data_len : avail;
-    m_connection.recv_buf.push_range(data, to_store);
-    m_connection.recv_next += (uint32_t)to_store;
-    uint8_t ack_pkt[TCP_HEADER_SIZE];
-    auto* ack = reinterpret_cast<TcpHeader*>(ack_pkt);
-    ack->fill(m_connection.local().port, m_connection.remote().port,
-              m_connection.send_next, m_connection.recv_next,
-              TCP_FLAG_ACK, m_connection.recv_window());
-    ack->checksum = tcp_checksum(m_connection.remote().ip, ack_pkt, TCP_HEADER_SIZE);
-    NetworkStack::the().send_ipv4(m_connection.remote().ip, IP_PROTO_TCP,
-                                  ack_pkt, TCP_HEADER_SIZE);
+    auto& c = m_connection;
+    if (c.state != TcpState::Established && c.state != TcpState::FinWait1 &&
+        c.state != TcpState::FinWait2) return;
+
+    // Drop the part we already have; a pure duplicate still gets an ACK
+    if (seq_lt(seq, c.recv_next)) {
+        uint32_t dup = c.recv_next - seq;
+        if (dup >= data_len) { send_ack(); return; }
+        seq += dup;
+        data += dup;
+        data_len -= dup;
+    }
+    uint32_t window = c.recv_window();
+    uint32_t offset = seq - c.recv_next;
+    if (offset >= window) { send_ack(); return; }
+    if (data_len > window - offset) data_len = window - offset;
+
+    if (offset > 0) {
+        // Out of order: hold it and send an immediate duplicate ACK (RFC 5681 4.2)
+        c.reassembly_queue.insert(seq, data, (uint32_t)data_len);
+        send_ack();
+        return;
+    }
+
+    c.recv_next += (uint32_t)c.recv_buf.write(data, data_len);
+    // The segment may have filled a hole
+    c.recv_next = c.reassembly_queue.drain(c.recv_next, [&c](const uint8_t* p, size_t n) {
+        return c.recv_buf.write(p, n);
+    });
+    send_ack();
 }
 
-void TcpSocket::process_fin(const TcpHeader*, uint8_t flags) {
+void TcpSocket::process_fin(const TcpHeader*, uint8_t flags, size_t data_len, uint32_t seq) {
     if (!(flags & TCP_FLAG_FIN)) return;
-    ++m_connection.recv_next;
-    m_connection.state = TcpState::CloseWait;
-    uint8_t fin_ack[TCP_HEADER_SIZE];
-    auto* fa = reinterpret_cast<TcpHeader*>(fin_ack);
-    fa->fill(m_connection.local().port, m_connection.remote().port,
-             m_connection.send_next, m_connection.recv_next,
-             TCP_FLAG_ACK | TCP_FLAG_FIN, m_connection.recv_window());
-    fa->checksum = tcp_checksum(m_connection.remote().ip, fin_ack, TCP_HEADER_SIZE);
-    NetworkStack::the().send_ipv4(m_connection.remote().ip, IP_PROTO_TCP,
-                                  fin_ack, TCP_HEADER_SIZE);
-    ++m_connection.send_next;
-    m_connection.state = TcpState::LastAck;
+    // Only an in-order FIN; one beyond a hole is retransmitted by the peer
+    if (seq + (uint32_t)data_len != m_connection.recv_next) return;
+    auto& c = m_connection;
+    switch (c.state) {
+    case TcpState::SynReceived:
+    case TcpState::Established:
+        // Our side stays open until shutdown() sends the FIN
+        c.state = TcpState::CloseWait;
+        break;
+    case TcpState::FinWait1:
+        // Simultaneous close; a FIN that also acked ours already moved us to FinWait2
+        c.state = TcpState::Closing;
+        break;
+    case TcpState::FinWait2:
+        enter_time_wait();
+        break;
+    default:
+        return;
+    }
+    ++c.recv_next;
+    send_ack();
+    // Readers see end of stream
+    c.state_changed.signal(1);
+}
+
+void TcpSocket::enter_time_wait() {
+    auto& c = m_connection;
+    c.state = TcpState::TimeWait;
+    c.time_wait_deadline = TickManager::the().get_ticks() + ms_to_ticks(TCP_TIME_WAIT_MS);
 }
 
 fk::core::Result<void, fk::core::Error> TcpSocket::shutdown(int how) {
@@ -284,16 +575,11 @@ fk::core::Result<void, fk::core::Error> TcpSocket::shutdown(int how) {
     if (how == 0 || how == 2) // SHUT_RD or SHUT_RDWR
         m_connection.recv_buf.clear();
     if (how == 1 || how == 2) { // SHUT_WR or SHUT_RDWR
-        uint8_t fin[TCP_HEADER_SIZE];
-        auto* hdr = reinterpret_cast<TcpHeader*>(fin);
-        hdr->fill(m_connection.local().port, m_connection.remote().port,
-                  m_connection.send_next, m_connection.recv_next,
-                  TCP_FLAG_FIN | TCP_FLAG_ACK, m_connection.recv_window());
-        hdr->checksum = tcp_checksum(m_connection.remote().ip, fin, TCP_HEADER_SIZE);
-        NetworkStack::the().send_ipv4(m_connection.remote().ip, IP_PROTO_TCP,
-                                      fin, TCP_HEADER_SIZE);
-        ++m_connection.send_next;
-        m_connection.state = TcpState::FinWait1;
+        auto res = transmit(TCP_FLAG_FIN | TCP_FLAG_ACK, nullptr, 0);
+        if (res.is_error()) return res.error();
+        // The peer already closed its side when we are in CloseWait
+        m_connection.state = m_connection.state == TcpState::CloseWait ? TcpState::LastAck
+                                                                      : TcpState::FinWait1;
     }
     return {};
 }
@@ -325,6 +611,16 @@ fk::core::Result<void, fk::core::Error> TcpSocket::setsockopt(
     if (level == 1) { // SOL_SOCKET
         if (optname == 2) { m_so_reuseaddr = (val != 0); return {}; } // SO_REUSEADDR
         if (optname == 9) { m_so_keepalive = (val != 0); return {}; }  // SO_KEEPALIVE
+        if (optname == 7 || optname == 8) { // SO_SNDBUF, SO_RCVBUF
+            size_t bytes = val < (int)TCP_MIN_BUFFER ? TCP_MIN_BUFFER : (size_t)val;
+            if (bytes > TCP_MAX_BUFFER) bytes = TCP_MAX_BUFFER;
+            fk::synchronization::ScopedLock lock(m_lock);
+            if (optname == 7) { m_connection.send_buffer_size = bytes; return {}; }
+            // The window scale is fixed by the SYN; a larger buffer than it can
+            // express is still usable, the window just saturates.
+            if (!m_connection.recv_buf.set_capacity(bytes)) return fk::core::Error::DeviceBusy;
+            return {};
+        }
         return fk::core::Error::NotImplemented;
     }
     if (level == 6) { // IPPROTO_TCP
@@ -341,6 +637,8 @@ fk::core::Result<void, fk::core::Error> TcpSocket::getsockopt(
         if (optname == 4) { *reinterpret_cast<int*>(optval) = m_so_error; *optlen = 4; return {}; } // SO_ERROR
         if (optname == 2) { *reinterpret_cast<int*>(optval) = m_so_reuseaddr ? 1 : 0; *optlen = 4; return {}; } // SO_REUSEADDR
         if (optname == 9) { *reinterpret_cast<int*>(optval) = m_so_keepalive ? 1 : 0; *optlen = 4; return {}; } // SO_KEEPALIVE
+        if (optname == 7) { *reinterpret_cast<int*>(optval) = (int)m_connection.send_buffer_size; *optlen = 4; return {}; } // SO_SNDBUF
+        if (optname == 8) { *reinterpret_cast<int*>(optval) = (int)m_connection.recv_buf.capacity(); *optlen = 4; return {}; } // SO_RCVBUF
         return fk::core::Error::NotImplemented;
     }
     if (level == 6) { // IPPROTO_TCP
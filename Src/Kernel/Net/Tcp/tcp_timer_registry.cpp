@@ -0,0 +1,107 @@
+#include <Kernel/Net/Tcp/tcp_timer_registry.h>
+#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
+#include <Kernel/Net/Tcp/tcp_socket.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Scheduler/wait_queue.h>
+#include <LibFK/Algorithms/log.h>
+#include <LibFK/Container/vector.h>
+#include <LibFK/Synchronization/spinlock.h>
+
+namespace fkernel {
+namespace net {
+namespace tcp_timer_registry {
+
+namespace {
+    fk::synchronization::Spinlock s_lock;
+    fk::containers::Vector<TcpSocket*> s_sockets;
+    bool s_work_due{false};          // guarded by s_lock
+    WaitQueue s_worker_queue{"tcp.timers"};
+    bool s_worker_started{false};
+}
+
+// Sending reaches the NIC driver, which is neither IRQ-safe nor quick, so
+// the tick only notices due timers and this task runs them.
+static void timer_worker_entry() {
+    fk::containers::Vector<TcpSocket*> due;
+    for (;;) {
+        WaitQueueEntry wait;
+        bool idle;
+        {
+            fk::synchronization::ScopedLockIRQ lock(s_lock);
+            idle = !s_work_due;
+            if (idle) {
+                s_worker_queue.prepare_to_wait(wait);
+            } else {
+                s_work_due = false;
+                // A socket whose last reference is going away is skipped; its
+                // destructor is about to unregister it
+                uint64_t now = TickManager::the().get_ticks();
+                for (size_t i = 0; i < s_sockets.size(); ++i) {
+                    if (s_sockets[i]->timer_due(now) && s_sockets[i]->try_ref())
+                        due.push_back(s_sockets[i]);
+                }
+            }
+        }
+        if (idle) {
+            (void)s_worker_queue.finish_wait(wait);
+            continue;
+        }
+
+        uint64_t now = TickManager::the().get_ticks();
+        for (size_t i = 0; i < due.size(); ++i) {
+            due[i]->on_timer(now);
+            due[i]->unref();
+        }
+        due.clear();
+    }
+}
+
+static void start_worker() {
+    if (!__sync_bool_compare_and_swap(&s_worker_started, false, true)) return;
+    Task* worker = new Task();
+    if (!worker) {
+        fk::algorithms::kerror("TCP", "Failed to allocate the timer task");
+        return;
+    }
+    *worker = create_a_new_task(SchedulerManager::the().generate_pid(), "tcp-timers",
+                                timer_worker_entry, true, 5, 0, 0, 0);
+    SchedulerManager::the().add_task(worker);
+}
+
+// Task-context callers keep interrupts off while holding s_lock: tick_all()
+// runs from the timer tick, and the recursive spinlock would let it walk
+// s_sockets on the same CPU in the middle of an update.
+void register_socket(TcpSocket* socket) {
+    start_worker();
+    fk::synchronization::ScopedLockIRQ lock(s_lock);
+    s_sockets.push_back(socket);
+}
+
+void unregister_socket(TcpSocket* socket) {
+    fk::synchronization::ScopedLockIRQ lock(s_lock);
+    for (size_t i = 0; i < s_sockets.size(); ++i) {
+        if (s_sockets[i] == socket) {
+            s_sockets[i] = s_sockets[s_sockets.size() - 1];
+            s_sockets.pop_back();
+            return;
+        }
+    }
+}
+
+void tick_all(uint64_t now_ticks) {
+    // Sockets unregister under s_lock before their members are destroyed,
+    // so every pointer seen here is still valid while it is checked.
+    fk::synchronization::ScopedLock lock(s_lock);
+    if (s_work_due) return;
+    for (size_t i = 0; i < s_sockets.size(); ++i) {
+        if (s_sockets[i]->timer_due(now_ticks)) {
+            s_work_due = true;
+            s_worker_queue.wake_one();
+            return;
+        }
+    }
+}
+
+} // namespace tcp_timer_registry
+} // namespace net
+} // namespace fkernel
@@ -0,0 +1,65 @@
+#include <Kernel/Net/socket_ring_buffer.h>
+#include <Kernel/Memory/memory_manager.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+
+SocketRingBuffer::SocketRingBuffer(size_t capacity) : m_capacity(capacity) {}
+
+SocketRingBuffer::~SocketRingBuffer() {
+  if (m_data)
+    MemoryManager::the().free(m_data);
+}
+
+bool SocketRingBuffer::set_capacity(size_t capacity) {
+  if (!is_empty())
+    return false;
+  if (capacity == m_capacity)
+    return true;
+  if (m_data) {
+    MemoryManager::the().free(m_data);
+    m_data = nullptr;
+  }
+  m_capacity = capacity;
+  clear();
+  return true;
+}
+
+size_t SocketRingBuffer::read(uint8_t* buf, size_t max) {
+  size_t to_read = max < available() ? max : available();
+  if (to_read == 0)
+    return 0;
+  size_t rpos = m_read_ptr % m_capacity;
+  size_t first = m_capacity - rpos;
+  if (first >= to_read) {
+    fk::memory::copy(buf, m_data + rpos, to_read);
+  } else {
+    fk::memory::copy(buf, m_data + rpos, first);
+    fk::memory::copy(buf + first, m_data, to_read - first);
+  }
+  m_read_ptr += to_read;
+  return to_read;
+}
+
+size_t SocketRingBuffer::write(const uint8_t* src, size_t count) {
+  size_t to_write = count < free_space() ? count : free_space();
+  if (to_write == 0)
+    return 0;
+  if (!m_data) {
+    m_data = reinterpret_cast<uint8_t*>(MemoryManager::the().allocate(m_capacity));
+    if (!m_data)
+      return 0;
+  }
+  size_t wpos = m_write_ptr % m_capacity;
+  size_t first = m_capacity - wpos;
+  if (first >= to_write) {
+    fk::memory::copy(m_data + wpos, src, to_write);
+  } else {
+    fk::memory::copy(m_data + wpos, src, first);
+    fk::memory::copy(m_data, src + first, to_write - first);
+  }
+  m_write_ptr += to_write;
+  return to_write;
+}
+
+} // namespace fkernel
@@ -32,13 +32,14 @@ UnixSocket::UnixSocket(SocketType type) : m_type(type) {}
 UnixSocket::~UnixSocket() = default;
 
 fk::core::Result<void, fk::core::Error> UnixSocket::bind(const char* path) {
-  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  // mount() may sleep on the VFS lock, so it runs before m_lock is taken
   auto res = VirtualFileSystem::the().mount(path, fk::RefPtr<Node>(this));
-  if (res.is_ok()) {
-    m_bound_path = fk::text::fixed_string<108>(path);
-    fk::algorithms::kdebug("UNIX", "bind(%s)", path);
-  }
-  return res;
+  if (res.is_error()) return res;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  m_bound_path = fk::text::fixed_string<108>(path);
+  fk::algorithms::kdebug("UNIX", "bind(%s)", path);
+  return {};
 }
 
 fk::core::Result<void, fk::core::Error> UnixSocket::connect(const char* path) {
@@ -0,0 +1,163 @@
+#include <Kernel/Scheduler/Task/file_table.h>
+
+fk::core::Result<fk::RefPtr<FileTable>, fk::core::Error> FileTable::create() {
+  return fk::make_ref<FileTable>();
+}
+
+fk::core::Result<fk::RefPtr<FileTable>, fk::core::Error> FileTable::clone() const {
+  auto copy_res = create();
+  if (copy_res.is_error()) return copy_res.error();
+  auto copy = copy_res.value();
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  if (!copy->ensure_slots_locked(m_files.size())) return fk::core::Error::OutOfMemory;
+  for (size_t i = 0; i < m_files.size(); ++i)
+    copy->m_files[i] = m_files[i];
+  // The bitmaps may hold spare words past m_files from a failed grow
+  for (size_t i = 0; i < m_files.size() / BITS_PER_WORD; ++i) {
+    copy->m_open_bits[i] = m_open_bits[i];
+    copy->m_cloexec_bits[i] = m_cloexec_bits[i];
+  }
+  copy->m_next_fd = m_next_fd;
+  return copy;
+}
+
+bool FileTable::is_open_locked(size_t fd) const {
+  return fd < m_files.size() && (m_open_bits[fd / BITS_PER_WORD] & (1ULL << (fd % BITS_PER_WORD)));
+}
+
+void FileTable::set_bit(fk::containers::Vector<uint64_t>& bits, size_t fd, bool value) {
+  uint64_t mask = 1ULL << (fd % BITS_PER_WORD);
+  if (value)
+    bits[fd / BITS_PER_WORD] |= mask;
+  else
+    bits[fd / BITS_PER_WORD] &= ~mask;
+}
+
+// Grows by doubling, a whole bitmap word at a time
+bool FileTable::ensure_slots_locked(size_t slots) {
+  if (slots <= m_files.size()) return true;
+  if (slots > FD_TABLE_MAX) return false;
+
+  size_t target = m_files.size() ? m_files.size() : BITS_PER_WORD;
+  while (target < slots)
+    target *= 2;
+  if (target > FD_TABLE_MAX) target = FD_TABLE_MAX;
+
+  // Bitmaps first and m_files last: m_files.size() bounds every bitmap
+  // access, so a failure part way leaves spare bitmap words but never a slot
+  // without its bits. Vector::resize leaves the size alone when it cannot
+  // allocate.
+  size_t words = target / BITS_PER_WORD;
+  if (m_open_bits.size() < words) {
+    m_open_bits.resize(words);
+    if (m_open_bits.size() != words) return false;
+  }
+  if (m_cloexec_bits.size() < words) {
+    m_cloexec_bits.resize(words);
+    if (m_cloexec_bits.size() != words) return false;
+  }
+  m_files.resize(target);
+  return m_files.size() == target;
+}
+
+void FileTable::release_locked(size_t fd) {
+  m_files[fd] = nullptr;
+  set_bit(m_open_bits, fd, false);
+  set_bit(m_cloexec_bits, fd, false);
+  if (fd < m_next_fd) m_next_fd = fd;
+}
+
+fk::RefPtr<FileDescription> FileTable::get(int fd) const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  if (fd < 0 || !is_open_locked(static_cast<size_t>(fd))) return {};
+  return m_files[fd];
+}
+
+fk::core::Result<int, fk::core::Error>
+FileTable::allocate(fk::RefPtr<FileDescription> description, int min_fd, bool cloexec,
+                    size_t limit) {
+  if (limit > FD_TABLE_MAX) limit = FD_TABLE_MAX;
+  if (min_fd < 0 || static_cast<size_t>(min_fd) >= limit) return fk::core::Error::InvalidParameter;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  size_t start = static_cast<size_t>(min_fd) > m_next_fd ? static_cast<size_t>(min_fd) : m_next_fd;
+  size_t fd = m_files.size();
+  for (size_t word = start / BITS_PER_WORD; word < m_open_bits.size(); ++word) {
+    uint64_t used = m_open_bits[word];
+    // Bits below start in its own word count as used
+    if (word == start / BITS_PER_WORD) used |= (1ULL << (start % BITS_PER_WORD)) - 1;
+    if (~used) {
+      fd = word * BITS_PER_WORD + __builtin_ctzll(~used);
+      break;
+    }
+  }
+  if (fd < start) fd = start;
+  if (fd >= limit) return fk::core::Error::TooManyOpenFiles;
+  if (!ensure_slots_locked(fd + 1)) return fk::core::Error::OutOfMemory;
+
+  m_files[fd] = description;
+  set_bit(m_open_bits, fd, true);
+  set_bit(m_cloexec_bits, fd, cloexec);
+  if (fd == m_next_fd) m_next_fd = fd + 1;
+  return static_cast<int>(fd);
+}
+
+fk::core::Result<fk::RefPtr<FileDescription>, fk::core::Error>
+FileTable::install(int fd, fk::RefPtr<FileDescription> description, bool cloexec, size_t limit) {
+  if (fd < 0 || static_cast<size_t>(fd) >= limit || static_cast<size_t>(fd) >= FD_TABLE_MAX)
+    return fk::core::Error::InvalidHandle;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  if (!ensure_slots_locked(static_cast<size_t>(fd) + 1)) return fk::core::Error::OutOfMemory;
+
+  fk::RefPtr<FileDescription> displaced = m_files[fd];
+  m_files[fd] = description;
+  set_bit(m_open_bits, fd, true);
+  set_bit(m_cloexec_bits, fd, cloexec);
+  if (static_cast<size_t>(fd) == m_next_fd) m_next_fd = fd + 1;
+  return displaced;
+}
+
+fk::RefPtr<FileDescription> FileTable::remove(int fd) {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  if (fd < 0 || !is_open_locked(static_cast<size_t>(fd))) return {};
+  fk::RefPtr<FileDescription> description = m_files[fd];
+  release_locked(fd);
+  return description;
+}
+
+fk::core::Result<bool, fk::core::Error> FileTable::is_cloexec(int fd) const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  if (fd < 0 || !is_open_locked(static_cast<size_t>(fd))) return fk::core::Error::InvalidHandle;
+  return (m_cloexec_bits[fd / BITS_PER_WORD] & (1ULL << (fd % BITS_PER_WORD))) != 0;
+}
+
+fk::core::Result<void, fk::core::Error> FileTable::set_cloexec(int fd, bool cloexec) {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  if (fd < 0 || !is_open_locked(static_cast<size_t>(fd))) return fk::core::Error::InvalidHandle;
+  set_bit(m_cloexec_bits, fd, cloexec);
+  return {};
+}
+
+void FileTable::close_on_exec() {
+  // Collected first so the last references drop outside the lock
+  fk::containers::Vector<fk::RefPtr<FileDescription>> closing;
+  {
+    fk::synchronization::ScopedLockIRQ lock(m_lock);
+    for (size_t word = 0; word < m_cloexec_bits.size(); ++word) {
+      uint64_t bits = m_cloexec_bits[word];
+      while (bits) {
+        size_t fd = word * BITS_PER_WORD + __builtin_ctzll(bits);
+        bits &= bits - 1;
+        closing.push_back(m_files[fd]);
+        release_locked(fd);
+      }
+    }
+  }
+}
+
+size_t FileTable::slot_count() const {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  return m_files.size();
+}
@@ -1,6 +1,7 @@
 #include <Kernel/Fs/Vfs/node.h>
 #include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
 #include <Kernel/Scheduler/Task/task.h>
+#include <Kernel/Syscall/syscall_utils.h>
 #include <LibFK/Algorithms/log.h>
 #include <LibFK/Memory/heap_malloc.h>
 
@@ -58,7 +59,8 @@ Task create_a_new_task(fk::ProcessId id, const fk::text::fixed_string<64>& name,
                             .vfork_parent_id = fk::ProcessId(),
                             .is_vfork_sharing_address_space = false};
 
-  task.resources.memory = {.cr3 = read_on_cr3()};
+  // Strip the PCID bits: tasks hold the bare PML4 address
+  task.resources.memory = {.cr3 = read_on_cr3() & ~0xFFFULL};
   task.resources.files.cwd = "/";
   task.resources.ipc.cspace = cspace;
   task.resources.ipc.signal_notification = signal_notification;
@@ -106,6 +108,7 @@ void Task::destroy() {
     VirtualMemoryManager::the().free_address_space(resources.memory.cr3);
     resources.memory.cr3 = 0;
   }
+  resources.memory.vmas = nullptr;
 }
 
 void Task::set_heap_regions(uintptr_t start, uintptr_t break_addr) {
@@ -113,54 +116,46 @@ void Task::set_heap_regions(uintptr_t start, uintptr_t break_addr) {
     resources.memory.regions.heap_break = break_addr;
 }
 
-void Task::set_mmap_regions(uintptr_t start, uintptr_t end) {
-    resources.memory.regions.mmap_start = start;
-    resources.memory.regions.mmap_end = end;
-}
-
-bool Task::is_address_in_allowed_regions(uintptr_t address) const {
-    if (address >= resources.memory.regions.heap_start && address < resources.memory.regions.heap_break) {
-        return true;
-    }
-    if (address >= resources.memory.regions.mmap_start && address < resources.memory.regions.mmap_end) {
-        return true;
-    }
-    if (address >= 0x7ffffff00000ULL && address < 0x7fffffffe000ULL) {
-        return true;
-    }
-    return false;
+bool Task::find_vma(uintptr_t address, fkernel::Vma& out) const {
+    if (!resources.memory.vmas) return false;
+    return resources.memory.vmas->lookup(address, out);
 }
 
 void Task::print_info() const {}
 
-int Task::add_file_descriptor(fk::RefPtr<FileDescription> description) {
+fk::RefPtr<FileTable> Task::file_table() {
   fk::synchronization::ScopedLockIRQ lock_task(lock);
-  for (size_t i = 0; i < resources.files.descriptors.size(); ++i) {
-    if (!resources.files.descriptors[i]) {
-      resources.files.descriptors[i] = description;
-
-      return static_cast<int>(i);
-    }
-  }
-
-  // No empty slots? Add to the end.
-  if (resources.files.descriptors.is_full()) {
-    fk::algorithms::kwarn("TASK", "Task %lu: FD table full!", control.identity.id.value());
-    return -24; // -EMFILE
+  if (!resources.files.table) {
+    auto table = FileTable::create();
+    if (table.is_error()) return {};
+    resources.files.table = table.value();
   }
+  return resources.files.table;
+}
 
-  int fd = static_cast<int>(resources.files.descriptors.size());
-  resources.files.descriptors.push_back(description);
+static int descriptor_or_errno(fk::core::Result<int, fk::core::Error> result) {
+  if (result.is_error()) return -fkernel::error_to_errno(result.error());
+  return result.value();
+}
 
+int Task::add_file_descriptor(fk::RefPtr<FileDescription> description, bool cloexec) {
+  auto table = file_table();
+  if (!table) return -12; // -ENOMEM
+  int fd = descriptor_or_errno(table->allocate(description, 0, cloexec, resources.files.nofile_soft));
+  if (fd == -24)
+    fk::algorithms::kwarn("TASK", "Task %lu: FD table full!", control.identity.id.value());
   return fd;
 }
 
 void Task::dump_file_descriptors() const {
-  fk::synchronization::ScopedLockIRQ lock_task(lock);
-
-  for (size_t i = 0; i < resources.files.descriptors.size(); ++i) {
-    if (resources.files.descriptors[i]) {
-      auto node = resources.files.descriptors[i]->node();
+  fk::RefPtr<FileTable> table = resources.files.table;
+  if (!table) return;
+
+  size_t slots = table->slot_count();
+  for (size_t i = 0; i < slots; ++i) {
+    auto description = table->get(static_cast<int>(i));
+    if (description) {
+      auto node = description->node();
       const char* type = "unknown";
       if (node->is_character_device())
         type = "char";
@@ -175,46 +170,49 @@ void Task::dump_file_descriptors() const {
   }
 }
 
-int Task::dup_file_descriptor(int old_fd, [[maybe_unused]] bool cloexec, int min_fd) {
-  fk::synchronization::ScopedLockIRQ lock_task(lock);
-  auto description = (old_fd < 0 || old_fd >= static_cast<int>(resources.files.descriptors.size()))
-                         ? nullptr
-                         : resources.files.descriptors[old_fd];
+int Task::dup_file_descriptor(int old_fd, bool cloexec, int min_fd) {
+  auto table = file_table();
+  if (!table) return -12; // -ENOMEM
+  auto description = table->get(old_fd);
   if (!description) {
     fk::algorithms::kwarn("TASK", "dup_file_descriptor: Source FD %d not found", old_fd);
-    return -1; // EBADF
+    return -9; // -EBADF
   }
+  return descriptor_or_errno(
+      table->allocate(description, min_fd, cloexec, resources.files.nofile_soft));
+}
 
-  for (int i = min_fd; i < static_cast<int>(resources.files.descriptors.capacity()); ++i) {
-    if (i >= static_cast<int>(resources.files.descriptors.size())) {
-      while (static_cast<int>(resources.files.descriptors.size()) < i) {
-        resources.files.descriptors.push_back({});
-      }
-      resources.files.descriptors.push_back(description);
-      int new_fd = resources.files.descriptors.size() - 1;
-      return new_fd;
-    }
+int Task::install_file_descriptor(int fd, fk::RefPtr<FileDescription> description, bool cloexec) {
+  auto table = file_table();
+  if (!table) return -12; // -ENOMEM
+  auto displaced = table->install(fd, description, cloexec, resources.files.nofile_soft);
+  if (displaced.is_error()) return -fkernel::error_to_errno(displaced.error());
+  return fd;
+}
 
-    if (!resources.files.descriptors[i]) {
-      resources.files.descriptors[i] = description;
-      return i;
-    }
+fk::core::Result<void, fk::core::Error> Task::inherit_files(Task& parent, bool share) {
+  auto table = parent.file_table();
+  if (!table) return fk::core::Error::OutOfMemory;
+  if (share) {
+    resources.files.table = table;
+  } else {
+    auto copy = table->clone();
+    if (copy.is_error()) return copy.error();
+    resources.files.table = copy.value();
   }
-
-  return -1; // EMFILE
+  resources.files.nofile_soft = parent.resources.files.nofile_soft;
+  resources.files.nofile_hard = parent.resources.files.nofile_hard;
+  return {};
 }
 
 fk::RefPtr<FileDescription> Task::get_file_descriptor(int fd) {
-  if (fd < 0 || fd >= static_cast<int>(resources.files.descriptors.size())) {
-    return {};
-  }
-  return resources.files.descriptors[fd];
+  fk::RefPtr<FileTable> table = resources.files.table;
+  if (!table) return {};
+  return table->get(fd);
 }
 
-void Task::close_file_descriptor(int fd) {
-  fk::synchronization::ScopedLockIRQ lock_task(lock);
-  if (fd < 0 || fd >= static_cast<int>(resources.files.descriptors.size())) {
-    return;
-  }
-  resources.files.descriptors[fd] = nullptr;
+int Task::close_file_descriptor(int fd) {
+  fk::RefPtr<FileTable> table = resources.files.table;
+  if (!table || !table->remove(fd)) return -9; // -EBADF
+  return 0;
 }
\ No newline at end of file
@@ -21,7 +21,6 @@ extern "C" void idle_task_entry() {
 
     // Set initial memory regions for demand paging
     init->set_heap_regions(0x10000000, 0x10000000);
-    init->set_mmap_regions(0x40000000, 0x40000000);
 
     // Keep Display so kernel panics/errors remain visible on VGA alongside serial.
     fk::algorithms::set_log_targets(fk::algorithms::LogTarget::Serial |
@@ -70,9 +70,14 @@ load_init_executable_and_setup_address_space() {
     return init_dentry_res.error();
   }
 
+  auto vmas_res = VmaTree::create();
+  if (vmas_res.is_error())
+    return vmas_res.error();
+
   uintptr_t new_cr3 = VirtualMemoryManager::the().create_address_space();
   VirtualMemoryManager::the().switch_address_space(new_cr3);
   SchedulerManager::the().current()->resources.memory.cr3 = new_cr3;
+  SchedulerManager::the().current()->resources.memory.vmas = vmas_res.value();
 
   return ElfLoader::load(init_dentry_res.value()->top_node());
 }
@@ -88,6 +93,9 @@ static uintptr_t setup_user_stack() {
                                              PageFlags::User);
     fk::memory::set(reinterpret_cast<void*>(USER_STACK_TOP - (i + 1) * 0x1000), 0, 0x1000);
   }
+  SchedulerManager::the().current()->memory().vmas->insert(
+      USER_STACK_TOP - USER_STACK_RESERVE, USER_STACK_TOP,
+      PageFlags::Present | PageFlags::Writable | PageFlags::User, VmaKind::Stack, "[stack]");
   return USER_STACK_TOP;
 }
 
@@ -121,6 +129,10 @@ static void setup_initial_stack_frame_and_enter_user_mode(uintptr_t entry, uintp
   pointers[idx++] = elf_res.ph_num; // AT_PHNUM
   pointers[idx++] = 6;
   pointers[idx++] = PAGE_SIZE; // AT_PAGESZ
+  if (elf_res.vdso_base) {
+    pointers[idx++] = 33;
+    pointers[idx++] = elf_res.vdso_base; // AT_SYSINFO_EHDR
+  }
   pointers[idx++] = 0;
   pointers[idx++] = 0; // AT_NULL
 
@@ -151,7 +163,6 @@ extern "C" void init_task_entry() {
   ElfLoadResult elf_res = elf_load_res.value();
 
   current->set_heap_regions(elf_res.highest_load_end, elf_res.highest_load_end);
-  current->set_mmap_regions(0x40000000, 0x40000000);
 
   uintptr_t entry = elf_res.entry;
   fk::algorithms::klog("INIT", "Jumping to user-mode init at %p", (void*)entry);
@@ -0,0 +1,45 @@
+#include <Kernel/Scheduler/lock_waiter.h>
+#include <Kernel/Scheduler/scheduler.h>
+
+namespace fkernel {
+
+Task* lock_caller() {
+  auto& scheduler = SchedulerManager::the();
+  if (!scheduler.is_initialized())
+    return BOOT_LOCK_OWNER;
+  Task* task = scheduler.current();
+  return task ? task : BOOT_LOCK_OWNER;
+}
+
+bool lock_owner_running(const Task* owner) {
+  if (!owner || owner == BOOT_LOCK_OWNER)
+    return false;
+  return owner->state() == TaskState::Running && owner != SchedulerManager::the().current();
+}
+
+void lock_wait_for_grant(fk::synchronization::Spinlock& guard, LockWaiter& waiter) {
+  auto& scheduler = SchedulerManager::the();
+  for (;;) {
+    {
+      fk::synchronization::ScopedLockIRQ lock(guard);
+      if (waiter.granted)
+        return;
+      // Marked blocked before the guard drops, so a grant in between still
+      // wakes us; queued so kill and wait4 still find the task
+      scheduler.block_current();
+    }
+    scheduler.schedule();
+  }
+}
+
+void lock_grant(LockWaiter& waiter) {
+  Task* task = waiter.task;
+  waiter.granted = true;
+  SchedulerManager::the().wake_task(task);
+}
+
+void lock_owner_blocks(Task*, Task*) {}
+
+void lock_owner_releases(Task*) {}
+
+} // namespace fkernel
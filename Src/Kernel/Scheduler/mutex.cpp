@@ -0,0 +1,72 @@
+#include <Kernel/Scheduler/mutex.h>
+#include <LibFK/Core/assertions.h>
+
+namespace fkernel {
+
+bool Mutex::try_acquire(Task* self) {
+  Task* expected = nullptr;
+  return __atomic_compare_exchange_n(&m_owner, &expected, self, false, __ATOMIC_ACQUIRE,
+                                     __ATOMIC_RELAXED);
+}
+
+// Worth it only while the owner is on a CPU: it is about to release
+void Mutex::spin_on_owner() {
+  for (uint32_t i = 0; i < LOCK_OWNER_SPIN_LIMIT; ++i) {
+    Task* owner = __atomic_load_n(&m_owner, __ATOMIC_RELAXED);
+    if (!owner || !lock_owner_running(owner))
+      return;
+    asm volatile("pause");
+  }
+}
+
+void Mutex::lock() {
+  Task* self = lock_caller();
+  ASSERT(__atomic_load_n(&m_owner, __ATOMIC_RELAXED) != self);
+  if (try_acquire(self))
+    return;
+
+  if (self == BOOT_LOCK_OWNER) {
+    while (!try_acquire(self))
+      asm volatile("pause");
+    return;
+  }
+
+  spin_on_owner();
+  if (try_acquire(self))
+    return;
+
+  LockWaiter waiter;
+  waiter.task = self;
+  {
+    fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+    if (try_acquire(self))
+      return;
+    m_waiters.append(waiter);
+    lock_owner_blocks(m_owner, self);
+  }
+  // unlock() stores us as the owner before granting
+  lock_wait_for_grant(m_wait_lock, waiter);
+}
+
+bool Mutex::try_lock() {
+  return try_acquire(lock_caller());
+}
+
+void Mutex::unlock() {
+  fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+  lock_owner_releases(m_owner);
+  LockWaiter* next = m_waiters.first();
+  if (!next) {
+    __atomic_store_n(&m_owner, nullptr, __ATOMIC_RELEASE);
+    return;
+  }
+  m_waiters.remove(next);
+  __atomic_store_n(&m_owner, next->task, __ATOMIC_RELEASE);
+  lock_grant(*next);
+}
+
+bool Mutex::is_locked_by_current() const {
+  return __atomic_load_n(&m_owner, __ATOMIC_RELAXED) == lock_caller();
+}
+
+} // namespace fkernel
@@ -0,0 +1,111 @@
+#include <Kernel/Scheduler/rw_semaphore.h>
+#include <LibFK/Core/assertions.h>
+
+namespace fkernel {
+
+// Queued waiters go first, so a newcomer never overtakes them
+bool RwSemaphore::try_acquire_locked(bool writer, Task* self) {
+  if (m_writer || !m_waiters.is_empty())
+    return false;
+  if (!writer) {
+    ++m_readers;
+    return true;
+  }
+  if (m_readers)
+    return false;
+  m_writer = self;
+  return true;
+}
+
+void RwSemaphore::spin_on_writer() {
+  for (uint32_t i = 0; i < LOCK_OWNER_SPIN_LIMIT; ++i) {
+    Task* writer = __atomic_load_n(&m_writer, __ATOMIC_RELAXED);
+    if (!writer || !lock_owner_running(writer))
+      return;
+    asm volatile("pause");
+  }
+}
+
+void RwSemaphore::lock(bool writer) {
+  Task* self = lock_caller();
+  ASSERT(__atomic_load_n(&m_writer, __ATOMIC_RELAXED) != self);
+
+  if (self == BOOT_LOCK_OWNER) {
+    for (;;) {
+      {
+        fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+        if (try_acquire_locked(writer, self))
+          return;
+      }
+      asm volatile("pause");
+    }
+  }
+
+  spin_on_writer();
+
+  LockWaiter waiter;
+  waiter.task = self;
+  waiter.writer = writer;
+  {
+    fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+    if (try_acquire_locked(writer, self))
+      return;
+    m_waiters.append(waiter);
+    lock_owner_blocks(m_writer, self);
+  }
+  lock_wait_for_grant(m_wait_lock, waiter);
+}
+
+void RwSemaphore::lock_read() {
+  lock(false);
+}
+
+bool RwSemaphore::try_lock_read() {
+  fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+  return try_acquire_locked(false, lock_caller());
+}
+
+void RwSemaphore::unlock_read() {
+  fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+  ASSERT(m_readers > 0);
+  if (--m_readers == 0)
+    grant_waiters_locked();
+}
+
+void RwSemaphore::lock_write() {
+  lock(true);
+}
+
+bool RwSemaphore::try_lock_write() {
+  fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+  return try_acquire_locked(true, lock_caller());
+}
+
+void RwSemaphore::unlock_write() {
+  fk::synchronization::ScopedLockIRQ guard(m_wait_lock);
+  lock_owner_releases(m_writer);
+  __atomic_store_n(&m_writer, nullptr, __ATOMIC_RELAXED);
+  grant_waiters_locked();
+}
+
+// Hands the semaphore to the head of the queue: one writer, or every reader
+// up to the next queued writer
+void RwSemaphore::grant_waiters_locked() {
+  while (LockWaiter* next = m_waiters.first()) {
+    if (m_writer)
+      return;
+    if (next->writer) {
+      if (m_readers)
+        return;
+      m_waiters.remove(next);
+      __atomic_store_n(&m_writer, next->task, __ATOMIC_RELAXED);
+      lock_grant(*next);
+      return;
+    }
+    m_waiters.remove(next);
+    ++m_readers;
+    lock_grant(*next);
+  }
+}
+
+} // namespace fkernel
@@ -0,0 +1,71 @@
+#include <Kernel/Scheduler/scheduler.h>
+#include <LibFK/Algorithms/log.h>
+#include <LibFK/Synchronization/interrupt_disabler.h>
+#include <LibFK/Synchronization/spinlock.h>
+
+using namespace fk::synchronization;
+
+void SchedulerManager::block_current() {
+  ScopedInterruptDisabler intr_disabler;
+  auto& proc = current_processor();
+  if (!proc.current_task) return;
+
+  Task* task = proc.current_task;
+  if (task->control.lifecycle.in_wait_queue) return;
+
+  task->control.lifecycle.state = TaskState::Blocked;
+  fk::algorithms::kdebug("SCHEDULER", "Task %lu blocked", task->control.identity.id.value());
+  {
+    ScopedLock lock(m_lock);
+    task->control.lifecycle.in_wait_queue = true;
+    m_wait_queue.push_back(task);
+  }
+  proc.need_resched = true;
+}
+
+void SchedulerManager::block_current_noqueue() {
+  ScopedInterruptDisabler intr_disabler;
+  auto& proc = current_processor();
+  if (!proc.current_task) return;
+
+  Task* task = proc.current_task;
+  task->control.lifecycle.state = TaskState::Blocked;
+  fk::algorithms::kdebug("SCHEDULER", "Task %lu blocked (ipc)", task->control.identity.id.value());
+  proc.need_resched = true;
+}
+
+void SchedulerManager::wake_task(Task* task) {
+  if (!task || !task->is_valid()) return;
+  ScopedInterruptDisabler intr_disabler;
+  {
+    ScopedLock lock(m_lock);
+    TaskState state = task->control.lifecycle.state;
+    if (state == TaskState::Ready || state == TaskState::Running)
+      return;
+    if (state == TaskState::Blocked && task->control.lifecycle.in_wait_queue) {
+      m_wait_queue.remove(task);
+      task->control.lifecycle.in_wait_queue = false;
+    } else if (state == TaskState::Sleeping) {
+      m_sleep_queue.remove(task);
+    }
+  }
+
+  task->control.lifecycle.state = TaskState::Ready;
+  task->control.lifecycle.time_slice_ticks = m_default_quantum;
+  fk::algorithms::kdebug("SCHEDULER", "Task %lu woken", task->control.identity.id.value());
+
+  uint32_t target_cpu = 0;
+  for (uint32_t i = 0; i < 32; ++i) {
+    if (task->control.lifecycle.cpu_affinity & (1ULL << i)) {
+      target_cpu = i;
+      break;
+    }
+  }
+  if (target_cpu >= m_processor_count)
+    target_cpu = 0;
+
+  {
+    ScopedLock lock(m_processors[target_cpu].run_queue_lock);
+    m_processors[target_cpu].run_queue.push_back(task);
+  }
+}
@@ -2,6 +2,7 @@
 #include <Kernel/Arch/x86_64/Interrupt/interrupt_controller.h>
 #include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
 #include <Kernel/Fs/TimerFd/timer_fd_registry.h>
+#include <Kernel/Net/Tcp/tcp_timer_registry.h>
 #include <Kernel/Ipc/signal_delivery.h>
 #include <Kernel/Posix/signal_defs.h>
 #include <Kernel/Memory/UserAccess/user_access.h>
@@ -20,35 +21,6 @@ struct PosixTimerEntry { bool used; int signo; uint64_t interval_ticks;
 extern PosixTimerEntry s_timers[];
 static constexpr int POSIX_TIMER_MAX = 8;
 
-void SchedulerManager::block_current() {
-  ScopedInterruptDisabler intr_disabler;
-  auto& proc = current_processor();
-  if (!proc.current_task) return;
-
-  Task* task = proc.current_task;
-  if (task->control.lifecycle.in_wait_queue) return;
-
-  task->control.lifecycle.state = TaskState::Blocked;
-  fk::algorithms::kdebug("SCHEDULER", "Task %lu blocked", task->control.identity.id.value());
-  {
-    ScopedLock lock(m_lock);
-    task->control.lifecycle.in_wait_queue = true;
-    m_wait_queue.push_back(task);
-  }
-  proc.need_resched = true;
-}
-
-void SchedulerManager::block_current_noqueue() {
-  ScopedInterruptDisabler intr_disabler;
-  auto& proc = current_processor();
-  if (!proc.current_task) return;
-
-  Task* task = proc.current_task;
-  task->control.lifecycle.state = TaskState::Blocked;
-  fk::algorithms::kdebug("SCHEDULER", "Task %lu blocked (ipc)", task->control.identity.id.value());
-  proc.need_resched = true;
-}
-
 void SchedulerManager::zombify_current() {
   ScopedInterruptDisabler intr_disabler;
   auto& proc = current_processor();
@@ -94,42 +66,6 @@ void SchedulerManager::reap_zombie(Task* task) {
   task->unref(); // drop scheduler's reference; deletes if no RefPtr holders remain
 }
 
-void SchedulerManager::wake_task(Task* task) {
-  if (!task || !task->is_valid()) return;
-  ScopedInterruptDisabler intr_disabler;
-  {
-    ScopedLock lock(m_lock);
-    TaskState state = task->control.lifecycle.state;
-    if (state == TaskState::Ready || state == TaskState::Running)
-      return;
-    if (state == TaskState::Blocked && task->control.lifecycle.in_wait_queue) {
-      m_wait_queue.remove(task);
-      task->control.lifecycle.in_wait_queue = false;
-    } else if (state == TaskState::Sleeping) {
-      m_sleep_queue.remove(task);
-    }
-  }
-
-  task->control.lifecycle.state = TaskState::Ready;
-  task->control.lifecycle.time_slice_ticks = m_default_quantum;
-  fk::algorithms::kdebug("SCHEDULER", "Task %lu woken", task->control.identity.id.value());
-
-  uint32_t target_cpu = 0;
-  for (uint32_t i = 0; i < 32; ++i) {
-    if (task->control.lifecycle.cpu_affinity & (1ULL << i)) {
-      target_cpu = i;
-      break;
-    }
-  }
-  if (target_cpu >= m_processor_count)
-    target_cpu = 0;
-
-  {
-    ScopedLock lock(m_processors[target_cpu].run_queue_lock);
-    m_processors[target_cpu].run_queue.push_back(task);
-  }
-}
-
 void SchedulerManager::terminate_current(int status) {
   Task* curr = this->current();
   if (!curr) return;
@@ -270,6 +206,7 @@ void SchedulerManager::on_tick() {
   }
 
   fkernel::timer_fd_registry::tick_all(now, TickManager::the().get_frequency());
+  fkernel::net::tcp_timer_registry::tick_all(now);
 
   bool is_run_queue_empty = false;
   {
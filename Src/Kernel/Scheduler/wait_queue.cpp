@@ -0,0 +1,57 @@
+#include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Scheduler/wait_queue.h>
+
+namespace fkernel {
+
+void WaitQueue::prepare_to_wait(WaitQueueEntry& entry) {
+  auto& scheduler = SchedulerManager::the();
+  entry.task = scheduler.current();
+  // With a signal pending finish_wait() returns straight away
+  if (entry.task->has_pending_signals())
+    return;
+
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  m_waiters.append(entry);
+  entry.queued = true;
+  // Marked blocked with the entry queued, so a wake from here on is not lost.
+  // The scheduler's wait list keeps the sleeper visible to kill, process
+  // group signals and wait4.
+  scheduler.block_current();
+}
+
+fk::core::Result<void, fk::core::Error> WaitQueue::finish_wait(WaitQueueEntry& entry) {
+  if (entry.queued)
+    SchedulerManager::the().schedule();
+
+  {
+    fk::synchronization::ScopedLockIRQ lock(m_lock);
+    if (entry.queued) {
+      m_waiters.remove(entry);
+      entry.queued = false;
+    }
+  }
+  if (entry.task->has_pending_signals())
+    return fk::core::Error::Interrupted;
+  return {};
+}
+
+void WaitQueue::wake_one() {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  WaitQueueEntry* entry = m_waiters.first();
+  if (!entry)
+    return;
+  m_waiters.remove(*entry);
+  entry->queued = false;
+  SchedulerManager::the().wake_task(entry->task);
+}
+
+void WaitQueue::wake_all() {
+  fk::synchronization::ScopedLockIRQ lock(m_lock);
+  while (WaitQueueEntry* entry = m_waiters.first()) {
+    m_waiters.remove(*entry);
+    entry->queued = false;
+    SchedulerManager::the().wake_task(entry->task);
+  }
+}
+
+} // namespace fkernel
@@ -1,9 +1,11 @@
-#include <Kernel/Fs/DebugFs/debug_fs.h>
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
 #include <Kernel/Hardware/Cpu/cpu_block.h>
 #include <Kernel/Ipc/signal_delivery.h>
 #include <Kernel/Memory/memory_manager.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall.h>
+#include <Kernel/Syscall/syscall_stats.h>
+#include <Kernel/Trace/tracer.h>
 #include <LibFK/Algorithms/log.h>
 #ifdef __x86_64__
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
@@ -407,33 +409,15 @@ extern "C" uint64_t syscall_dispatcher(uint64_t num, uint64_t arg1, uint64_t arg
                                        uint64_t arg4, uint64_t arg5, uint64_t arg6, PtRegs* regs) {
   auto* task = SchedulerManager::the().current();
 
-  // Log BEFORE handle() so blocking syscalls that never return are visible in dmesg
-  if (MemoryManager::the().is_heap_initialized()) {
-    char enter_buf[512];
-    int enter_len =
-        snprintf(enter_buf, sizeof(enter_buf),
-                 "[SYSCALL >] Task %lu (%s): %lu (args: %p, %p, %p, %p, %p, %p)\n",
-                 task ? task->control.identity.id.value() : 0,
-                 task ? task->control.identity.name.c_str() : "unknown", num, (void*)arg1,
-                 (void*)arg2, (void*)arg3, (void*)arg4, (void*)arg5, (void*)arg6);
-    auto syscall_log = fkernel::SyscallLogNode::the();
-    if (syscall_log)
-      syscall_log->append(enter_buf, enter_len);
-  }
+  // Trace entry before handle() so blocking syscalls that never return are visible
+  fkernel::trace::tracepoint(fkernel::trace::TraceEventId::SyscallEnter, num, arg1, arg2, arg3,
+                             arg4, arg5);
 
+  uint64_t start = arch_read_tsc();
   uint64_t result = SyscallManager::the().handle(num, arg1, arg2, arg3, arg4, arg5, arg6, regs);
+  fkernel::SyscallStats::the().record(num, result, arch_read_tsc() - start);
 
-  if (MemoryManager::the().is_heap_initialized()) {
-    char exit_buf[128];
-    int exit_len =
-        snprintf(exit_buf, sizeof(exit_buf),
-                 "[SYSCALL <] Task %lu (%s): %lu -> %p\n",
-                 task ? task->control.identity.id.value() : 0,
-                 task ? task->control.identity.name.c_str() : "unknown", num, (void*)result);
-    auto syscall_log = fkernel::SyscallLogNode::the();
-    if (syscall_log)
-      syscall_log->append(exit_buf, exit_len);
-  }
+  fkernel::trace::tracepoint(fkernel::trace::TraceEventId::SyscallExit, num, result);
 
   if (task && !task->is_a_kernel_task()) {
     // PtRegs.rax holds the syscall NUMBER at entry (not the return value). Update it now so
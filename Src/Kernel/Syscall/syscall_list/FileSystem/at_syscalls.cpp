@@ -45,11 +45,8 @@ uint64_t sys_openat(uint64_t dirfd_u, uint64_t path_ptr, uint64_t flags,
     auto res = VirtualFileSystem::the().open(resolved, (int)flags);
     if (res.is_error()) return return_error(res.error());
 
-    int fd = task->add_file_descriptor(res.value());
-    if (fd < 0) return (uint64_t)fd;
-
-    if (flags & 02000000) res.value()->set_cloexec(true); // O_CLOEXEC
-    return (uint64_t)fd;
+    bool cloexec = (flags & 02000000) != 0; // O_CLOEXEC
+    return (uint64_t)task->add_file_descriptor(res.value(), cloexec);
 }
 
 uint64_t sys_mkdirat(uint64_t dirfd_u, uint64_t path_ptr, uint64_t mode,
@@ -15,16 +15,9 @@ uint64_t sys_close(uint64_t fd_u64, uint64_t, uint64_t, uint64_t, uint64_t, uint
   if (!current_task)
     return -1;
 
-  if (fd < 0 || fd >= (int)current_task->resources.files.descriptors.size())
-    return -static_cast<int>(fk::core::Error::InvalidHandle);
-
-  if (!current_task->resources.files.descriptors[fd]) {
+  int res = current_task->close_file_descriptor(fd);
+  if (res < 0)
     fk::algorithms::kwarn("SYSCALL", "sys_close: fd %d not open", fd);
-    return -static_cast<int>(fk::core::Error::InvalidHandle);
-  }
-
-  auto desc = current_task->resources.files.descriptors[fd];
-  current_task->resources.files.descriptors[fd] = nullptr;
-  return 0;
+  return res;
 }
 }
\ No newline at end of file
@@ -10,16 +10,7 @@ uint64_t sys_dup(uint64_t oldfd_u64, uint64_t, uint64_t, uint64_t,
   int oldfd = (int)oldfd_u64;
   auto* current = SchedulerManager::the().current();
   if (!current) return (uint64_t)-1;
-  auto desc = current->get_file_descriptor(oldfd);
-  if (!desc) return -static_cast<int>(fk::core::Error::InvalidHandle);
-  auto& fds = current->resources.files.descriptors;
-  for (size_t i = 0; i < fds.size(); ++i) {
-    if (!fds[i]) {
-      fds[i] = desc;
-      return (uint64_t)i;
-    }
-  }
-  return -static_cast<int>(fk::core::Error::OutOfMemory);
+  return (uint64_t)current->dup_file_descriptor(oldfd);
 }
 
 uint64_t sys_dup2(uint64_t oldfd_u64, uint64_t newfd_u64, uint64_t, uint64_t,
@@ -35,9 +26,6 @@ uint64_t sys_dup2(uint64_t oldfd_u64, uint64_t newfd_u64, uint64_t, uint64_t,
 
     if (oldfd == newfd) return newfd;
 
-    if (newfd < 0 || newfd >= static_cast<int>(MAX_OPEN_FILES)) return -static_cast<int>(fk::core::Error::InvalidParameter);
-
-    current->resources.files.descriptors[newfd] = desc;
-    return newfd;
+    return (uint64_t)current->install_file_descriptor(newfd, desc, false);
 }
 }
\ No newline at end of file
@@ -13,20 +13,11 @@ uint64_t sys_dup3(uint64_t oldfd_u64, uint64_t newfd_u64, uint64_t flags,
     if (!task) return (uint64_t)-1;
 
     if (oldfd == newfd) return (uint64_t)-22; // EINVAL — dup3 requires oldfd != newfd
-    if (newfd < 0 || newfd >= static_cast<int>(MAX_OPEN_FILES)) return (uint64_t)-22;
-
     auto desc = task->get_file_descriptor(oldfd);
     if (!desc) return (uint64_t)-9; // EBADF
 
-    if (task->resources.files.descriptors[newfd])
-        task->close_file_descriptor(newfd);
-
-    task->resources.files.descriptors[newfd] = desc;
-
     bool cloexec = (flags & 02000000) != 0; // O_CLOEXEC
-    desc->set_cloexec(cloexec);
-
-    return (uint64_t)newfd;
+    return (uint64_t)task->install_file_descriptor(newfd, desc, cloexec);
 }
 
 }
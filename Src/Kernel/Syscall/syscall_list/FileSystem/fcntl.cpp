@@ -44,14 +44,17 @@ uint64_t sys_fcntl(uint64_t fd, uint64_t cmd, uint64_t arg,
     case F_DUPFD_CLOEXEC:
         return (uint64_t)task->dup_file_descriptor((int)fd, true, (int)arg);
     case F_GETFD: {
-        auto desc = task->get_file_descriptor((int)fd);
-        if (!desc) return fkernel::return_error(fk::core::Error::InvalidHandle);
-        return desc->is_cloexec() ? FD_CLOEXEC : 0;
+        auto table = task->file_table();
+        if (!table) return fkernel::return_error(fk::core::Error::OutOfMemory);
+        auto cloexec = table->is_cloexec((int)fd);
+        if (cloexec.is_error()) return fkernel::return_error(cloexec.error());
+        return cloexec.value() ? FD_CLOEXEC : 0;
     }
     case F_SETFD: {
-        auto desc = task->get_file_descriptor((int)fd);
-        if (!desc) return fkernel::return_error(fk::core::Error::InvalidHandle);
-        desc->set_cloexec(arg & FD_CLOEXEC);
+        auto table = task->file_table();
+        if (!table) return fkernel::return_error(fk::core::Error::OutOfMemory);
+        auto res = table->set_cloexec((int)fd, arg & FD_CLOEXEC);
+        if (res.is_error()) return fkernel::return_error(res.error());
         return 0;
     }
     case F_GETFL: {
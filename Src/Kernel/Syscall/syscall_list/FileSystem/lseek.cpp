@@ -15,10 +15,7 @@ uint64_t sys_lseek(uint64_t fd_u64, uint64_t offset, uint64_t whence,
   if (!current_task)
     return -1;
 
-  if (fd < 0 || fd >= (int)current_task->resources.files.descriptors.size())
-    return -static_cast<int>(fk::core::Error::InvalidHandle);
-
-  auto &desc = current_task->resources.files.descriptors[fd];
+  auto desc = current_task->get_file_descriptor(fd);
   if (!desc) {
     return -static_cast<int>(fk::core::Error::InvalidHandle);
   }
@@ -78,11 +78,7 @@ uint64_t sys_open(uint64_t path_ptr, uint64_t flags, uint64_t, uint64_t,
     return fkernel::return_error(result.error());
   }
 
-  int fd = current_task->add_file_descriptor(result.value());
-  if (fd < 0) {
-      return fkernel::return_error(fk::core::Error::DeviceError); // EMFILE
-  }
-
-  return fd;
+  bool cloexec = (flags & 02000000) != 0; // O_CLOEXEC
+  return (uint64_t)current_task->add_file_descriptor(result.value(), cloexec);
 }
 }
\ No newline at end of file
@@ -26,12 +26,11 @@ uint64_t sys_pipe2(uint64_t pipefd_ptr, uint64_t flags, uint64_t, uint64_t, uint
 
     auto read_desc  = fk::make_ref<FileDescription>(dentry, O_RDONLY).value();
     auto write_desc = fk::make_ref<FileDescription>(dentry, O_WRONLY).value();
-    if (cloexec) { read_desc->set_cloexec(true); write_desc->set_cloexec(true); }
     pipe_res.value()->add_reader();
 
-    int fd_r = task->add_file_descriptor(read_desc);
+    int fd_r = task->add_file_descriptor(read_desc, cloexec);
     if (fd_r < 0) return (uint64_t)fd_r;
-    int fd_w = task->add_file_descriptor(write_desc);
+    int fd_w = task->add_file_descriptor(write_desc, cloexec);
     if (fd_w < 0) { task->close_file_descriptor(fd_r); return (uint64_t)fd_w; }
 
     int* user_fds = reinterpret_cast<int*>(pipefd_ptr);
@@ -39,10 +39,7 @@ uint64_t sys_poll(uint64_t fds_ptr, uint64_t nfds_u64, uint64_t timeout_raw,
       pfds[i].revents = 0;
       int fd = pfds[i].fd;
       if (fd < 0) { pfds[i].revents = POLLNVAL; ready++; continue; }
-      if (static_cast<size_t>(fd) >= task->resources.files.descriptors.size()) {
-        pfds[i].revents = POLLNVAL; ready++; continue;
-      }
-      auto& desc = task->resources.files.descriptors[fd];
+      auto desc = task->get_file_descriptor(fd);
       if (!desc) { pfds[i].revents = POLLNVAL; ready++; continue; }
       auto node = desc->node();
       if (!node) { pfds[i].revents = POLLHUP; ready++; continue; }
@@ -3,6 +3,7 @@
 #include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Syscall/syscall_utils.h>
+#include <Kernel/Loader/elf_image_cache.h>
 
 extern "C" uint64_t sys_pread64(uint64_t fd, uint64_t buf_ptr, uint64_t count,
                                  uint64_t offset, uint64_t, uint64_t, [[maybe_unused]] PtRegs* regs) {
@@ -32,6 +33,8 @@ extern "C" uint64_t sys_pwrite64(uint64_t fd, uint64_t buf_ptr, uint64_t count,
     if (!node) return (uint64_t)-9;
 
     auto res = node->write(offset, (size_t)count, reinterpret_cast<const uint8_t*>(buf_ptr));
+    // Once the bytes are in place; see FileDescription::write()
+    fkernel::ElfImageCache::the().invalidate(*node);
     if (res.is_error()) return fkernel::return_error(res.error());
     return (uint64_t)res.value();
 }
@@ -35,9 +35,7 @@ static int check_ready(Task* task, int nfds, const fd_set* in_read, const fd_set
     bool want_r = in_read && FD_ISSET(fd, in_read);
     bool want_w = in_write && FD_ISSET(fd, in_write);
     if (!want_r && !want_w) continue;
-    if (static_cast<size_t>(fd) >= task->resources.files.descriptors.size()) continue;
-
-    auto& desc = task->resources.files.descriptors[fd];
+    auto desc = task->get_file_descriptor(fd);
     if (!desc) continue;
     auto node = desc->node();
     if (!node) continue;
@@ -2,6 +2,7 @@
 #include <Kernel/Fs/Vfs/virtual_filesystem.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall.h>
+#include <Kernel/Loader/elf_image_cache.h>
 #include <LibFK/Core/error.h>
 #include <LibFK/Types/types.h>
 
@@ -27,10 +28,7 @@ uint64_t sys_ftruncate(uint64_t fd_u64, uint64_t length, uint64_t,
   if (!current_task)
     return -1;
 
-  if (fd < 0 || fd >= (int)current_task->resources.files.descriptors.size())
-    return -static_cast<int>(fk::core::Error::InvalidHandle);
-
-  auto& desc = current_task->resources.files.descriptors[fd];
+  auto desc = current_task->get_file_descriptor(fd);
   if (!desc)
     return -static_cast<int>(fk::core::Error::InvalidHandle);
 
@@ -39,6 +37,7 @@ uint64_t sys_ftruncate(uint64_t fd_u64, uint64_t length, uint64_t,
     return -static_cast<int>(fk::core::Error::InvalidHandle);
 
   auto res = node->truncate(length);
+  fkernel::ElfImageCache::the().invalidate(*node);
   if (res.is_error())
     return -static_cast<int>(res.error());
 
@@ -2,6 +2,7 @@
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Syscall/syscall_utils.h>
+#include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <LibFK/Algorithms/log.h>
 
@@ -18,8 +19,25 @@ uint64_t sys_brk(uint64_t brk_addr, uint64_t, uint64_t, uint64_t, uint64_t,
       return task->memory().regions.heap_break;
   }
 
-  // Just update the break. Demand paging will map the pages on fault.
-  task->memory().regions.heap_break = brk_addr;
-  return task->memory().regions.heap_break;
+  auto& regions = task->memory().regions;
+  auto& vmas = task->memory().vmas;
+  uintptr_t old_end = (regions.heap_break + 0xFFF) & ~0xFFFULL;
+  uintptr_t new_end = (brk_addr + 0xFFF) & ~0xFFFULL;
+
+  if (vmas && new_end > old_end) {
+    // Grow the [heap] VMA; demand paging maps the pages on fault
+    auto res = vmas->resize(regions.heap_start, new_end);
+    if (res.is_error() && res.error() == fk::core::Error::NotFound) {
+      PageFlags flags = PageFlags::Present | PageFlags::Writable | PageFlags::User |
+                        PageFlags::ExecuteDisable;
+      res = vmas->insert(regions.heap_start, new_end, flags, fkernel::VmaKind::Heap, "[heap]");
+    }
+    if (res.is_error()) return regions.heap_break;
+  } else if (new_end < old_end) {
+    VirtualMemoryManager::the().munmap(new_end, old_end - new_end);
+  }
+
+  regions.heap_break = brk_addr;
+  return regions.heap_break;
 }
 }
@@ -1,9 +1,25 @@
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
+#include <Kernel/Memory/VirtualMemory/transparent_huge_pages.h>
+#include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall.h>
+#include <Kernel/Syscall/syscall_utils.h>
 
-// madvise — performance hints; safe to ignore in FKernel
-extern "C" uint64_t sys_madvise(uint64_t, uint64_t, uint64_t,
+// madvise — performance hints; only the huge page advice changes behaviour
+extern "C" uint64_t sys_madvise(uint64_t addr, uint64_t length, uint64_t advice,
                                  uint64_t, uint64_t, uint64_t,
                                  [[maybe_unused]] PtRegs* regs) {
+  if (advice != fkernel::MADV_HUGEPAGE && advice != fkernel::MADV_NOHUGEPAGE)
+    return 0;
+  if ((addr & 0xFFF) != 0)
+    return fkernel::return_error(fk::core::Error::InvalidParameter);
+
+  auto* task = SchedulerManager::the().current();
+  if (!task) return fkernel::return_error(fk::core::Error::PermissionDenied);
+
+  uintptr_t end = (addr + length + 0xFFF) & ~0xFFFULL;
+  if (end <= addr) return 0;
+  auto res = fkernel::TransparentHugePages::the().advise(task, addr, end,
+                                                        advice == fkernel::MADV_HUGEPAGE);
+  if (res.is_error()) return fkernel::return_error(res.error());
   return 0;
 }
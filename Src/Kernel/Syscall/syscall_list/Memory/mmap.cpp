@@ -6,6 +6,10 @@
 #include <Kernel/Memory/VirtualMemory/virtual_memory_manager.h>
 #include <Kernel/Memory/PhysicalMemory/physical_memory_manager.h>
 #include <Kernel/Memory/VirtualMemory/Pages/page_flags.h>
+#include <Kernel/Memory/VirtualMemory/file_page_cache.h>
+#include <Kernel/Memory/VirtualMemory/transparent_huge_pages.h>
+#include <Kernel/Memory/VirtualMemory/vma_tree.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Fs/Vfs/file_description.h>
 #include <Kernel/Fs/Vfs/node.h>
 #include <LibFK/Algorithms/log.h>
@@ -13,12 +17,52 @@
 
 static constexpr uint64_t PROT_WRITE = 0x2;
 static constexpr uint64_t PROT_EXEC  = 0x4;
+static constexpr uint64_t MAP_FIXED     = 0x10;
 static constexpr uint64_t MAP_ANONYMOUS = 0x20;
 
-static uintptr_t reserve_mmap_range(Task* task, uintptr_t hint, uint64_t len) {
-    if (hint != 0) return hint;
-    uintptr_t addr = task->memory().regions.mmap_end;
-    task->memory().regions.mmap_end += (len + 0xFFF) & ~0xFFFULL;
+// Picks the range for a new mapping and records it in the task's VMA tree.
+// A free, page-aligned hint is taken as is; MAP_FIXED replaces whatever is
+// there; otherwise the lowest hole in the mmap window wins. With a file the
+// range is recorded as a file-backed mapping of it starting at file_offset.
+static fk::core::Result<uintptr_t, fk::core::Error>
+reserve_mmap_range(Task* task, uintptr_t hint, uint64_t len, uint64_t map_flags,
+                   PageFlags pg_flags, const char* name = "",
+                   fk::RefPtr<Node> file = {}, uint64_t file_offset = 0) {
+    auto& vmas = task->memory().vmas;
+    if (!vmas) return fk::core::Error::PermissionDenied;
+    uint64_t size = (len + 0xFFF) & ~0xFFFULL;
+    if (size == 0) return fk::core::Error::InvalidParameter;
+
+    bool hint_usable = hint && !(hint & 0xFFF) && fkernel::memory::is_user_address(hint, size);
+    if (map_flags & MAP_FIXED) {
+        if (!hint_usable) return fk::core::Error::InvalidParameter;
+        auto unmap_res = VirtualMemoryManager::the().munmap(hint, size);
+        if (unmap_res.is_error()) return unmap_res.error();
+    } else if (hint_usable && !vmas->is_range_free(hint, hint + size)) {
+        hint_usable = false;
+    }
+
+    uintptr_t addr = hint;
+    if (!hint_usable) {
+        // Large mappings start on a 2 MiB boundary so they can use huge pages
+        size_t alignment = size >= PAGE_SIZE_2M ? PAGE_SIZE_2M : PAGE_SIZE;
+        auto range = vmas->find_free_range(size, alignment, fkernel::USER_MMAP_BASE,
+                                           fkernel::USER_MMAP_END);
+        if (range.is_error()) return range.error();
+        addr = range.value();
+    }
+
+    if (file) {
+        uint64_t available = file_offset < file->size() ? file->size() - file_offset : 0;
+        uintptr_t file_end = addr + (available < size ? available : size);
+        auto insert_res = vmas->insert_file(addr, addr + size, pg_flags, name, file,
+                                            file_offset, file_end);
+        if (insert_res.is_error()) return insert_res.error();
+        return addr;
+    }
+
+    auto insert_res = vmas->insert(addr, addr + size, pg_flags, fkernel::VmaKind::Anonymous, name);
+    if (insert_res.is_error()) return insert_res.error();
     return addr;
 }
 
@@ -30,22 +74,38 @@ static PageFlags prot_to_page_flags(uint64_t prot) {
 }
 
 static uint64_t mmap_file(Task* task, uintptr_t addr, uint64_t len, uint64_t prot,
-                           uint64_t fd, uint64_t offset) {
+                           uint64_t map_flags, uint64_t fd, uint64_t offset) {
     auto file = task->get_file_descriptor(static_cast<int>(fd));
     if (!file) {
         fk::algorithms::kwarn("sys_mmap", "invalid fd=%lu", fd);
         return fkernel::return_error(fk::core::Error::InvalidParameter);
     }
 
-    uintptr_t target = reserve_mmap_range(task, addr, len);
     PageFlags flags = prot_to_page_flags(prot);
+    fk::RefPtr<Node> node = file->node();
+
+    // Immutable files (the initrd) fault their pages in from the page cache,
+    // which maps the initrd's own frames where it can; writes copy the page
+    if (fkernel::FilePageCache::can_cache(*node) && !(offset & 0xFFF)) {
+        auto range = reserve_mmap_range(task, addr, len, map_flags, flags,
+                                        node->get_path().c_str(), node, offset);
+        if (range.is_error()) return fkernel::return_error(range.error());
+        return range.value();
+    }
+
+    auto range = reserve_mmap_range(task, addr, len, map_flags, flags,
+                                    node->get_path().c_str());
+    if (range.is_error()) return fkernel::return_error(range.error());
+    uintptr_t target = range.value();
     uint64_t pages = (len + 0xFFF) >> 12;
 
+    // Filled through the user mapping, which CR0.WP makes fault while it is
+    // read-only: map writable and drop to the requested protection after
     for (uint64_t i = 0; i < pages; ++i) {
         uintptr_t phys = PhysicalMemoryManager::the().alloc_page();
         if (!phys) return fkernel::return_error(fk::core::Error::OutOfMemory);
-        fk::memory::set(reinterpret_cast<void*>(phys + 0xFFFF800000000000ULL), 0, 4096);
-        VirtualMemoryManager::the().map_page(target + i * 4096, phys, flags);
+        VirtualMemoryManager::the().map_page(target + i * 4096, phys, flags | PageFlags::Writable);
+        fk::memory::set(reinterpret_cast<void*>(target + i * 4096), 0, 4096);
     }
 
     uint8_t* dest = reinterpret_cast<uint8_t*>(target);
@@ -56,13 +116,15 @@ static uint64_t mmap_file(Task* task, uintptr_t addr, uint64_t len, uint64_t pro
     while (done < remaining) {
         size_t chunk = remaining - done;
         if (chunk > 4096) chunk = 4096;
-        auto res = file->node()->read(file_offset + done, chunk, dest + done);
+        auto res = node->read(file_offset + done, chunk, dest + done);
         if (res.is_error()) break;
         size_t read = res.value();
         if (read == 0) break;
         done += read;
     }
 
+    if (!(flags & PageFlags::Writable))
+        VirtualMemoryManager::the().protect_range(target, target + pages * 4096, flags);
     return target;
 }
 
@@ -74,19 +136,32 @@ uint64_t sys_mmap(uint64_t addr, uint64_t len, uint64_t prot, uint64_t flags,
     if (!task) return fkernel::return_error(fk::core::Error::PermissionDenied);
 
     if (flags & MAP_ANONYMOUS) {
-        uintptr_t target_addr = reserve_mmap_range(task, addr, len);
         PageFlags pg_flags = prot_to_page_flags(prot);
-        uint64_t pages = (len + 0xFFF) >> 12;
-        for (uint64_t i = 0; i < pages; ++i) {
+        auto range = reserve_mmap_range(task, addr, len, flags, pg_flags);
+        if (range.is_error()) return fkernel::return_error(range.error());
+        uintptr_t target_addr = range.value();
+        uint64_t size = (len + 0xFFF) & ~0xFFFULL;
+        for (uint64_t off = 0; off < size;) {
+            uintptr_t vaddr = target_addr + off;
+            if ((vaddr & (PAGE_SIZE_2M - 1)) == 0 &&
+                fkernel::TransparentHugePages::the().try_map(task, vaddr, target_addr,
+                                                             target_addr + size, pg_flags)) {
+                off += PAGE_SIZE_2M;
+                continue;
+            }
             uintptr_t phys = PhysicalMemoryManager::the().alloc_page();
             if (!phys) return fkernel::return_error(fk::core::Error::OutOfMemory);
-            VirtualMemoryManager::the().map_page(target_addr + i * 4096, phys, pg_flags);
-            fk::memory::set(reinterpret_cast<void*>(target_addr + i * 4096), 0, 4096);
+            // Zeroed through the user mapping, so writable until it is clear
+            VirtualMemoryManager::the().map_page(vaddr, phys, pg_flags | PageFlags::Writable);
+            fk::memory::set(reinterpret_cast<void*>(vaddr), 0, 4096);
+            if (!(pg_flags & PageFlags::Writable))
+                VirtualMemoryManager::the().protect_page(vaddr, pg_flags);
+            off += 4096;
         }
         return target_addr;
     }
 
-    return mmap_file(task, addr, len, prot, fd, offset);
+    return mmap_file(task, addr, len, prot, flags, fd, offset);
 }
 
 uint64_t sys_munmap(uint64_t addr, uint64_t length, [[maybe_unused]] uint64_t, uint64_t, uint64_t, uint64_t, PtRegs*) {
@@ -107,13 +182,15 @@ uint64_t sys_mremap(uint64_t old_addr, uint64_t old_size, uint64_t new_size,
     if (!task) return (uint64_t)-12;
 
     (void)flags; (void)new_addr_hint;
-    uintptr_t new_region = reserve_mmap_range(task, 0, new_size);
+    PageFlags pg_flags = PageFlags::Present | PageFlags::Writable | PageFlags::User;
+    auto range = reserve_mmap_range(task, 0, new_size, 0, pg_flags);
+    if (range.is_error()) return fkernel::return_error(range.error());
+    uintptr_t new_region = range.value();
     uint64_t new_pages = (new_size + 0xFFF) >> 12;
     for (uint64_t i = 0; i < new_pages; ++i) {
         uintptr_t phys = PhysicalMemoryManager::the().alloc_page();
         if (!phys) return (uint64_t)-12;
-        VirtualMemoryManager::the().map_page(new_region + i * 4096, phys,
-            PageFlags::Present | PageFlags::Writable | PageFlags::User);
+        VirtualMemoryManager::the().map_page(new_region + i * 4096, phys, pg_flags);
         fk::memory::set(reinterpret_cast<void*>(new_region + i * 4096), 0, 4096);
     }
     fk::memory::copy(reinterpret_cast<void*>(new_region),
@@ -16,8 +16,12 @@ extern "C" uint64_t sys_mprotect(uint64_t addr, uint64_t len, uint64_t prot,
     if (prot & 2) flags = flags | Writable;
     if (!(prot & 4)) flags = flags | ExecuteDisable;
 
-    auto& vmm = VirtualMemoryManager::the();
-    for (uint64_t page = addr; page < end; page += 4096)
-        vmm.protect_page(page, flags);
+    auto* task = SchedulerManager::the().current();
+    if (task && task->memory().vmas) {
+        auto res = task->memory().vmas->protect_range(addr, end, flags);
+        if (res.is_error()) return fkernel::return_error(res.error());
+    }
+
+    VirtualMemoryManager::the().protect_range(addr, end, flags);
     return 0;
 }
@@ -1,141 +1,120 @@
-#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Ipc/futex.h>
 #include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Syscall/syscall_utils.h>
-#include <LibFK/Synchronization/spinlock.h>
 
-// Simple futex wait table: fixed-size hash table mapping uaddr → waiting task.
-// Each bucket holds one waiter (chain collision via linear probe isn't needed
-// for typical musl usage patterns — contended mutexes rarely have >1 waiter).
-static constexpr size_t FUTEX_TABLE_SIZE = 64;
-
-struct FutexEntry {
-    uintptr_t uaddr{0};
-    Task*     task{nullptr};
-};
-
-static FutexEntry s_futex_table[FUTEX_TABLE_SIZE];
-static fk::synchronization::Spinlock s_futex_lock;
-
-static size_t futex_bucket(uintptr_t uaddr) {
-    return (uaddr >> 2) & (FUTEX_TABLE_SIZE - 1);
-}
-
-static void futex_register(uintptr_t uaddr, Task* task) {
-    size_t idx = futex_bucket(uaddr);
-    for (size_t i = 0; i < FUTEX_TABLE_SIZE; ++i) {
-        size_t slot = (idx + i) & (FUTEX_TABLE_SIZE - 1);
-        if (!s_futex_table[slot].task) {
-            s_futex_table[slot].uaddr = uaddr;
-            s_futex_table[slot].task  = task;
-            return;
-        }
-    }
-    // Table full — caller will fall back to yield
-}
-
-static void futex_unregister(Task* task) {
-    for (size_t i = 0; i < FUTEX_TABLE_SIZE; ++i) {
-        if (s_futex_table[i].task == task) {
-            s_futex_table[i].task  = nullptr;
-            s_futex_table[i].uaddr = 0;
-            return;
-        }
-    }
-}
-
-// Returns number of tasks woken.
-static uint32_t futex_wake(uintptr_t uaddr, uint32_t max_wake) {
-    uint32_t woken = 0;
-    size_t idx = futex_bucket(uaddr);
-    for (size_t i = 0; i < FUTEX_TABLE_SIZE && woken < max_wake; ++i) {
-        size_t slot = (idx + i) & (FUTEX_TABLE_SIZE - 1);
-        if (s_futex_table[slot].uaddr == uaddr && s_futex_table[slot].task) {
-            Task* t = s_futex_table[slot].task;
-            s_futex_table[slot].task  = nullptr;
-            s_futex_table[slot].uaddr = 0;
-            SchedulerManager::the().wake_task(t);
-            ++woken;
-        }
-    }
-    return woken;
-}
+using fkernel::ipc::FutexTable;
 
 // Called from thread exit to wake pthread_join waiters on clear_child_tid address
 extern "C" void fkernel_futex_wake_one(uintptr_t uaddr) {
-    fk::synchronization::ScopedLock lock(s_futex_lock);
-    futex_wake(uaddr, 1);
+    auto key = FutexTable::the().key_for(uaddr, false);
+    if (!key.is_error())
+        FutexTable::the().wake(key.value(), 1);
 }
 
-static constexpr int FUTEX_WAIT         = 0;
-static constexpr int FUTEX_WAKE         = 1;
-static constexpr int FUTEX_PRIVATE_FLAG = 128;
+static constexpr int FUTEX_WAIT           = 0;
+static constexpr int FUTEX_WAKE           = 1;
+static constexpr int FUTEX_REQUEUE        = 3;
+static constexpr int FUTEX_CMP_REQUEUE    = 4;
+static constexpr int FUTEX_WAIT_BITSET    = 9;
+static constexpr int FUTEX_WAKE_BITSET    = 10;
+static constexpr int FUTEX_PRIVATE_FLAG   = 128;
+static constexpr int FUTEX_CLOCK_REALTIME = 256;
+
+static constexpr uint64_t NS_PER_SEC = 1000000000ULL;
+
+// FUTEX_WAIT takes a relative timeout; FUTEX_WAIT_BITSET an absolute one on
+// CLOCK_MONOTONIC, or CLOCK_REALTIME with FUTEX_CLOCK_REALTIME. Either way
+// the result is a CLOCK_MONOTONIC deadline for FutexTable::wait().
+static fk::core::Result<uint64_t, fk::core::Error>
+futex_deadline(uint64_t timeout_ptr, bool absolute, bool realtime) {
+    if (!timeout_ptr)
+        return uint64_t{0};
+
+    struct { int64_t tv_sec; int64_t tv_nsec; } ts{};
+    if (fkernel::memory::copy_from_user(&ts, reinterpret_cast<const void*>(timeout_ptr),
+                                        sizeof(ts)).is_error())
+        return fk::core::Error::BadAddress;
+    if (ts.tv_sec < 0 || ts.tv_nsec < 0 || (uint64_t)ts.tv_nsec >= NS_PER_SEC)
+        return fk::core::Error::InvalidParameter;
+
+    auto& clock = TimeKeeper::the();
+    uint64_t now = clock.monotonic_ns();
+    constexpr uint64_t FOREVER = ~0ULL;
+    uint64_t ns = (uint64_t)ts.tv_sec >= FOREVER / NS_PER_SEC - 1
+                      ? FOREVER
+                      : (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+    uint64_t deadline;
+    if (!absolute) {
+        deadline = ns > FOREVER - now ? FOREVER : now + ns;
+    } else if (realtime) {
+        uint64_t realtime_now = clock.realtime_ns();
+        deadline = ns > realtime_now ? now + (ns - realtime_now) : now;
+    } else {
+        deadline = ns;
+    }
+    // 0 means "no timeout" to FutexTable::wait()
+    return deadline ? deadline : uint64_t{1};
+}
 
 extern "C" uint64_t sys_futex(uint64_t uaddr, uint64_t op, uint64_t val,
                                uint64_t timeout_ptr, uint64_t uaddr2, uint64_t val3,
                                [[maybe_unused]] PtRegs* regs) {
-    (void)uaddr2; (void)val3;
-    int cmd = (int)(op & ~FUTEX_PRIVATE_FLAG);
-
-    switch (cmd) {
-    case FUTEX_WAIT: {
-        if (!fkernel::memory::is_user_address(static_cast<uintptr_t>(uaddr), sizeof(int)))
-            return (uint64_t)-14; // EFAULT
+    auto& table = FutexTable::the();
+    bool is_private = op & FUTEX_PRIVATE_FLAG;
+    bool realtime = op & FUTEX_CLOCK_REALTIME;
+    int cmd = (int)(op & ~(FUTEX_PRIVATE_FLAG | FUTEX_CLOCK_REALTIME));
 
-        // Atomically check value and register waiter under lock
-        int cur_val = 0;
-        {
-            fk::synchronization::ScopedLockIRQ lock(s_futex_lock);
-            auto res = fkernel::memory::copy_from_user(&cur_val,
-                                                        reinterpret_cast<const void*>(uaddr),
-                                                        sizeof(int));
-            if (res.is_error()) return (uint64_t)-14;
-            if (cur_val != (int)val) return (uint64_t)-11; // EAGAIN
+    if (realtime && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET)
+        return (uint64_t)-38; // ENOSYS, as Linux does
 
-            futex_register((uintptr_t)uaddr, SchedulerManager::the().current());
-        }
+    auto key = table.key_for(uaddr, is_private);
+    if (key.is_error())
+        return fkernel::return_error(key.error());
 
-        // Compute timeout ticks
-        if (timeout_ptr) {
-            struct { int64_t tv_sec; int64_t tv_nsec; } ts{};
-            auto res = fkernel::memory::copy_from_user(&ts,
-                                                        reinterpret_cast<const void*>(timeout_ptr),
-                                                        sizeof(ts));
-            if (res.is_error()) {
-                fk::synchronization::ScopedLockIRQ lock(s_futex_lock);
-                futex_unregister(SchedulerManager::the().current());
-                return (uint64_t)-14;
-            }
-            uint32_t freq = TickManager::the().get_frequency();
-            if (freq == 0) freq = 1000;
-            uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
-            uint64_t ticks = (ns / 1000000ULL) * freq / 1000ULL;
-            if (ticks == 0) ticks = 1;
-            SchedulerManager::the().sleep_current(ticks);
-        } else {
-            SchedulerManager::the().block_current();
-            SchedulerManager::the().schedule();
-        }
-
-        // Clean up registration if we weren't woken by FUTEX_WAKE
-        {
-            fk::synchronization::ScopedLockIRQ lock(s_futex_lock);
-            futex_unregister(SchedulerManager::the().current());
-        }
+    switch (cmd) {
+    case FUTEX_WAIT:
+    case FUTEX_WAIT_BITSET: {
+        uint32_t bitset = cmd == FUTEX_WAIT ? fkernel::ipc::FUTEX_BITSET_MATCH_ANY : (uint32_t)val3;
+        if (!bitset)
+            return fkernel::return_error(fk::core::Error::InvalidParameter);
+        auto deadline = futex_deadline(timeout_ptr, cmd == FUTEX_WAIT_BITSET, realtime);
+        if (deadline.is_error())
+            return fkernel::return_error(deadline.error());
+        auto res = table.wait(key.value(), uaddr, (uint32_t)val, bitset, deadline.value());
+        if (res.is_error())
+            return fkernel::return_error(res.error());
+        return 0;
+    }
 
-        return (uint64_t)-4; // EINTR — caller re-checks the value
+    case FUTEX_WAKE:
+    case FUTEX_WAKE_BITSET: {
+        uint32_t bitset = cmd == FUTEX_WAKE ? fkernel::ipc::FUTEX_BITSET_MATCH_ANY : (uint32_t)val3;
+        if (!bitset)
+            return fkernel::return_error(fk::core::Error::InvalidParameter);
+        return table.wake(key.value(), (uint32_t)val, bitset);
     }
 
-    case FUTEX_WAKE: {
-        uint32_t count = (uint32_t)val;
-        fk::synchronization::ScopedLockIRQ lock(s_futex_lock);
-        uint32_t woken = futex_wake((uintptr_t)uaddr, count);
-        return (uint64_t)woken;
+    case FUTEX_REQUEUE:
+    case FUTEX_CMP_REQUEUE: {
+        // The fourth argument carries the requeue limit instead of a timeout
+        if ((int32_t)val < 0 || (int32_t)timeout_ptr < 0)
+            return fkernel::return_error(fk::core::Error::InvalidParameter);
+        auto target = table.key_for(uaddr2, is_private);
+        if (target.is_error())
+            return fkernel::return_error(target.error());
+        auto res = table.requeue(key.value(), target.value(), (uint32_t)val,
+                                 (uint32_t)timeout_ptr, cmd == FUTEX_CMP_REQUEUE, uaddr,
+                                 (uint32_t)val3);
+        if (res.is_error())
+            return fkernel::return_error(res.error());
+        return res.value();
     }
 
     default:
-        return 0;
+        return (uint64_t)-38; // ENOSYS
     }
 }
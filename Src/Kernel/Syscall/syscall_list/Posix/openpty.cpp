@@ -28,10 +28,10 @@ uint64_t sys_openpty(uint64_t master_ptr, uint64_t slave_ptr,
 
   uint32_t index = __sync_fetch_and_add(&s_pty_index, 1);
 
-  auto to_slave   = fk::make_ref<PtyBuffer>().value();
   auto to_master  = fk::make_ref<PtyBuffer>().value();
-  auto master_node = fk::make_ref<PtyMaster>(to_slave, to_master, index).value();
-  auto slave_node  = fk::make_ref<PtySlave>(to_slave, to_master, index).value();
+  auto ldisc      = fk::make_ref<PtyLineDiscipline>(to_master.get()).value();
+  auto master_node = fk::make_ref<PtyMaster>(ldisc, to_master, index).value();
+  auto slave_node  = fk::make_ref<PtySlave>(ldisc, to_master, index).value();
 
   auto pts_dir = get_pts_dir();
   if (pts_dir) pts_dir->register_slave(index, fk::RefPtr<Node>(slave_node.get()));
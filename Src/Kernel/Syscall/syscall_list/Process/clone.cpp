@@ -37,6 +37,20 @@ extern "C" uint64_t sys_clone(uint64_t flags, uint64_t child_stack,
     Task* child = new Task();
     if (!child) return fkernel::return_error(fk::core::Error::OutOfMemory);
 
+    // Threads share the mapping set; a plain clone copies it like fork()
+    if (flags & CLONE_VM) {
+        child->resources.memory.vmas = parent->resources.memory.vmas;
+    } else if (parent->resources.memory.vmas) {
+        auto vmas = parent->resources.memory.vmas->clone();
+        if (vmas.is_error()) { delete child; return fkernel::return_error(vmas.error()); }
+        child->resources.memory.vmas = vmas.value();
+    }
+    // CLONE_FILES threads share one table; otherwise the child gets a copy
+    if (auto files = child->inherit_files(*parent, flags & CLONE_FILES); files.is_error()) {
+        delete child;
+        return fkernel::return_error(files.error());
+    }
+
     child->control.identity.id   = SchedulerManager::the().generate_pid();
     child->control.identity.ppid = parent->control.identity.id;
     child->control.identity.name = parent->control.identity.name;
@@ -66,11 +80,6 @@ extern "C" uint64_t sys_clone(uint64_t flags, uint64_t child_stack,
             child->resources.ipc.signals.actions[i] = parent->resources.ipc.signals.actions[i];
     }
 
-    if (flags & CLONE_FILES) {
-        for (size_t i = 0; i < parent->resources.files.descriptors.size(); ++i)
-            child->resources.files.descriptors.push_back(parent->resources.files.descriptors[i]);
-    }
-
     const size_t STACK_SIZE = 16 * 1024;
     void* child_kstack = kmalloc(STACK_SIZE);
     if (!child_kstack) { delete child; return fkernel::return_error(fk::core::Error::OutOfMemory); }
@@ -90,10 +99,6 @@ extern "C" uint64_t sys_clone(uint64_t flags, uint64_t child_stack,
 
     child->resources.memory.regions.heap_start = parent->resources.memory.regions.heap_start;
     child->resources.memory.regions.heap_break = parent->resources.memory.regions.heap_break;
-    child->resources.memory.regions.mmap_start = parent->resources.memory.regions.mmap_start;
-    child->resources.memory.regions.mmap_end   = parent->resources.memory.regions.mmap_end;
-    for (size_t i = 0; i < parent->resources.memory.regions.list.size(); ++i)
-        child->resources.memory.regions.list.push_back(parent->resources.memory.regions.list[i]);
 
     child->resources.context.saved_rip    = regs->rip;
     child->resources.context.saved_rflags = regs->rflags;
@@ -118,6 +118,9 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
   }
 
   // 2. Load the new binary into a fresh address space
+  auto vmas_res = fkernel::VmaTree::create();
+  if (vmas_res.is_error())
+    return fkernel::return_error(vmas_res.error());
   uintptr_t old_cr3 = task->resources.memory.cr3;
   uintptr_t new_cr3 = VirtualMemoryManager::the().create_address_space();
   VirtualMemoryManager::the().switch_address_space(new_cr3);
@@ -127,6 +130,8 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
   task->control.lifecycle.is_vfork_sharing_address_space = false;
   task->resources.memory.prev_cr3 = shared_cr3 ? 0 : old_cr3;
   task->resources.memory.cr3 = new_cr3;
+  // A vfork child still shares the parent's tree; this drops that reference
+  task->resources.memory.vmas = vmas_res.value();
 
   // If we are a vfork child, unblock the parent now that we have our own address space
   if (task->control.lifecycle.vfork_parent_id.is_valid()) {
@@ -149,7 +154,6 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
   fk::algorithms::klog("EXEC", "execve: loading %s, entry=%p", path.c_str(), (void*)entry);
 
   task->set_heap_regions(elf_res.highest_load_end, elf_res.highest_load_end);
-  task->set_mmap_regions(0x40000000, 0x40000000);
 
   // 2.4 POSIX: Reset caught signal handlers to SIG_DFL across exec.
   //     SIG_IGN handlers are preserved per POSIX. SIG_DFL (0) stays as-is.
@@ -178,6 +182,9 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
     uintptr_t tp = TLS_VIRT_BASE + elf_res.tls.memsz;
     *reinterpret_cast<uintptr_t*>(tp) = tp; // self-reference
     tls_fs_base = tp;
+    task->memory().vmas->insert(TLS_VIRT_BASE, TLS_VIRT_BASE + tls_pages * 0x1000,
+                                PageFlags::Present | PageFlags::Writable | PageFlags::User,
+                                fkernel::VmaKind::Special, "[tls]");
     task->resources.context.fs_base = tp;
     CPU::the().write_msr(MSR_FS_BASE, tp);
   }
@@ -192,6 +199,8 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
     VirtualMemoryManager::the().map_page(v, phys, stack_flags);
     fk::memory::set(reinterpret_cast<void*>(v), 0, 0x1000);
   }
+  task->memory().vmas->insert(USER_STACK_TOP - fkernel::USER_STACK_RESERVE, USER_STACK_TOP,
+                              stack_flags, fkernel::VmaKind::Stack, "[stack]");
 
   uintptr_t current_user_stack = USER_STACK_TOP;
   auto push_string = [&](const fk::text::String& s) -> uintptr_t {
@@ -219,7 +228,7 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
 
   // 4. Construct the pointer array below the strings
   current_user_stack &= ~0xFULL; // Alignment
-  size_t auxv_pairs = tls_fs_base ? 11u : 10u;
+  size_t auxv_pairs = 10u + (tls_fs_base ? 1u : 0u) + (elf_res.vdso_base ? 1u : 0u);
   size_t total_ptrs = 1 + args.size() + 1 + envs.size() + 1 + (auxv_pairs * 2);
   if (total_ptrs % 2 != 0)
     total_ptrs++; // 16-byte alignment requirement
@@ -260,6 +269,10 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
   stack_ptr[idx++] = random_ptr; // AT_RANDOM
   stack_ptr[idx++] = 31;
   stack_ptr[idx++] = execfn_ptr; // AT_EXECFN
+  if (elf_res.vdso_base) {
+    stack_ptr[idx++] = 33;
+    stack_ptr[idx++] = elf_res.vdso_base; // AT_SYSINFO_EHDR
+  }
   if (tls_fs_base) {
     stack_ptr[idx++] = 51; // AT_MINSIGSTKSZ reused as AT_TLS base signal
     stack_ptr[idx++] = tls_fs_base;
@@ -286,10 +299,7 @@ uint64_t sys_execve(uint64_t path_ptr, uint64_t argv_ptr, uint64_t envp_ptr, uin
   task->resources.context.saved_rflags = 0x202;
 
   // Close all FDs marked O_CLOEXEC across execve
-  for (size_t i = 0; i < task->resources.files.descriptors.size(); ++i) {
-    auto& desc = task->resources.files.descriptors[i];
-    if (desc && desc->is_cloexec()) desc = nullptr;
-  }
+  if (auto table = task->resources.files.table) table->close_on_exec();
 
   task->dump_file_descriptors();
 
@@ -36,6 +36,20 @@ uint64_t sys_fork([[maybe_unused]] uint64_t arg1, [[maybe_unused]] uint64_t arg2
     return fkernel::return_error(fk::core::Error::OutOfMemory);
   }
 
+  // Copy the mapping set first: nothing else needs unwinding yet
+  if (parent->resources.memory.vmas) {
+    auto vmas = parent->resources.memory.vmas->clone();
+    if (vmas.is_error()) {
+      delete child;
+      return fkernel::return_error(vmas.error());
+    }
+    child->resources.memory.vmas = vmas.value();
+  }
+  if (auto files = child->inherit_files(*parent, false); files.is_error()) {
+    delete child;
+    return fkernel::return_error(files.error());
+  }
+
   // 2. Clone metadata
   child->control.identity.id = SchedulerManager::the().generate_pid();
   child->control.identity.ppid = parent->control.identity.id;
@@ -70,11 +84,6 @@ uint64_t sys_fork([[maybe_unused]] uint64_t arg1, [[maybe_unused]] uint64_t arg2
 
   child->resources.memory.regions.heap_start = parent->resources.memory.regions.heap_start;
   child->resources.memory.regions.heap_break = parent->resources.memory.regions.heap_break;
-  child->resources.memory.regions.mmap_start = parent->resources.memory.regions.mmap_start;
-  child->resources.memory.regions.mmap_end = parent->resources.memory.regions.mmap_end;
-  for (size_t i = 0; i < parent->resources.memory.regions.list.size(); ++i) {
-    child->resources.memory.regions.list.push_back(parent->resources.memory.regions.list[i]);
-  }
 
   // 2.5. Inherit syscall return state
   child->resources.context.user_rsp = regs->rsp;
@@ -85,10 +94,7 @@ uint64_t sys_fork([[maybe_unused]] uint64_t arg1, [[maybe_unused]] uint64_t arg2
   child->resources.context.fs_base = CPU::the().read_msr(MSR_FS_BASE);
   child->resources.context.gs_base = CPU::the().read_msr(MSR_KERNEL_GS_BASE);
 
-  // 3. Clone File Descriptors
-  for (size_t i = 0; i < parent->resources.files.descriptors.size(); ++i) {
-    child->resources.files.descriptors.push_back(parent->resources.files.descriptors[i]);
-  }
+  // 3. File descriptors were copied with the mapping set above
   child->dump_file_descriptors();
 
   // 4. Setup Kernel Stack
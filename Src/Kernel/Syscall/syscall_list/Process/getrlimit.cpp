@@ -5,20 +5,12 @@
 using namespace fkernel;
 
 extern "C" {
-uint64_t sys_getrlimit([[maybe_unused]] uint64_t resource, uint64_t rlim_ptr, uint64_t, uint64_t,
-                       uint64_t, uint64_t, [[maybe_unused]] PtRegs* regs) {
-  struct rlimit {
-    uint64_t rlim_cur;
-    uint64_t rlim_max;
-  };
+uint64_t sys_prlimit64(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, PtRegs*);
 
-  auto* rlim = reinterpret_cast<struct rlimit*>(rlim_ptr);
-  if (!rlim)
-    return return_error(fk::core::Error::InvalidParameter);
-
-  rlim->rlim_cur = 0x7fffffffffffffffUL;
-  rlim->rlim_max = 0x7fffffffffffffffUL;
-
-  return 0;
+uint64_t sys_getrlimit(uint64_t resource, uint64_t rlim_ptr, uint64_t, uint64_t,
+                       uint64_t, uint64_t, PtRegs* regs) {
+  if (!rlim_ptr)
+    return return_error(fk::core::Error::BadAddress);
+  return sys_prlimit64(0, resource, 0, rlim_ptr, 0, 0, regs);
 }
 }
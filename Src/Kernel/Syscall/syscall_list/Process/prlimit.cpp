@@ -1,4 +1,5 @@
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Scheduler/scheduler.h>
 #include <Kernel/Syscall/syscall_utils.h>
 
@@ -8,18 +9,59 @@ struct RLimit64 {
 };
 
 static constexpr uint64_t RLIM_INFINITY = 0x7fffffffffffffffUL;
+static constexpr uint64_t RLIMIT_NOFILE = 7;
 
+// Only RLIMIT_NOFILE is enforced; every other resource reads as unlimited
+// and accepts any new value.
 extern "C" {
 
 uint64_t sys_prlimit64(uint64_t pid, uint64_t resource, uint64_t new_limit_ptr,
                        uint64_t old_limit_ptr, uint64_t, uint64_t,
                        [[maybe_unused]] PtRegs* regs) {
-  (void)pid; (void)resource; (void)new_limit_ptr;
-  if (old_limit_ptr) {
-    auto* rlim = reinterpret_cast<RLimit64*>(old_limit_ptr);
-    rlim->rlim_cur = RLIM_INFINITY;
-    rlim->rlim_max = RLIM_INFINITY;
+  auto* current = SchedulerManager::the().current();
+  if (!current) return fkernel::return_error(fk::core::Error::PermissionDenied);
+
+  fk::RefPtr<Task> target_ref;
+  Task* target = current;
+  if (pid && pid != current->control.identity.id.value()) {
+    target_ref = SchedulerManager::the().find_task(fk::ProcessId(pid));
+    if (!target_ref) return (uint64_t)-3; // ESRCH
+    target = target_ref.get();
+    // Another task's limits need a matching real or effective uid, or root
+    const auto& self = current->control.identity;
+    const auto& other = target->control.identity;
+    if (self.euid != 0 && self.uid != other.uid && self.euid != other.euid)
+      return fkernel::return_error(fk::core::Error::PermissionDenied);
+  }
+
+  RLimit64 new_limit{};
+  if (new_limit_ptr) {
+    if (fkernel::memory::copy_from_user(&new_limit, reinterpret_cast<const void*>(new_limit_ptr),
+                                        sizeof(new_limit)).is_error())
+      return fkernel::return_error(fk::core::Error::BadAddress);
+    if (new_limit.rlim_cur > new_limit.rlim_max)
+      return fkernel::return_error(fk::core::Error::InvalidParameter);
   }
+
+  RLimit64 old_limit{RLIM_INFINITY, RLIM_INFINITY};
+  if (resource == RLIMIT_NOFILE) {
+    auto& files = target->resources.files;
+    old_limit = {files.nofile_soft, files.nofile_hard};
+    if (new_limit_ptr) {
+      // Descriptors cannot go past the table ceiling; only root may raise the hard limit
+      if (new_limit.rlim_max > FD_TABLE_MAX)
+        return fkernel::return_error(fk::core::Error::PermissionDenied);
+      if (new_limit.rlim_max > files.nofile_hard && current->control.identity.euid != 0)
+        return fkernel::return_error(fk::core::Error::PermissionDenied);
+      files.nofile_soft = new_limit.rlim_cur;
+      files.nofile_hard = new_limit.rlim_max;
+    }
+  }
+
+  if (old_limit_ptr &&
+      fkernel::memory::copy_to_user(reinterpret_cast<void*>(old_limit_ptr), &old_limit,
+                                    sizeof(old_limit)).is_error())
+    return fkernel::return_error(fk::core::Error::BadAddress);
   return 0;
 }
 
@@ -5,8 +5,12 @@
 using namespace fkernel;
 
 extern "C" {
-uint64_t sys_setrlimit([[maybe_unused]] uint64_t resource, [[maybe_unused]] uint64_t rlim_ptr,
-                       uint64_t, uint64_t, uint64_t, uint64_t, [[maybe_unused]] PtRegs* regs) {
-  return 0;
+uint64_t sys_prlimit64(uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, uint64_t, PtRegs*);
+
+uint64_t sys_setrlimit(uint64_t resource, uint64_t rlim_ptr, uint64_t, uint64_t, uint64_t,
+                       uint64_t, PtRegs* regs) {
+  if (!rlim_ptr)
+    return return_error(fk::core::Error::BadAddress);
+  return sys_prlimit64(0, resource, rlim_ptr, 0, 0, 0, regs);
 }
 }
@@ -28,6 +28,10 @@ extern "C" uint64_t sys_vfork([[maybe_unused]] uint64_t arg1, [[maybe_unused]] u
   Task* child = new Task();
   if (!child)
     return fkernel::return_error(fk::core::Error::OutOfMemory);
+  if (auto files = child->inherit_files(*parent, false); files.is_error()) {
+    delete child;
+    return fkernel::return_error(files.error());
+  }
 
   // 2. Clone metadata
   child->control.identity.id = SchedulerManager::the().generate_pid();
@@ -59,10 +63,7 @@ extern "C" uint64_t sys_vfork([[maybe_unused]] uint64_t arg1, [[maybe_unused]] u
     child->resources.ipc.signals.actions[i] = parent->resources.ipc.signals.actions[i];
   }
 
-  // 3. Clone file descriptors
-  for (size_t i = 0; i < parent->resources.files.descriptors.size(); ++i) {
-    child->resources.files.descriptors.push_back(parent->resources.files.descriptors[i]);
-  }
+  // 3. File descriptors were copied when the task was created
   child->dump_file_descriptors();
 
   // 4. Setup Kernel Stack
@@ -85,11 +86,7 @@ extern "C" uint64_t sys_vfork([[maybe_unused]] uint64_t arg1, [[maybe_unused]] u
   // Manual copy of regions
   child->resources.memory.regions.heap_start = parent->resources.memory.regions.heap_start;
   child->resources.memory.regions.heap_break = parent->resources.memory.regions.heap_break;
-  child->resources.memory.regions.mmap_start = parent->resources.memory.regions.mmap_start;
-  child->resources.memory.regions.mmap_end = parent->resources.memory.regions.mmap_end;
-  for (size_t i = 0; i < parent->resources.memory.regions.list.size(); ++i) {
-    child->resources.memory.regions.list.push_back(parent->resources.memory.regions.list[i]);
-  }
+  child->resources.memory.vmas = parent->resources.memory.vmas;
 
   // 6. Setup context
   child->resources.context.user_rsp = regs->rsp;
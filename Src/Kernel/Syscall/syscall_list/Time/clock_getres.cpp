@@ -1,5 +1,6 @@
-#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Syscall/syscall_utils.h>
 
@@ -8,13 +9,20 @@ struct timespec {
   int64_t tv_nsec;
 };
 
-extern "C" uint64_t sys_clock_getres([[maybe_unused]] uint64_t clk_id, uint64_t res_ptr,
+extern "C" uint64_t sys_clock_getres(uint64_t clk_id, uint64_t res_ptr,
                                       uint64_t, uint64_t, uint64_t, uint64_t,
                                       [[maybe_unused]] PtRegs* regs) {
+  auto resolution = TimeKeeper::the().resolution_ns(static_cast<uint32_t>(clk_id));
+  if (resolution.is_error())
+    return fkernel::return_error(resolution.error());
   if (!res_ptr) return 0;
-  auto* res = reinterpret_cast<timespec*>(res_ptr);
-  uint32_t freq = TickManager::the().get_frequency();
-  res->tv_sec = 0;
-  res->tv_nsec = (freq > 0) ? (int64_t)(1000000000ULL / freq) : 1000000;
+  if (!fkernel::memory::is_user_address(res_ptr, sizeof(timespec)))
+    return fkernel::return_error(fk::core::Error::BadAddress);
+
+  timespec res;
+  res.tv_sec = 0;
+  res.tv_nsec = static_cast<int64_t>(resolution.value());
+  if (fkernel::memory::copy_to_user(reinterpret_cast<void*>(res_ptr), &res, sizeof(res)).is_error())
+    return fkernel::return_error(fk::core::Error::BadAddress);
   return 0;
 }
@@ -1,6 +1,6 @@
-#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
-#include <Kernel/Clock/clock_interrupt.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Syscall/syscall_utils.h>
 #include <LibFK/Algorithms/log.h>
@@ -12,30 +12,22 @@ struct timespec {
 
 extern "C" {
 
-uint64_t sys_clock_gettime([[maybe_unused]] uint64_t clk_id, uint64_t tp_ptr, uint64_t, uint64_t,
+// Slow path only: musl resolves __vdso_clock_gettime from AT_SYSINFO_EHDR and
+// reaches here just when the vDSO cannot serve the clock (no invariant TSC).
+uint64_t sys_clock_gettime(uint64_t clk_id, uint64_t tp_ptr, uint64_t, uint64_t,
                            uint64_t, uint64_t, [[maybe_unused]] PtRegs* regs) {
-  auto* tp = reinterpret_cast<struct timespec*>(tp_ptr);
-  if (!tp)
-    return fkernel::return_error(fk::core::Error::InvalidParameter);
-
-  auto dt = ClockManager::the().datetime();
-
-  // Convert DateTime to Unix epoch (simplified but better)
-  uint64_t y = dt.year - 1970;
-  uint64_t days = y * 365 + (y + 2) / 4; // Leap years
-  static const int days_in_month[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-  for (int i = 0; i < dt.month - 1 && i < 12; ++i)
-    days += days_in_month[i];
-  if (dt.month > 2 && (dt.year % 4 == 0))
-    days++;
-  days += (dt.day - 1);
-
-  tp->tv_sec = days * 86400 + dt.hour * 3600 + dt.minute * 60 + dt.second;
-
-  uint64_t ticks = TickManager::the().get_ticks();
-  uint32_t freq = TickManager::the().get_frequency();
-  tp->tv_nsec = (freq > 0) ? (int64_t)((ticks % freq) * 1000000000ULL / freq)
-                            : (int64_t)((ticks % 100) * 10000000);
+  if (!tp_ptr || !fkernel::memory::is_user_address(tp_ptr, sizeof(timespec)))
+    return fkernel::return_error(fk::core::Error::BadAddress);
+
+  auto now = TimeKeeper::the().now_ns(static_cast<uint32_t>(clk_id));
+  if (now.is_error())
+    return fkernel::return_error(now.error());
+
+  timespec ts;
+  ts.tv_sec = static_cast<int64_t>(now.value() / 1000000000ULL);
+  ts.tv_nsec = static_cast<int64_t>(now.value() % 1000000000ULL);
+  if (fkernel::memory::copy_to_user(reinterpret_cast<void*>(tp_ptr), &ts, sizeof(ts)).is_error())
+    return fkernel::return_error(fk::core::Error::BadAddress);
 
   return 0;
 }
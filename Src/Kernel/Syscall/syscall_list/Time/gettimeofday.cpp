@@ -1,9 +1,8 @@
-#include <Kernel/Syscall/syscall_utils.h>
 #include <Kernel/Arch/x86_64/Syscall/syscall_arch.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Memory/UserAccess/user_access.h>
 #include <Kernel/Syscall/syscall.h>
 #include <Kernel/Syscall/syscall_utils.h>
-#include <Kernel/Arch/x86_64/Interrupt/HardwareInterrupts/tick_manager.h>
-#include <Kernel/Clock/clock_interrupt.h>
 #include <LibFK/Algorithms/log.h>
 
 struct timeval {
@@ -14,22 +13,18 @@ struct timeval {
 extern "C" {
 
 uint64_t sys_gettimeofday(uint64_t tv_ptr, [[maybe_unused]] uint64_t tz_ptr, uint64_t, uint64_t, uint64_t, uint64_t, [[maybe_unused]] PtRegs* regs) {
-    auto* tv = reinterpret_cast<struct timeval*>(tv_ptr);
-    if (!tv) return fkernel::return_error(fk::core::Error::InvalidParameter);
-
-    auto dt = ClockManager::the().datetime();
-    uint64_t y = dt.year - 1970;
-    uint64_t days = y * 365 + (y + 2) / 4;
-    static const int days_in_month[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
-    for (int i = 0; i < dt.month - 1 && i < 12; ++i) days += days_in_month[i];
-    if (dt.month > 2 && (dt.year % 4 == 0)) days++;
-    days += (dt.day - 1);
+    // Only the (obsolete) timezone was asked for
+    if (!tv_ptr)
+        return 0;
+    if (!fkernel::memory::is_user_address(tv_ptr, sizeof(timeval)))
+        return fkernel::return_error(fk::core::Error::BadAddress);
 
-    tv->tv_sec = days * 86400 + dt.hour * 3600 + dt.minute * 60 + dt.second;
-    
-    uint64_t ticks = TickManager::the().get_ticks();
-    uint32_t freq = TickManager::the().get_frequency();
-    tv->tv_usec = (freq > 0) ? (int64_t)((ticks % freq) * 1000000 / freq) : (int64_t)((ticks % 100) * 10000);
+    uint64_t now = TimeKeeper::the().realtime_ns();
+    timeval tv;
+    tv.tv_sec = static_cast<int64_t>(now / 1000000000ULL);
+    tv.tv_usec = static_cast<int64_t>((now % 1000000000ULL) / 1000);
+    if (fkernel::memory::copy_to_user(reinterpret_cast<void*>(tv_ptr), &tv, sizeof(tv)).is_error())
+        return fkernel::return_error(fk::core::Error::BadAddress);
 
     return 0;
 }
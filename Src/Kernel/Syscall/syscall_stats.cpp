@@ -0,0 +1,76 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
+#include <Kernel/Syscall/syscall_stats.h>
+#include <LibFK/Memory/heap_malloc.h>
+#include <LibFK/Utilities/memory.h>
+
+namespace fkernel {
+
+SyscallCounters* SyscallStats::table_for(uint32_t cpu) {
+  SyscallCounters* table = __atomic_load_n(&m_cpu_tables[cpu], __ATOMIC_ACQUIRE);
+  if (table)
+    return table;
+
+  auto* fresh = static_cast<SyscallCounters*>(kmalloc(sizeof(SyscallCounters) * SYS_MAX));
+  if (!fresh)
+    return nullptr;
+  fk::memory::set(fresh, 0, sizeof(SyscallCounters) * SYS_MAX);
+
+  // A task preempted here may race another on the same CPU; keep the winner.
+  SyscallCounters* expected = nullptr;
+  if (!__atomic_compare_exchange_n(&m_cpu_tables[cpu], &expected, fresh, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    kfree(fresh);
+    return expected;
+  }
+  return fresh;
+}
+
+void SyscallStats::record(uint64_t num, uint64_t result, uint64_t cycles) {
+  if (num >= SYS_MAX)
+    return;
+  uint32_t cpu = arch_current_cpu_id();
+  if (cpu >= MAX_CPUS)
+    return;
+  SyscallCounters* table = table_for(cpu);
+  if (!table)
+    return;
+
+  size_t bucket = cycles ? static_cast<size_t>(63 - __builtin_clzll(cycles)) : 0;
+  if (bucket >= SYSCALL_LATENCY_BUCKETS)
+    bucket = SYSCALL_LATENCY_BUCKETS - 1;
+
+  // Preemption is on: a task that migrated after reading the CPU id shares
+  // this table with the CPU it belongs to, so the adds must be atomic
+  SyscallCounters& entry = table[num];
+  __atomic_fetch_add(&entry.calls, 1, __ATOMIC_RELAXED);
+  if (static_cast<int64_t>(result) < 0 && static_cast<int64_t>(result) >= -4095)
+    __atomic_fetch_add(&entry.errors, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&entry.cycles, cycles, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&entry.latency[bucket], 1, __ATOMIC_RELAXED);
+}
+
+void SyscallStats::snapshot(SyscallCounters* out) const {
+  fk::memory::set(out, 0, sizeof(SyscallCounters) * SYS_MAX);
+  for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu) {
+    const SyscallCounters* table = __atomic_load_n(&m_cpu_tables[cpu], __ATOMIC_ACQUIRE);
+    if (!table)
+      continue;
+    for (size_t nr = 0; nr < SYS_MAX; ++nr) {
+      out[nr].calls += table[nr].calls;
+      out[nr].errors += table[nr].errors;
+      out[nr].cycles += table[nr].cycles;
+      for (size_t b = 0; b < SYSCALL_LATENCY_BUCKETS; ++b)
+        out[nr].latency[b] += table[nr].latency[b];
+    }
+  }
+}
+
+void SyscallStats::reset() {
+  for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu) {
+    SyscallCounters* table = __atomic_load_n(&m_cpu_tables[cpu], __ATOMIC_ACQUIRE);
+    if (table)
+      fk::memory::set(table, 0, sizeof(SyscallCounters) * SYS_MAX);
+  }
+}
+
+} // namespace fkernel
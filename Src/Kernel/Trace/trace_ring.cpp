@@ -0,0 +1,59 @@
+#include <Kernel/Trace/trace_ring.h>
+
+namespace fkernel::trace {
+
+void TraceRing::record(const TraceEvent& event) {
+  uint64_t seq = __atomic_fetch_add(&m_head, 1, __ATOMIC_RELAXED);
+  size_t slot = seq & (CAPACITY - 1);
+
+  // Zero the commit word first so a consumer never pairs the old sequence
+  // with a half-written event.
+  __atomic_store_n(&m_commit[slot], 0, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  m_events[slot] = event;
+  __atomic_store_n(&m_commit[slot], seq + 1, __ATOMIC_RELEASE);
+}
+
+size_t TraceRing::consume(TraceEvent* out, size_t max) {
+  uint64_t head = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+  if (head - m_tail > CAPACITY) {
+    m_dropped += head - CAPACITY - m_tail;
+    m_tail = head - CAPACITY;
+  }
+
+  size_t count = 0;
+  while (count < max && m_tail < head) {
+    size_t slot = m_tail & (CAPACITY - 1);
+    uint64_t expected = m_tail + 1;
+
+    uint64_t commit = __atomic_load_n(&m_commit[slot], __ATOMIC_ACQUIRE);
+    if (commit < expected)
+      break; // Producer still filling this slot; pick it up on the next read.
+
+    if (commit == expected) {
+      out[count] = m_events[slot];
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      if (__atomic_load_n(&m_commit[slot], __ATOMIC_RELAXED) == expected) {
+        ++count;
+        ++m_tail;
+        continue;
+      }
+    }
+
+    // Overwritten by a newer event while we were behind.
+    ++m_dropped;
+    ++m_tail;
+  }
+  return count;
+}
+
+void TraceRing::clear() {
+  m_tail = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+}
+
+size_t TraceRing::pending() const {
+  uint64_t queued = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE) - m_tail;
+  return queued > CAPACITY ? CAPACITY : static_cast<size_t>(queued);
+}
+
+} // namespace fkernel::trace
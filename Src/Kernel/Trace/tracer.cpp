@@ -0,0 +1,65 @@
+#include <Kernel/Arch/x86_64/Hardware/Cpu/cpu_ops.h>
+#include <Kernel/Clock/time_keeper.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Trace/tracer.h>
+#include <LibFK/Algorithms/log.h>
+
+namespace fkernel::trace {
+
+bool g_tracing_enabled = false;
+
+void Tracer::set_enabled(bool enabled) {
+  __atomic_store_n(&g_tracing_enabled, enabled, __ATOMIC_RELEASE);
+  fk::algorithms::klog("TRACE", "Tracing %s", enabled ? "enabled" : "disabled");
+}
+
+void Tracer::record(TraceEventId id, uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3,
+                    uint64_t a4, uint64_t a5) {
+  TraceEvent event;
+  event.timestamp_ns = TimeKeeper::the().monotonic_ns();
+
+  auto* task = SchedulerManager::the().current();
+  event.tid = task ? static_cast<uint32_t>(task->control.identity.id.value()) : 0;
+
+  uint32_t cpu = arch_current_cpu_id();
+  event.cpu = static_cast<uint16_t>(cpu);
+  event.event_id = static_cast<uint16_t>(id);
+  event.args[0] = a0;
+  event.args[1] = a1;
+  event.args[2] = a2;
+  event.args[3] = a3;
+  event.args[4] = a4;
+  event.args[5] = a5;
+
+  m_rings[cpu % MAX_CPUS].record(event);
+}
+
+size_t Tracer::consume(TraceEvent* out, size_t max) {
+  fk::synchronization::ScopedLockIRQ lock(m_consumer_lock);
+  size_t count = 0;
+  for (size_t cpu = 0; cpu < MAX_CPUS && count < max; ++cpu)
+    count += m_rings[cpu].consume(out + count, max - count);
+  return count;
+}
+
+void Tracer::clear() {
+  fk::synchronization::ScopedLockIRQ lock(m_consumer_lock);
+  for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+    m_rings[cpu].clear();
+}
+
+size_t Tracer::pending() const {
+  size_t total = 0;
+  for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+    total += m_rings[cpu].pending();
+  return total;
+}
+
+uint64_t Tracer::dropped() const {
+  uint64_t total = 0;
+  for (size_t cpu = 0; cpu < MAX_CPUS; ++cpu)
+    total += m_rings[cpu].dropped();
+  return total;
+}
+
+} // namespace fkernel::trace
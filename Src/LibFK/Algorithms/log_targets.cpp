@@ -9,6 +9,7 @@ static uint32_t g_log_targets =
     LogTarget::Serial;
 
 static LogLevel g_log_level = LevelInfo;
+static bool g_panic_mode = false;
 
 void set_log_targets(uint32_t targets) {
     g_log_targets = targets;
@@ -26,5 +27,13 @@ LogLevel get_log_level() {
     return g_log_level;
 }
 
+void enter_panic_mode() {
+    __atomic_store_n(&g_panic_mode, true, __ATOMIC_RELEASE);
+}
+
+bool in_panic_mode() {
+    return __atomic_load_n(&g_panic_mode, __ATOMIC_ACQUIRE);
+}
+
 } // namespace algorithms
 } // namespace fk
@@ -174,6 +174,44 @@ static void test_getuid(void) {
     else          fail("getuid", "returned negative uid");
 }
 
+/* ── benchmarks ───────────────────────────────────────────── */
+
+#define EXEC_BENCH_RUNS 32
+
+static long now_us(void) {
+    struct { long tv_sec; long tv_usec; } tv;
+    sys_gettimeofday(&tv, 0);
+    return tv.tv_sec * 1000000L + tv.tv_usec;
+}
+
+/* fork + execve + wait of /bin/true, as a shell loop does. The first run
+ * parses and reads the binary; the rest should hit the kernel's caches. */
+static void bench_exec_latency(void) {
+    long first = 0, rest_start = 0;
+    for (int i = 0; i < EXEC_BENCH_RUNS; i++) {
+        long t0 = now_us();
+        int pid = sys_fork();
+        if (pid < 0) { fail("exec_latency", "fork failed"); return; }
+        if (pid == 0) {
+            char *argv[] = { "/bin/true", 0 };
+            char *envp[] = { 0 };
+            sys_execve("/bin/true", argv, envp);
+            sys_exit(127);
+        }
+        int status = 0;
+        sys_wait4(pid, &status, 0, 0);
+        if ((status >> 8) & 0xff) { fail("exec_latency", "/bin/true exited non-zero"); return; }
+        if (i == 0) {
+            rest_start = now_us();
+            first = rest_start - t0;
+        }
+    }
+    long avg = (now_us() - rest_start) / (EXEC_BENCH_RUNS - 1);
+    puts_("  exec latency: first "); print_int((int)first);
+    puts_(" us, then "); print_int((int)avg); puts_(" us avg\n");
+    pass("exec_latency");
+}
+
 /* ── main ─────────────────────────────────────────────────── */
 
 int main(void) {
@@ -202,6 +240,9 @@ int main(void) {
     test_fork_exec();
     test_vfork_exec();
 
+    puts_("\n[Benchmarks]\n");
+    bench_exec_latency();
+
     puts_("\n");
     puts_("=========================\n");
     puts_("Results: ");
@@ -0,0 +1,196 @@
+#include <fk_user.h>
+
+/*
+ * tracecat: renders the kernel's binary trace ring (/debug/trace) as text.
+ *
+ *   tracecat on|off   start or stop tracing (/debug/tracing_on)
+ *   tracecat          drain and print every queued event
+ */
+
+#define O_RDONLY 0
+#define O_WRONLY 1
+
+/* Must match struct TraceEvent in Include/Kernel/Trace/trace_event.h */
+struct trace_event {
+    uint64_t timestamp_ns;
+    uint32_t tid;
+    uint16_t cpu;
+    uint16_t event_id;
+    uint64_t args[6];
+};
+
+/* Must match enum TraceEventId in Include/Kernel/Trace/trace_event_id.h */
+enum {
+    EV_SYSCALL_ENTER = 1,
+    EV_SYSCALL_EXIT = 2,
+    EV_IPC_DELIVER = 16,
+    EV_IPC_SEND_BLOCKED = 17,
+    EV_IPC_SEND_IMMEDIATE = 18,
+    EV_IPC_RECEIVE_BLOCKED = 19,
+    EV_IPC_RECEIVE_IMMEDIATE = 20,
+    EV_NOTIFY_SIGNAL_WAKE = 32,
+    EV_NOTIFY_SIGNAL_QUEUE = 33,
+    EV_NOTIFY_WAIT_IMMEDIATE = 34,
+    EV_NOTIFY_WAIT_BLOCKED = 35,
+    EV_NOTIFY_WAIT_WOKEN = 36,
+    EV_NOTIFY_POLL = 37,
+    EV_SIGNAL_DELIVER = 48,
+};
+
+/* ── buffered output ──────────────────────────────────────── */
+
+static char g_out[4096];
+static int g_out_len = 0;
+
+static void flush_out(void) {
+    if (g_out_len > 0) sys_write(1, g_out, (size_t)g_out_len);
+    g_out_len = 0;
+}
+
+static void put_char(char c) {
+    if (g_out_len == (int)sizeof(g_out)) flush_out();
+    g_out[g_out_len++] = c;
+}
+
+static void put_str(const char *s) {
+    while (*s) put_char(*s++);
+}
+
+static void put_dec(uint64_t v) {
+    char buf[21]; int i = 20;
+    buf[i] = 0;
+    if (v == 0) buf[--i] = '0';
+    while (v) { buf[--i] = (char)('0' + v % 10); v /= 10; }
+    put_str(buf + i);
+}
+
+static void put_ns(uint64_t ns) {
+    static const char digits[] = "0123456789";
+    put_dec(ns / 1000000000ULL);
+    put_char('.');
+    uint64_t frac = ns % 1000000000ULL;
+    for (uint64_t div = 100000000ULL; div; div /= 10)
+        put_char(digits[(frac / div) % 10]);
+}
+
+static void put_hex(uint64_t v) {
+    static const char digits[] = "0123456789abcdef";
+    char buf[17]; int i = 16;
+    buf[i] = 0;
+    if (v == 0) buf[--i] = '0';
+    while (v) { buf[--i] = digits[v & 0xf]; v >>= 4; }
+    put_str("0x");
+    put_str(buf + i);
+}
+
+/* ── decoding ─────────────────────────────────────────────── */
+
+static const char *endpoint_op(uint16_t id) {
+    switch (id) {
+    case EV_IPC_DELIVER: return "deliver_message";
+    case EV_IPC_SEND_BLOCKED: return "send_blocked";
+    case EV_IPC_SEND_IMMEDIATE: return "send_immediate";
+    case EV_IPC_RECEIVE_BLOCKED: return "receive_blocked";
+    case EV_IPC_RECEIVE_IMMEDIATE: return "receive_immediate";
+    default: return 0;
+    }
+}
+
+static const char *notification_op(uint16_t id) {
+    switch (id) {
+    case EV_NOTIFY_SIGNAL_WAKE: return "signal_wake";
+    case EV_NOTIFY_SIGNAL_QUEUE: return "signal_queue";
+    case EV_NOTIFY_WAIT_IMMEDIATE: return "wait_immediate";
+    case EV_NOTIFY_WAIT_BLOCKED: return "wait_blocked";
+    case EV_NOTIFY_WAIT_WOKEN: return "wait_woken";
+    case EV_NOTIFY_POLL: return "poll";
+    default: return 0;
+    }
+}
+
+static void print_event(const struct trace_event *ev) {
+    put_char('[');
+    put_ns(ev->timestamp_ns);
+    put_str("] cpu");
+    put_dec(ev->cpu);
+    put_char(' ');
+
+    const char *op;
+    if (ev->event_id == EV_SYSCALL_ENTER) {
+        put_str("[SYSCALL >] Task "); put_dec(ev->tid);
+        put_str(": "); put_dec(ev->args[0]);
+        put_str(" (args: ");
+        for (int i = 1; i < 6; i++) {
+            put_hex(ev->args[i]);
+            if (i < 5) put_str(", ");
+        }
+        put_str(")\n");
+    } else if (ev->event_id == EV_SYSCALL_EXIT) {
+        put_str("[SYSCALL <] Task "); put_dec(ev->tid);
+        put_str(": "); put_dec(ev->args[0]);
+        put_str(" -> "); put_hex(ev->args[1]);
+        put_char('\n');
+    } else if ((op = endpoint_op(ev->event_id)) != 0) {
+        put_str("[ENDPOINT] "); put_str(op);
+        put_str(" - Task:"); put_dec(ev->args[0]);
+        put_str(" Sender:"); put_dec(ev->args[0]);
+        put_str(" Receiver:"); put_dec(ev->args[1]);
+        put_str(" MsgInfo:"); put_hex(ev->args[2]);
+        put_char('\n');
+    } else if ((op = notification_op(ev->event_id)) != 0) {
+        put_str("[NOTIFICATION] "); put_str(op);
+        put_str(" - Task:"); put_dec(ev->args[0]);
+        put_str(" Bits:"); put_hex(ev->args[1]);
+        put_char('\n');
+    } else if (ev->event_id == EV_SIGNAL_DELIVER) {
+        put_str("[SIGNAL] deliver - Task:"); put_dec(ev->args[0]);
+        put_str(" Signal:"); put_dec(ev->args[1]);
+        put_str(" Handler:"); put_hex(ev->args[2]);
+        put_str(" Frame:"); put_hex(ev->args[3]);
+        put_char('\n');
+    } else {
+        put_str("[UNKNOWN "); put_dec(ev->event_id);
+        put_str("] Task "); put_dec(ev->tid);
+        put_char('\n');
+    }
+}
+
+/* ── entry ────────────────────────────────────────────────── */
+
+static int set_tracing(char state) {
+    int fd = sys_open("/debug/tracing_on", O_WRONLY, 0);
+    if (fd < 0) {
+        print("tracecat: cannot open /debug/tracing_on\n");
+        return 1;
+    }
+    long n = sys_write(fd, &state, 1);
+    sys_close(fd);
+    return n == 1 ? 0 : 1;
+}
+
+int main(int argc, char **argv, char **envp) {
+    (void)envp;
+    if (argc > 1) {
+        const char *arg = argv[1];
+        if (arg[0] == 'o' && arg[1] == 'n' && arg[2] == 0) return set_tracing('1');
+        if (arg[0] == 'o' && arg[1] == 'f' && arg[2] == 'f' && arg[3] == 0) return set_tracing('0');
+        print("usage: tracecat [on|off]\n");
+        return 1;
+    }
+
+    int fd = sys_open("/debug/trace", O_RDONLY, 0);
+    if (fd < 0) {
+        print("tracecat: cannot open /debug/trace\n");
+        return 1;
+    }
+
+    static struct trace_event events[64];
+    long n;
+    while ((n = sys_read(fd, events, sizeof(events))) > 0) {
+        long count = n / (long)sizeof(struct trace_event);
+        for (long i = 0; i < count; i++) print_event(&events[i]);
+    }
+    flush_out();
+    sys_close(fd);
+    return 0;
+}
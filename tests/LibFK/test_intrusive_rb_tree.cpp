@@ -0,0 +1,161 @@
+#include <tests/test_framework.h>
+#include <LibFK/Tree/intrusive_rb_tree.h>
+
+using namespace fk::containers;
+
+struct Item {
+    int key = 0;
+    size_t subtree_size = 1;
+    int subtree_max = 0;
+    IntrusiveRBNode<Item> node;
+};
+
+struct ItemLess {
+    bool operator()(const Item& a, const Item& b) const { return a.key < b.key; }
+};
+
+struct ItemAugment {
+    static void update(Item& item) {
+        item.subtree_size = 1;
+        item.subtree_max = item.key;
+        if (Item* l = item.node.left) {
+            item.subtree_size += l->subtree_size;
+            if (l->subtree_max > item.subtree_max) item.subtree_max = l->subtree_max;
+        }
+        if (Item* r = item.node.right) {
+            item.subtree_size += r->subtree_size;
+            if (r->subtree_max > item.subtree_max) item.subtree_max = r->subtree_max;
+        }
+    }
+};
+
+using ItemTree = IntrusiveRBTree<Item, &Item::node, ItemLess, ItemAugment>;
+
+// Returns the black height, or -1 if a red-black or augmentation invariant fails
+static int check_subtree(const Item* item) {
+    if (!item) return 1;
+    const Item* l = item->node.left;
+    const Item* r = item->node.right;
+    if (l && (l->node.parent != item || l->key > item->key)) return -1;
+    if (r && (r->node.parent != item || r->key < item->key)) return -1;
+    if (item->node.red && ((l && l->node.red) || (r && r->node.red))) return -1;
+    size_t size = 1 + (l ? l->subtree_size : 0) + (r ? r->subtree_size : 0);
+    if (item->subtree_size != size) return -1;
+    int lh = check_subtree(l);
+    int rh = check_subtree(r);
+    if (lh < 0 || rh < 0 || lh != rh) return -1;
+    return lh + (item->node.red ? 0 : 1);
+}
+
+static bool tree_valid(const ItemTree& tree) {
+    if (tree.root() && (tree.root()->node.red || tree.root()->node.parent)) return false;
+    if (check_subtree(tree.root()) < 0) return false;
+    return !tree.root() || tree.root()->subtree_size == tree.size();
+}
+
+static const char* test_rbtree_empty() {
+    ItemTree tree;
+    TEST_ASSERT(tree.is_empty(), "New tree should be empty");
+    TEST_ASSERT(tree.first() == nullptr, "Empty tree has no first node");
+    TEST_ASSERT(tree.last() == nullptr, "Empty tree has no last node");
+    return NULL;
+}
+
+static const char* test_rbtree_inorder_iteration() {
+    static Item items[64];
+    ItemTree tree;
+    for (int i = 0; i < 64; ++i) {
+        items[i] = Item{};
+        items[i].key = (i * 37) % 64;
+        tree.insert(items[i]);
+    }
+    TEST_ASSERT(tree_valid(tree), "Tree invariants should hold after inserts");
+    TEST_ASSERT_EQ(64, (long)tree.size(), "Size should count every insert");
+
+    int expected = 0;
+    for (Item* it = tree.first(); it; it = ItemTree::next(*it))
+        TEST_ASSERT_EQ(expected++, it->key, "Forward iteration should be sorted");
+    TEST_ASSERT_EQ(64, expected, "Forward iteration should visit every node");
+
+    expected = 63;
+    for (Item* it = tree.last(); it; it = ItemTree::prev(*it))
+        TEST_ASSERT_EQ(expected--, it->key, "Reverse iteration should be sorted");
+    return NULL;
+}
+
+static const char* test_rbtree_augment_tracks_max() {
+    static Item items[32];
+    ItemTree tree;
+    for (int i = 0; i < 32; ++i) {
+        items[i] = Item{};
+        items[i].key = i;
+        tree.insert(items[i]);
+    }
+    TEST_ASSERT_EQ(31, tree.root()->subtree_max, "Root should see the largest key");
+    tree.remove(items[31]);
+    tree.remove(items[30]);
+    TEST_ASSERT(tree_valid(tree), "Tree invariants should hold after removes");
+    TEST_ASSERT_EQ(29, tree.root()->subtree_max, "Root max should drop after removal");
+
+    // Rekeying means remove, change, reinsert
+    tree.remove(items[5]);
+    items[5].key = 100;
+    tree.insert(items[5]);
+    TEST_ASSERT_EQ(100, tree.root()->subtree_max, "Reinserted key should reach the root");
+    return NULL;
+}
+
+static const char* test_rbtree_remove_all_orders() {
+    static Item items[128];
+    ItemTree tree;
+    for (int i = 0; i < 128; ++i) {
+        items[i] = Item{};
+        items[i].key = i;
+        tree.insert(items[i]);
+    }
+    // Remove in a scattered order, checking invariants as we go
+    for (int i = 0; i < 128; ++i) {
+        int idx = (i * 53) % 128;
+        tree.remove(items[idx]);
+        TEST_ASSERT(tree_valid(tree), "Tree invariants should hold during removal");
+        TEST_ASSERT(items[idx].node.parent == nullptr, "Removed node should be unlinked");
+    }
+    TEST_ASSERT(tree.is_empty(), "Tree should be empty after removing everything");
+    return NULL;
+}
+
+static const char* test_rbtree_duplicates_and_reuse() {
+    static Item items[16];
+    ItemTree tree;
+    for (int i = 0; i < 16; ++i) {
+        items[i] = Item{};
+        items[i].key = i % 4;
+        tree.insert(items[i]);
+    }
+    TEST_ASSERT(tree_valid(tree), "Duplicate keys should keep invariants");
+    tree.remove(items[3]);
+    tree.insert(items[3]);
+    TEST_ASSERT(tree_valid(tree), "Reinserting a removed node should work");
+    TEST_ASSERT_EQ(16, (long)tree.size(), "Size should be unchanged after reinsert");
+
+    ItemTree moved(static_cast<ItemTree&&>(tree));
+    TEST_ASSERT(tree.is_empty(), "Moved-from tree should be empty");
+    TEST_ASSERT_EQ(16, (long)moved.size(), "Moved-to tree should own the nodes");
+    return NULL;
+}
+
+/* ---- Registration ---- */
+
+static test_case_t s_tests[] = {
+    {"test_rbtree_empty",                test_rbtree_empty},
+    {"test_rbtree_inorder_iteration",    test_rbtree_inorder_iteration},
+    {"test_rbtree_augment_tracks_max",   test_rbtree_augment_tracks_max},
+    {"test_rbtree_remove_all_orders",    test_rbtree_remove_all_orders},
+    {"test_rbtree_duplicates_and_reuse", test_rbtree_duplicates_and_reuse},
+};
+
+int run_libfk_intrusive_rb_tree_tests() {
+    return run_tests("LibFK IntrusiveRBTree",
+                     s_tests,
+                     sizeof(s_tests) / sizeof(s_tests[0]));
+}
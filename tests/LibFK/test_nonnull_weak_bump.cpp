@@ -23,6 +23,12 @@ struct RefTracked : public fk::memory::RefCounted<RefTracked> {
 };
 int RefTracked::alive = 0;
 
+struct TryRefProbe : public fk::memory::RefCounted<TryRefProbe> {
+    static bool ref_taken_in_dtor;
+    ~TryRefProbe() { ref_taken_in_dtor = try_ref(); }
+};
+bool TryRefProbe::ref_taken_in_dtor = true;
+
 struct WeakTarget : public fk::Weakable<WeakTarget> {
     int value;
     static int alive;
@@ -89,6 +95,17 @@ static const char* test_nonnull_ref_copy() {
     return NULL;
 }
 
+static const char* test_ref_counted_try_ref() {
+    auto* p = new TryRefProbe();
+    TEST_ASSERT(p->try_ref(), "try_ref on a live object should succeed");
+    TEST_ASSERT_EQ(2, (int)p->ref_count(), "try_ref should add a reference");
+    p->unref();
+    TryRefProbe::ref_taken_in_dtor = true;
+    p->unref();
+    TEST_ASSERT(!TryRefProbe::ref_taken_in_dtor, "try_ref should fail once the count hit zero");
+    return NULL;
+}
+
 static const char* test_nonnull_ref_as_nullable() {
     RefTracked::alive = 0;
     fk::NonnullRefPtr<RefTracked> p(new RefTracked(30));
@@ -192,6 +209,7 @@ static const test_case_t nonnull_weak_bump_tests[] = {
     {"nonnull_ref_basic",       test_nonnull_ref_basic},
     {"nonnull_ref_copy",        test_nonnull_ref_copy},
     {"nonnull_ref_as_nullable", test_nonnull_ref_as_nullable},
+    {"ref_counted_try_ref",     test_ref_counted_try_ref},
     {"weakptr_basic",           test_weakptr_basic},
     {"weakptr_copy",            test_weakptr_copy},
     {"weakptr_multiple",        test_weakptr_multiple},
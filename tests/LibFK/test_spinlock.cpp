@@ -0,0 +1,188 @@
+#include <tests/test_framework.h>
+#include <LibFK/Synchronization/lock_stat.h>
+#include <LibFK/Synchronization/spinlock.h>
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace fk::synchronization;
+
+// The unfair test-and-set lock Spinlock used to be, kept as the baseline
+class TasLock {
+public:
+    void lock() {
+        while (__sync_lock_test_and_set(&m_lock, 1)) {
+            while (m_lock) {
+                asm volatile("pause");
+            }
+        }
+    }
+    void unlock() { __sync_lock_release(&m_lock); }
+
+private:
+    volatile int m_lock{0};
+};
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// ---- Semantics ------------------------------------------------------------
+
+static const char* test_spinlock_try_lock() {
+    Spinlock lock;
+    TEST_ASSERT(lock.try_lock(), "try_lock on a free lock succeeds");
+    TEST_ASSERT(lock.is_locked(), "lock is held after try_lock");
+    TEST_ASSERT(!lock.try_lock(), "try_lock on a held lock fails");
+    lock.unlock();
+    TEST_ASSERT(!lock.is_locked(), "unlock releases it");
+    lock.lock();
+    lock.unlock();
+    TEST_ASSERT(lock.try_lock(), "try_lock succeeds after lock/unlock");
+    lock.unlock();
+    return NULL;
+}
+
+static const char* test_spinlock_try_lock_keeps_rank() {
+    set_cpu_lock_rank(LockRank::None);
+    Spinlock lock(LockRank::Driver);
+    TEST_ASSERT(lock.try_lock(), "ranked try_lock succeeds");
+    TEST_ASSERT(current_cpu_lock_rank() == LockRank::Driver, "try_lock advances the rank");
+    lock.unlock();
+    TEST_ASSERT(current_cpu_lock_rank() == LockRank::None, "unlock restores the rank");
+    return NULL;
+}
+
+static const char* test_lock_stat_classes() {
+    char copy[] = "test.class";
+    LockClassStats* first = lock_class("test.class");
+    TEST_ASSERT(first != NULL, "a class is registered");
+    TEST_ASSERT(lock_class(copy) == first, "classes are matched by name, not pointer");
+    TEST_ASSERT(lock_class("test.other") != first, "distinct names get distinct slots");
+    TEST_ASSERT(lock_class(lock_rank_class_name(LockRank::None)) ==
+                    lock_class("unclassified"),
+                "unnamed unranked locks share one class");
+
+    first->acquisitions = 5;
+    lock_stat_raise(first->max_spin_cycles, 7);
+    lock_stat_raise(first->max_spin_cycles, 3);
+    TEST_ASSERT_EQ(7, (long)first->max_spin_cycles, "raise keeps the maximum");
+    lock_stat_reset();
+    TEST_ASSERT_EQ(0, (long)first->acquisitions, "reset zeroes the counters");
+    TEST_ASSERT_EQ(0, (long)first->max_spin_cycles, "reset zeroes the maxima");
+    return NULL;
+}
+
+// ---- Contention -----------------------------------------------------------
+
+static constexpr int MAX_THREADS = 4;
+static constexpr uint64_t CONTENDED_RUN_NS = 50000000ull;
+
+template <typename Lock> struct Contention {
+    Lock lock;
+    volatile bool start{false};
+    volatile bool stop{false};
+    uint64_t shared_counter{0};
+    uint64_t acquisitions[MAX_THREADS]{};
+    uint64_t wait_ns[MAX_THREADS]{};
+};
+
+template <typename Lock> struct Worker {
+    Contention<Lock>* state;
+    int index;
+};
+
+template <typename Lock> static void* contend(void* arg) {
+    auto* worker = static_cast<Worker<Lock>*>(arg);
+    auto* state = worker->state;
+    while (!state->start)
+        ;
+    uint64_t count = 0, waited = 0;
+    while (!state->stop) {
+        uint64_t before = now_ns();
+        state->lock.lock();
+        waited += now_ns() - before;
+        state->shared_counter = state->shared_counter + 1;
+        state->lock.unlock();
+        ++count;
+    }
+    state->acquisitions[worker->index] = count;
+    state->wait_ns[worker->index] = waited;
+    return NULL;
+}
+
+// Runs threads against one lock for a fixed time; returns false on a lost update
+template <typename Lock> static bool run_contention(const char* name, int threads) {
+    auto* state = new Contention<Lock>();
+    pthread_t ids[MAX_THREADS];
+    Worker<Lock> workers[MAX_THREADS];
+    for (int i = 0; i < threads; ++i) {
+        workers[i] = {state, i};
+        pthread_create(&ids[i], NULL, contend<Lock>, &workers[i]);
+    }
+    state->start = true;
+    uint64_t deadline = now_ns() + CONTENDED_RUN_NS;
+    while (now_ns() < deadline)
+        ;
+    state->stop = true;
+    for (int i = 0; i < threads; ++i)
+        pthread_join(ids[i], NULL);
+
+    uint64_t total = 0, waited = 0;
+    uint64_t least = ~0ull, most = 0;
+    for (int i = 0; i < threads; ++i) {
+        total += state->acquisitions[i];
+        waited += state->wait_ns[i];
+        if (state->acquisitions[i] < least) least = state->acquisitions[i];
+        if (state->acquisitions[i] > most) most = state->acquisitions[i];
+    }
+    TEST_LOG("\n    %-8s %d threads: %lu acquisitions, %lu ns mean wait, min/max share %lu/%lu ",
+             name, threads, (unsigned long)total,
+             (unsigned long)(total ? waited / total : 0), (unsigned long)least,
+             (unsigned long)most);
+    bool consistent = state->shared_counter == total;
+    delete state;
+    return consistent;
+}
+
+template <typename Lock> static uint64_t uncontended_ns(Lock& lock) {
+    constexpr int iterations = 1000000;
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; ++i) {
+        lock.lock();
+        lock.unlock();
+    }
+    return (now_ns() - start) / iterations;
+}
+
+static const char* test_spinlock_benchmark() {
+    Spinlock ticket;
+    TasLock tas;
+    TEST_LOG("\n    uncontended lock+unlock: ticket %lu ns, test-and-set %lu ns ",
+             (unsigned long)uncontended_ns(ticket), (unsigned long)uncontended_ns(tas));
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = cpus < 2 ? 2 : (cpus > MAX_THREADS ? MAX_THREADS : (int)cpus);
+    TEST_ASSERT(run_contention<Spinlock>("ticket", threads), "ticket lock lost an update");
+    TEST_ASSERT(run_contention<TasLock>("tas", threads), "test-and-set lock lost an update");
+    TEST_LOG("\n    ");
+    return NULL;
+}
+
+/* ---- Registration ---- */
+
+static test_case_t s_tests[] = {
+    {"test_spinlock_try_lock",            test_spinlock_try_lock},
+    {"test_spinlock_try_lock_keeps_rank", test_spinlock_try_lock_keeps_rank},
+    {"test_lock_stat_classes",            test_lock_stat_classes},
+    {"test_spinlock_benchmark",           test_spinlock_benchmark},
+};
+
+int run_libfk_spinlock_tests() {
+    return run_tests("LibFK Spinlock",
+                     s_tests,
+                     sizeof(s_tests) / sizeof(s_tests[0]));
+}
@@ -0,0 +1,128 @@
+#include <tests/test_framework.h>
+#include <Kernel/Net/Tcp/tcp_options.h>
+
+using namespace fkernel::net;
+
+// A header followed by its options area, as parse() sees it on the wire
+struct Segment {
+    TcpHeader hdr;
+    uint8_t   options[TCP_MAX_OPTIONS_SIZE];
+} __attribute__((packed));
+
+static void make_segment(Segment& seg, const uint8_t* opts, size_t len) {
+    memset(&seg, 0, sizeof(seg));
+    if (len) memcpy(seg.options, opts, len);
+    seg.hdr.set_header_length(TCP_HEADER_SIZE + ((len + 3) & ~(size_t)3));
+}
+
+static const char* test_options_syn_round_trip() {
+    TcpOptions out;
+    out.has_mss = true;
+    out.mss = 1460;
+    out.has_wscale = true;
+    out.wscale = 7;
+    out.has_timestamp = true;
+    out.ts_val = 0x01020304;
+    out.ts_ecr = 0xA0B0C0D0;
+
+    Segment seg;
+    memset(&seg, 0, sizeof(seg));
+    size_t len = out.write(seg.options);
+    TEST_ASSERT_EQ(0, len % 4, "options are padded to a word");
+    TEST_ASSERT(len <= TCP_MAX_OPTIONS_SIZE, "options fit the header");
+    seg.hdr.set_header_length(TCP_HEADER_SIZE + len);
+
+    TcpOptions in = TcpOptions::parse(&seg.hdr);
+    TEST_ASSERT(in.has_mss, "MSS parsed");
+    TEST_ASSERT_EQ(1460, in.mss, "MSS value");
+    TEST_ASSERT(in.has_wscale, "window scale parsed");
+    TEST_ASSERT_EQ(7, in.wscale, "window scale value");
+    TEST_ASSERT(in.has_timestamp, "timestamp parsed");
+    TEST_ASSERT_EQ(0x01020304, in.ts_val, "TSval");
+    TEST_ASSERT_EQ(0xA0B0C0D0u, in.ts_ecr, "TSecr");
+    return NULL;
+}
+
+static const char* test_options_timestamp_only() {
+    TcpOptions out;
+    out.has_timestamp = true;
+    out.ts_val = 42;
+    out.ts_ecr = 7;
+    Segment seg;
+    memset(&seg, 0, sizeof(seg));
+    size_t len = out.write(seg.options);
+    TEST_ASSERT_EQ(TCP_TIMESTAMP_OPTION_SIZE, len, "data segments carry 12 option bytes");
+    seg.hdr.set_header_length(TCP_HEADER_SIZE + len);
+
+    TcpOptions in = TcpOptions::parse(&seg.hdr);
+    TEST_ASSERT(!in.has_mss && !in.has_wscale, "only the timestamp present");
+    TEST_ASSERT_EQ(42, in.ts_val, "TSval");
+    TEST_ASSERT_EQ(7, in.ts_ecr, "TSecr");
+    return NULL;
+}
+
+static const char* test_options_wscale_clamped() {
+    const uint8_t raw[] = {TCP_OPT_NOP, TCP_OPT_WSCALE, 3, 20};
+    Segment seg;
+    make_segment(seg, raw, sizeof(raw));
+    TcpOptions in = TcpOptions::parse(&seg.hdr);
+    TEST_ASSERT(in.has_wscale, "window scale parsed");
+    TEST_ASSERT_EQ(TCP_MAX_WSCALE, in.wscale, "shift above 14 is treated as 14");
+    return NULL;
+}
+
+static const char* test_options_no_options() {
+    Segment seg;
+    make_segment(seg, nullptr, 0);
+    TcpOptions in = TcpOptions::parse(&seg.hdr);
+    TEST_ASSERT(!in.has_mss && !in.has_wscale && !in.has_timestamp, "bare header has no options");
+    return NULL;
+}
+
+static const char* test_options_malformed_lengths() {
+    Segment seg;
+    // Length 0 would loop forever; parsing stops instead
+    const uint8_t zero_len[] = {TCP_OPT_MSS, 0, 0x05, 0xB4};
+    make_segment(seg, zero_len, sizeof(zero_len));
+    TEST_ASSERT(!TcpOptions::parse(&seg.hdr).has_mss, "length 0 rejected");
+
+    // Length running past the header
+    const uint8_t overrun[] = {TCP_OPT_NOP, TCP_OPT_NOP, TCP_OPT_TIMESTAMP, 10, 0, 0, 0, 1};
+    make_segment(seg, overrun, sizeof(overrun));
+    TEST_ASSERT(!TcpOptions::parse(&seg.hdr).has_timestamp, "option past the header rejected");
+
+    // Known kind with the wrong length is skipped, later options still parse
+    const uint8_t bad_mss[] = {TCP_OPT_MSS, 3, 0x05, TCP_OPT_WSCALE, 3, 5, TCP_OPT_NOP, TCP_OPT_NOP};
+    make_segment(seg, bad_mss, sizeof(bad_mss));
+    TcpOptions in = TcpOptions::parse(&seg.hdr);
+    TEST_ASSERT(!in.has_mss, "MSS with length 3 ignored");
+    TEST_ASSERT(in.has_wscale, "following option still parsed");
+    TEST_ASSERT_EQ(5, in.wscale, "following option value");
+
+    // Kind byte with no room for its length
+    const uint8_t truncated[] = {TCP_OPT_NOP, TCP_OPT_NOP, TCP_OPT_NOP, TCP_OPT_WSCALE};
+    make_segment(seg, truncated, sizeof(truncated));
+    TEST_ASSERT(!TcpOptions::parse(&seg.hdr).has_wscale, "truncated option rejected");
+
+    // Nothing after END is read
+    const uint8_t after_end[] = {TCP_OPT_END, TCP_OPT_WSCALE, 3, 5};
+    make_segment(seg, after_end, sizeof(after_end));
+    TEST_ASSERT(!TcpOptions::parse(&seg.hdr).has_wscale, "options after END ignored");
+    return NULL;
+}
+
+/* ---- Registration ---- */
+
+static test_case_t s_tests[] = {
+    {"test_options_syn_round_trip",    test_options_syn_round_trip},
+    {"test_options_timestamp_only",    test_options_timestamp_only},
+    {"test_options_wscale_clamped",    test_options_wscale_clamped},
+    {"test_options_no_options",        test_options_no_options},
+    {"test_options_malformed_lengths", test_options_malformed_lengths},
+};
+
+int run_net_tcp_options_tests() {
+    return run_tests("Net TCP Options",
+                     s_tests,
+                     sizeof(s_tests) / sizeof(s_tests[0]));
+}
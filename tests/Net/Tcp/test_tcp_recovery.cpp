@@ -0,0 +1,219 @@
+#include <tests/test_framework.h>
+#include <Kernel/Net/Tcp/tcp_congestion.h>
+#include <Kernel/Net/Tcp/tcp_retransmit_queue.h>
+#include <Kernel/Net/Tcp/tcp_rtt_estimator.h>
+
+using namespace fkernel::net;
+
+/* ---- TcpRttEstimator ---- */
+
+static const char* test_rtt_initial_rto() {
+    TcpRttEstimator rtt;
+    TEST_ASSERT(!rtt.has_sample(), "fresh estimator has no sample");
+    TEST_ASSERT_EQ(TCP_INITIAL_RTO_MS, rtt.rto_ms(), "RTO starts at 1 s");
+    return NULL;
+}
+
+static const char* test_rtt_samples() {
+    TcpRttEstimator rtt;
+    // (2.2): SRTT = R, RTTVAR = R/2, RTO = SRTT + max(G, 4 * RTTVAR)
+    rtt.sample(100, 10);
+    TEST_ASSERT_EQ(100, rtt.srtt_ms(), "first SRTT");
+    TEST_ASSERT_EQ(50, rtt.rttvar_ms(), "first RTTVAR");
+    TEST_ASSERT_EQ(300, rtt.rto_ms(), "first RTO");
+    // (2.3): RTTVAR = 3/4 * 50 + 1/4 * |100 - 100|
+    rtt.sample(100, 10);
+    TEST_ASSERT_EQ(100, rtt.srtt_ms(), "steady SRTT");
+    TEST_ASSERT_EQ(37, rtt.rttvar_ms(), "RTTVAR decays");
+    TEST_ASSERT_EQ(248, rtt.rto_ms(), "RTO follows RTTVAR");
+    return NULL;
+}
+
+static const char* test_rtt_granularity_and_floor() {
+    TcpRttEstimator rtt;
+    rtt.sample(0, 10);
+    TEST_ASSERT_EQ(TCP_MIN_RTO_MS, rtt.rto_ms(), "RTO never drops below the minimum");
+    TcpRttEstimator coarse;
+    coarse.sample(400, 1000);
+    TEST_ASSERT_EQ(1400, coarse.rto_ms(), "clock granularity bounds the variance term");
+    return NULL;
+}
+
+static const char* test_rtt_back_off() {
+    TcpRttEstimator rtt;
+    rtt.sample(100, 10);
+    rtt.back_off();
+    TEST_ASSERT_EQ(600, rtt.rto_ms(), "one timeout doubles the RTO");
+    rtt.back_off();
+    TEST_ASSERT_EQ(1200, rtt.rto_ms(), "two timeouts quadruple it");
+    for (int i = 0; i < 20; ++i) rtt.back_off();
+    TEST_ASSERT_EQ(TCP_MAX_RTO_MS, rtt.rto_ms(), "backoff is capped");
+    rtt.sample(100, 10);
+    TEST_ASSERT(rtt.rto_ms() < 600, "a new sample clears the backoff");
+    return NULL;
+}
+
+/* ---- TcpCongestionControl ---- */
+
+static const char* test_cc_initial_window() {
+    TcpCongestionControl cc(1000);
+    TEST_ASSERT_EQ(10000, cc.cwnd(), "RFC 6928 initial window is 10 segments");
+    TcpCongestionControl big(2000);
+    TEST_ASSERT_EQ(14600, big.cwnd(), "initial window is capped at 14600 bytes");
+    return NULL;
+}
+
+static const char* test_cc_slow_start_and_avoidance() {
+    TcpCongestionControl cc(1000);
+    TEST_ASSERT(cc.on_ack(2000, 1000, 10000) == TcpCongestionControl::Action::None,
+                "a new ACK needs no retransmit");
+    TEST_ASSERT_EQ(11000, cc.cwnd(), "slow start grows by the bytes acked");
+    cc.on_ack(7000, 5000, 10000);
+    TEST_ASSERT_EQ(12000, cc.cwnd(), "growth per ACK is capped at one MSS");
+
+    // Drop into congestion avoidance: ssthresh = flight / 2
+    cc.on_timeout(16000, 20000);
+    TEST_ASSERT_EQ(8000, cc.ssthresh(), "timeout halves the flight");
+    TEST_ASSERT_EQ(1000, cc.cwnd(), "timeout collapses cwnd to one MSS");
+    while (cc.cwnd() < cc.ssthresh())
+        cc.on_ack(20000, 1000, 1000);
+    uint32_t before = cc.cwnd();
+    cc.on_ack(21000, 1000, before);
+    TEST_ASSERT_EQ(before + 1000 * 1000 / before, cc.cwnd(),
+                   "congestion avoidance adds MSS*MSS/cwnd");
+    return NULL;
+}
+
+static const char* test_cc_fast_retransmit_and_recovery() {
+    TcpCongestionControl cc(1000);
+    const uint32_t una = 1000, nxt = 11000;
+    TEST_ASSERT(cc.on_dup_ack(10000, una, nxt) == TcpCongestionControl::Action::None, "first dup");
+    TEST_ASSERT(cc.on_dup_ack(10000, una, nxt) == TcpCongestionControl::Action::None, "second dup");
+    TEST_ASSERT(cc.on_dup_ack(10000, una, nxt) == TcpCongestionControl::Action::Retransmit,
+                "third dup ACK triggers fast retransmit");
+    TEST_ASSERT(cc.in_recovery(), "fast recovery entered");
+    TEST_ASSERT_EQ(5000, cc.ssthresh(), "ssthresh = flight / 2");
+    TEST_ASSERT_EQ(8000, cc.cwnd(), "cwnd = ssthresh + 3 * MSS");
+    cc.on_dup_ack(10000, una, nxt);
+    TEST_ASSERT_EQ(9000, cc.cwnd(), "further dups inflate cwnd");
+
+    // RFC 6582: a partial ACK retransmits the next hole and stays in recovery
+    TEST_ASSERT(cc.on_ack(2000, 1000, 10000) == TcpCongestionControl::Action::Retransmit,
+                "partial ACK retransmits");
+    TEST_ASSERT(cc.in_recovery(), "partial ACK stays in recovery");
+    TEST_ASSERT_EQ(9000, cc.cwnd(), "partial ACK deflates by the bytes acked plus one MSS");
+
+    // Full ACK: cwnd = min(ssthresh, max(FlightSize, SMSS) + SMSS)
+    TEST_ASSERT(cc.on_ack(nxt, 9000, 9000) == TcpCongestionControl::Action::None,
+                "full ACK needs no retransmit");
+    TEST_ASSERT(!cc.in_recovery(), "full ACK leaves recovery");
+    TEST_ASSERT_EQ(2000, cc.cwnd(), "window deflated on exit");
+    return NULL;
+}
+
+static const char* test_cc_no_fast_retransmit_after_timeout() {
+    TcpCongestionControl cc(1000);
+    cc.on_timeout(10000, 11000);
+    for (int i = 0; i < 3; ++i)
+        TEST_ASSERT(cc.on_dup_ack(1000, 1000, 11000) == TcpCongestionControl::Action::None,
+                    "dups for data sent before the timeout are ignored");
+    TEST_ASSERT(!cc.in_recovery(), "no recovery after timeout");
+    // Once everything before the timeout is acked, fast retransmit works again
+    cc.on_ack(11000, 10000, 10000);
+    for (int i = 0; i < 2; ++i) cc.on_dup_ack(2000, 11000, 13000);
+    TEST_ASSERT(cc.on_dup_ack(2000, 11000, 13000) == TcpCongestionControl::Action::Retransmit,
+                "fast retransmit re-armed");
+    return NULL;
+}
+
+/* ---- TcpRetransmitQueue ---- */
+
+static const char* test_rq_cumulative_ack() {
+    TcpRetransmitQueue q;
+    uint8_t payload[100];
+    for (int i = 0; i < 100; ++i) payload[i] = (uint8_t)i;
+    for (uint32_t i = 0; i < 3; ++i)
+        TEST_ASSERT(q.push(1000 + i * 100, TCP_FLAG_ACK, payload, 100, 10 + i), "push");
+    TEST_ASSERT_EQ(3, q.size(), "three segments queued");
+
+    auto none = q.acknowledge(1000);
+    TEST_ASSERT_EQ(0, none.segments, "an ACK at the head releases nothing");
+
+    auto res = q.acknowledge(1200);
+    TEST_ASSERT_EQ(2, res.segments, "two segments released");
+    TEST_ASSERT(res.has_rtt_sample, "fresh segments give an RTT sample");
+    TEST_ASSERT_EQ(11, res.sample_sent_ticks, "sample from the newest acked segment");
+    TEST_ASSERT_EQ(1200, q.front()->seq, "third segment is now the head");
+    return NULL;
+}
+
+static const char* test_rq_partial_ack_trims_head() {
+    TcpRetransmitQueue q;
+    uint8_t payload[100];
+    for (int i = 0; i < 100; ++i) payload[i] = (uint8_t)i;
+    q.push(5000, TCP_FLAG_ACK, payload, 100, 0);
+    auto res = q.acknowledge(5040);
+    TEST_ASSERT_EQ(0, res.segments, "partial ACK releases no segment");
+    TcpSegment* head = q.front();
+    TEST_ASSERT_EQ(5040, head->seq, "head moved to the ACK point");
+    TEST_ASSERT_EQ(60, head->len, "covered bytes dropped");
+    TEST_ASSERT_EQ(40, head->data[0], "remaining payload shifted down");
+    TEST_ASSERT_EQ(99, head->data[59], "tail of the payload kept");
+    return NULL;
+}
+
+static const char* test_rq_syn_and_fin_occupy_sequence_space() {
+    TcpRetransmitQueue q;
+    q.push(0, TCP_FLAG_SYN, nullptr, 0, 0);
+    TEST_ASSERT_EQ(1, q.front()->seq_len(), "bare SYN takes one sequence number");
+    TEST_ASSERT_EQ(0, q.acknowledge(0).segments, "SYN unacknowledged at its own seq");
+    TEST_ASSERT_EQ(1, q.acknowledge(1).segments, "SYN released by ACK seq+1");
+
+    uint8_t payload[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+    q.push(100, TCP_FLAG_SYN | TCP_FLAG_ACK, payload, 10, 0);
+    q.acknowledge(101);
+    TEST_ASSERT(!(q.front()->flags & TCP_FLAG_SYN), "acked SYN flag dropped");
+    TEST_ASSERT_EQ(101, q.front()->seq, "data starts after the SYN");
+    TEST_ASSERT_EQ(10, q.front()->len, "payload untouched");
+    q.clear();
+
+    q.push(200, TCP_FLAG_FIN | TCP_FLAG_ACK, nullptr, 0, 0);
+    TEST_ASSERT_EQ(0, q.acknowledge(200).segments, "FIN needs its own sequence number acked");
+    TEST_ASSERT_EQ(1, q.acknowledge(201).segments, "FIN released");
+    TEST_ASSERT(q.is_empty(), "queue drained");
+    return NULL;
+}
+
+static const char* test_rq_karn_and_wrap() {
+    TcpRetransmitQueue q;
+    uint8_t payload[32] = {};
+    q.push(0xFFFFFFF0u, TCP_FLAG_ACK, payload, 32, 0);
+    q.front()->retransmitted = true;
+    auto res = q.acknowledge(0x10);
+    TEST_ASSERT_EQ(1, res.segments, "segment spanning the wrap released");
+    TEST_ASSERT(!res.has_rtt_sample, "retransmitted segment gives no RTT sample");
+    return NULL;
+}
+
+/* ---- Registration ---- */
+
+static test_case_t s_tests[] = {
+    {"test_rtt_initial_rto",                      test_rtt_initial_rto},
+    {"test_rtt_samples",                          test_rtt_samples},
+    {"test_rtt_granularity_and_floor",            test_rtt_granularity_and_floor},
+    {"test_rtt_back_off",                         test_rtt_back_off},
+    {"test_cc_initial_window",                    test_cc_initial_window},
+    {"test_cc_slow_start_and_avoidance",          test_cc_slow_start_and_avoidance},
+    {"test_cc_fast_retransmit_and_recovery",      test_cc_fast_retransmit_and_recovery},
+    {"test_cc_no_fast_retransmit_after_timeout",  test_cc_no_fast_retransmit_after_timeout},
+    {"test_rq_cumulative_ack",                    test_rq_cumulative_ack},
+    {"test_rq_partial_ack_trims_head",            test_rq_partial_ack_trims_head},
+    {"test_rq_syn_and_fin_occupy_sequence_space", test_rq_syn_and_fin_occupy_sequence_space},
+    {"test_rq_karn_and_wrap",                     test_rq_karn_and_wrap},
+};
+
+int run_net_tcp_recovery_tests() {
+    return run_tests("Net TCP Recovery",
+                     s_tests,
+                     sizeof(s_tests) / sizeof(s_tests[0]));
+}
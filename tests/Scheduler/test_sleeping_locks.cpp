@@ -0,0 +1,254 @@
+#include <tests/test_framework.h>
+#include <Kernel/Scheduler/mutex.h>
+#include <Kernel/Scheduler/rw_semaphore.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+using namespace fkernel;
+
+/* ---- Scheduler hooks: host threads stand in for tasks ---- */
+
+namespace fkernel {
+
+static thread_local char t_task_tag;
+
+Task* lock_caller() {
+    return reinterpret_cast<Task*>(&t_task_tag);
+}
+
+bool lock_owner_running(const Task*) {
+    return false;
+}
+
+void lock_wait_for_grant(fk::synchronization::Spinlock& guard, LockWaiter& waiter) {
+    for (;;) {
+        {
+            fk::synchronization::ScopedLockIRQ lock(guard);
+            if (waiter.granted)
+                return;
+        }
+        sched_yield();
+    }
+}
+
+void lock_grant(LockWaiter& waiter) {
+    waiter.granted = true;
+}
+
+void lock_owner_blocks(Task*, Task*) {}
+
+void lock_owner_releases(Task*) {}
+
+} // namespace fkernel
+
+// Long enough for a started thread to reach the wait queue
+static void let_threads_queue() {
+    usleep(50 * 1000);
+}
+
+/* ---- Mutex ---- */
+
+struct MutexHandoff {
+    Mutex* mutex;
+    volatile bool acquired;
+    volatile bool release;
+};
+
+static void* mutex_handoff_thread(void* arg) {
+    auto* h = static_cast<MutexHandoff*>(arg);
+    h->mutex->lock();
+    h->acquired = true;
+    while (!h->release)
+        sched_yield();
+    h->mutex->unlock();
+    return nullptr;
+}
+
+static const char* test_mutex_try_lock() {
+    Mutex mutex;
+    TEST_ASSERT(!mutex.is_locked(), "starts unlocked");
+    TEST_ASSERT(mutex.try_lock(), "try_lock on a free mutex");
+    TEST_ASSERT(mutex.is_locked_by_current(), "caller owns it");
+    mutex.unlock();
+    TEST_ASSERT(!mutex.is_locked(), "unlock frees it");
+    return NULL;
+}
+
+static const char* test_mutex_hands_off_to_waiter() {
+    Mutex mutex;
+    mutex.lock();
+    MutexHandoff h{&mutex, false, false};
+    pthread_t t;
+    pthread_create(&t, nullptr, mutex_handoff_thread, &h);
+    let_threads_queue();
+    TEST_ASSERT(!h.acquired, "waiter blocks while the mutex is held");
+
+    mutex.unlock();
+    // Ownership moved to the waiter inside unlock(), before it even runs
+    TEST_ASSERT(!mutex.try_lock(), "released mutex goes to the queued waiter");
+    while (!h.acquired)
+        sched_yield();
+    TEST_ASSERT(!mutex.is_locked_by_current(), "waiter, not us, is the owner");
+    h.release = true;
+    pthread_join(t, nullptr);
+    TEST_ASSERT(!mutex.is_locked(), "free after the waiter unlocks");
+    return NULL;
+}
+
+static constexpr int CONTENTION_THREADS = 4;
+static constexpr int CONTENTION_ITERATIONS = 20000;
+
+struct MutexCounter {
+    Mutex mutex;
+    uint64_t value{0};
+};
+
+static void* mutex_counter_thread(void* arg) {
+    auto* c = static_cast<MutexCounter*>(arg);
+    for (int i = 0; i < CONTENTION_ITERATIONS; ++i) {
+        MutexLocker lock(c->mutex);
+        uint64_t v = c->value;
+        if ((i & 63) == 0) sched_yield();
+        c->value = v + 1;
+    }
+    return nullptr;
+}
+
+static const char* test_mutex_contention() {
+    MutexCounter counter;
+    pthread_t threads[CONTENTION_THREADS];
+    for (auto& t : threads) pthread_create(&t, nullptr, mutex_counter_thread, &counter);
+    for (auto& t : threads) pthread_join(t, nullptr);
+    TEST_ASSERT_EQ((uint64_t)CONTENTION_THREADS * CONTENTION_ITERATIONS, counter.value,
+                   "no increment lost under contention");
+    return NULL;
+}
+
+/* ---- RwSemaphore ---- */
+
+struct RwProbe {
+    RwSemaphore* sem;
+    bool writer;
+    volatile bool acquired;
+    volatile bool release;
+};
+
+static void* rw_probe_thread(void* arg) {
+    auto* p = static_cast<RwProbe*>(arg);
+    if (p->writer) p->sem->lock_write();
+    else p->sem->lock_read();
+    p->acquired = true;
+    while (!p->release)
+        sched_yield();
+    if (p->writer) p->sem->unlock_write();
+    else p->sem->unlock_read();
+    return nullptr;
+}
+
+static const char* test_rwsem_shared_readers() {
+    RwSemaphore sem;
+    RwProbe reader{&sem, false, false, false};
+    pthread_t t;
+    pthread_create(&t, nullptr, rw_probe_thread, &reader);
+    while (!reader.acquired)
+        sched_yield();
+
+    TEST_ASSERT(sem.try_lock_read(), "second reader shares the semaphore");
+    TEST_ASSERT(!sem.try_lock_write(), "writer excluded while readers hold it");
+    sem.unlock_read();
+    reader.release = true;
+    pthread_join(t, nullptr);
+    TEST_ASSERT(sem.try_lock_write(), "writer gets it once readers are gone");
+    TEST_ASSERT(!sem.try_lock_read(), "reader excluded while a writer holds it");
+    sem.unlock_write();
+    return NULL;
+}
+
+static const char* test_rwsem_queued_writer_blocks_new_readers() {
+    RwSemaphore sem;
+    sem.lock_read();
+    RwProbe writer{&sem, true, false, false};
+    pthread_t tw;
+    pthread_create(&tw, nullptr, rw_probe_thread, &writer);
+    let_threads_queue();
+    TEST_ASSERT(!writer.acquired, "writer waits for the reader");
+    TEST_ASSERT(!sem.try_lock_read(), "new reader does not overtake the queued writer");
+
+    RwProbe late_reader{&sem, false, false, false};
+    pthread_t tr;
+    pthread_create(&tr, nullptr, rw_probe_thread, &late_reader);
+    let_threads_queue();
+
+    sem.unlock_read();
+    while (!writer.acquired)
+        sched_yield();
+    TEST_ASSERT(!late_reader.acquired, "reader queued behind the writer still waits");
+    writer.release = true;
+    pthread_join(tw, nullptr);
+    while (!late_reader.acquired)
+        sched_yield();
+    late_reader.release = true;
+    pthread_join(tr, nullptr);
+    TEST_ASSERT(sem.try_lock_write(), "semaphore free at the end");
+    sem.unlock_write();
+    return NULL;
+}
+
+struct RwCounter {
+    RwSemaphore sem;
+    uint64_t a{0};
+    uint64_t b{0};
+    volatile bool torn{false};
+};
+
+static void* rw_writer_thread(void* arg) {
+    auto* c = static_cast<RwCounter*>(arg);
+    for (int i = 0; i < CONTENTION_ITERATIONS; ++i) {
+        WriteLocker lock(c->sem);
+        ++c->a;
+        if ((i & 63) == 0) sched_yield();
+        ++c->b;
+    }
+    return nullptr;
+}
+
+static void* rw_reader_thread(void* arg) {
+    auto* c = static_cast<RwCounter*>(arg);
+    for (int i = 0; i < CONTENTION_ITERATIONS; ++i) {
+        ReadLocker lock(c->sem);
+        if (c->a != c->b) c->torn = true;
+    }
+    return nullptr;
+}
+
+static const char* test_rwsem_contention() {
+    RwCounter counter;
+    pthread_t threads[CONTENTION_THREADS];
+    for (int i = 0; i < CONTENTION_THREADS; ++i)
+        pthread_create(&threads[i], nullptr, (i & 1) ? rw_reader_thread : rw_writer_thread,
+                       &counter);
+    for (auto& t : threads) pthread_join(t, nullptr);
+    TEST_ASSERT(!counter.torn, "readers never see a writer's partial update");
+    TEST_ASSERT_EQ((uint64_t)(CONTENTION_THREADS / 2) * CONTENTION_ITERATIONS, counter.a,
+                   "no write lost under contention");
+    return NULL;
+}
+
+/* ---- Registration ---- */
+
+static test_case_t s_tests[] = {
+    {"test_mutex_try_lock",                         test_mutex_try_lock},
+    {"test_mutex_hands_off_to_waiter",              test_mutex_hands_off_to_waiter},
+    {"test_mutex_contention",                       test_mutex_contention},
+    {"test_rwsem_shared_readers",                   test_rwsem_shared_readers},
+    {"test_rwsem_queued_writer_blocks_new_readers", test_rwsem_queued_writer_blocks_new_readers},
+    {"test_rwsem_contention",                       test_rwsem_contention},
+};
+
+int run_scheduler_sleeping_lock_tests() {
+    return run_tests("Scheduler Sleeping Locks",
+                     s_tests,
+                     sizeof(s_tests) / sizeof(s_tests[0]));
+}
@@ -0,0 +1,128 @@
+#include <tests/test_framework.h>
+#include <Kernel/Ipc/signal_delivery.h>
+#include <Kernel/Scheduler/scheduler.h>
+#include <Kernel/Scheduler/wait_queue.h>
+
+using namespace fkernel;
+
+/* ---- Scheduler hooks: one CPU, and no context switch ---- */
+
+static Processor s_cpu;
+
+SchedulerManager::SchedulerManager() {}
+
+Processor& SchedulerManager::current_processor() {
+    return s_cpu;
+}
+
+// The tests wake the task before finish_wait(), so there is nothing to switch to
+void SchedulerManager::schedule() {}
+
+void Task::print_info() const {}
+
+// The kernel wakes the target inline, re-entering the per-CPU recursive
+// scheduler lock; host spinlocks do not recurse, so the wake is deferred
+static Task* s_signalled;
+
+void fkernel::ipc::SignalDelivery::send_signal(Task* target, int signum) {
+    target->resources.ipc.signals.pending |= (1ULL << signum);
+    if (target->control.lifecycle.state == TaskState::Blocked)
+        s_signalled = target;
+}
+
+static void deliver_deferred_wake() {
+    if (s_signalled)
+        SchedulerManager::the().wake_task(s_signalled);
+    s_signalled = nullptr;
+}
+
+static constexpr int TEST_SIGINT = 2;
+
+// Tasks stay linked into the scheduler's lists after a test, so none is on the stack
+static Task* make_task(uint64_t pid, uint64_t ppid, uint64_t pgid) {
+    auto* task = new Task();
+    task->control.identity.id = fk::ProcessId(pid);
+    task->control.identity.ppid = fk::ProcessId(ppid);
+    task->control.identity.pgid = fk::ProcessId(pgid);
+    task->control.lifecycle.state = TaskState::Running;
+    task->control.lifecycle.cpu_affinity = 1;
+    return task;
+}
+
+// Parks the current task on queue, then switches it out as schedule() would
+static void park(WaitQueue& queue, WaitQueueEntry& entry, Task* task) {
+    s_cpu.current_task = task;
+    queue.prepare_to_wait(entry);
+    s_cpu.current_task = nullptr;
+}
+
+/* ---- Tests ---- */
+
+static const char* test_blocked_reader_is_visible() {
+    Task* reader = make_task(101, 100, 100);
+    WaitQueue queue;
+    WaitQueueEntry entry;
+    park(queue, entry, reader);
+    TEST_ASSERT(reader->state() == TaskState::Blocked, "reader sleeps");
+
+    auto& scheduler = SchedulerManager::the();
+    TEST_ASSERT(scheduler.find_task(fk::ProcessId(101)).get() == reader,
+                "kill can find a sleeping reader");
+    TEST_ASSERT(scheduler.find_any_child(fk::ProcessId(100)).get() == reader,
+                "wait4 sees the sleeping child");
+
+    queue.wake_one();
+    TEST_ASSERT(reader->state() == TaskState::Ready, "wake_one makes it runnable");
+    s_cpu.current_task = reader;
+    TEST_ASSERT(queue.finish_wait(entry).is_ok(), "a plain wake is not an interruption");
+    s_cpu.current_task = nullptr;
+    return NULL;
+}
+
+static const char* test_pgrp_signal_wakes_blocked_reader() {
+    Task* reader = make_task(201, 200, 200);
+    WaitQueue queue;
+    WaitQueueEntry entry;
+    park(queue, entry, reader);
+
+    // ISIG ^C on the tty
+    SchedulerManager::the().send_signal_to_pgrp(200, TEST_SIGINT);
+    deliver_deferred_wake();
+    TEST_ASSERT(reader->has_pending_signals(), "the group signal reached the reader");
+    TEST_ASSERT(reader->state() == TaskState::Ready, "the signal woke it");
+
+    s_cpu.current_task = reader;
+    TEST_ASSERT(queue.finish_wait(entry).is_error(), "the read is interrupted");
+    s_cpu.current_task = nullptr;
+    TEST_ASSERT(!queue.has_waiters(), "an interrupted reader leaves the queue");
+    return NULL;
+}
+
+static const char* test_pending_signal_skips_the_wait() {
+    Task* reader = make_task(301, 300, 300);
+    reader->resources.ipc.signals.pending = 1ULL << TEST_SIGINT;
+    WaitQueue queue;
+    WaitQueueEntry entry;
+    park(queue, entry, reader);
+    TEST_ASSERT(reader->state() == TaskState::Running, "never marked blocked");
+    TEST_ASSERT(!queue.has_waiters(), "never queued");
+
+    s_cpu.current_task = reader;
+    TEST_ASSERT(queue.finish_wait(entry).is_error(), "returns Interrupted straight away");
+    s_cpu.current_task = nullptr;
+    return NULL;
+}
+
+/* ---- Registration ---- */
+
+static test_case_t s_tests[] = {
+    {"test_blocked_reader_is_visible",        test_blocked_reader_is_visible},
+    {"test_pgrp_signal_wakes_blocked_reader", test_pgrp_signal_wakes_blocked_reader},
+    {"test_pending_signal_skips_the_wait",    test_pending_signal_skips_the_wait},
+};
+
+int run_scheduler_wait_queue_tests() {
+    return run_tests("Scheduler Wait Queue",
+                     s_tests,
+                     sizeof(s_tests) / sizeof(s_tests[0]));
+}
@@ -15,6 +15,12 @@ int run_libfk_stringbuilder_tests();
 int run_libfk_bitmap_unordered_set_tests();
 int run_libfk_algorithm_tests();
 int run_libfk_string_view_tests();
+int run_libfk_intrusive_rb_tree_tests();
+int run_libfk_spinlock_tests();
+int run_net_tcp_recovery_tests();
+int run_net_tcp_options_tests();
+int run_scheduler_sleeping_lock_tests();
+int run_scheduler_wait_queue_tests();
 
 int main() {
     int failed = 0;
@@ -33,6 +39,12 @@ int main() {
     failed += run_libfk_bitmap_unordered_set_tests();
     failed += run_libfk_algorithm_tests();
     failed += run_libfk_string_view_tests();
+    failed += run_libfk_intrusive_rb_tree_tests();
+    failed += run_libfk_spinlock_tests();
+    failed += run_net_tcp_recovery_tests();
+    failed += run_net_tcp_options_tests();
+    failed += run_scheduler_sleeping_lock_tests();
+    failed += run_scheduler_wait_queue_tests();
 
     if (failed == 0) {
         TEST_LOG("\n>>> SUMMARY: ALL TEST SUITES PASSED!\n");
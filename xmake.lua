@@ -68,6 +68,7 @@ local kernel_non_architecture_related = {
   "Src/Kernel/Syscall/**.cpp",
   "Src/Kernel/Net/**.cpp",
   "Src/Kernel/Io/**.cpp",
+  "Src/Kernel/Trace/**.cpp",
 }
 
 -- Custom Toolchain for Kernel
@@ -98,6 +99,11 @@ set_default("busybox")
 set_values("busybox", "openrc")
 set_description("Select initrd system style")
 
+option("lock_stat")
+set_default(false)
+set_showmenu(true)
+set_description("Collect per-class spinlock contention statistics in /proc/lock_stat")
+
 -- TARGET: FKernel
 target("FKernel")
   set_kind("binary")
@@ -124,6 +130,10 @@ target("FKernel")
     add_defines("FKERNEL_LOG_LEVEL=2")  -- strip debug; keep warn/error/fatal
   end
 
+  if has_config("lock_stat") then
+    add_defines("FKERNEL_LOCK_STAT")
+  end
+
   add_files("Src/LibC/**.c")
   add_files("Src/LibC/**.cpp")
   add_files("Src/LibFK/**.cpp")
@@ -185,6 +195,7 @@ target("Test")
   set_languages("cxx20")
   add_defines("FKERNEL_TEST")
   add_cxflags("-g")
+  add_syslinks("pthread")
   
   -- Add test files
   add_files("tests/main.cpp")
@@ -202,9 +213,25 @@ target("Test")
   add_files("tests/LibFK/test_bitmap_unordered_set.cpp")
   add_files("tests/LibFK/test_algorithms.cpp")
   add_files("tests/LibFK/test_string_view.cpp")
+  add_files("tests/LibFK/test_intrusive_rb_tree.cpp")
+  add_files("tests/LibFK/test_spinlock.cpp")
+  add_files("tests/Net/Tcp/test_tcp_recovery.cpp")
+  add_files("tests/Net/Tcp/test_tcp_options.cpp")
+  add_files("tests/Scheduler/test_sleeping_locks.cpp")
+  add_files("tests/Scheduler/test_wait_queue.cpp")
   add_files("Src/LibFK/Text/string.cpp")
   add_files("Src/LibFK/Text/string_builder.cpp")
   add_files("Src/LibFK/Memory/new.cpp")
+  add_files("Src/Kernel/Net/Tcp/tcp_rtt_estimator.cpp")
+  add_files("Src/Kernel/Net/Tcp/tcp_congestion.cpp")
+  add_files("Src/Kernel/Net/Tcp/tcp_retransmit_queue.cpp")
+  add_files("Src/Kernel/Net/Tcp/tcp_options.cpp")
+  add_files("Src/Kernel/Scheduler/mutex.cpp")
+  add_files("Src/Kernel/Scheduler/rw_semaphore.cpp")
+  add_files("Src/Kernel/Scheduler/wait_queue.cpp")
+  add_files("Src/Kernel/Scheduler/scheduler_blocking.cpp")
+  add_files("Src/Kernel/Scheduler/scheduler_introspection.cpp")
+  add_files("Src/LibFK/Algorithms/log_targets.cpp")
   add_files("tests/test_mock.c")
 
   on_run(function(target)